@@ -1,6 +1,7 @@
 // src/enhancedTechnicalCoaching.js
 import { characterNames } from './utils/slippiUtils.js';
 import { executeOpenAIRequest } from './utils/api/openaiHandler.js';
+import { searchKnowledge } from './utils/knowledgeIndex.js';
 
 /**
  * Enhanced coaching profile types for targeted feedback
@@ -14,6 +15,20 @@ const COACHING_PROFILES = {
   COMPREHENSIVE: 'comprehensive'               // Balanced approach
 };
 
+/**
+ * Knowledge corpus tags that match each coaching profile
+ */
+const PROFILE_KNOWLEDGE_TAGS = {
+  [COACHING_PROFILES.TECHNICAL_EXECUTION]: ['tech-skill', 'execution', 'frame-data'],
+  [COACHING_PROFILES.NEUTRAL_GAME]: ['neutral', 'spacing', 'stage'],
+  [COACHING_PROFILES.PUNISH_OPTIMIZATION]: ['punish', 'combos', 'conversions', 'tech-chase'],
+  [COACHING_PROFILES.MATCHUP_SPECIFIC]: ['matchup'],
+  [COACHING_PROFILES.DEFENSIVE_OPTIONS]: ['defense', 'recovery', 'di'],
+  [COACHING_PROFILES.COMPREHENSIVE]: []
+};
+
+const KNOWLEDGE_SNIPPET_COUNT = 5;
+
 /**
  * Cache for coaching advice to reduce LLM calls for similar data
  */
@@ -326,6 +341,22 @@ ${perfRating.technicalDetails ? `- Technical Details:
       prompt += `\n- ${area}`;
     });
   }
+
+  // Ground the advice in curated notes for these characters and focus areas
+  const knowledge = searchKnowledge(
+    [coachingProfile, ...(focusAreas || [])].join(' '),
+    {
+      characters: characterInfo.map(p => p.character),
+      tags: PROFILE_KNOWLEDGE_TAGS[coachingProfile] || [],
+      topK: KNOWLEDGE_SNIPPET_COUNT
+    }
+  );
+  if (knowledge.length > 0) {
+    prompt += `\n\n## Relevant Coaching Notes:`;
+    knowledge.forEach(note => {
+      prompt += `\n- ${note.text}`;
+    });
+  }
   
   // Add profile-specific instructions
   prompt += `\n\n${getCoachingProfileInstructions(coachingProfile)}`;
@@ -129,7 +129,9 @@ async function main() {
                     maxLength: aiConfig.maxTokens,
                     temperature: aiConfig.temperature
                 });
-                console.log(`🗣️  Commentary: ${commentary}`);
+                if (commentary) {
+                    console.log(`🗣️  Commentary: ${commentary}`);
+                }
             } catch (error) {
                 console.error(`❌ Error generating commentary: ${error.message}`);
             }
@@ -6,7 +6,7 @@ import { Server } from 'socket.io';
 import path from 'path';
 import { fileURLToPath } from 'url';
 import fs from 'fs';
-import { getConfig, validateConfig, getSlippiConfig, getAIConfig, loadFullConfig } from './utils/configManager.js';
+import { getConfig, validateConfig, getSlippiConfig, getAIConfig, loadFullConfig, reloadConfig } from './utils/configManager.js';
 import { getLiveMonitor } from './enhancedLiveMonitor.js';
 import { provideLiveCommentary } from './liveCommentary.js';
 import './utils/logger.js';
@@ -59,6 +59,7 @@ app.post('/api/config', (req, res) => {
         }
         
         fs.writeFileSync(configPath, JSON.stringify(newConfig, null, 2));
+        reloadConfig(); // Don't wait for the file watcher before the next read
         res.json({ success: true, message: 'Configuration saved successfully' });
     } catch (error) {
         res.status(500).json({ error: error.message });
@@ -1,10 +1,15 @@
 // src/liveCommentary.js
 import { generateTemplateCommentary } from './templateCommentarySystem.js';
 import { COMMENTARY_STYLES, CACHE_EXPIRY } from './utils/constants.js';
+import { NearDuplicateFilter } from './utils/nearDuplicateFilter.js';
 
 // Cache for commentaries to reduce duplicate API calls
 const commentaryCache = new Map();
 
+// Events close to one the model was asked about in the last 15 seconds (a
+// burst of hits, the same combo again) are skipped rather than sent
+const requestRepeats = new NearDuplicateFilter();
+
 /**
  * Provides dual-mode live commentary with both fast reactions and analytical insights
  * 
@@ -37,6 +42,11 @@ export async function provideDualCommentary(fastProvider, analyticalProvider, ev
     return { fast: 'Great play!', analytical: 'Interesting strategic choice there.' };
   }
   
+  if (!requestRepeats.admit(describeRequest(event, commentaryStyle))) {
+    console.log(`🎙️ Skipping dual commentary for ${eventType}: near-duplicate of a recent request`);
+    return { fast: '', analytical: '' };
+  }
+  
   console.log(`🎙️ Generating dual commentary for ${eventType}:`, event);
   
   // Generate both types of commentary in parallel
@@ -198,6 +208,11 @@ export async function provideLiveCommentary(llmProvider, events, options = {}) {
     return commentary;
   }
   
+  if (!requestRepeats.admit(describeRequest(event, commentaryStyle))) {
+    console.log(`🎙️ Skipping ${event.type || 'unknown'} commentary: near-duplicate of a recent request`);
+    return '';
+  }
+  
   // Build LLM prompt with appropriate context and style
   const prompt = buildTechnicalCommentaryPrompt(event, commentaryStyle, null, gameState);
   
@@ -342,6 +357,21 @@ Focus on moves, techniques, and excitement!
   return promptBase;
 }
 
+/**
+ * The part of a commentary request that changes from event to event, for the
+ * near-duplicate check: the event's fields, with the player written as "P<n>"
+ * so events for different players never count as repeats
+ * 
+ * @param {Object} event - Event the request is about
+ * @param {string} style - Commentary style
+ * @returns {string} - Text to fingerprint
+ */
+function describeRequest(event, style) {
+  const { playerIndex, ...fields } = event;
+  const player = Number.isInteger(playerIndex) ? `P${playerIndex + 1} ` : '';
+  return `${style} ${player}${JSON.stringify(fields)}`;
+}
+
 /**
  * Generates a cache key for commentary deduplication
  * 
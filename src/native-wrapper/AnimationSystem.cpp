@@ -0,0 +1,102 @@
+#include "AnimationSystem.h"
+
+AnimationHandle AnimationSystem::Register(const std::string& name, float initialValue) {
+    auto existing = m_handles.find(name);
+    if (existing != m_handles.end()) {
+        return existing->second;
+    }
+
+    AnimationHandle handle = static_cast<AnimationHandle>(m_value.size());
+    m_startTime.push_back(0);
+    m_duration.push_back(0);
+    m_from.push_back(initialValue);
+    m_to.push_back(initialValue);
+    m_value.push_back(initialValue);
+    m_easing.push_back(Easing::LINEAR);
+    m_runningSlot.push_back(NOT_RUNNING);
+    m_handles.emplace(name, handle);
+    return handle;
+}
+
+AnimationHandle AnimationSystem::Find(const std::string& name) const {
+    auto existing = m_handles.find(name);
+    return existing != m_handles.end() ? existing->second : INVALID_ANIMATION;
+}
+
+void AnimationSystem::Start(AnimationHandle handle, float from, float to, uint32_t durationMs, uint32_t nowMs,
+                            Easing easing) {
+    if (handle >= m_value.size()) {
+        return;
+    }
+
+    m_startTime[handle] = nowMs;
+    m_duration[handle] = durationMs;
+    m_from[handle] = from;
+    m_to[handle] = to;
+    m_value[handle] = from;
+    m_easing[handle] = easing;
+
+    if (m_runningSlot[handle] == NOT_RUNNING) {
+        m_runningSlot[handle] = static_cast<uint32_t>(m_running.size());
+        m_running.push_back(handle);
+    }
+}
+
+void AnimationSystem::Stop(AnimationHandle handle) {
+    if (handle < m_value.size() && m_runningSlot[handle] != NOT_RUNNING) {
+        RemoveRunning(handle);
+    }
+}
+
+void AnimationSystem::Update(uint32_t nowMs) {
+    // Backwards, so a finished animation can be swapped out without skipping one
+    for (size_t i = m_running.size(); i-- > 0;) {
+        AnimationHandle handle = m_running[i];
+        uint32_t elapsed = nowMs - m_startTime[handle];  // Unsigned, so tick wrap-around is fine
+
+        if (elapsed >= m_duration[handle]) {
+            m_value[handle] = m_to[handle];
+            RemoveRunning(handle);
+            continue;
+        }
+
+        float t = static_cast<float>(elapsed) / static_cast<float>(m_duration[handle]);
+        m_value[handle] = m_from[handle] + (m_to[handle] - m_from[handle]) * Ease(m_easing[handle], t);
+    }
+}
+
+float AnimationSystem::GetValue(AnimationHandle handle) const {
+    return handle < m_value.size() ? m_value[handle] : 0.0f;
+}
+
+bool AnimationSystem::IsRunning(AnimationHandle handle) const {
+    return handle < m_value.size() && m_runningSlot[handle] != NOT_RUNNING;
+}
+
+float AnimationSystem::Ease(Easing easing, float t) {
+    switch (easing) {
+        case Easing::EASE_OUT_CUBIC: {
+            float inverse = 1.0f - t;
+            return 1.0f - inverse * inverse * inverse;
+        }
+        case Easing::EASE_IN_OUT_CUBIC: {
+            if (t < 0.5f) {
+                return 4.0f * t * t * t;
+            }
+            float inverse = -2.0f * t + 2.0f;
+            return 1.0f - inverse * inverse * inverse / 2.0f;
+        }
+        case Easing::LINEAR:
+        default:
+            return t;
+    }
+}
+
+void AnimationSystem::RemoveRunning(AnimationHandle handle) {
+    uint32_t slot = m_runningSlot[handle];
+    AnimationHandle last = m_running.back();
+    m_running[slot] = last;
+    m_runningSlot[last] = slot;
+    m_running.pop_back();
+    m_runningSlot[handle] = NOT_RUNNING;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class Easing : uint8_t {
+    LINEAR,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_CUBIC
+};
+
+using AnimationHandle = uint32_t;
+constexpr AnimationHandle INVALID_ANIMATION = UINT32_MAX;
+
+// Animated float values stored as parallel arrays. Names are resolved to
+// handles once, at registration; per-frame work only walks the compact list
+// of running animations, so idle ones cost nothing.
+//
+//   AnimationHandle fade = animations.Register("tips.fade");
+//   animations.Start(fade, 0.0f, 1.0f, 200, now);
+//   animations.Update(now);            // once per frame
+//   float alpha = animations.GetValue(fade);
+class AnimationSystem {
+public:
+    // Returns the existing handle if the name is already registered
+    AnimationHandle Register(const std::string& name, float initialValue = 0.0f);
+    AnimationHandle Find(const std::string& name) const;
+
+    // Restarts the animation if it is already running. Times are in
+    // milliseconds from any monotonic clock that wraps at 2^32 (GetTickCount).
+    void Start(AnimationHandle handle, float from, float to, uint32_t durationMs, uint32_t nowMs,
+               Easing easing = Easing::EASE_OUT_CUBIC);
+    void Stop(AnimationHandle handle);
+
+    // Advances running animations; finished ones snap to their target value
+    void Update(uint32_t nowMs);
+
+    float GetValue(AnimationHandle handle) const;
+    bool IsRunning(AnimationHandle handle) const;
+    size_t GetRunningCount() const { return m_running.size(); }
+
+private:
+    static constexpr uint32_t NOT_RUNNING = UINT32_MAX;
+
+    static float Ease(Easing easing, float t);
+    void RemoveRunning(AnimationHandle handle);
+
+    // Indexed by handle
+    std::vector<uint32_t> m_startTime;
+    std::vector<uint32_t> m_duration;
+    std::vector<float> m_from;
+    std::vector<float> m_to;
+    std::vector<float> m_value;
+    std::vector<Easing> m_easing;
+    std::vector<uint32_t> m_runningSlot;    // Position in m_running, or NOT_RUNNING
+
+    std::vector<AnimationHandle> m_running;
+    std::unordered_map<std::string, AnimationHandle> m_handles;
+};
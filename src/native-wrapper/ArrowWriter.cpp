@@ -0,0 +1,366 @@
+#include "ArrowWriter.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+// Arrow's metadata is flatbuffers (Schema.fbs, Message.fbs, File.fbs). Only
+// a handful of tables are needed, so they are laid out by hand: objects are
+// written front to back, parents before children, and each offset field is
+// patched once its target is written (flatbuffer offsets only point forward).
+class FlatBuilder {
+public:
+    struct Field {
+        uint16_t id;        // Field number in the .fbs table
+        uint8_t size;       // 1, 2, 4 or 8; offsets are 4
+        uint64_t value;     // Scalars only; offsets are linked afterwards
+    };
+
+    std::vector<uint8_t>& Bytes() { return m_bytes; }
+
+    size_t Size() const { return m_bytes.size(); }
+
+    // Pads so that Size() + extra is a multiple of alignment
+    void Pad(size_t alignment, size_t extra = 0) {
+        while ((m_bytes.size() + extra) % alignment != 0) {
+            m_bytes.push_back(0);
+        }
+    }
+
+    template <typename T>
+    size_t Put(T value) {
+        size_t position = m_bytes.size();
+        m_bytes.resize(position + sizeof(T));
+        memcpy(m_bytes.data() + position, &value, sizeof(T));
+        return position;
+    }
+
+    // Points the offset field at slot to the object at target
+    void Link(size_t slot, size_t target) {
+        uint32_t offset = static_cast<uint32_t>(target - slot);
+        memcpy(m_bytes.data() + slot, &offset, sizeof(offset));
+    }
+
+    // Root offset at the start of the buffer; link it to the root table
+    size_t Root() {
+        return Put<uint32_t>(0);
+    }
+
+    // Writes a vtable and the table after it. fieldPositions receives where
+    // each field landed (same order as fields), for linking offset fields.
+    size_t Table(std::initializer_list<Field> fields, size_t* fieldPositions = nullptr) {
+        size_t count = 0;
+        bool hasWide = false;
+        for (const Field& field : fields) {
+            count = std::max(count, static_cast<size_t>(field.id) + 1);
+            hasWide = hasWide || field.size == 8;
+        }
+
+        // Widest fields first, each naturally aligned within an 8-aligned table
+        std::vector<uint16_t> fieldOffsets(count, 0);
+        std::vector<size_t> placed(fields.size(), 0);
+        size_t tableSize = hasWide ? 8 : 4;
+        for (uint8_t size : {8, 4, 2, 1}) {
+            size_t index = 0;
+            for (const Field& field : fields) {
+                if (field.size == size) {
+                    fieldOffsets[field.id] = static_cast<uint16_t>(tableSize);
+                    placed[index] = tableSize;
+                    tableSize += size;
+                }
+                index++;
+            }
+        }
+
+        size_t vtableSize = 4 + 2 * count;
+        Pad(8, vtableSize);
+        Put<uint16_t>(static_cast<uint16_t>(vtableSize));
+        Put<uint16_t>(static_cast<uint16_t>(tableSize));
+        for (uint16_t offset : fieldOffsets) {
+            Put<uint16_t>(offset);
+        }
+
+        size_t table = Put<int32_t>(static_cast<int32_t>(vtableSize));
+        m_bytes.resize(table + tableSize, 0);
+        size_t index = 0;
+        for (const Field& field : fields) {
+            memcpy(m_bytes.data() + table + placed[index], &field.value, field.size);
+            if (fieldPositions) {
+                fieldPositions[index] = table + placed[index];
+            }
+            index++;
+        }
+        return table;
+    }
+
+    // Vector of structs whose widest member is 8 bytes
+    size_t StructVector(const void* data, size_t count, size_t elementSize) {
+        Pad(8, 4);
+        size_t position = Put<uint32_t>(static_cast<uint32_t>(count));
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + count * elementSize);
+        return position;
+    }
+
+    // Vector of offsets; element i is at the returned position + 4 + 4 * i
+    size_t OffsetVector(size_t count) {
+        Pad(4);
+        size_t position = Put<uint32_t>(static_cast<uint32_t>(count));
+        m_bytes.resize(m_bytes.size() + count * 4, 0);
+        return position;
+    }
+
+    size_t String(const std::string& text) {
+        Pad(4);
+        size_t position = Put<uint32_t>(static_cast<uint32_t>(text.size()));
+        m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+        m_bytes.push_back(0);
+        return position;
+    }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+// Schema.fbs / Message.fbs constants
+const uint16_t METADATA_V5 = 4;
+const uint8_t HEADER_SCHEMA = 1;
+const uint8_t HEADER_RECORD_BATCH = 3;
+const uint8_t TYPE_INT = 2;
+const uint8_t TYPE_FLOATING_POINT = 3;
+const uint8_t TYPE_UTF8 = 5;
+const uint16_t PRECISION_SINGLE = 1;
+const uint16_t PRECISION_DOUBLE = 2;
+
+const uint32_t CONTINUATION = 0xFFFFFFFF;
+const char FILE_MAGIC[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+
+struct FieldNode {
+    int64_t length;
+    int64_t nullCount;
+};
+
+struct BufferSpan {
+    int64_t offset;
+    int64_t length;
+};
+
+size_t AlignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// table Field { name, nullable, type_type, type, dictionary, children, custom_metadata }
+size_t WriteField(FlatBuilder& builder, const std::string& name, ColumnType type) {
+    uint8_t typeType = TYPE_INT;
+    if (type == ColumnType::FLOAT32 || type == ColumnType::FLOAT64) {
+        typeType = TYPE_FLOATING_POINT;
+    } else if (type == ColumnType::UTF8) {
+        typeType = TYPE_UTF8;
+    }
+
+    size_t slots[5];
+    size_t field = builder.Table({{0, 4, 0}, {1, 1, 0}, {2, 1, typeType}, {3, 4, 0}, {5, 4, 0}}, slots);
+    builder.Link(slots[0], builder.String(name));
+
+    size_t typeTable;
+    if (typeType == TYPE_INT) {
+        // table Int { bitWidth: int, is_signed: bool }
+        bool isSigned = type == ColumnType::INT32 || type == ColumnType::INT64;
+        typeTable = builder.Table({{0, 4, ColumnTypeSize(type) * 8}, {1, 1, isSigned ? 1u : 0u}});
+    } else if (typeType == TYPE_FLOATING_POINT) {
+        typeTable = builder.Table({{0, 2, type == ColumnType::FLOAT32 ? PRECISION_SINGLE : PRECISION_DOUBLE}});
+    } else {
+        typeTable = builder.Table({});
+    }
+    builder.Link(slots[3], typeTable);
+
+    // Readers expect a children vector even for primitive types
+    builder.Link(slots[4], builder.OffsetVector(0));
+    return field;
+}
+
+// table Schema { endianness, fields, custom_metadata, features }
+size_t WriteSchema(FlatBuilder& builder, const std::vector<std::pair<std::string, ColumnType>>& columns) {
+    size_t slots[1];
+    size_t schema = builder.Table({{1, 4, 0}}, slots);
+
+    size_t fields = builder.OffsetVector(columns.size());
+    builder.Link(slots[0], fields);
+    for (size_t i = 0; i < columns.size(); i++) {
+        builder.Link(fields + 4 + 4 * i, WriteField(builder, columns[i].first, columns[i].second));
+    }
+    return schema;
+}
+
+} // namespace
+
+ArrowWriter::~ArrowWriter() {
+    if (m_open) {
+        Close();
+    }
+}
+
+bool ArrowWriter::Open(const std::filesystem::path& path, Format format) {
+    m_outBuffer.resize(OUTPUT_BUFFER_SIZE);
+    m_out.rdbuf()->pubsetbuf(m_outBuffer.data(), static_cast<std::streamsize>(m_outBuffer.size()));
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out) {
+        LOG_ERROR("Failed to open Arrow output: {}", path.wstring());
+        return false;
+    }
+
+    m_format = format;
+    m_open = true;
+    m_position = 0;
+    m_schema.clear();
+    m_batches.clear();
+    if (format == Format::FILE) {
+        Write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    }
+    return true;
+}
+
+bool ArrowWriter::WriteBatch(const ColumnTable& table) {
+    if (!m_open) {
+        return false;
+    }
+
+    if (m_schema.empty()) {
+        std::vector<std::pair<std::string, ColumnType>> columns;
+        for (const Column& column : table.columns) {
+            m_schema.push_back(SchemaColumn{column.name, column.type});
+            columns.emplace_back(column.name, column.type);
+        }
+
+        // table Message { version, header_type, header, bodyLength, custom_metadata }
+        FlatBuilder builder;
+        size_t root = builder.Root();
+        size_t slots[4];
+        builder.Link(root, builder.Table({{0, 2, METADATA_V5}, {1, 1, HEADER_SCHEMA}, {2, 4, 0}, {3, 8, 0}}, slots));
+        builder.Link(slots[2], WriteSchema(builder, columns));
+        if (!WriteMessage(builder.Bytes(), 0, nullptr)) {
+            return false;
+        }
+    }
+
+    if (table.columns.size() != m_schema.size()) {
+        LOG_ERROR("Arrow batch has {} columns, schema has {}", table.columns.size(), m_schema.size());
+        return false;
+    }
+
+    // One validity buffer (empty: no nulls) and one or two data buffers per column
+    std::vector<FieldNode> nodes;
+    std::vector<BufferSpan> buffers;
+    int64_t bodyLength = 0;
+    for (size_t i = 0; i < table.columns.size(); i++) {
+        const Column& column = table.columns[i];
+        if (column.name != m_schema[i].name || column.type != m_schema[i].type) {
+            LOG_ERROR("Arrow batch column {} does not match the schema", column.name);
+            return false;
+        }
+
+        nodes.push_back(FieldNode{static_cast<int64_t>(table.rows), 0});
+        buffers.push_back(BufferSpan{bodyLength, 0});
+        if (column.type == ColumnType::UTF8) {
+            int64_t offsetsLength = static_cast<int64_t>(column.offsets.size() * sizeof(int32_t));
+            buffers.push_back(BufferSpan{bodyLength, offsetsLength});
+            bodyLength += static_cast<int64_t>(AlignUp(static_cast<size_t>(offsetsLength), BUFFER_ALIGNMENT));
+        }
+        int64_t dataLength = static_cast<int64_t>(column.data.size());
+        buffers.push_back(BufferSpan{bodyLength, dataLength});
+        bodyLength += static_cast<int64_t>(AlignUp(column.data.size(), BUFFER_ALIGNMENT));
+    }
+
+    // table RecordBatch { length, nodes, buffers, compression, variadicBufferCounts }
+    FlatBuilder builder;
+    size_t root = builder.Root();
+    size_t messageSlots[4];
+    builder.Link(root, builder.Table({{0, 2, METADATA_V5}, {1, 1, HEADER_RECORD_BATCH}, {2, 4, 0},
+                                      {3, 8, static_cast<uint64_t>(bodyLength)}}, messageSlots));
+    size_t batchSlots[3];
+    builder.Link(messageSlots[2], builder.Table({{0, 8, table.rows}, {1, 4, 0}, {2, 4, 0}}, batchSlots));
+    builder.Link(batchSlots[1], builder.StructVector(nodes.data(), nodes.size(), sizeof(FieldNode)));
+    builder.Link(batchSlots[2], builder.StructVector(buffers.data(), buffers.size(), sizeof(BufferSpan)));
+
+    Block block = {};
+    if (!WriteMessage(builder.Bytes(), bodyLength, &block)) {
+        return false;
+    }
+
+    // The body: each column's buffers straight from memory
+    for (const Column& column : table.columns) {
+        if (column.type == ColumnType::UTF8) {
+            size_t offsetsLength = column.offsets.size() * sizeof(int32_t);
+            Write(column.offsets.data(), offsetsLength);
+            WritePadding(AlignUp(offsetsLength, BUFFER_ALIGNMENT) - offsetsLength);
+        }
+        Write(column.data.data(), column.data.size());
+        WritePadding(AlignUp(column.data.size(), BUFFER_ALIGNMENT) - column.data.size());
+    }
+
+    m_batches.push_back(block);
+    return static_cast<bool>(m_out);
+}
+
+bool ArrowWriter::Close() {
+    if (!m_open) {
+        return false;
+    }
+    m_open = false;
+
+    uint32_t endOfStream[2] = {CONTINUATION, 0};
+    Write(endOfStream, sizeof(endOfStream));
+
+    if (m_format == Format::FILE && !m_schema.empty()) {
+        // table Footer { version, schema, dictionaries, recordBatches, custom_metadata }
+        std::vector<std::pair<std::string, ColumnType>> columns;
+        for (const SchemaColumn& column : m_schema) {
+            columns.emplace_back(column.name, column.type);
+        }
+
+        FlatBuilder builder;
+        size_t root = builder.Root();
+        size_t slots[4];
+        builder.Link(root, builder.Table({{0, 2, METADATA_V5}, {1, 4, 0}, {2, 4, 0}, {3, 4, 0}}, slots));
+        builder.Link(slots[1], WriteSchema(builder, columns));
+        builder.Link(slots[2], builder.StructVector(nullptr, 0, sizeof(Block)));
+        builder.Link(slots[3], builder.StructVector(m_batches.data(), m_batches.size(), sizeof(Block)));
+
+        int32_t footerLength = static_cast<int32_t>(builder.Size());
+        Write(builder.Bytes().data(), builder.Size());
+        Write(&footerLength, sizeof(footerLength));
+        Write(FILE_MAGIC, 6);
+    }
+
+    m_out.close();
+    return !m_out.fail();
+}
+
+void ArrowWriter::Write(const void* data, size_t size) {
+    m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    m_position += size;
+}
+
+void ArrowWriter::WritePadding(size_t size) {
+    static const char ZEROS[BUFFER_ALIGNMENT] = {};
+    Write(ZEROS, size);
+}
+
+bool ArrowWriter::WriteMessage(const std::vector<uint8_t>& metadata, int64_t bodyLength, Block* block) {
+    // Continuation marker, length, then the flatbuffer padded so the body starts 8-aligned
+    int32_t length = static_cast<int32_t>(AlignUp(metadata.size(), 8));
+    if (block) {
+        block->offset = static_cast<int64_t>(m_position);
+        block->metadataLength = length + 8;
+        block->padding = 0;
+        block->bodyLength = bodyLength;
+    }
+
+    Write(&CONTINUATION, sizeof(CONTINUATION));
+    Write(&length, sizeof(length));
+    Write(metadata.data(), metadata.size());
+    WritePadding(static_cast<size_t>(length) - metadata.size());
+    return static_cast<bool>(m_out);
+}
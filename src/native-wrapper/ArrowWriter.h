@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "ColumnTable.h"
+
+// Writes ColumnTables as Arrow IPC: the file format (memory-mappable, with a
+// footer indexing every record batch) or the stream format (for pipes).
+// Each WriteBatch is one record batch whose buffers are the columns' own
+// bytes, written as they are; only the small flatbuffer metadata is encoded.
+// Assumes a little-endian host, as Arrow's default layout does.
+//
+//   ArrowWriter writer;
+//   writer.Open("frames.arrow", ArrowWriter::Format::FILE);
+//   for (...) writer.WriteBatch(store.GetTable());
+//   writer.Close();
+
+class ArrowWriter {
+public:
+    enum class Format {
+        FILE,
+        STREAM
+    };
+
+    ~ArrowWriter();
+
+    bool Open(const std::filesystem::path& path, Format format);
+
+    // The first batch fixes the schema; later batches must have the same
+    // column names and types
+    bool WriteBatch(const ColumnTable& table);
+
+    // Writes the end-of-stream marker and, for files, the footer
+    bool Close();
+
+    uint64_t GetBytesWritten() const { return m_position; }
+    size_t GetBatchCount() const { return m_batches.size(); }
+
+private:
+    struct SchemaColumn {
+        std::string name;
+        ColumnType type;
+    };
+
+    // Footer entry for a record batch
+    struct Block {
+        int64_t offset;
+        int32_t metadataLength;
+        int32_t padding;
+        int64_t bodyLength;
+    };
+
+    void Write(const void* data, size_t size);
+    void WritePadding(size_t size);
+    bool WriteMessage(const std::vector<uint8_t>& metadata, int64_t bodyLength, Block* block);
+
+    std::ofstream m_out;
+    std::vector<char> m_outBuffer;
+    Format m_format = Format::FILE;
+    bool m_open = false;
+    uint64_t m_position = 0;
+    std::vector<SchemaColumn> m_schema;
+    std::vector<Block> m_batches;
+
+    static constexpr size_t BUFFER_ALIGNMENT = 64;  // Arrow's recommended buffer alignment
+    static constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+};
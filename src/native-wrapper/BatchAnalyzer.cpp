@@ -0,0 +1,573 @@
+#include "BatchAnalyzer.h"
+#include "ContentHash.h"
+#include "ZipArchive.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<ReplaySummary>::value,
+              "ReplaySummary is cached as a raw blob");
+
+namespace {
+
+// Action states used for tech and missed-tech detection
+const uint16_t ACTION_DOWN_BOUND_U = 0xB7;
+const uint16_t ACTION_DOWN_BOUND_D = 0xBF;
+const uint16_t ACTION_DOWN_FIRST = 0xB7;
+const uint16_t ACTION_DOWN_LAST = 0xC6;
+const uint16_t ACTION_TECH_IN_PLACE = 0xC7;
+const uint16_t ACTION_TECH_FORWARD = 0xC8;
+const uint16_t ACTION_TECH_BACK = 0xC9;
+const uint16_t ACTION_TECH_LAST = 0xCC;     // Wall, wall jump and ceiling techs follow
+
+// Tech situation a transition into actionState starts, or -1
+int ClassifyTech(uint16_t previousState, uint16_t actionState) {
+    bool wasDown = previousState >= ACTION_DOWN_FIRST && previousState <= ACTION_TECH_LAST;
+    if (wasDown) {
+        return -1;
+    }
+    switch (actionState) {
+        case ACTION_TECH_IN_PLACE: return ReplaySummary::TECH_IN_PLACE;
+        case ACTION_TECH_FORWARD: return ReplaySummary::TECH_ROLL_FORWARD;
+        case ACTION_TECH_BACK: return ReplaySummary::TECH_ROLL_BACK;
+        case ACTION_DOWN_BOUND_U:
+        case ACTION_DOWN_BOUND_D: return ReplaySummary::TECH_MISSED;
+    }
+    if (actionState > ACTION_TECH_BACK && actionState <= ACTION_TECH_LAST) {
+        return ReplaySummary::TECH_WALL;
+    }
+    return -1;
+}
+
+// Slippi external character ids with techniques of their own; every other
+// character shares the CHARACTER_OTHER pass
+constexpr int CHARACTER_OTHER = -1;
+constexpr int CHARACTER_FOX = 2;
+constexpr int CHARACTER_FALCO = 20;
+
+// Action states the technique detectors look for
+const uint16_t ACTION_JUMP_SQUAT = 0x18;
+const uint16_t ACTION_DAIR = 0x45;
+const uint16_t ACTION_AIR_DODGE = 0xEC;
+
+const int MULTISHINE_FRAMES = 15;       // Shine to shine
+const int WAVESHINE_FRAMES = 15;        // Shine to jump squat
+const int WAVEDASH_FRAMES = 8;          // Jump squat to air dodge
+const int PILLAR_FRAMES = 30;           // Shine to dair
+
+// Which detectors a character's pass includes, with their action states as
+// constants, so the frame loop only holds the checks that can apply
+template <int CHARACTER>
+struct CharacterTraits {
+    static constexpr bool HAS_SHINE = false;
+    static constexpr bool HAS_PILLAR = false;
+};
+
+// Fox and Falco share their down special action states
+struct SpacieTraits {
+    static constexpr bool HAS_SHINE = true;
+    static constexpr uint16_t SHINE_FIRST = 0x168;     // Grounded shine start...
+    static constexpr uint16_t SHINE_LAST = 0x16E;      // ...through aerial shine
+};
+
+template <>
+struct CharacterTraits<CHARACTER_FOX> : SpacieTraits {
+    static constexpr bool HAS_PILLAR = false;
+};
+
+template <>
+struct CharacterTraits<CHARACTER_FALCO> : SpacieTraits {
+    static constexpr bool HAS_PILLAR = true;
+};
+
+// Latest percent/stocks per player per frame. Rollbacks re-emit frames,
+// so later updates for a frame overwrite earlier ones before deltas are taken.
+struct FrameSample {
+    float percent;
+    int stocks;
+    uint16_t actionState;
+    uint8_t lastHitBy;
+    uint8_t lastAttackLanded;
+    bool present;
+};
+
+using PlayerSamples = std::vector<FrameSample>[4];
+
+// One player's frames, start to end. Instantiated per character and picked
+// once at game start, so the loop itself never looks at the character.
+template <int CHARACTER>
+void AnalyzePlayer(int player, const PlayerSamples& samples, ReplaySummary& summary, float& finalPercent) {
+    using Traits = CharacterTraits<CHARACTER>;
+    const int NEVER = -1000000;
+
+    bool hasPrevious = false;
+    size_t previousIndex = 0;
+    FrameSample previous = {0.0f, 0, 0, 0, 0, false};
+
+    // Shine technique tracking, frames as sample indices
+    int lastShine = NEVER;
+    int jumpSquatAfterShine = NEVER;
+    bool dodgedSinceShine = false;
+
+    for (size_t index = 0; index < samples[player].size(); index++) {
+        const FrameSample& sample = samples[player][index];
+        if (!sample.present) {
+            continue;
+        }
+
+        if (hasPrevious) {
+            if (sample.stocks < previous.stocks) {
+                summary.stocksLost[player] += previous.stocks - sample.stocks;
+
+                // Credit the kill to the last attacker's last landed move
+                // as of the frame before the stock was lost
+                int killer = previous.lastHitBy;
+                if (killer < 4 && killer != player && previousIndex < samples[killer].size() &&
+                    samples[killer][previousIndex].present) {
+                    uint8_t move = samples[killer][previousIndex].lastAttackLanded;
+                    if (move < ReplaySummary::MOVE_ID_COUNT && summary.killMoves[killer][move] < 255) {
+                        summary.killMoves[killer][move]++;
+                    }
+                }
+            }
+            if (sample.percent > previous.percent) {
+                summary.damageTaken[player] += sample.percent - previous.percent;
+            }
+
+            int tech = ClassifyTech(previous.actionState, sample.actionState);
+            if (tech >= 0) {
+                summary.techs[player][tech]++;
+            }
+
+            if constexpr (Traits::HAS_SHINE) {
+                int frame = static_cast<int>(index);
+                uint16_t state = sample.actionState;
+                bool wasShining = previous.actionState >= Traits::SHINE_FIRST && previous.actionState <= Traits::SHINE_LAST;
+                uint16_t* techniques = summary.techniques[player];
+
+                if (state >= Traits::SHINE_FIRST && state <= Traits::SHINE_LAST) {
+                    if (!wasShining) {
+                        // A wavedash in between makes it a waveshine, not a multishine
+                        if (frame - lastShine <= MULTISHINE_FRAMES && !dodgedSinceShine) {
+                            techniques[ReplaySummary::TECHNIQUE_MULTISHINE]++;
+                        }
+                        lastShine = frame;
+                        jumpSquatAfterShine = NEVER;
+                        dodgedSinceShine = false;
+                    }
+                } else if (state != previous.actionState) {
+                    if (state == ACTION_JUMP_SQUAT && frame - lastShine <= WAVESHINE_FRAMES) {
+                        jumpSquatAfterShine = frame;
+                    } else if (state == ACTION_AIR_DODGE && !dodgedSinceShine &&
+                               frame - jumpSquatAfterShine <= WAVEDASH_FRAMES) {
+                        techniques[ReplaySummary::TECHNIQUE_WAVESHINE]++;
+                        dodgedSinceShine = true;
+                    }
+
+                    if constexpr (Traits::HAS_PILLAR) {
+                        if (state == ACTION_DAIR && frame - lastShine <= PILLAR_FRAMES) {
+                            techniques[ReplaySummary::TECHNIQUE_PILLAR]++;
+                        }
+                    }
+                }
+            }
+        }
+
+        previous = sample;
+        previousIndex = index;
+        hasPrevious = true;
+    }
+
+    summary.stocksRemaining[player] = hasPrevious ? previous.stocks : 0;
+    finalPercent = hasPrevious ? previous.percent : 0.0f;
+}
+
+using PlayerPass = void (*)(int player, const PlayerSamples& samples, ReplaySummary& summary, float& finalPercent);
+
+PlayerPass SelectPlayerPass(int character) {
+    switch (character) {
+        case CHARACTER_FOX: return &AnalyzePlayer<CHARACTER_FOX>;
+        case CHARACTER_FALCO: return &AnalyzePlayer<CHARACTER_FALCO>;
+        default: return &AnalyzePlayer<CHARACTER_OTHER>;
+    }
+}
+
+void CopyField(char* destination, size_t capacity, const std::string& text) {
+    size_t length = std::min(text.size(), capacity - 1);
+    memcpy(destination, text.data(), length);
+    destination[length] = '\0';
+}
+
+} // namespace
+
+std::vector<uint8_t> ReplaySummary::Serialize() const {
+    std::vector<uint8_t> blob(sizeof(ReplaySummary));
+    memcpy(blob.data(), this, sizeof(ReplaySummary));
+    return blob;
+}
+
+bool ReplaySummary::Deserialize(const std::vector<uint8_t>& blob, ReplaySummary& summary) {
+    if (blob.size() != sizeof(ReplaySummary)) {
+        return false;
+    }
+    memcpy(&summary, blob.data(), sizeof(ReplaySummary));
+    return true;
+}
+
+bool AnalyzeReplay(const SlpReader& reader, ReplaySummary& summary) {
+    summary = ReplaySummary();
+
+    SlpGameStart gameStart;
+    if (!reader.ReadGameStart(gameStart)) {
+        return false;
+    }
+
+    summary.stage = gameStart.stage;
+    summary.randomSeed = gameStart.randomSeed;
+    for (int i = 0; i < 4; i++) {
+        summary.characters[i] = gameStart.characters[i];
+        if (gameStart.characters[i] >= 0) {
+            summary.playerCount++;
+        }
+        CopyField(summary.connectCodes[i], ReplaySummary::CODE_LENGTH, gameStart.connectCodes[i]);
+        CopyField(summary.displayNames[i], ReplaySummary::NAME_LENGTH, gameStart.displayNames[i]);
+    }
+
+    PlayerPass passes[4];
+    for (int i = 0; i < 4; i++) {
+        passes[i] = SelectPlayerPass(gameStart.characters[i]);
+    }
+
+    PlayerSamples samples;
+    const int FIRST_FRAME = -123;
+    bool sawFrame = false;
+
+    reader.ForEachEvent([&](uint8_t command, const uint8_t* payload, size_t size) {
+        if (command == SlpCommand::POST_FRAME_UPDATE) {
+            SlpPostFrame postFrame;
+            if (SlpReader::DecodePostFrame(payload, size, postFrame) &&
+                !postFrame.isFollower && postFrame.playerIndex < 4 &&
+                postFrame.frame >= FIRST_FRAME) {
+                size_t index = static_cast<size_t>(postFrame.frame - FIRST_FRAME);
+                std::vector<FrameSample>& playerSamples = samples[postFrame.playerIndex];
+                if (playerSamples.size() <= index) {
+                    playerSamples.resize(index + 1, FrameSample{0.0f, 0, 0, 0, 0, false});
+                }
+                playerSamples[index] = FrameSample{postFrame.percent, postFrame.stocksRemaining,
+                                                   postFrame.actionState, postFrame.lastHitBy,
+                                                   postFrame.lastAttackLanded, true};
+
+                // Both bounds start at the first frame seen; a replay can end
+                // before frame 0
+                if (!sawFrame) {
+                    summary.firstFrame = postFrame.frame;
+                    summary.lastFrame = postFrame.frame;
+                    sawFrame = true;
+                }
+                summary.firstFrame = std::min(summary.firstFrame, static_cast<int>(postFrame.frame));
+                summary.lastFrame = std::max(summary.lastFrame, static_cast<int>(postFrame.frame));
+            }
+        } else if (command == SlpCommand::GAME_END) {
+            SlpGameEnd gameEnd;
+            if (SlpReader::DecodeGameEnd(payload, size, gameEnd)) {
+                summary.gameEndMethod = gameEnd.method;
+                summary.lrasInitiator = gameEnd.lrasInitiator;
+            }
+        }
+        return true;
+    });
+
+    float finalPercent[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int player = 0; player < 4; player++) {
+        passes[player](player, samples, summary, finalPercent[player]);
+    }
+
+    // Singles only: LRAS forfeits, otherwise more stocks then lower percent wins
+    if (!gameStart.isTeams && summary.playerCount == 2 && summary.gameEndMethod > 0) {
+        int ports[2];
+        int found = 0;
+        for (int i = 0; i < 4 && found < 2; i++) {
+            if (summary.characters[i] >= 0) {
+                ports[found++] = i;
+            }
+        }
+
+        int a = ports[0];
+        int b = ports[1];
+        if (summary.lrasInitiator == a || summary.lrasInitiator == b) {
+            summary.winner = summary.lrasInitiator == a ? b : a;
+        } else if (summary.gameEndMethod != 7) {
+            if (summary.stocksRemaining[a] != summary.stocksRemaining[b]) {
+                summary.winner = summary.stocksRemaining[a] > summary.stocksRemaining[b] ? a : b;
+            } else if (finalPercent[a] != finalPercent[b]) {
+                summary.winner = finalPercent[a] < finalPercent[b] ? a : b;
+            }
+        }
+    }
+
+    return sawFrame;
+}
+
+void BatchTotals::Add(const ReplaySummary& summary) {
+    games++;
+    frames += static_cast<uint64_t>(std::max(0, summary.lastFrame - summary.firstFrame + 1));
+
+    if (summary.stage >= 0 && summary.stage < 64) {
+        stageGames[summary.stage]++;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        if (summary.characters[i] < 0) {
+            continue;
+        }
+        if (summary.characters[i] < MAX_CHARACTERS) {
+            characterGames[summary.characters[i]]++;
+        }
+        stocksLost += static_cast<uint64_t>(summary.stocksLost[i]);
+        damage += summary.damageTaken[i];
+    }
+}
+
+void BatchTotals::Merge(const BatchTotals& other) {
+    games += other.games;
+    frames += other.frames;
+    stocksLost += other.stocksLost;
+    damage += other.damage;
+    for (int i = 0; i < 64; i++) {
+        stageGames[i] += other.stageGames[i];
+    }
+    for (int i = 0; i < MAX_CHARACTERS; i++) {
+        characterGames[i] += other.characterGames[i];
+    }
+}
+
+ColumnTable BuildSummaryTable(const std::vector<BatchResult>& results, int32_t firstReplayId) {
+    ColumnTable table;
+    table.Add("replay", ColumnType::INT32);
+    table.Add("path", ColumnType::UTF8);
+    const char* const GAME_COLUMNS[] = {
+        "stage", "player_count", "first_frame", "last_frame", "winner", "end_method", "lras"
+    };
+    for (const char* name : GAME_COLUMNS) {
+        table.Add(name, ColumnType::INT32);
+    }
+    for (int port = 0; port < 4; port++) {
+        std::string prefix = "p" + std::to_string(port + 1) + "_";
+        table.Add(prefix + "character", ColumnType::INT32);
+        table.Add(prefix + "stocks_lost", ColumnType::INT32);
+        table.Add(prefix + "stocks_remaining", ColumnType::INT32);
+        table.Add(prefix + "damage_taken", ColumnType::FLOAT32);
+        table.Add(prefix + "connect_code", ColumnType::UTF8);
+        table.Add(prefix + "multishines", ColumnType::INT32);
+        table.Add(prefix + "waveshines", ColumnType::INT32);
+        table.Add(prefix + "pillars", ColumnType::INT32);
+    }
+
+    int32_t replayId = firstReplayId;
+    for (const auto& result : results) {
+        if (!result.succeeded) {
+            continue;
+        }
+
+        const ReplaySummary& summary = result.summary;
+        Column* column = table.columns.data();
+        (column++)->Append<int32_t>(replayId++);
+        (column++)->AppendString(result.path.u8string());
+        int32_t gameValues[] = {
+            summary.stage, summary.playerCount, summary.firstFrame, summary.lastFrame,
+            summary.winner, summary.gameEndMethod, summary.lrasInitiator
+        };
+        for (int32_t value : gameValues) {
+            (column++)->Append<int32_t>(value);
+        }
+        for (int port = 0; port < 4; port++) {
+            (column++)->Append<int32_t>(summary.characters[port]);
+            (column++)->Append<int32_t>(summary.stocksLost[port]);
+            (column++)->Append<int32_t>(summary.stocksRemaining[port]);
+            (column++)->Append<float>(summary.damageTaken[port]);
+            const char* code = summary.connectCodes[port];
+            (column++)->AppendString(std::string(code, strnlen(code, ReplaySummary::CODE_LENGTH)));
+            for (int technique = 0; technique < ReplaySummary::TECHNIQUE_COUNT; technique++) {
+                (column++)->Append<int32_t>(summary.techniques[port][technique]);
+            }
+        }
+        table.rows++;
+    }
+    return table;
+}
+
+BatchAnalyzer::BatchAnalyzer(const BatchOptions& options, ReplayResultCache* cache)
+    : m_options(options), m_cache(cache) {
+    m_optionsHash = ContentHash::Hash64(&m_options.analysisFlags, sizeof(m_options.analysisFlags));
+}
+
+std::vector<std::filesystem::path> BatchAnalyzer::CollectReplays(const std::filesystem::path& root,
+                                                                 bool recursive) {
+    std::vector<std::filesystem::path> replays;
+    std::error_code error;
+
+    // Zipped sets are read in place: their replays are listed as entry paths
+    auto addArchive = [&replays](const std::filesystem::path& path) {
+        std::shared_ptr<const ZipArchive> archive = ZipArchive::OpenShared(path);
+        if (!archive) {
+            return;
+        }
+        for (const ZipEntry& entry : archive->GetEntries()) {
+            std::filesystem::path entryPath = std::filesystem::u8path(entry.name);
+            if (entryPath.extension() == ".slp") {
+                replays.push_back(path / entryPath);
+            }
+        }
+    };
+
+    if (std::filesystem::is_regular_file(root, error)) {
+        if (ZipArchive::IsArchive(root)) {
+            addArchive(root);
+            std::sort(replays.begin(), replays.end());
+        } else {
+            replays.push_back(root);
+        }
+        return replays;
+    }
+
+    auto addIfReplay = [&replays, &addArchive](const std::filesystem::directory_entry& entry) {
+        std::error_code entryError;
+        if (!entry.is_regular_file(entryError)) {
+            return;
+        }
+        if (entry.path().extension() == ".slp") {
+            replays.push_back(entry.path());
+        } else if (ZipArchive::IsArchive(entry.path())) {
+            addArchive(entry.path());
+        }
+    };
+
+    if (recursive) {
+        for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+            addIfReplay(*it);
+        }
+    } else {
+        for (std::filesystem::directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+            addIfReplay(*it);
+        }
+    }
+
+    // Stable order keeps output and work sharding deterministic
+    std::sort(replays.begin(), replays.end());
+    return replays;
+}
+
+bool BatchAnalyzer::AnalyzeFile(const std::filesystem::path& path, ReplaySummary& summary, bool& fromCache) {
+    fromCache = false;
+    bool useCache = m_cache && m_options.useCache;
+
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    int64_t modifiedTime = 0;
+    if (!error) {
+        modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    } else if (!ZipArchive::StatEntry(path, fileSize, modifiedTime)) {
+        return false;
+    }
+    std::string pathKey = path.generic_u8string();
+
+    ReplayCacheKey key;
+    key.analyzerVersion = REPLAY_ANALYZER_VERSION;
+    key.optionsHash = m_optionsHash;
+
+    // Fast path: unchanged file, no read or hash needed
+    std::vector<uint8_t> blob;
+    if (useCache && m_cache->LookupFingerprint(pathKey, fileSize, modifiedTime, key.contentHash) &&
+        m_cache->Lookup(key, blob) && ReplaySummary::Deserialize(blob, summary)) {
+        fromCache = true;
+        return true;
+    }
+
+    SlpReader reader;
+    if (!reader.LoadFile(path)) {
+        return false;
+    }
+
+    key.contentHash = ContentHash::Hash64(reader.GetBytes().data(), reader.GetBytes().size());
+
+    if (useCache) {
+        FileFingerprint fingerprint;
+        fingerprint.size = fileSize;
+        fingerprint.modifiedTime = modifiedTime;
+        fingerprint.contentHash = key.contentHash;
+        m_cache->StoreFingerprint(pathKey, fingerprint);
+
+        // Same content under a new path (copied or renamed replay)
+        if (m_cache->Lookup(key, blob) && ReplaySummary::Deserialize(blob, summary)) {
+            fromCache = true;
+            return true;
+        }
+    }
+
+    if (!AnalyzeReplay(reader, summary)) {
+        return false;
+    }
+
+    if (useCache) {
+        m_cache->Store(key, summary.Serialize());
+    }
+    return true;
+}
+
+std::vector<BatchResult> BatchAnalyzer::Run(const std::vector<std::filesystem::path>& replays) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<BatchResult> results(replays.size());
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<size_t> analyzed(0);
+    std::atomic<size_t> cacheHits(0);
+    std::atomic<size_t> failed(0);
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= replays.size()) {
+                break;
+            }
+
+            BatchResult& result = results[index];
+            result.path = replays[index];
+            result.succeeded = AnalyzeFile(result.path, result.summary, result.fromCache);
+
+            if (!result.succeeded) {
+                failed++;
+            } else if (result.fromCache) {
+                cacheHits++;
+            } else {
+                analyzed++;
+            }
+        }
+    };
+
+    unsigned threadCount = m_options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(1, replays.size())));
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    m_stats.total = replays.size();
+    m_stats.analyzed = analyzed;
+    m_stats.cacheHits = cacheHits;
+    m_stats.failed = failed;
+    m_stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    return results;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "SlippiReplay.h"
+#include "ReplayResultCache.h"
+#include "ColumnTable.h"
+
+// Bump whenever AnalyzeReplay or ReplaySummary changes so cached results
+// from older analyzers are recomputed
+const uint32_t REPLAY_ANALYZER_VERSION = 4;
+
+// Per-replay analysis result. Kept trivially copyable so it can be stored
+// in the result cache as a raw blob.
+struct ReplaySummary {
+    static const int CODE_LENGTH = 12;
+    static const int NAME_LENGTH = 32;
+    static const int MOVE_ID_COUNT = 64;        // Slippi move ids (lastAttackLanded)
+
+    // Tech situations counted per player
+    enum TechOption {
+        TECH_IN_PLACE,
+        TECH_ROLL_FORWARD,
+        TECH_ROLL_BACK,
+        TECH_WALL,          // Wall, wall jump and ceiling techs
+        TECH_MISSED,
+        TECH_OPTION_COUNT
+    };
+
+    // Character techniques counted per player; only Fox and Falco have any yet
+    enum Technique {
+        TECHNIQUE_MULTISHINE,
+        TECHNIQUE_WAVESHINE,
+        TECHNIQUE_PILLAR,       // Falco only
+        TECHNIQUE_COUNT
+    };
+
+    int stage = 0;
+    int playerCount = 0;
+    int characters[4] = {-1, -1, -1, -1};
+    int firstFrame = 0;
+    int lastFrame = 0;
+    int stocksRemaining[4] = {0, 0, 0, 0};
+    int stocksLost[4] = {0, 0, 0, 0};
+    float damageTaken[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    int gameEndMethod = -1;
+    int lrasInitiator = -1;
+    uint32_t randomSeed = 0;
+    int winner = -1;                                // Port; -1 for teams, ties and unfinished games
+    char connectCodes[4][CODE_LENGTH] = {};         // Empty outside Slippi online
+    char displayNames[4][NAME_LENGTH] = {};
+    uint16_t techs[4][TECH_OPTION_COUNT] = {};
+    uint8_t killMoves[4][MOVE_ID_COUNT] = {};       // Stocks taken by each port, by move id
+    uint16_t techniques[4][TECHNIQUE_COUNT] = {};
+
+    std::vector<uint8_t> Serialize() const;
+    static bool Deserialize(const std::vector<uint8_t>& blob, ReplaySummary& summary);
+};
+
+bool AnalyzeReplay(const SlpReader& reader, ReplaySummary& summary);
+
+struct BatchOptions {
+    unsigned threadCount = 0;       // 0 = hardware concurrency
+    bool useCache = true;
+    bool recursive = true;
+    uint32_t analysisFlags = 0;     // Folded into the cache key
+};
+
+struct BatchResult {
+    std::filesystem::path path;
+    ReplaySummary summary;
+    bool succeeded = false;
+    bool fromCache = false;
+};
+
+struct BatchStats {
+    size_t total = 0;
+    size_t analyzed = 0;
+    size_t cacheHits = 0;
+    size_t failed = 0;
+    double elapsedSeconds = 0.0;
+};
+
+// Archive-wide aggregates. Merge is associative and commutative so partial
+// totals from separate workers can be combined in any order.
+struct BatchTotals {
+    static const int MAX_CHARACTERS = 33;
+
+    uint64_t games = 0;
+    uint64_t frames = 0;
+    uint64_t stocksLost = 0;
+    double damage = 0.0;
+    uint64_t stageGames[64] = {};
+    uint64_t characterGames[MAX_CHARACTERS] = {};
+
+    void Add(const ReplaySummary& summary);
+    void Merge(const BatchTotals& other);
+};
+
+// The succeeded results as a summary table, one row per replay. Row i's
+// replay id is firstReplayId + i, matching the replay column of the frame
+// tables exported alongside it.
+//
+//   replay (int32), path (utf8), stage, player_count, first_frame, last_frame,
+//   winner, end_method, lras (int32),
+//   p<N>_character, p<N>_stocks_lost, p<N>_stocks_remaining (int32),
+//   p<N>_damage_taken (float32), p<N>_connect_code (utf8),
+//   p<N>_multishines, p<N>_waveshines, p<N>_pillars (int32)  for N = 1..4
+ColumnTable BuildSummaryTable(const std::vector<BatchResult>& results, int32_t firstReplayId = 0);
+
+// Runs AnalyzeReplay over a set of replays in parallel, skipping replays whose
+// results are already in the cache
+class BatchAnalyzer {
+public:
+    BatchAnalyzer(const BatchOptions& options, ReplayResultCache* cache);
+
+    static std::vector<std::filesystem::path> CollectReplays(const std::filesystem::path& root,
+                                                             bool recursive);
+
+    // Analyzes (or fetches from cache) a single replay
+    bool AnalyzeFile(const std::filesystem::path& path, ReplaySummary& summary, bool& fromCache);
+
+    std::vector<BatchResult> Run(const std::vector<std::filesystem::path>& replays);
+
+    const BatchStats& GetStats() const { return m_stats; }
+    uint64_t GetOptionsHash() const { return m_optionsHash; }
+
+private:
+    BatchOptions m_options;
+    ReplayResultCache* m_cache;
+    uint64_t m_optionsHash;
+    BatchStats m_stats;
+};
@@ -0,0 +1,634 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include "BatchAnalyzer.h"
+#include "ReplayResultCache.h"
+#include "ReplayCatalog.h"
+#include "DistributedAnalysis.h"
+#include "KnowledgeIndex.h"
+#include "OpponentScouting.h"
+#include "HighlightScorer.h"
+#include "FrameStore.h"
+#include "ArrowWriter.h"
+#include "FrameQuery.h"
+#include "Logger.h"
+
+// Command-line batch analysis over a replay archive
+//
+//   CoachClippiBatch <replay folder or file> [options]
+//     (.zip sets in the folder, or a .zip given directly, are read in place)
+//     --cache <file>    Result cache location (default: <folder>/coachclippi_results.cache)
+//     --no-cache        Analyze every replay and leave the cache untouched
+//     --threads <n>     Worker threads (default: hardware concurrency)
+//     --flat            Do not descend into subfolders
+//     --quiet           Only print the totals
+//     --scouting <file> Fold the singles games into this opponent scouting store
+//     --arrow <folder>  Export frames.arrow and summaries.arrow (Arrow IPC files)
+//     --arrow-stream    With --arrow, write the stream format (.arrows) instead
+//     --import <file>   Register the replays in this catalog first and only
+//                       analyze the games it didn't have; byte copies and the
+//                       other player's recording of a known game are skipped
+//
+//   Distributed mode (workers must see the replays under the same paths):
+//   CoachClippiBatch <replay folder or file> --coordinator <port> [--bind <address>] [--token <secret>]
+//                    [--shard-size <n>] [--item-timeout <s>]
+//   CoachClippiBatch --worker <host:port> [--token <secret>] [--cache <file>] [--threads <n>]
+//
+//   The coordinator listens on 127.0.0.1 unless --bind says otherwise; any
+//   other address needs a --token, which workers must send to be accepted.
+//
+//   Knowledge corpus lookup (prints the top snippets and the query time):
+//   CoachClippiBatch --knowledge <corpus> --query <text> [--characters <a,b>] [--tags <x,y>] [--top <k>]
+//
+//   Opponent scouting report (connect code or display name, optional character id):
+//   CoachClippiBatch --scouting <file> --scout <code or name> [--as <character>]
+//
+//   Highlight reel (streams every replay's frames through the highlight scorer
+//   and writes the best moments as a Dolphin playback queue):
+//   CoachClippiBatch <replay folder or file> --highlights <queue file>
+//
+//   Frame query (prints matching frame ranges, optionally as a playback queue):
+//   CoachClippiBatch <replay folder or file> --find "<query>" [--min-frames <n>] [--merge-gap <n>]
+//                    [--clips <queue file>]
+
+namespace {
+
+void PrintUsage() {
+    std::wcout << L"Usage: CoachClippiBatch <replay folder or file> [--cache <file>] [--no-cache]"
+               << L" [--threads <n>] [--flat] [--quiet] [--scouting <file>]"
+               << L" [--arrow <folder> [--arrow-stream]] [--import <catalog>]" << std::endl;
+    std::wcout << L"       CoachClippiBatch <replay folder or file> --coordinator <port>"
+               << L" [--bind <address>] [--token <secret>] [--shard-size <n>] [--item-timeout <s>]" << std::endl;
+    std::wcout << L"       CoachClippiBatch --worker <host:port> [--token <secret>] [--cache <file>]"
+               << L" [--threads <n>]" << std::endl;
+    std::wcout << L"       CoachClippiBatch --knowledge <corpus> --query <text> [--characters <a,b>]"
+               << L" [--tags <x,y>] [--top <k>]" << std::endl;
+    std::wcout << L"       CoachClippiBatch --scouting <file> --scout <code or name> [--as <character>]" << std::endl;
+    std::wcout << L"       CoachClippiBatch <replay folder or file> --highlights <queue file>" << std::endl;
+    std::wcout << L"       CoachClippiBatch <replay folder or file> --find <query> [--min-frames <n>]"
+               << L" [--merge-gap <n>] [--clips <queue file>]" << std::endl;
+}
+
+std::vector<std::string> SplitCommaList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void PrintSummary(const BatchResult& result) {
+    const ReplaySummary& summary = result.summary;
+
+    std::wcout << result.path.wstring() << L"\t";
+    if (!result.succeeded) {
+        std::wcout << L"FAILED" << std::endl;
+        return;
+    }
+
+    std::wcout << L"stage=" << summary.stage
+               << L" frames=" << (summary.lastFrame - summary.firstFrame + 1);
+    for (int i = 0; i < 4; i++) {
+        if (summary.characters[i] < 0) {
+            continue;
+        }
+        std::wcout << L" p" << (i + 1) << L"[char=" << summary.characters[i]
+                   << L" stocks=" << summary.stocksRemaining[i]
+                   << L" lost=" << summary.stocksLost[i]
+                   << L" dmg=" << std::fixed << std::setprecision(1) << summary.damageTaken[i] << L"]";
+    }
+    std::wcout << (result.fromCache ? L" (cached)" : L"") << std::endl;
+}
+
+void PrintTotals(const BatchTotals& totals) {
+    std::wcout << L"Games: " << totals.games
+               << L", frames: " << totals.frames
+               << L", stocks lost: " << totals.stocksLost
+               << L", damage: " << std::fixed << std::setprecision(1) << totals.damage << std::endl;
+}
+
+void UpdateScouting(const std::filesystem::path& storeFile, const std::vector<BatchResult>& results) {
+    OpponentScouting scouting(storeFile);
+    scouting.Load();
+
+    size_t added = 0;
+    for (const auto& result : results) {
+        if (result.succeeded && scouting.AddGame(result.summary)) {
+            added++;
+        }
+    }
+    if (scouting.IsDirty()) {
+        scouting.Save();
+    }
+
+    std::wcout << L"Scouting: " << added << L" new games, " << scouting.GetGameCount()
+               << L" games over " << scouting.GetPlayerCount() << L" players" << std::endl;
+}
+
+int RunScoutingReport(const std::filesystem::path& storeFile, const std::string& player, int character) {
+    auto start = std::chrono::steady_clock::now();
+    OpponentScouting scouting(storeFile);
+    if (!scouting.Load()) {
+        std::wcout << L"Failed to load scouting store: " << storeFile.wstring() << std::endl;
+        return 1;
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    ScoutingReport report;
+    bool found = scouting.BuildReport(player, player, character, report);
+    double reportMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!found) {
+        std::wcout << L"No games against " << std::wstring(player.begin(), player.end()) << std::endl;
+    }
+    for (const std::string& line : report.lines) {
+        std::wcout << std::wstring(line.begin(), line.end()) << std::endl;
+    }
+    std::wcout << L"Store: " << scouting.GetPlayerCount() << L" players, " << scouting.GetGameCount()
+               << L" games; load " << std::fixed << std::setprecision(2) << loadMs << L"ms, report "
+               << std::setprecision(3) << reportMs << L"ms" << std::endl;
+    return found ? 0 : 2;
+}
+
+// Feeds a replay to the scorer the way live frames arrive: one GameState per
+// frame, players in port order. Rolled-back frames are replayed by the
+// stream and only their first appearance is used.
+bool ScoreReplay(const std::filesystem::path& path, HighlightScorer& scorer) {
+    SlpReader reader;
+    SlpGameStart gameStart;
+    if (!reader.LoadFile(path) || !reader.ReadGameStart(gameStart)) {
+        return false;
+    }
+
+    int slots[4] = {-1, -1, -1, -1};
+    GameState state = {};
+    for (int port = 0; port < 4; port++) {
+        if (gameStart.characters[port] >= 0) {
+            slots[port] = state.activePlayerCount++;
+        }
+    }
+
+    scorer.BeginGame();
+    bool pending = false;
+    reader.ForEachEvent([&](uint8_t command, const uint8_t* payload, size_t size) {
+        SlpPostFrame postFrame;
+        if (command != SlpCommand::POST_FRAME_UPDATE || !SlpReader::DecodePostFrame(payload, size, postFrame) ||
+            postFrame.isFollower || postFrame.playerIndex >= 4 || slots[postFrame.playerIndex] < 0) {
+            return true;
+        }
+
+        if (pending && postFrame.frame != state.frameCount) {
+            if (postFrame.frame < state.frameCount) {
+                return true;
+            }
+            scorer.Observe(state);
+        }
+        state.frameCount = postFrame.frame;
+        pending = true;
+
+        PlayerState& player = state.players[slots[postFrame.playerIndex]];
+        player.damage = postFrame.percent;
+        player.stocks = postFrame.stocksRemaining;
+        player.actionState = postFrame.actionState;
+        return true;
+    });
+    if (pending) {
+        scorer.Observe(state);
+    }
+
+    scorer.SetReplay(scorer.GetCurrentGame(), path);
+    scorer.EndGame();
+    return true;
+}
+
+int RunHighlights(const std::vector<std::filesystem::path>& replays, const std::filesystem::path& queueFile,
+                  bool quiet) {
+    auto start = std::chrono::steady_clock::now();
+    HighlightScorer scorer;
+    size_t scored = 0;
+    for (const auto& replay : replays) {
+        if (ScoreReplay(replay, scorer)) {
+            scored++;
+        }
+    }
+    double scoreMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::vector<Highlight> best = scorer.GetSessionHighlights();
+    int written = scorer.ExportPlaybackQueue(queueFile, best);
+    double exportMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!quiet) {
+        const char* const KIND_NAMES[] = {"combo", "kill", "comeback", "swing"};
+        for (const Highlight& highlight : best) {
+            std::wstring kinds;
+            for (int bit = 0; bit < 4; bit++) {
+                if (highlight.kinds & (1 << bit)) {
+                    std::string name = KIND_NAMES[bit];
+                    kinds += (kinds.empty() ? L"" : L"+") + std::wstring(name.begin(), name.end());
+                }
+            }
+            std::wcout << std::fixed << std::setprecision(1) << highlight.score << L"  game " << highlight.game
+                       << L" frames " << highlight.startFrame << L"-" << highlight.endFrame
+                       << L" player " << highlight.player + 1 << L" " << kinds << std::endl;
+        }
+    }
+    std::wcout << L"Highlights: " << written << L" clips from " << scored << L" replays written to "
+               << queueFile.wstring() << L"; scoring " << std::fixed << std::setprecision(1) << scoreMs
+               << L"ms, export " << std::setprecision(3) << exportMs << L"ms" << std::endl;
+    return written >= 0 ? 0 : 1;
+}
+
+int RunFrameQuery(const std::vector<std::filesystem::path>& replays, const std::string& text,
+                  const FrameQueryOptions& options, const std::filesystem::path& clipsFile, bool quiet) {
+    FrameQuery query;
+    std::string error;
+    if (!query.Compile(text, error)) {
+        std::wcout << L"Query error: " << std::wstring(error.begin(), error.end()) << std::endl;
+        return 1;
+    }
+
+    FrameQueryStats stats;
+    std::vector<FrameQueryHit> hits = query.Run(replays, options, stats);
+
+    std::vector<PlaybackClip> clips;
+    uint64_t matchedFrames = 0;
+    for (const FrameQueryHit& hit : hits) {
+        matchedFrames += hit.endFrame - hit.startFrame + 1;
+        if (!quiet) {
+            std::wcout << replays[hit.replay].wstring() << L"\t" << hit.startFrame << L"-" << hit.endFrame << std::endl;
+        }
+        clips.push_back(PlaybackClip{replays[hit.replay], hit.startFrame - HighlightScorer::LEAD_IN_FRAMES,
+                                     hit.endFrame + HighlightScorer::FOLLOW_FRAMES});
+    }
+
+    std::wcout << L"Hits: " << hits.size() << L" (" << matchedFrames << L" frames) in " << stats.replays
+               << L" replays, " << stats.frames << L" frames scanned, " << stats.blocksSkipped << L"/"
+               << stats.blocks << L" blocks skipped, " << stats.blocksAccepted << L" accepted by zone maps, "
+               << stats.failed << L" failed in " << std::fixed << std::setprecision(3) << stats.elapsedSeconds
+               << L"s" << std::endl;
+
+    if (!clipsFile.empty()) {
+        if (!WritePlaybackQueue(clipsFile, clips)) {
+            return 1;
+        }
+        std::wcout << L"Clips written to " << clipsFile.wstring() << std::endl;
+    }
+    return stats.failed > 0 ? 2 : 0;
+}
+
+// Writes the summaries as one record batch and each replay's frames as its
+// own batch, so readers can fetch a single game from the file's footer
+bool ExportArrow(const std::filesystem::path& folder, bool stream, const std::vector<BatchResult>& results) {
+    auto start = std::chrono::steady_clock::now();
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+
+    ArrowWriter::Format format = stream ? ArrowWriter::Format::STREAM : ArrowWriter::Format::FILE;
+    const wchar_t* extension = stream ? L".arrows" : L".arrow";
+
+    ArrowWriter summaries;
+    if (!summaries.Open(folder / (L"summaries" + std::wstring(extension)), format) ||
+        !summaries.WriteBatch(BuildSummaryTable(results)) || !summaries.Close()) {
+        return false;
+    }
+
+    ArrowWriter frames;
+    if (!frames.Open(folder / (L"frames" + std::wstring(extension)), format)) {
+        return false;
+    }
+
+    // Replay ids follow the summary table: succeeded results in order
+    FrameStore store;
+    int32_t replayId = 0;
+    size_t rows = 0;
+    bool ok = true;
+    for (const auto& result : results) {
+        if (!result.succeeded) {
+            continue;
+        }
+        SlpReader reader;
+        int32_t id = replayId++;
+        if (!reader.LoadFile(result.path) || !store.Load(reader, id)) {
+            LOG_WARN("No frames exported for {}", result.path.wstring());
+            continue;
+        }
+        rows += store.GetRowCount();
+        ok = frames.WriteBatch(store.GetTable()) && ok;
+    }
+    if (frames.GetBatchCount() == 0) {
+        // Keep the schema readable even when no replay had frames
+        ok = frames.WriteBatch(FrameStore::EmptyTable()) && ok;
+    }
+    ok = frames.Close() && ok;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::wcout << L"Arrow: " << replayId << L" replays, " << rows << L" frames, "
+               << (summaries.GetBytesWritten() + frames.GetBytesWritten()) / (1024 * 1024) << L" MiB written to "
+               << folder.wstring() << L" in " << std::fixed << std::setprecision(3) << seconds << L"s" << std::endl;
+    return ok;
+}
+
+int RunWorker(const std::string& address, const std::string& token, const std::filesystem::path& cacheFile,
+              const BatchOptions& options) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        PrintUsage();
+        return 1;
+    }
+    std::string host = address.substr(0, colon);
+    uint16_t port = static_cast<uint16_t>(std::stoul(address.substr(colon + 1)));
+
+    // Each worker keeps its own cache so repeat runs stay incremental per machine
+    std::unique_ptr<ReplayResultCache> cache;
+    if (options.useCache) {
+        cache = std::make_unique<ReplayResultCache>(
+            cacheFile.empty() ? std::filesystem::path("coachclippi_worker.cache") : cacheFile);
+        cache->Load();
+    }
+
+    BatchAnalyzer analyzer(options, cache.get());
+    AnalysisWorker worker(host, port, token, analyzer);
+    bool ok = worker.Run();
+
+    if (cache) {
+        cache->PruneVersions(REPLAY_ANALYZER_VERSION);
+        if (cache->IsDirty()) {
+            cache->Save();
+        }
+    }
+
+    std::wcout << L"Worker processed " << worker.GetProcessedCount() << L" replays" << std::endl;
+    return ok ? 0 : 2;
+}
+
+int RunCoordinator(const std::vector<std::filesystem::path>& replays, const DistributedOptions& distributed,
+                   bool quiet, const std::filesystem::path& scoutingFile) {
+    AnalysisCoordinator coordinator(replays, distributed);
+    bool ok = coordinator.Run();
+
+    if (!quiet) {
+        for (const auto& result : coordinator.GetResults()) {
+            PrintSummary(result);
+        }
+    }
+
+    const BatchStats& stats = coordinator.GetStats();
+    std::wcout << L"Replays: " << stats.total
+               << L", analyzed: " << stats.analyzed
+               << L", cached: " << stats.cacheHits
+               << L", failed: " << stats.failed
+               << L", reassigned: " << coordinator.GetReassignedCount()
+               << L" in " << std::fixed << std::setprecision(3) << stats.elapsedSeconds << L"s" << std::endl;
+    PrintTotals(coordinator.GetTotals());
+
+    if (!scoutingFile.empty()) {
+        UpdateScouting(scoutingFile, coordinator.GetResults());
+    }
+
+    return (!ok || stats.failed > 0) ? 2 : 0;
+}
+
+int RunKnowledgeQuery(const std::filesystem::path& corpus, const KnowledgeQuery& query) {
+    KnowledgeIndex index;
+    std::string error;
+    if (!index.LoadCorpus(corpus, error)) {
+        std::wcout << L"Failed to load corpus: " << std::wstring(error.begin(), error.end()) << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<KnowledgeHit> hits = index.Search(query);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    for (const KnowledgeHit& hit : hits) {
+        const KnowledgeSnippet& snippet = index.GetSnippet(hit.snippet);
+        std::wcout << std::fixed << std::setprecision(3) << hit.score << L"\t"
+                   << std::wstring(snippet.id.begin(), snippet.id.end()) << L"\t"
+                   << std::wstring(snippet.text.begin(), snippet.text.end()) << std::endl;
+    }
+    std::wcout << L"Snippets: " << index.GetSnippetCount()
+               << L", terms: " << index.GetTermCount()
+               << L", hits: " << hits.size()
+               << L" in " << std::fixed << std::setprecision(1) << micros << L"us" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Diagnostics go to stderr so stdout stays machine-readable; the logger
+    // drains whatever is left when the process exits
+    Logger::Start(LogOptions());
+
+    std::filesystem::path root;
+    std::filesystem::path cacheFile;
+    BatchOptions options;
+    DistributedOptions distributed;
+    std::string workerAddress;
+    bool coordinator = false;
+    bool quiet = false;
+    std::filesystem::path knowledgeCorpus;
+    KnowledgeQuery knowledgeQuery;
+    std::filesystem::path scoutingFile;
+    std::string scoutPlayer;
+    int scoutCharacter = -1;
+    std::filesystem::path highlightsFile;
+    std::filesystem::path arrowFolder;
+    bool arrowStream = false;
+    std::string findQuery;
+    FrameQueryOptions findOptions;
+    std::filesystem::path clipsFile;
+    std::filesystem::path catalogFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) {
+            cacheFile = argv[++i];
+        } else if (arg == "--no-cache") {
+            options.useCache = false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threadCount = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--flat") {
+            options.recursive = false;
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--coordinator" && i + 1 < argc) {
+            coordinator = true;
+            distributed.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        } else if (arg == "--bind" && i + 1 < argc) {
+            distributed.bindAddress = argv[++i];
+        } else if (arg == "--token" && i + 1 < argc) {
+            distributed.token = argv[++i];
+        } else if (arg == "--shard-size" && i + 1 < argc) {
+            distributed.shardSize = std::stoul(argv[++i]);
+        } else if (arg == "--item-timeout" && i + 1 < argc) {
+            distributed.itemTimeoutSeconds = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--worker" && i + 1 < argc) {
+            workerAddress = argv[++i];
+        } else if (arg == "--knowledge" && i + 1 < argc) {
+            knowledgeCorpus = argv[++i];
+        } else if (arg == "--query" && i + 1 < argc) {
+            knowledgeQuery.text = argv[++i];
+        } else if (arg == "--characters" && i + 1 < argc) {
+            knowledgeQuery.characters = SplitCommaList(argv[++i]);
+        } else if (arg == "--tags" && i + 1 < argc) {
+            knowledgeQuery.tags = SplitCommaList(argv[++i]);
+        } else if (arg == "--top" && i + 1 < argc) {
+            knowledgeQuery.topK = std::stoul(argv[++i]);
+        } else if (arg == "--scouting" && i + 1 < argc) {
+            scoutingFile = argv[++i];
+        } else if (arg == "--scout" && i + 1 < argc) {
+            scoutPlayer = argv[++i];
+        } else if (arg == "--as" && i + 1 < argc) {
+            scoutCharacter = std::stoi(argv[++i]);
+        } else if (arg == "--highlights" && i + 1 < argc) {
+            highlightsFile = argv[++i];
+        } else if (arg == "--arrow" && i + 1 < argc) {
+            arrowFolder = argv[++i];
+        } else if (arg == "--arrow-stream") {
+            arrowStream = true;
+        } else if (arg == "--find" && i + 1 < argc) {
+            findQuery = argv[++i];
+        } else if (arg == "--min-frames" && i + 1 < argc) {
+            findOptions.minFrames = std::stoi(argv[++i]);
+        } else if (arg == "--merge-gap" && i + 1 < argc) {
+            findOptions.mergeGapFrames = std::stoi(argv[++i]);
+        } else if (arg == "--clips" && i + 1 < argc) {
+            clipsFile = argv[++i];
+        } else if (arg == "--import" && i + 1 < argc) {
+            catalogFile = argv[++i];
+        } else if (root.empty() && arg.compare(0, 2, "--") != 0) {
+            root = arg;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (!knowledgeCorpus.empty()) {
+        return RunKnowledgeQuery(knowledgeCorpus, knowledgeQuery);
+    }
+
+    if (!scoutPlayer.empty()) {
+        if (scoutingFile.empty()) {
+            PrintUsage();
+            return 1;
+        }
+        return RunScoutingReport(scoutingFile, scoutPlayer, scoutCharacter);
+    }
+
+    if (!workerAddress.empty()) {
+        return RunWorker(workerAddress, distributed.token, cacheFile, options);
+    }
+
+    if (root.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> replays = BatchAnalyzer::CollectReplays(root, options.recursive);
+    if (replays.empty()) {
+        std::wcout << L"No replays found in " << root.wstring() << std::endl;
+        return 1;
+    }
+
+    if (!highlightsFile.empty()) {
+        return RunHighlights(replays, highlightsFile, quiet);
+    }
+
+    if (!findQuery.empty()) {
+        findOptions.threadCount = options.threadCount;
+        return RunFrameQuery(replays, findQuery, findOptions, clipsFile, quiet);
+    }
+
+    if (!catalogFile.empty()) {
+        ReplayCatalog catalog(catalogFile);
+        catalog.Load();
+
+        ImportStats importStats;
+        replays = catalog.Import(replays, options.threadCount, importStats);
+        if (catalog.IsDirty() && !catalog.Save()) {
+            std::wcout << L"Failed to save replay catalog: " << catalogFile.wstring() << std::endl;
+            return 2;
+        }
+
+        std::wcout << L"Imported: " << importStats.total
+                   << L", new games: " << importStats.added
+                   << L", duplicates: " << importStats.duplicates
+                   << L", perspectives: " << importStats.perspectives
+                   << L", unchanged: " << importStats.unchanged
+                   << L", failed: " << importStats.failed
+                   << L" in " << std::fixed << std::setprecision(3) << importStats.elapsedSeconds << L"s"
+                   << L" (" << catalog.GetGameCount() << L" games in catalog)" << std::endl;
+        if (replays.empty()) {
+            return importStats.failed > 0 ? 2 : 0;
+        }
+    }
+
+    if (coordinator) {
+        return RunCoordinator(replays, distributed, quiet, scoutingFile);
+    }
+
+    if (cacheFile.empty()) {
+        std::error_code error;
+        bool isDirectory = std::filesystem::is_directory(root, error);
+        cacheFile = (isDirectory ? root : root.parent_path()) / "coachclippi_results.cache";
+    }
+
+    std::unique_ptr<ReplayResultCache> cache;
+    if (options.useCache) {
+        cache = std::make_unique<ReplayResultCache>(cacheFile);
+        cache->Load();
+        size_t pruned = cache->PruneVersions(REPLAY_ANALYZER_VERSION);
+        if (pruned > 0) {
+            LOG_INFO("Pruned {} cached results from older analyzer versions", pruned);
+        }
+    }
+
+    BatchAnalyzer analyzer(options, cache.get());
+    std::vector<BatchResult> results = analyzer.Run(replays);
+
+    BatchTotals totals;
+    for (const auto& result : results) {
+        if (!quiet) {
+            PrintSummary(result);
+        }
+        if (result.succeeded) {
+            totals.Add(result.summary);
+        }
+    }
+
+    if (cache && cache->IsDirty()) {
+        cache->Save();
+    }
+
+    const BatchStats& stats = analyzer.GetStats();
+    std::wcout << L"Replays: " << stats.total
+               << L", analyzed: " << stats.analyzed
+               << L", cached: " << stats.cacheHits
+               << L", failed: " << stats.failed
+               << L" in " << std::fixed << std::setprecision(3) << stats.elapsedSeconds << L"s" << std::endl;
+    PrintTotals(totals);
+
+    if (!scoutingFile.empty()) {
+        UpdateScouting(scoutingFile, results);
+    }
+
+    if (!arrowFolder.empty() && !ExportArrow(arrowFolder, arrowStream, results)) {
+        std::wcout << L"Arrow export failed: " << arrowFolder.wstring() << std::endl;
+        return 2;
+    }
+
+    return stats.failed > 0 ? 2 : 0;
+}
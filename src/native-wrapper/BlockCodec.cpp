@@ -0,0 +1,130 @@
+#include "BlockCodec.h"
+
+namespace {
+
+const uint8_t MAX_LITERALS = 0x80;
+const uint8_t ZERO_RUN = 0x80;          // 0x80 + (n - 1) for n = 1..127 zeros
+const uint8_t LONG_ZERO_RUN = 0xFF;     // Followed by a varint count
+const size_t MAX_SHORT_ZEROS = 127;
+
+// Zero runs shorter than this are cheaper left inside a literal run
+const size_t MIN_ZERO_RUN = 3;
+
+void WriteVarint(std::vector<uint8_t>& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool ReadVarint(const uint8_t* data, size_t size, size_t& position, size_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= size) {
+            return false;
+        }
+        uint8_t byte = data[position++];
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WriteLiterals(std::vector<uint8_t>& out, const uint8_t* bytes, size_t length) {
+    while (length > 0) {
+        size_t chunk = length < MAX_LITERALS ? length : MAX_LITERALS;
+        out.push_back(static_cast<uint8_t>(chunk - 1));
+        out.insert(out.end(), bytes, bytes + chunk);
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+void WriteZeros(std::vector<uint8_t>& out, size_t length) {
+    if (length <= MAX_SHORT_ZEROS) {
+        out.push_back(static_cast<uint8_t>(ZERO_RUN + length - 1));
+    } else {
+        out.push_back(LONG_ZERO_RUN);
+        WriteVarint(out, length);
+    }
+}
+
+} // namespace
+
+namespace BlockCodec {
+
+void Encode(const uint8_t* values, size_t count, size_t valueSize, std::vector<uint8_t>& out) {
+    // One plane at a time through a scratch buffer of deltas
+    std::vector<uint8_t> deltas(count);
+    for (size_t plane = 0; plane < valueSize; plane++) {
+        uint8_t previous = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint8_t byte = values[i * valueSize + plane];
+            deltas[i] = static_cast<uint8_t>(byte - previous);
+            previous = byte;
+        }
+
+        size_t literalStart = 0;
+        size_t i = 0;
+        while (i < count) {
+            if (deltas[i] != 0) {
+                i++;
+                continue;
+            }
+            size_t runEnd = i;
+            while (runEnd < count && deltas[runEnd] == 0) {
+                runEnd++;
+            }
+            if (runEnd - i >= MIN_ZERO_RUN) {
+                WriteLiterals(out, deltas.data() + literalStart, i - literalStart);
+                WriteZeros(out, runEnd - i);
+                literalStart = runEnd;
+            }
+            i = runEnd;
+        }
+        WriteLiterals(out, deltas.data() + literalStart, count - literalStart);
+    }
+}
+
+bool Decode(const uint8_t* data, size_t size, size_t count, size_t valueSize, uint8_t* values, size_t& consumed) {
+    size_t position = 0;
+    for (size_t plane = 0; plane < valueSize; plane++) {
+        uint8_t previous = 0;
+        size_t i = 0;
+        while (i < count) {
+            if (position >= size) {
+                return false;
+            }
+            uint8_t token = data[position++];
+            if (token < ZERO_RUN) {
+                size_t length = static_cast<size_t>(token) + 1;
+                if (length > count - i || length > size - position) {
+                    return false;
+                }
+                for (size_t end = i + length; i < end; i++) {
+                    previous = static_cast<uint8_t>(previous + data[position++]);
+                    values[i * valueSize + plane] = previous;
+                }
+            } else {
+                size_t length = static_cast<size_t>(token - ZERO_RUN) + 1;
+                if (token == LONG_ZERO_RUN && !ReadVarint(data, size, position, length)) {
+                    return false;
+                }
+                if (length > count - i) {
+                    return false;
+                }
+                // A zero delta repeats the previous byte
+                for (size_t end = i + length; i < end; i++) {
+                    values[i * valueSize + plane] = previous;
+                }
+            }
+        }
+    }
+    consumed = position;
+    return true;
+}
+
+} // namespace BlockCodec
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Lossless codec for fixed-width column data, built for speed over ratio.
+//
+// Values are split into byte planes (every value's byte 0, then every byte
+// 1, ...), each plane is delta coded byte by byte, and the result is run
+// length coded: a token below 0x80 is followed by that many plus one literal
+// bytes, 0x80-0xFE stand for 1-127 zero bytes, and 0xFF is followed by a
+// varint count of zeros. Frame columns are mostly constant or slowly
+// changing, so their high planes collapse into a few zero runs.
+namespace BlockCodec {
+
+// Appends the encoding of count values of valueSize bytes each to out
+void Encode(const uint8_t* values, size_t count, size_t valueSize, std::vector<uint8_t>& out);
+
+// Decodes count values of valueSize bytes from data into values. consumed
+// is set to the encoded size; false if data is truncated or malformed.
+bool Decode(const uint8_t* data, size_t size, size_t count, size_t valueSize, uint8_t* values, size_t& consumed);
+
+} // namespace BlockCodec
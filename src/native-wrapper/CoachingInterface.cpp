@@ -1,9 +1,75 @@
 #include "CoachingInterface.h"
 #include "imgui.h"
-#include <iostream>
+#include "Logger.h"
+#include "OpponentScouting.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm> // For std::min, std::max
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Per-player stats published to the tip rules as "p<N>.<name>"
+enum LiveTipStat {
+    TIP_STOCKS_LOST,
+    TIP_DAMAGE_TAKEN,
+    TIP_DAMAGE_DEALT,
+    TIP_COMBOS_RECEIVED,
+    TIP_LONGEST_COMBO,
+    TIP_BIGGEST_COMBO_DAMAGE,
+    TIP_DAMAGE_PER_STOCK,   // Damage taken per stock lost, unset until a stock is lost
+    TIP_DAMAGE_RATIO        // Dealt / taken, unset until damage is taken
+};
+
+const char* const LIVE_TIP_STAT_NAMES[] = {
+    "stocksLost", "damageTaken", "damageDealt", "combosReceived",
+    "longestCombo", "biggestComboDamage", "damagePerStock", "damageRatio"
+};
+
+struct DefaultTipRule {
+    const char* id;
+    const char* conditions;
+    const char* title;
+    const char* description;
+    const char* category;
+    int importance;
+};
+
+// Written from the local player's point of view: self.<stat> and opp.<stat>
+// follow the ports StartRollupGame was given
+const DefaultTipRule DEFAULT_TIP_RULES[] = {
+    { "self-long-combos", "self.longestCombo >= 5",
+      "Escape the Long Combos",
+      "You've been caught in a 5+ hit combo. Vary your DI and SDI the multi-hits so the same string doesn't work twice.",
+      "defense", 4 },
+    { "self-early-stocks", "self.stocksLost >= 2 && self.damagePerStock < 70",
+      "Stocks Are Ending Early",
+      "You're losing stocks at low percent on average. Play safer near the ledge and mix up your recovery.",
+      "recovery", 5 },
+    { "self-damage-race", "self.damageTaken >= 150 && self.damageRatio < 0.6",
+      "Losing the Damage Race",
+      "You're taking far more damage than you deal. Slow down in neutral and punish whiffed moves.",
+      "neutral", 4 },
+    { "self-big-punish", "self.biggestComboDamage >= 50",
+      "Big Punishes Against You",
+      "A single opening cost you 50% or more. Watch what starts those strings and shield or space around it.",
+      "defense", 3 },
+    { "opp-comboed", "opp.combosReceived >= 3",
+      "Your Combos Are Landing",
+      "Three or more strings so far. Keep converting those openings and look for a finisher at the end.",
+      "combo", 2 },
+};
+
+// Slippi's game end method for a time out
+const int GAME_END_TIME = 1;
+
+int64_t RollupNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
 
 CoachingInterface::CoachingInterface(HWND parentWindow) 
     : m_parentWindow(parentWindow) {
@@ -19,9 +85,11 @@ CoachingInterface::CoachingInterface(HWND parentWindow)
     // Initialize game state
     memset(&m_lastGameState, 0, sizeof(GameState));
     
-    // Create fonts and resources
-    CreateFonts();
-    CreateBrushes();
+    // GDI fonts and brushes are only needed by the legacy Paint path and are
+    // created on its first use; the ImGui panels never touch them
+    
+    m_commentaryFlash = m_animations.Register("commentary.flash");
+    LoadDefaultTipRules();
     
     // Add some sample commentary for demonstration
     AddCommentaryWithType("Welcome to Coach Clippi! Docking system is now active.", "system", false);
@@ -40,15 +108,18 @@ CoachingInterface::CoachingInterface(HWND parentWindow)
     sampleTip.showTime = GetTickCount();
     m_tips.push_back(sampleTip);
     
-    std::wcout << L"CoachingInterface initialized with docking support" << std::endl;
+    LOG_INFO("CoachingInterface initialized with docking support");
 }
 
 CoachingInterface::~CoachingInterface() {
+    SaveRollups();
     DestroyFonts();
     DestroyBrushes();
 }
 
 void CoachingInterface::Paint(HDC hdc) {
+    EnsureGdiResources();
+    
     // Set background mode for text
     SetBkMode(hdc, TRANSPARENT);
     
@@ -79,18 +150,12 @@ void CoachingInterface::UpdateLayout(const RECT& clientRect, const RECT& gameAre
     bool hasValidGameArea = (gameArea.right > gameArea.left && gameArea.bottom > gameArea.top);
     
     // Log layout information for debugging
-    std::wcout << L"UpdateLayout: Client area: "
-              << m_clientRect.right - m_clientRect.left << L"x"
-              << m_clientRect.bottom - m_clientRect.top << std::endl;
+    LOG_DEBUG("UpdateLayout: Client area: {}x{}", m_clientRect.right - m_clientRect.left, m_clientRect.bottom - m_clientRect.top);
               
     if (hasValidGameArea) {
-        std::wcout << L"UpdateLayout: Game area: "
-                  << m_gameArea.right - m_gameArea.left << L"x"
-                  << m_gameArea.bottom - m_gameArea.top
-                  << L" at (" << m_gameArea.left << L"," << m_gameArea.top << L")"
-                  << std::endl;
+        LOG_DEBUG("UpdateLayout: Game area: {}x{} at ({},{})", m_gameArea.right - m_gameArea.left, m_gameArea.bottom - m_gameArea.top, m_gameArea.left, m_gameArea.top);
     } else {
-        std::wcout << L"UpdateLayout: No valid game area" << std::endl;
+        LOG_DEBUG("UpdateLayout: No valid game area");
     }
     
     // Calculate panel layout based on client and game areas
@@ -142,15 +207,7 @@ void CoachingInterface::AddCommentary(const std::string& text, bool isImportant)
     item.text = text;
     item.timestamp = GetTickCount();
     item.isImportant = isImportant;
-    
-    m_commentary.push_back(item);
-    
-    // Keep only recent items
-    if (m_commentary.size() > MAX_COMMENTARY_ITEMS) {
-        m_commentary.erase(m_commentary.begin());
-    }
-    
-    // ImGui handles all rendering updates automatically
+    PushCommentary(std::move(item));
 }
 
 void CoachingInterface::AddCommentaryWithType(const std::string& text, const std::string& eventType, bool isImportant) {
@@ -173,7 +230,32 @@ void CoachingInterface::AddCommentaryWithType(const std::string& text, const std
         item.eventColor = RGB(255, 255, 255); // White for system/other
     }
     
-    m_commentary.push_back(item);
+    PushCommentary(std::move(item));
+}
+
+void CoachingInterface::PushCommentary(CommentaryItem item) {
+    uint64_t fingerprint = NearDuplicateFilter::Fingerprint(item.text);
+    uint64_t repeatOf = 0;
+    if (m_commentaryRepeats.Match(fingerprint, item.timestamp, repeatOf)) {
+        auto existing = std::find_if(m_commentary.begin(), m_commentary.end(),
+                                     [repeatOf](const CommentaryItem& other) { return other.id == repeatOf; });
+        if (existing != m_commentary.end()) {
+            // Show the latest wording once, with a repeat count, as the newest item
+            CommentaryItem merged = std::move(*existing);
+            m_commentary.erase(existing);
+            merged.text = std::move(item.text);
+            merged.timestamp = item.timestamp;
+            merged.isImportant = merged.isImportant || item.isImportant;
+            merged.repeatCount++;
+            m_commentary.push_back(std::move(merged));
+            m_commentaryAdded++;
+            return;
+        }
+    }
+    
+    item.id = ++m_commentaryAdded;
+    m_commentaryRepeats.Remember(fingerprint, item.timestamp, item.id);
+    m_commentary.push_back(std::move(item));
     
     // Keep only recent items
     if (m_commentary.size() > MAX_COMMENTARY_ITEMS) {
@@ -200,6 +282,289 @@ void CoachingInterface::AddTip(const std::string& title, const std::string& desc
     // ImGui handles all rendering updates automatically
 }
 
+void CoachingInterface::LoadDefaultTipRules() {
+    static_assert(sizeof(LIVE_TIP_STAT_NAMES) / sizeof(LIVE_TIP_STAT_NAMES[0]) == LIVE_TIP_STAT_COUNT,
+                  "One name per live tip stat");
+    
+    for (int player = 0; player < LiveAnalytics::MAX_PLAYERS; player++) {
+        std::string prefix = "p" + std::to_string(player + 1) + ".";
+        for (int stat = 0; stat < LIVE_TIP_STAT_COUNT; stat++) {
+            m_liveTipStats[player][stat] = m_tipRules.GetStatId(prefix + LIVE_TIP_STAT_NAMES[stat]);
+        }
+    }
+    for (int stat = 0; stat < LIVE_TIP_STAT_COUNT; stat++) {
+        m_sideTipStats[0][stat] = m_tipRules.GetStatId(std::string("self.") + LIVE_TIP_STAT_NAMES[stat]);
+        m_sideTipStats[1][stat] = m_tipRules.GetStatId(std::string("opp.") + LIVE_TIP_STAT_NAMES[stat]);
+    }
+    
+    for (const DefaultTipRule& definition : DEFAULT_TIP_RULES) {
+        TipRule rule;
+        std::string error;
+        if (!TipRuleEngine::ParseConditions(definition.conditions, rule.conditions, error)) {
+            LOG_ERROR("Bad tip rule {}: {}", definition.id, error);
+            continue;
+        }
+        rule.id = definition.id;
+        rule.title = definition.title;
+        rule.description = definition.description;
+        rule.category = definition.category;
+        rule.importance = definition.importance;
+        m_tipRules.AddRule(rule);
+    }
+}
+
+void CoachingInterface::PushTipStats(const TipStatId* ids, const LiveAnalytics& analytics, int player) {
+    const double unset = NAN;
+    if (player < 0 || player >= analytics.GetPlayerCount()) {
+        for (int stat = 0; stat < LIVE_TIP_STAT_COUNT; stat++) {
+            m_tipRules.SetStat(ids[stat], unset);
+        }
+        return;
+    }
+    
+    const LivePlayerStats& stats = analytics.GetPlayer(player);
+    m_tipRules.SetStat(ids[TIP_STOCKS_LOST], stats.stocksLost);
+    m_tipRules.SetStat(ids[TIP_DAMAGE_TAKEN], stats.damageTaken);
+    m_tipRules.SetStat(ids[TIP_DAMAGE_DEALT], stats.damageDealt);
+    m_tipRules.SetStat(ids[TIP_COMBOS_RECEIVED], stats.combosReceived);
+    m_tipRules.SetStat(ids[TIP_LONGEST_COMBO], stats.longestCombo);
+    m_tipRules.SetStat(ids[TIP_BIGGEST_COMBO_DAMAGE], stats.biggestComboDamage);
+    m_tipRules.SetStat(ids[TIP_DAMAGE_PER_STOCK],
+                       stats.stocksLost > 0 ? stats.damageTaken / stats.stocksLost : unset);
+    m_tipRules.SetStat(ids[TIP_DAMAGE_RATIO],
+                       stats.damageTaken > 0.0f ? stats.damageDealt / stats.damageTaken : unset);
+}
+
+void CoachingInterface::ResetTipStats() {
+    m_tipRules.ResetStats();
+    m_tipStatsStale = true;
+}
+
+void CoachingInterface::UpdateLiveAnalytics(const LiveAnalytics& analytics) {
+    if (!analytics.HasBaseline()) {
+        return;
+    }
+    
+    // After a reset the analytics hold the last game until the new one's
+    // first frame (which is earlier) arrives; pushing them would fire its
+    // rules again
+    if (m_tipStatsStale && analytics.GetLastFrame() < m_tipStatsFrame) {
+        m_tipStatsStale = false;
+    }
+    if (m_tipStatsStale) {
+        UpdateRollups(analytics);
+        return;
+    }
+    m_tipStatsFrame = analytics.GetLastFrame();
+    
+    // Unchanged values cost nothing, so everything is pushed every frame
+    for (int player = 0; player < LiveAnalytics::MAX_PLAYERS; player++) {
+        PushTipStats(m_liveTipStats[player], analytics, player);
+    }
+    for (int side = 0; side < 2; side++) {
+        PushTipStats(m_sideTipStats[side], analytics, m_rollupPorts[side]);
+    }
+    
+    for (const TipRule* rule : m_tipRules.Evaluate()) {
+        TipItem tip;
+        tip.title = rule->title;
+        tip.description = rule->description;
+        tip.category = rule->category;
+        tip.importance = rule->importance;
+        tip.isActive = true;
+        tip.showTime = GetTickCount();
+        m_tips.push_back(tip);
+        
+        if (m_tips.size() > MAX_TIP_ITEMS) {
+            m_tips.erase(m_tips.begin());
+        }
+        LOG_DEBUG("Tip rule {} fired", rule->id);
+    }
+    
+    UpdateRollups(analytics);
+}
+
+bool CoachingInterface::LoadRollups(const std::filesystem::path& path) {
+    m_rollupFile = path;
+    return m_rollup.Load(path);
+}
+
+bool CoachingInterface::SaveRollups() const {
+    return !m_rollupFile.empty() && m_rollup.Save(m_rollupFile);
+}
+
+void CoachingInterface::StartRollupGame(int localPort, int opponentPort, const std::string& opponent,
+                                        const std::string& matchId, int gameNumber) {
+    m_rollupPorts[0] = localPort;
+    m_rollupPorts[1] = opponentPort;
+    m_rollupOpponent = opponent;
+    m_rollupMatchId = matchId;
+    m_rollup.StartGame(opponent, RollupNowMs(), matchId, gameNumber);
+    m_rollupGameEnded = false;
+    
+    // The analytics still hold the previous game until its first frame
+    // arrives; that drop is what rebaselines m_rollupLast
+}
+
+void CoachingInterface::EndRollupGame(const GameEndInfo& gameEnd) {
+    m_rollupGameEnded = true;
+    if (!m_rollup.IsInGame()) {
+        return;
+    }
+    
+    const int self = m_rollupPorts[0];
+    const int opponent = m_rollupPorts[1];
+    const LivePlayerStats& lastSelf = m_rollupLast[0];
+    const LivePlayerStats& lastOpponent = m_rollupLast[1];
+    
+    GameResult result = GameResult::NONE;
+    if (gameEnd.winner >= 0) {
+        result = gameEnd.winner == self ? GameResult::WIN
+               : gameEnd.winner == opponent ? GameResult::LOSS : GameResult::NONE;
+    } else if (gameEnd.lrasInitiator >= 0) {
+        // Quitting out concedes the game
+        result = gameEnd.lrasInitiator == self ? GameResult::LOSS
+               : gameEnd.lrasInitiator == opponent ? GameResult::WIN : GameResult::NONE;
+    } else if (gameEnd.method == GAME_END_TIME) {
+        // Time out: more stocks wins, then lower percent; a full tie goes to sudden death
+        if (lastSelf.stocks != lastOpponent.stocks) {
+            result = lastSelf.stocks > lastOpponent.stocks ? GameResult::WIN : GameResult::LOSS;
+        } else if (lastSelf.percent != lastOpponent.percent) {
+            result = lastSelf.percent < lastOpponent.percent ? GameResult::WIN : GameResult::LOSS;
+        }
+    }
+    
+    m_rollup.EndGame(result, RollupNowMs());
+    SaveRollups();
+    LOG_INFO("Game ended (method {}): {}", gameEnd.method,
+             result == GameResult::WIN ? "win" : result == GameResult::LOSS ? "loss" : "unresolved");
+}
+
+void CoachingInterface::UpdateRollups(const LiveAnalytics& analytics) {
+    int count = analytics.GetPlayerCount();
+    if (m_rollupPorts[0] >= count || m_rollupPorts[1] >= count) {
+        return;
+    }
+    
+    const LivePlayerStats& self = analytics.GetPlayer(m_rollupPorts[0]);
+    const LivePlayerStats& opponent = analytics.GetPlayer(m_rollupPorts[1]);
+    LivePlayerStats& lastSelf = m_rollupLast[0];
+    LivePlayerStats& lastOpponent = m_rollupLast[1];
+    int64_t nowMs = RollupNowMs();
+    
+    // Cumulative values only go down when the analytics reset for a new game
+    bool restarted = false;
+    for (int i = 0; i < 2; i++) {
+        const LivePlayerStats& current = i == 0 ? self : opponent;
+        const LivePlayerStats& last = m_rollupLast[i];
+        restarted = restarted || current.stocks > last.stocks || current.stocksLost < last.stocksLost ||
+                    current.damageTaken < last.damageTaken || current.combosReceived < last.combosReceived;
+    }
+    if (restarted) {
+        lastSelf = LivePlayerStats();
+        lastOpponent = LivePlayerStats();
+        lastSelf.stocks = self.stocks;
+        lastOpponent.stocks = opponent.stocks;
+        m_rollupLastFrame = analytics.GetLastFrame();
+        m_rollupCombosSeen = 0;
+    }
+    
+    float dealt = opponent.damageTaken - lastOpponent.damageTaken;
+    float taken = self.damageTaken - lastSelf.damageTaken;
+    int stocksTaken = opponent.stocksLost - lastOpponent.stocksLost;
+    int stocksLost = self.stocksLost - lastSelf.stocksLost;
+    
+    // A game without a gameStart event (older overlays) opens on its first activity
+    bool active = dealt > 0.0f || taken > 0.0f || stocksTaken > 0 || stocksLost > 0;
+    if (restarted) {
+        m_rollupGameEnded = false;
+    }
+    if (!m_rollup.IsInGame() && (restarted || (active && !m_rollupGameEnded)) && self.stocks > 0 &&
+        opponent.stocks > 0) {
+        m_rollup.StartGame(m_rollupOpponent, nowMs, m_rollupMatchId);
+    }
+    
+    if (m_rollup.IsInGame()) {
+        m_rollup.AddFrames(analytics.GetLastFrame() - m_rollupLastFrame, nowMs);
+        if (dealt > 0.0f || taken > 0.0f) {
+            m_rollup.AddDamage(dealt, taken, nowMs);
+        }
+        if (stocksTaken > 0 || stocksLost > 0) {
+            m_rollup.AddStocks(stocksTaken, stocksLost, nowMs);
+        }
+        
+        // Every combo the opponent received since the last poll. Numbers at or
+        // below the ones already seen are a resync replaying the same combos.
+        uint32_t closedCount = analytics.GetClosedComboCount();
+        uint32_t oldest = closedCount > LiveAnalytics::CLOSED_COMBO_HISTORY
+                              ? closedCount - LiveAnalytics::CLOSED_COMBO_HISTORY : 0;
+        for (uint32_t number = std::max(m_rollupCombosSeen, oldest) + 1; number <= closedCount; number++) {
+            const ClosedCombo& combo = analytics.GetClosedCombo(number);
+            if (combo.victim == m_rollupPorts[1]) {
+                m_rollup.AddCombo(combo.damage, combo.hits, nowMs);
+            }
+        }
+        
+        if (self.stocks == 0 || opponent.stocks == 0) {
+            m_rollup.EndGame(self.stocks == 0 ? GameResult::LOSS : GameResult::WIN, nowMs);
+            SaveRollups();
+        }
+    }
+    
+    lastSelf = self;
+    lastOpponent = opponent;
+    m_rollupLastFrame = analytics.GetLastFrame();
+    m_rollupCombosSeen = std::max(m_rollupCombosSeen, analytics.GetClosedComboCount());
+}
+
+void CoachingInterface::ShowScoutingReport(const ScoutingReport& report) {
+    TipItem tip;
+    tip.title = "Scouting: " + report.identity;
+    for (const std::string& line : report.lines) {
+        if (!tip.description.empty()) {
+            tip.description += "\n";
+        }
+        tip.description += line;
+    }
+    tip.category = "scouting";
+    tip.importance = 4;
+    tip.isActive = true;
+    tip.showTime = GetTickCount();
+    m_tips.push_back(tip);
+    
+    if (m_tips.size() > MAX_TIP_ITEMS) {
+        m_tips.erase(m_tips.begin());
+    }
+}
+
+void CoachingInterface::UpdateDetectors(const std::vector<DetectorStatus>& status, const FocusStats& stats) {
+    m_detectorStatus = status;
+    m_focusStats = stats;
+}
+
+void CoachingInterface::ShowGameTimeline(const GameTimeline& timeline, size_t gameCount) {
+    m_timeline = timeline;
+    m_timelineGameCount = gameCount;
+}
+
+bool CoachingInterface::TakeTimelineRequest(size_t& game) {
+    if (!m_timelineRequested) {
+        return false;
+    }
+    m_timelineRequested = false;
+    game = m_timelineRequest;
+    return true;
+}
+
+bool CoachingInterface::TakeFocusChange(uint8_t& focus) {
+    if (!m_focusChanged) {
+        return false;
+    }
+    m_focusChanged = false;
+    focus = m_focus;
+    return true;
+}
+
 void CoachingInterface::UpdateStats(const StatsData& stats) {
     m_currentStats = stats;
     // ImGui handles all rendering updates automatically
@@ -241,8 +606,10 @@ void CoachingInterface::SetTheme(const UITheme& theme) {
     m_theme = theme;
     
     // Recreate brushes with new colors
-    DestroyBrushes();
-    CreateBrushes();
+    if (m_gdiResourcesCreated) {
+        DestroyBrushes();
+        CreateBrushes();
+    }
     
     // ImGui handles all rendering updates automatically
 }
@@ -1042,14 +1409,25 @@ void CoachingInterface::CalculateLayout() {
     }
 }
 
-void CoachingInterface::CreateFonts() {
-    // Get system DPI for proper font scaling
+void CoachingInterface::EnsureGdiResources() {
+    if (m_gdiResourcesCreated) {
+        return;
+    }
+    m_gdiResourcesCreated = true;
+    CreateFonts();
+    CreateBrushes();
+}
+
+float CoachingInterface::GetSystemDpiScale() {
     HDC hdc = GetDC(NULL);
     int dpiX = GetDeviceCaps(hdc, LOGPIXELSX);
     ReleaseDC(NULL, hdc);
-    
-    // Calculate font sizes based on DPI
-    float dpiScale = static_cast<float>(dpiX) / 96.0f;
+    return static_cast<float>(dpiX) / 96.0f;
+}
+
+void CoachingInterface::CreateFonts() {
+    // Calculate font sizes based on the system DPI
+    float dpiScale = GetSystemDpiScale();
     
     // Scale font sizes based on DPI
     int titleSize = static_cast<int>(18 * dpiScale);
@@ -1079,9 +1457,7 @@ void CoachingInterface::CreateFonts() {
                                   CLEARTYPE_QUALITY, FIXED_PITCH | FF_MODERN, L"Consolas");
     
     // Log font creation for debugging
-    std::wcout << L"Created fonts with DPI scale: " << dpiScale
-              << L" (Title: " << titleSize
-              << L", Normal: " << normalSize << L")" << std::endl;
+    LOG_INFO("Created fonts with DPI scale: {} (Title: {}, Normal: {})", dpiScale, titleSize, normalSize);
 }
 
 void CoachingInterface::DestroyFonts() {
@@ -1109,7 +1485,7 @@ void CoachingInterface::CreateBrushes() {
     m_borderPen = CreatePen(PS_SOLID, borderThickness, RGB(58, 58, 62));
     
     // Log brush creation for debugging
-    std::wcout << L"Created brushes with border thickness: " << borderThickness << std::endl;
+    LOG_INFO("Created brushes with border thickness: {}", borderThickness);
 }
 
 void CoachingInterface::DestroyBrushes() {
@@ -1117,6 +1493,10 @@ void CoachingInterface::DestroyBrushes() {
     if (m_panelBrush) DeleteObject(m_panelBrush);
     if (m_accentBrush) DeleteObject(m_accentBrush);
     if (m_borderPen) DeleteObject(m_borderPen);
+    m_backgroundBrush = nullptr;
+    m_panelBrush = nullptr;
+    m_accentBrush = nullptr;
+    m_borderPen = nullptr;
 }
 
 std::string CoachingInterface::FormatTime(DWORD timestamp) const {
@@ -1180,6 +1560,8 @@ void CoachingInterface::CleanupOldItems() {
 }
 
 void CoachingInterface::Render() {
+    UpdateAnimations();
+    
     // Set ImGui style to match our theme
     ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.10f, 0.10f, 0.12f, 1.0f));
     ImGui::PushStyleColor(ImGuiCol_TitleBg, ImVec4(0.08f, 0.08f, 0.10f, 1.0f));
@@ -1201,6 +1583,26 @@ void CoachingInterface::Render() {
     
     // Pop all style colors
     ImGui::PopStyleColor(8);
+    
+    m_catchUpFrame = false;
+}
+
+AnimationHandle CoachingInterface::StartAnimation(const std::string& animationName, int duration) {
+    AnimationHandle handle = m_animations.Register(animationName);
+    m_animations.Start(handle, 0.0f, 1.0f, static_cast<uint32_t>(duration), GetTickCount());
+    return handle;
+}
+
+void CoachingInterface::UpdateAnimations() {
+    m_lastAnimationUpdate = GetTickCount();
+    m_animations.Update(m_lastAnimationUpdate);
+}
+
+void CoachingInterface::SetMinimized(bool minimized) {
+    if (m_isMinimized && !minimized) {
+        m_catchUpFrame = true;
+    }
+    m_isMinimized = minimized;
 }
 
 void CoachingInterface::RenderPlayerStatsPanel() {
@@ -1270,12 +1672,108 @@ void CoachingInterface::RenderPlayerStatsPanel() {
             ImGui::Spacing();
             ImGui::TableNextColumn();
 
-            // Session Section
+            // This game's focus area stats, for the areas being worked on
+            {
+                const FocusPlayerStats& focus = m_focusStats.players[std::min(m_rollupPorts[0], FocusStats::MAX_PLAYERS - 1)];
+                RenderSectionHeader("FOCUS");
+                if (m_focus & FOCUS_NEUTRAL) {
+                    std::string neutral = std::to_string(focus.neutralWins) + "-" + std::to_string(focus.neutralLosses);
+                    RenderStatRow("Neutral", neutral.c_str());
+                    
+                    int pressure = m_focusStats.neutralFrames > 0 ? focus.pressureFrames * 100 / m_focusStats.neutralFrames : 0;
+                    std::string pressureText = std::to_string(pressure) + "%";
+                    RenderStatRow("Pressure", pressureText.c_str());
+                }
+                if (m_focus & FOCUS_COMBOS) {
+                    int average = focus.punishes > 0 ? static_cast<int>(focus.punishDamage / focus.punishes + 0.5f) : 0;
+                    std::string punishes = std::to_string(focus.punishes) + " (" + std::to_string(focus.combos) +
+                                           " combos, " + std::to_string(average) + "% avg)";
+                    RenderStatRow("Punishes", punishes.c_str());
+                }
+                if (m_focus & FOCUS_EDGEGUARDING) {
+                    std::string edgeguards = std::to_string(focus.edgeguards) + " (" + std::to_string(focus.edgeguardKills) + " kills)";
+                    RenderStatRow("Edgeguards", edgeguards.c_str());
+                }
+                if (m_focus & FOCUS_RECOVERY) {
+                    std::string recoveries = std::to_string(focus.recoveries) + " (" + std::to_string(focus.failedRecoveries) + " lost)";
+                    RenderStatRow("Recoveries", recoveries.c_str());
+                }
+            
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Spacing();
+                ImGui::TableNextColumn();
+            }
+
+            // Percent over a finished game, one line per port; stock losses
+            // show as drops to zero
+            if ((m_focus & FOCUS_REVIEW) && m_timelineGameCount > 0) {
+                RenderSectionHeader("TIMELINE");
+                
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("Game");
+                ImGui::TableNextColumn();
+                ImGui::BeginDisabled(m_timelineRequested || m_timeline.game == 0);
+                if (ImGui::ArrowButton("##timelinePrevious", ImGuiDir_Left)) {
+                    m_timelineRequest = m_timeline.game - 1;
+                    m_timelineRequested = true;
+                }
+                ImGui::EndDisabled();
+                ImGui::SameLine();
+                ImGui::Text("%zu of %zu", m_timeline.game + 1, m_timelineGameCount);
+                ImGui::SameLine();
+                ImGui::BeginDisabled(m_timelineRequested || m_timeline.game + 1 >= m_timelineGameCount);
+                if (ImGui::ArrowButton("##timelineNext", ImGuiDir_Right)) {
+                    m_timelineRequest = m_timeline.game + 1;
+                    m_timelineRequested = true;
+                }
+                ImGui::EndDisabled();
+                
+                for (int port = 0; port < GameTimeline::PORTS; port++) {
+                    const std::vector<float>& percent = m_timeline.percent[port];
+                    if (!m_timeline.hasPort[port] || percent.empty()) {
+                        continue;
+                    }
+                    
+                    const std::vector<float>& stocks = m_timeline.stocks[port];
+                    std::string label = "P" + std::to_string(port + 1);
+                    std::string overlay = std::to_string(static_cast<int>(stocks.back())) + " stocks left";
+                    
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", label.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::PlotLines(("##timeline" + label).c_str(), percent.data(), static_cast<int>(percent.size()),
+                                     0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(-1, 40.0f));
+                }
+                
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Spacing();
+                ImGui::TableNextColumn();
+            }
+
+            // Rollups, finest first
             RenderSectionHeader("SESSION");
-            RenderStatRow("Games", "5");
-            RenderStatRow("Wins", "4");
-            RenderStatRow("Win Rate", "80%");
-            RenderStatRow("Time", "15m");
+            RenderRollupRow("Minute", m_rollup.Current(RollupLevel::MINUTE));
+            RenderRollupRow("Game", m_rollup.Current(RollupLevel::GAME));
+            
+            const RollupSet& set = m_rollup.CurrentSet();
+            if (!set.stats.IsEmpty()) {
+                std::string setScore = std::to_string(set.wins) + "-" + std::to_string(set.losses) +
+                                       " vs " + set.opponent;
+                RenderStatRow("Set", setScore.c_str());
+            }
+            if (!m_rollup.GetSets().empty()) {
+                const RollupSet& lastSet = m_rollup.GetSets().back();
+                std::string lastScore = std::to_string(lastSet.wins) + "-" + std::to_string(lastSet.losses) +
+                                        (lastSet.bestOf > 0 ? " (Bo" + std::to_string(lastSet.bestOf) + ")" : "");
+                RenderStatRow("Last Set", lastScore.c_str());
+            }
+            
+            RenderRollupRow("Session", m_rollup.Current(RollupLevel::SESSION));
+            RenderRollupRow("Lifetime", m_rollup.Current(RollupLevel::LIFETIME));
 
             ImGui::EndTable();
         }
@@ -1328,6 +1826,12 @@ void CoachingInterface::RenderCommentaryPanel() {
         
         // Scrollable commentary area
         if (ImGui::BeginChild("CommentaryScroll", ImVec2(0, 0), false, ImGuiWindowFlags_AlwaysVerticalScrollbar)) {
+            // Briefly highlight the newest item when it arrives
+            if (m_commentaryFlashed != m_commentaryAdded) {
+                m_commentaryFlashed = m_commentaryAdded;
+                m_animations.Start(m_commentaryFlash, 1.0f, 0.0f, 600, GetTickCount());
+            }
+            
             // Display commentary items with filtering
             for (const auto& item : m_commentary) {
                 // Apply filters
@@ -1361,6 +1865,10 @@ void CoachingInterface::RenderCommentaryPanel() {
                     }
                 }
                 
+                if (&item == &m_commentary.back()) {
+                    bgColor.w = std::min(1.0f, bgColor.w + 0.4f * m_animations.GetValue(m_commentaryFlash));
+                }
+                
                 // Create a colored background for each item
                 ImVec2 itemStart = ImGui::GetCursorScreenPos();
                 ImVec2 itemSize = ImVec2(ImGui::GetContentRegionAvail().x, 0);
@@ -1399,12 +1907,19 @@ void CoachingInterface::RenderCommentaryPanel() {
                     ImGui::Text("[%s]", item.eventType.c_str());
                     ImGui::PopStyleColor();
                 }
-                
+
+                if (item.repeatCount > 1) {
+                    ImGui::SameLine(ImGui::GetWindowWidth() - 150);
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.7f, 0.7f, 1.0f));
+                    ImGui::Text("x%d", item.repeatCount);
+                    ImGui::PopStyleColor();
+                }
+
                 ImGui::Spacing();
             }
             
-            // Auto-scroll to bottom for new items
-            if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+            // Auto-scroll to bottom for new items, and after coming back from the background
+            if (m_catchUpFrame || ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
                 ImGui::SetScrollHereY(1.0f);
             }
         }
@@ -1540,6 +2055,82 @@ void CoachingInterface::RenderControlsPanel() {
         
         ImGui::Separator();
         
+        // Live stream health
+        ImGui::Text("Data Stream:");
+        ImGui::Indent();
+        
+        ImGui::Text("Messages: %llu", static_cast<unsigned long long>(m_ingestStats.messages));
+        ImGui::Text("Gaps: %llu (%llu missing)", static_cast<unsigned long long>(m_ingestStats.gaps),
+                    static_cast<unsigned long long>(m_ingestStats.missingMessages));
+        ImGui::Text("Resyncs: %llu/%llu, %llu timed out",
+                    static_cast<unsigned long long>(m_ingestStats.resyncsCompleted),
+                    static_cast<unsigned long long>(m_ingestStats.resyncRequests),
+                    static_cast<unsigned long long>(m_ingestStats.resyncTimeouts));
+        ImGui::Text("Rebaselines: %llu, duplicates: %llu",
+                    static_cast<unsigned long long>(m_ingestStats.rebaselines),
+                    static_cast<unsigned long long>(m_ingestStats.duplicates));
+        
+        ImGui::Unindent();
+        
+        ImGui::Separator();
+        
+        // Focus areas decide which detectors run; each one's cost per frame
+        ImGui::Text("Coaching Focus:");
+        ImGui::Indent();
+        
+        static const struct { const char* label; uint8_t flag; } FOCUS_AREAS[] = {
+            {"Neutral", FOCUS_NEUTRAL}, {"Combos", FOCUS_COMBOS},
+            {"Edgeguarding", FOCUS_EDGEGUARDING}, {"Recovery", FOCUS_RECOVERY},
+            {"Review", FOCUS_REVIEW}
+        };
+        for (size_t i = 0; i < IM_ARRAYSIZE(FOCUS_AREAS); i++) {
+            bool selected = (m_focus & FOCUS_AREAS[i].flag) != 0;
+            if (i > 0) {
+                ImGui::SameLine();
+            }
+            if (ImGui::Checkbox(FOCUS_AREAS[i].label, &selected)) {
+                uint8_t focus = selected ? (m_focus | FOCUS_AREAS[i].flag) : (m_focus & ~FOCUS_AREAS[i].flag);
+                // Clearing every area would leave only the always-on detectors
+                if (focus != 0) {
+                    m_focus = focus;
+                    m_focusChanged = true;
+                }
+            }
+        }
+        
+        if (!m_detectorStatus.empty() &&
+            ImGui::BeginTable("detectors", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Detector", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Focus", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("us/frame", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableHeadersRow();
+            
+            for (const DetectorStatus& detector : m_detectorStatus) {
+                ImVec4 color = detector.enabled ? ImVec4(1.0f, 1.0f, 1.0f, 1.0f) : ImVec4(0.5f, 0.5f, 0.5f, 1.0f);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextColored(color, "%s", detector.info.name.c_str());
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("Reads: %s\nProduces: %s\nFrames: %llu, average %.2f us",
+                                      FieldsToString(detector.info.fields).c_str(), detector.info.outputs.c_str(),
+                                      static_cast<unsigned long long>(detector.frames), detector.averageNs / 1000.0);
+                }
+                ImGui::TableNextColumn();
+                ImGui::TextColored(color, "%s", detector.info.focus == 0 ? "always" : FocusToString(detector.info.focus).c_str());
+                ImGui::TableNextColumn();
+                if (detector.enabled) {
+                    ImGui::Text("%.2f", detector.recentNs / 1000.0);
+                } else {
+                    ImGui::TextColored(color, "off");
+                }
+            }
+            ImGui::EndTable();
+        }
+        
+        ImGui::Unindent();
+        
+        ImGui::Separator();
+        
         // Theme controls
         ImGui::Text("Theme Settings:");
         ImGui::Indent();
@@ -1600,15 +2191,13 @@ void CoachingInterface::RenderGameWindow() {
             int contentWidth = (int)(contentMax.x - contentMin.x);
             int contentHeight = (int)(contentMax.y - contentMin.y);
             
-            std::wcout << L"Game Window Panel Info:" << std::endl;
-            std::wcout << L"  Platform Window: " << (void*)platformWindow << std::endl;
-            std::wcout << L"  Content Position: (" << contentTopLeft.x << L"," << contentTopLeft.y << L")" << std::endl;
-            std::wcout << L"  Content Size: " << contentWidth << L"x" << contentHeight << std::endl;
+            LOG_DEBUG("Game window panel: platform window {}, content ({},{}) size {}x{}",
+                      (void*)platformWindow, contentTopLeft.x, contentTopLeft.y, contentWidth, contentHeight);
             
             // Update our container window handle and position info
             if (m_gameWindowContainer != platformWindow) {
                 m_gameWindowContainer = platformWindow;
-                std::wcout << L"Game window container updated: " << (void*)m_gameWindowContainer << std::endl;
+                LOG_INFO("Game window container updated: {}", (void*)m_gameWindowContainer);
                 
                 // Apply container window styles for proper child window clipping
                 if (IsWindow(m_gameWindowContainer)) {
@@ -1616,7 +2205,7 @@ void CoachingInterface::RenderGameWindow() {
                     style |= WS_CLIPCHILDREN;  // Prevent child windows from drawing outside bounds
                     SetWindowLong(m_gameWindowContainer, GWL_STYLE, style);
                     
-                    std::wcout << L"Applied WS_CLIPCHILDREN style to container window" << std::endl;
+                    LOG_DEBUG("Applied WS_CLIPCHILDREN style to container window");
                 }
             }
             
@@ -1627,9 +2216,7 @@ void CoachingInterface::RenderGameWindow() {
             m_gameContentArea.right = contentTopLeft.x + contentWidth;
             m_gameContentArea.bottom = contentTopLeft.y + contentHeight;
             
-            std::wcout << L"Updated game content area: (" << m_gameContentArea.left << L"," 
-                      << m_gameContentArea.top << L") to (" << m_gameContentArea.right 
-                      << L"," << m_gameContentArea.bottom << L")" << std::endl;
+            LOG_DEBUG("Updated game content area: ({},{}) to ({},{})", m_gameContentArea.left, m_gameContentArea.top, m_gameContentArea.right, m_gameContentArea.bottom);
         }
         
         // Get the content region for the embedded game
@@ -1696,6 +2283,28 @@ void CoachingInterface::RenderStatRow(const char* label, const char* value) {
     ImGui::Text(value);
 }
 
+void CoachingInterface::RenderRollupRow(const char* label, const RollupStats& stats) {
+    if (stats.IsEmpty()) {
+        RenderStatRow(label, "-");
+        return;
+    }
+    
+    std::string value;
+    if (stats.games > 0 && stats.wins + stats.losses > 0) {
+        value = std::to_string(stats.wins) + "-" + std::to_string(stats.losses) + ", ";
+    }
+    value += FormatNumber(static_cast<float>(stats.damageDealt), 0) + "% / " +
+             FormatNumber(static_cast<float>(stats.damageTaken), 0) + "%";
+    if (stats.combos > 0) {
+        value += ", " + std::to_string(stats.combos) + " combos (median " +
+                 FormatNumber(stats.ComboDamageQuantile(0.5f), 0) + "%)";
+    }
+    if (stats.games > 1) {
+        value += ", ~" + FormatNumber(static_cast<float>(stats.EstimateDistinctOpponents()), 0) + " opponents";
+    }
+    RenderStatRow(label, value.c_str());
+}
+
 void CoachingInterface::RenderProgressBar(float fraction, const ImVec4& color) {
     ImGui::TableNextRow();
     ImGui::TableNextColumn();
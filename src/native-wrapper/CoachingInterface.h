@@ -3,9 +3,18 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <filesystem>
 #include "GameDataInterface.h"
+#include "AnimationSystem.h"
+#include "StatsRollup.h"
+#include "TipRuleEngine.h"
+#include "NearDuplicateFilter.h"
+#include "DetectorRegistry.h"
+#include "FocusDetectors.h"
 #include "imgui.h"
 
+struct ScoutingReport;
+
 // UI Panel types
 enum class PanelType {
     STATS,
@@ -92,11 +101,7 @@ struct StatsData {
     int neutralWins = 0;
     int neutralLosses = 0;
     
-    // Session data
-    DWORD sessionStartTime = 0;
-    int gamesPlayed = 0;
-    int gamesWon = 0;
-    float winRate = 0.0f;
+    // Session and lifetime totals live in the StatsRollup, not here
 };
 
 struct CommentaryItem {
@@ -106,6 +111,8 @@ struct CommentaryItem {
     std::string eventType;  // "combo", "kill", "tech", "edgeguard", etc.
     COLORREF eventColor = RGB(255, 255, 255);
     int priority = 0;       // Higher priority items stay visible longer
+    uint64_t id = 0;
+    int repeatCount = 1;    // Near-identical lines merged into this one
 };
 
 struct TipItem {
@@ -118,17 +125,6 @@ struct TipItem {
     bool hasBeenSeen = false;
 };
 
-// Animation and visual effects
-struct AnimationState {
-    bool isAnimating = false;
-    DWORD startTime = 0;
-    DWORD duration = 200;
-    float progress = 0.0f;
-    int targetValue = 0;
-    int startValue = 0;
-    int currentValue = 0;
-};
-
 // Character data for visual representation
 struct CharacterInfo {
     std::string name;
@@ -143,6 +139,9 @@ public:
     CoachingInterface(HWND parentWindow);
     ~CoachingInterface();
     
+    // System DPI relative to 96; the GDI fonts and the ImGui font atlas both scale by it
+    static float GetSystemDpiScale();
+    
     // Main interface methods
     void Paint(HDC hdc);
     void UpdateLayout(const RECT& clientRect, const RECT& gameArea);
@@ -153,12 +152,61 @@ public:
     void AddCommentary(const std::string& text, bool isImportant = false);
     void AddTip(const std::string& title, const std::string& description);
     void UpdateStats(const StatsData& stats);
+    void UpdateIngestStats(const IngestStats& stats) { m_ingestStats = stats; }
+    void UpdateDetectors(const std::vector<DetectorStatus>& status, const FocusStats& stats);
+    
+    // Focus areas (FocusArea flags) picked in the Controls panel. TakeFocusChange
+    // returns true once per change, for the caller to pass on to the detectors.
+    void SetFocus(uint8_t focus) { m_focus = focus; }
+    uint8_t GetFocus() const { return m_focus; }
+    bool TakeFocusChange(uint8_t& focus);
+    
+    // Finished game shown in the Player Stats timeline, out of gameCount in
+    // the frame history. TakeTimelineRequest returns true once when another
+    // game is picked there, for the caller to load and show.
+    void ShowGameTimeline(const GameTimeline& timeline, size_t gameCount);
+    bool TakeTimelineRequest(size_t& game);
+    
+    // Feeds the live stats to the tip rules and the stats rollups; tips whose
+    // rules just became true are added
+    void UpdateLiveAnalytics(const LiveAnalytics& analytics);
+    
+    // Called when a game starts: the tip rules' stats and outcome windows
+    // start over, so rules can fire again in the new game
+    void ResetTipStats();
+    
+    // Minute/game/set/session/lifetime stats. The lifetime and session totals
+    // are loaded from path and saved back there after every game.
+    bool LoadRollups(const std::filesystem::path& path);
+    bool SaveRollups() const;
+    const StatsRollup& GetRollups() const { return m_rollup; }
+    
+    // Called when a game starts: whose stats are the player's, who they're
+    // facing (an identity that stays the same across a set), and the Slippi
+    // match id and game number if the game start had them
+    void StartRollupGame(int localPort, int opponentPort, const std::string& opponent,
+                         const std::string& matchId = "", int gameNumber = 0);
+    void SetDefaultBestOf(int bestOf) { m_rollup.SetDefaultBestOf(bestOf); }
+    
+    // Called on the overlay's gameEnd event. Closes the game if running out of
+    // stocks hasn't already: the reported winner decides it, else the player
+    // who quit out loses, else a time out goes by stocks and percent. Anything
+    // else (a disconnect, a no contest) is recorded as unresolved.
+    void EndRollupGame(const GameEndInfo& gameEnd);
+    
+    // Adds an opponent's scouting summary as a high-importance tip
+    void ShowScoutingReport(const ScoutingReport& report);
     
     // Panel management
     void ShowPanel(PanelType panel, bool show = true);
     bool IsPanelVisible(PanelType panel) const;
     void SetPanelSize(PanelType panel, int width, int height);
     
+    // Set by the render loop while no ImGui frames are being built; the first
+    // frame after a restore catches up on everything that arrived meanwhile
+    void SetMinimized(bool minimized);
+    bool IsMinimized() const { return m_isMinimized; }
+    
     // Settings and configuration
     void SetTheme(const UITheme& theme);
     void SetTheme(ThemeType themeType);
@@ -168,8 +216,10 @@ public:
     // Enhanced UI methods
     void AddCommentaryWithType(const std::string& text, const std::string& eventType, bool isImportant = false);
     void SetCharacterInfo(int playerId, const CharacterInfo& info);
-    void StartAnimation(const std::string& animationName, int duration = 200);
+    // Runs the named animation from 0 to 1; keep the handle to read its value
+    AnimationHandle StartAnimation(const std::string& animationName, int duration = 200);
     void UpdateAnimations();
+    float GetAnimationValue(AnimationHandle handle) const { return m_animations.GetValue(handle); }
     
     // Theme management
     UITheme GetTheme(ThemeType themeType) const;
@@ -190,7 +240,16 @@ private:
     void RenderControlsPanel();
     void RenderSectionHeader(const char* label);
     void RenderStatRow(const char* label, const char* value);
+    void RenderRollupRow(const char* label, const RollupStats& stats);
     void RenderProgressBar(float fraction, const ImVec4& color);
+    
+    // Data helpers
+    void LoadDefaultTipRules();
+    void PushTipStats(const TipStatId* ids, const LiveAnalytics& analytics, int player);
+    // Adds an item, or merges it into a near-identical recent one
+    void PushCommentary(CommentaryItem item);
+    void UpdateRollups(const LiveAnalytics& analytics);
+    
     HWND m_gameWindowContainer = nullptr;
     HWND m_parentWindow;
     UITheme m_theme;
@@ -213,8 +272,40 @@ private:
     // Data storage
     StatsData m_currentStats;
     std::vector<CommentaryItem> m_commentary;
+    NearDuplicateFilter m_commentaryRepeats;
     std::vector<TipItem> m_tips;
+    
+    // Live tip rules, with stat ids resolved up front: by port (p1.damageTaken,
+    // ...) and by side (self.damageTaken, opp.damageTaken), the sides being
+    // m_rollupPorts
+    static constexpr int LIVE_TIP_STAT_COUNT = 8;
+    TipRuleEngine m_tipRules;
+    TipStatId m_liveTipStats[LiveAnalytics::MAX_PLAYERS][LIVE_TIP_STAT_COUNT];
+    TipStatId m_sideTipStats[2][LIVE_TIP_STAT_COUNT];
+    bool m_tipStatsStale = false;       // Analytics still hold the game before the reset
+    int m_tipStatsFrame = 0;            // Last analytics frame pushed to the tip rules
     GameState m_lastGameState;
+    IngestStats m_ingestStats;
+    std::vector<DetectorStatus> m_detectorStatus;
+    FocusStats m_focusStats;
+    uint8_t m_focus = FOCUS_ALL;
+    bool m_focusChanged = false;
+    GameTimeline m_timeline;
+    size_t m_timelineGameCount = 0;
+    size_t m_timelineRequest = 0;
+    bool m_timelineRequested = false;
+    
+    // Rollups are fed deltas against the previous analytics snapshot of the
+    // local player and the opponent
+    StatsRollup m_rollup;
+    std::filesystem::path m_rollupFile;
+    int m_rollupPorts[2] = {0, 1};
+    std::string m_rollupOpponent;
+    std::string m_rollupMatchId;
+    LivePlayerStats m_rollupLast[2];
+    uint32_t m_rollupCombosSeen = 0;        // Closed combos already rolled up this game
+    bool m_rollupGameEnded = false;         // Closed by gameEnd; no reopening on trailing frames
+    int m_rollupLastFrame = 0;
     
     // Character information
     CharacterInfo m_player1Info;
@@ -224,10 +315,14 @@ private:
     int m_scrollPosition = 0;
     int m_selectedTab = 0;
     bool m_isMinimized = false;
+    bool m_catchUpFrame = false;
     
     // Animation system
-    std::vector<AnimationState> m_animations;
+    AnimationSystem m_animations;
     DWORD m_lastAnimationUpdate = 0;
+    AnimationHandle m_commentaryFlash = INVALID_ANIMATION;
+    size_t m_commentaryAdded = 0;
+    size_t m_commentaryFlashed = 0;
     
     // Enhanced visual state
     int m_hoverElement = -1;
@@ -270,6 +365,7 @@ private:
     int GetPanelHeight(PanelType panel) const;
     
     // Font and resource management
+    void EnsureGdiResources();
     void CreateFonts();
     void DestroyFonts();
     void CreateBrushes();
@@ -280,6 +376,7 @@ private:
     HBRUSH m_panelBrush = nullptr;
     HBRUSH m_accentBrush = nullptr;
     HPEN m_borderPen = nullptr;
+    bool m_gdiResourcesCreated = false;
     
     // Enhanced layout constants for better alignment
     static const int PANEL_MARGIN = 16;       // Increased for more breathing room
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// In-memory columns in Arrow's physical layout (little-endian values packed
+// back to back, UTF-8 strings as bytes plus int32 offsets), so they can be
+// written to Arrow IPC or scanned by the query kernels without conversion.
+
+enum class ColumnType : uint8_t {
+    UINT8,
+    UINT16,
+    INT32,
+    UINT32,
+    INT64,
+    FLOAT32,
+    FLOAT64,
+    UTF8
+};
+
+// Bytes per value; 0 for variable-width UTF8
+inline size_t ColumnTypeSize(ColumnType type) {
+    switch (type) {
+        case ColumnType::UINT8: return 1;
+        case ColumnType::UINT16: return 2;
+        case ColumnType::INT32: return 4;
+        case ColumnType::UINT32: return 4;
+        case ColumnType::INT64: return 8;
+        case ColumnType::FLOAT32: return 4;
+        case ColumnType::FLOAT64: return 8;
+        case ColumnType::UTF8: return 0;
+    }
+    return 0;
+}
+
+struct Column {
+    std::string name;
+    ColumnType type = ColumnType::INT32;
+    std::vector<uint8_t> data;          // Values, or the UTF-8 bytes of every string
+    std::vector<int32_t> offsets;       // UTF8 only: string i is data[offsets[i], offsets[i + 1])
+
+    template <typename T>
+    T* Values() { return reinterpret_cast<T*>(data.data()); }
+
+    template <typename T>
+    const T* Values() const { return reinterpret_cast<const T*>(data.data()); }
+
+    template <typename T>
+    void Append(T value) {
+        size_t size = data.size();
+        data.resize(size + sizeof(T));
+        memcpy(data.data() + size, &value, sizeof(T));
+    }
+
+    void AppendString(const std::string& text) {
+        if (offsets.empty()) {
+            offsets.push_back(0);
+        }
+        data.insert(data.end(), text.begin(), text.end());
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+};
+
+// Minimum and maximum of each BLOCK_ROWS-row block of a fixed-width column,
+// so a scan can rule a whole block in or out from two numbers
+struct ZoneMap {
+    static constexpr size_t BLOCK_ROWS = 1024;
+
+    std::vector<double> minimum;
+    std::vector<double> maximum;
+
+    size_t GetBlockCount() const { return minimum.size(); }
+
+    void Build(const Column& column, size_t rows) {
+        switch (column.type) {
+            case ColumnType::UINT8: Build(column.Values<uint8_t>(), rows); break;
+            case ColumnType::UINT16: Build(column.Values<uint16_t>(), rows); break;
+            case ColumnType::INT32: Build(column.Values<int32_t>(), rows); break;
+            case ColumnType::UINT32: Build(column.Values<uint32_t>(), rows); break;
+            case ColumnType::INT64: Build(column.Values<int64_t>(), rows); break;
+            case ColumnType::FLOAT32: Build(column.Values<float>(), rows); break;
+            case ColumnType::FLOAT64: Build(column.Values<double>(), rows); break;
+            case ColumnType::UTF8: minimum.clear(); maximum.clear(); break;
+        }
+    }
+
+private:
+    template <typename T>
+    void Build(const T* values, size_t rows) {
+        size_t blocks = (rows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+        minimum.resize(blocks);
+        maximum.resize(blocks);
+        for (size_t block = 0; block < blocks; block++) {
+            size_t begin = block * BLOCK_ROWS;
+            size_t end = begin + BLOCK_ROWS < rows ? begin + BLOCK_ROWS : rows;
+            T low = values[begin];
+            T high = values[begin];
+            for (size_t row = begin + 1; row < end; row++) {
+                low = values[row] < low ? values[row] : low;
+                high = values[row] > high ? values[row] : high;
+            }
+            minimum[block] = static_cast<double>(low);
+            maximum[block] = static_cast<double>(high);
+        }
+    }
+};
+
+struct ColumnTable {
+    size_t rows = 0;
+    std::vector<Column> columns;
+
+    Column& Add(const std::string& name, ColumnType type) {
+        columns.emplace_back();
+        columns.back().name = name;
+        columns.back().type = type;
+        return columns.back();
+    }
+
+    // Column index, or -1
+    int Find(const std::string& name) const {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i].name == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Fixed-width columns get rows values (new ones zeroed); UTF8 columns are untouched
+    void Resize(size_t newRows) {
+        for (Column& column : columns) {
+            if (column.type != ColumnType::UTF8) {
+                column.data.resize(newRows * ColumnTypeSize(column.type));
+            }
+        }
+        rows = newRows;
+    }
+};
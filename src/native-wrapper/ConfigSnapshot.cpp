@@ -0,0 +1,547 @@
+#include "ConfigSnapshot.h"
+#include "ContentHash.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+bool ReadWholeFile(const std::filesystem::path& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+std::string_view Trim(std::string_view text) {
+    const char* whitespace = " \t\r\n";
+    size_t start = text.find_first_not_of(whitespace);
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(whitespace);
+    return text.substr(start, end - start + 1);
+}
+
+void AppendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+} // namespace
+
+// Recursive-descent JSON reader that flattens straight into a snapshot
+class ConfigParser {
+public:
+    ConfigParser(std::string_view text, ConfigSnapshot& snapshot)
+        : m_text(text), m_snapshot(snapshot) {}
+
+    bool Parse(std::string& error) {
+        SkipWhitespace();
+        if (!Peek('{')) {
+            error = "config.json: top level must be an object";
+            return false;
+        }
+        if (!ParseObject("")) {
+            error = "config.json: " + m_error + " at offset " + std::to_string(m_pos);
+            return false;
+        }
+        SkipWhitespace();
+        if (m_pos != m_text.size()) {
+            error = "config.json: trailing characters at offset " + std::to_string(m_pos);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static const int MAX_DEPTH = 64;
+
+    bool Fail(const char* message) {
+        m_error = message;
+        return false;
+    }
+
+    void SkipWhitespace() {
+        while (m_pos < m_text.size() &&
+               (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\r' || m_text[m_pos] == '\n')) {
+            m_pos++;
+        }
+    }
+
+    bool Peek(char c) const {
+        return m_pos < m_text.size() && m_text[m_pos] == c;
+    }
+
+    bool Consume(char c) {
+        SkipWhitespace();
+        if (!Peek(c)) {
+            return false;
+        }
+        m_pos++;
+        return true;
+    }
+
+    bool ConsumeLiteral(std::string_view literal) {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        if (!Consume('"')) {
+            return Fail("expected string");
+        }
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            char escape = m_text[m_pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = 0;
+                    if (!ParseHex4(codePoint)) {
+                        return Fail("bad \\u escape");
+                    }
+                    // Surrogate pair
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00 && ConsumeLiteral("\\u")) {
+                        uint32_t low = 0;
+                        if (!ParseHex4(low) || low < 0xDC00 || low >= 0xE000) {
+                            return Fail("bad surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(out, codePoint);
+                    break;
+                }
+                default:
+                    return Fail("bad escape");
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseHex4(uint32_t& value) {
+        if (m_pos + 4 > m_text.size()) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = m_text[m_pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    bool ParseValue(const std::string& key) {
+        SkipWhitespace();
+        if (m_pos >= m_text.size()) {
+            return Fail("unexpected end of input");
+        }
+
+        ConfigValue value;
+        char c = m_text[m_pos];
+        if (c == '{') {
+            value.type = ConfigValue::OBJECT;
+            m_snapshot.Insert(key, value);
+            return ParseObject(key);
+        } else if (c == '[') {
+            value.type = ConfigValue::ARRAY;
+            m_snapshot.Insert(key, value);
+            return SkipArray();
+        } else if (c == '"') {
+            value.type = ConfigValue::STRING;
+            if (!ParseString(value.text)) {
+                return false;
+            }
+        } else if (ConsumeLiteral("true")) {
+            value.type = ConfigValue::BOOL;
+            value.boolean = true;
+        } else if (ConsumeLiteral("false")) {
+            value.type = ConfigValue::BOOL;
+        } else if (ConsumeLiteral("null")) {
+            value.type = ConfigValue::NUL;
+        } else {
+            // strtod needs a terminator; the number ends before the next delimiter
+            size_t end = m_text.find_first_of(",}] \t\r\n", m_pos);
+            std::string number(m_text.substr(m_pos, end == std::string_view::npos ? std::string_view::npos : end - m_pos));
+            char* parsedEnd = nullptr;
+            value.number = strtod(number.c_str(), &parsedEnd);
+            if (number.empty() || parsedEnd != number.c_str() + number.size()) {
+                return Fail("bad value");
+            }
+            value.type = ConfigValue::NUMBER;
+            m_pos += number.size();
+        }
+
+        m_snapshot.Insert(key, std::move(value));
+        return true;
+    }
+
+    bool ParseObject(const std::string& prefix) {
+        if (++m_depth > MAX_DEPTH) {
+            return Fail("nested too deeply");
+        }
+        Consume('{');
+        if (Consume('}')) {
+            m_depth--;
+            return true;
+        }
+        do {
+            std::string name;
+            if (!ParseString(name)) {
+                return false;
+            }
+            if (!Consume(':')) {
+                return Fail("expected ':'");
+            }
+            if (!ParseValue(prefix.empty() ? name : prefix + "." + name)) {
+                return false;
+            }
+        } while (Consume(','));
+        if (!Consume('}')) {
+            return Fail("expected '}'");
+        }
+        m_depth--;
+        return true;
+    }
+
+    // Arrays are only recorded as present; no config consumer indexes into them
+    bool SkipArray() {
+        if (++m_depth > MAX_DEPTH) {
+            return Fail("nested too deeply");
+        }
+        Consume('[');
+        if (Consume(']')) {
+            m_depth--;
+            return true;
+        }
+        do {
+            SkipWhitespace();
+            if (Peek('{') || Peek('[')) {
+                ConfigSnapshot scratch;
+                ConfigParser nested(m_text, scratch);
+                nested.m_pos = m_pos;
+                nested.m_depth = m_depth;
+                if (!nested.ParseValue("")) {
+                    m_error = nested.m_error;
+                    m_pos = nested.m_pos;
+                    return false;
+                }
+                m_pos = nested.m_pos;
+            } else {
+                std::string ignored;
+                if (Peek('"') ? !ParseString(ignored) : !ParseScalarInArray()) {
+                    return false;
+                }
+            }
+        } while (Consume(','));
+        if (!Consume(']')) {
+            return Fail("expected ']'");
+        }
+        m_depth--;
+        return true;
+    }
+
+    bool ParseScalarInArray() {
+        if (ConsumeLiteral("true") || ConsumeLiteral("false") || ConsumeLiteral("null")) {
+            return true;
+        }
+        size_t end = m_text.find_first_of(",] \t\r\n", m_pos);
+        if (end == m_pos || end == std::string_view::npos) {
+            return Fail("bad array element");
+        }
+        m_pos = end;
+        return true;
+    }
+
+    std::string_view m_text;
+    ConfigSnapshot& m_snapshot;
+    size_t m_pos = 0;
+    int m_depth = 0;
+    std::string m_error;
+};
+
+ConfigKey::ConfigKey(std::string_view name)
+    : name(name), hash(ContentHash::Hash64(name.data(), name.size())) {
+}
+
+std::unique_ptr<ConfigSnapshot> ConfigSnapshot::Load(const std::filesystem::path& jsonPath,
+                                                     const std::filesystem::path& envPath,
+                                                     uint64_t version, std::string& error) {
+    std::unique_ptr<ConfigSnapshot> snapshot(new ConfigSnapshot());
+    snapshot->m_version = version;
+
+    std::string contents;
+    if (ReadWholeFile(jsonPath, contents)) {
+        ConfigParser parser(contents, *snapshot);
+        if (!parser.Parse(error)) {
+            return nullptr;
+        }
+    }
+
+    // KEY=value lines; like the JS reader, the value ends at a second '='
+    if (ReadWholeFile(envPath, contents)) {
+        std::string_view rest(contents);
+        while (!rest.empty()) {
+            size_t newline = rest.find('\n');
+            std::string_view line = rest.substr(0, newline);
+            rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
+
+            size_t equals = line.find('=');
+            if (equals == std::string_view::npos) {
+                continue;
+            }
+            std::string_view value = line.substr(equals + 1);
+            value = value.substr(0, value.find('='));
+
+            ConfigValue entry;
+            entry.type = ConfigValue::STRING;
+            entry.text = std::string(Trim(value));
+            snapshot->Insert(std::string(Trim(line.substr(0, equals))), std::move(entry));
+        }
+    }
+
+    snapshot->BuildIndex();
+    return snapshot;
+}
+
+void ConfigSnapshot::Insert(const std::string& key, ConfigValue value) {
+    if (key.empty()) {
+        return;
+    }
+    ConfigKey hashed(key);
+    for (const Entry& entry : m_entries) {
+        if (entry.hash == hashed.hash && entry.key == key) {
+            return;
+        }
+    }
+    m_entries.push_back({key, hashed.hash, std::move(value)});
+}
+
+void ConfigSnapshot::BuildIndex() {
+    size_t slotCount = 16;
+    while (slotCount < m_entries.size() * 2) {
+        slotCount *= 2;
+    }
+    m_slots.assign(slotCount, EMPTY_SLOT);
+    m_slotMask = slotCount - 1;
+
+    for (uint32_t i = 0; i < m_entries.size(); i++) {
+        uint64_t slot = m_entries[i].hash & m_slotMask;
+        while (m_slots[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) & m_slotMask;
+        }
+        m_slots[slot] = i;
+    }
+}
+
+const ConfigValue* ConfigSnapshot::Find(const ConfigKey& key) const {
+    if (m_slots.empty()) {
+        return nullptr;
+    }
+    for (uint64_t slot = key.hash & m_slotMask; m_slots[slot] != EMPTY_SLOT; slot = (slot + 1) & m_slotMask) {
+        const Entry& entry = m_entries[m_slots[slot]];
+        if (entry.hash == key.hash && entry.key == key.name) {
+            return &entry.value;
+        }
+    }
+    return nullptr;
+}
+
+std::string ConfigSnapshot::GetString(const ConfigKey& key, const std::string& defaultValue) const {
+    const ConfigValue* value = Find(key);
+    if (!value) {
+        return defaultValue;
+    }
+    switch (value->type) {
+        case ConfigValue::STRING:
+            return value->text;
+        case ConfigValue::BOOL:
+            return value->boolean ? "true" : "false";
+        case ConfigValue::NUMBER: {
+            std::ostringstream text;
+            text << value->number;
+            return text.str();
+        }
+        default:
+            return defaultValue;
+    }
+}
+
+double ConfigSnapshot::GetNumber(const ConfigKey& key, double defaultValue) const {
+    const ConfigValue* value = Find(key);
+    if (!value) {
+        return defaultValue;
+    }
+    if (value->type == ConfigValue::NUMBER) {
+        return value->number;
+    }
+    if (value->type == ConfigValue::STRING) {
+        char* end = nullptr;
+        double parsed = strtod(value->text.c_str(), &end);
+        return end == value->text.c_str() ? defaultValue : parsed;
+    }
+    return defaultValue;
+}
+
+int ConfigSnapshot::GetInt(const ConfigKey& key, int defaultValue) const {
+    return static_cast<int>(GetNumber(key, defaultValue));
+}
+
+bool ConfigSnapshot::GetBool(const ConfigKey& key, bool defaultValue) const {
+    const ConfigValue* value = Find(key);
+    if (!value) {
+        return defaultValue;
+    }
+    switch (value->type) {
+        case ConfigValue::BOOL:
+            return value->boolean;
+        case ConfigValue::STRING:
+            return value->text == "true";
+        case ConfigValue::NUMBER:
+            return value->number != 0.0;
+        default:
+            return defaultValue;
+    }
+}
+
+ConfigStore::ConfigStore(const std::filesystem::path& jsonPath, const std::filesystem::path& envPath)
+    : m_jsonPath(jsonPath), m_envPath(envPath) {
+    if (!Reload()) {
+        // Never leave readers without a snapshot
+        std::string error;
+        m_snapshots.push_back(ConfigSnapshot::Load({}, {}, 0, error));
+        m_current.store(m_snapshots.back().get(), std::memory_order_release);
+    }
+}
+
+ConfigStore::~ConfigStore() {
+    StopWatching();
+}
+
+bool ConfigStore::Reload() {
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+
+    // Taken before reading, so an edit racing the read triggers another reload
+    FilesChanged();
+
+    const ConfigSnapshot* previous = m_current.load(std::memory_order_relaxed);
+    uint64_t version = previous ? previous->GetVersion() + 1 : 1;
+
+    std::string error;
+    std::unique_ptr<ConfigSnapshot> snapshot = ConfigSnapshot::Load(m_jsonPath, m_envPath, version, error);
+    if (!snapshot) {
+        LOG_WARN("Config not reloaded: {}", error);
+        return false;
+    }
+
+    m_snapshots.push_back(std::move(snapshot));
+    m_current.store(m_snapshots.back().get(), std::memory_order_release);
+    LOG_INFO("Config version {} loaded ({} keys)", version, m_snapshots.back()->GetKeyCount());
+
+    if (previous && m_changeCallback) {
+        m_changeCallback(Current());
+    }
+    return true;
+}
+
+void ConfigStore::StartWatching(unsigned pollIntervalMs) {
+    if (m_watchThread.joinable()) {
+        return;
+    }
+    m_stopWatching = false;
+    m_watchThread = std::thread(&ConfigStore::WatchThreadProc, this, pollIntervalMs);
+}
+
+void ConfigStore::StopWatching() {
+    {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        m_stopWatching = true;
+    }
+    m_watchCondition.notify_all();
+    if (m_watchThread.joinable()) {
+        m_watchThread.join();
+    }
+}
+
+void ConfigStore::SetChangeCallback(ChangeCallback callback) {
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+    m_changeCallback = std::move(callback);
+}
+
+void ConfigStore::WatchThreadProc(unsigned pollIntervalMs) {
+    std::unique_lock<std::mutex> lock(m_watchMutex);
+    while (!m_watchCondition.wait_for(lock, std::chrono::milliseconds(pollIntervalMs),
+                                      [this] { return m_stopWatching; })) {
+        lock.unlock();
+        bool changed;
+        {
+            std::lock_guard<std::mutex> reloadLock(m_reloadMutex);
+            changed = FilesChanged();
+        }
+        if (changed) {
+            Reload();
+        }
+        lock.lock();
+    }
+}
+
+bool ConfigStore::FilesChanged() {
+    std::error_code error;
+    auto jsonTime = std::filesystem::last_write_time(m_jsonPath, error);
+    if (error) {
+        jsonTime = std::filesystem::file_time_type::min();
+    }
+    auto envTime = std::filesystem::last_write_time(m_envPath, error);
+    if (error) {
+        envTime = std::filesystem::file_time_type::min();
+    }
+
+    bool changed = jsonTime != m_jsonTime || envTime != m_envTime;
+    m_jsonTime = jsonTime;
+    m_envTime = envTime;
+    return changed;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Immutable, pre-indexed view of config.json and the legacy .env file, the
+// same files and lookup order as utils/configManager.js: config.json first
+// (nested keys flattened to "slippi.address"), then .env.
+
+struct ConfigValue {
+    enum Type {
+        NUL,
+        BOOL,
+        NUMBER,
+        STRING,
+        OBJECT,
+        ARRAY
+    };
+
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;   // Strings, and the raw text of .env values
+};
+
+// A key with its hash computed once, so hot paths can keep it in a static:
+//   static const ConfigKey SLIPPI_PORT("slippi.port");
+struct ConfigKey {
+    explicit ConfigKey(std::string_view name);
+
+    std::string name;
+    uint64_t hash;
+};
+
+class ConfigSnapshot {
+public:
+    // Parses both files; a missing file is not an error, malformed JSON is
+    static std::unique_ptr<ConfigSnapshot> Load(const std::filesystem::path& jsonPath,
+                                                const std::filesystem::path& envPath,
+                                                uint64_t version, std::string& error);
+
+    const ConfigValue* Find(const ConfigKey& key) const;
+    const ConfigValue* Find(std::string_view key) const { return Find(ConfigKey(key)); }
+
+    // Typed reads; strings from .env are converted the way the JS side does
+    std::string GetString(const ConfigKey& key, const std::string& defaultValue = "") const;
+    double GetNumber(const ConfigKey& key, double defaultValue = 0.0) const;
+    int GetInt(const ConfigKey& key, int defaultValue = 0) const;
+    bool GetBool(const ConfigKey& key, bool defaultValue = false) const;
+
+    uint64_t GetVersion() const { return m_version; }
+    size_t GetKeyCount() const { return m_entries.size(); }
+
+private:
+    ConfigSnapshot() = default;
+
+    // First insert of a key wins, which gives config.json priority over .env
+    void Insert(const std::string& key, ConfigValue value);
+    void BuildIndex();
+
+    struct Entry {
+        std::string key;
+        uint64_t hash;
+        ConfigValue value;
+    };
+
+    uint64_t m_version = 0;
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_slots;   // Open addressing into m_entries, EMPTY_SLOT when free
+    uint64_t m_slotMask = 0;
+
+    friend class ConfigParser;
+};
+
+// Owns the current snapshot and swaps in a new one when either file changes.
+// Reads are a single atomic pointer load; superseded snapshots are kept until
+// the store is destroyed so references handed out never dangle (config edits
+// are rare, so this is a handful of small objects at most).
+class ConfigStore {
+public:
+    using ChangeCallback = std::function<void(const ConfigSnapshot&)>;
+
+    ConfigStore(const std::filesystem::path& jsonPath, const std::filesystem::path& envPath);
+    ~ConfigStore();
+
+    const ConfigSnapshot& Current() const { return *m_current.load(std::memory_order_acquire); }
+
+    // Re-reads both files; on a parse error the current snapshot stays in place
+    bool Reload();
+
+    // Polls the files' modification times on a background thread
+    void StartWatching(unsigned pollIntervalMs = 500);
+    void StopWatching();
+
+    // Called on the watcher thread after each swap
+    void SetChangeCallback(ChangeCallback callback);
+
+private:
+    void WatchThreadProc(unsigned pollIntervalMs);
+    bool FilesChanged();
+
+    std::filesystem::path m_jsonPath;
+    std::filesystem::path m_envPath;
+
+    std::atomic<const ConfigSnapshot*> m_current{nullptr};
+    std::vector<std::unique_ptr<ConfigSnapshot>> m_snapshots;
+    std::mutex m_reloadMutex;
+    ChangeCallback m_changeCallback;
+
+    std::filesystem::file_time_type m_jsonTime;
+    std::filesystem::file_time_type m_envTime;
+
+    std::thread m_watchThread;
+    std::mutex m_watchMutex;
+    std::condition_variable m_watchCondition;
+    bool m_stopWatching = false;
+};
@@ -0,0 +1,171 @@
+#include "ContentHash.h"
+#include <cstring>
+
+namespace ContentHash {
+
+namespace {
+
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME64_2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * PRIME64_1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= Round(0, accumulator);
+    return hash * PRIME64_1 + PRIME64_4;
+}
+
+// Mixes the trailing (<32 byte) input and applies the final avalanche
+uint64_t Finalize(uint64_t hash, const uint8_t* p, size_t length) {
+    while (length >= 8) {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+        length -= 8;
+    }
+
+    if (length >= 4) {
+        hash ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+        hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        length -= 4;
+    }
+
+    while (length > 0) {
+        hash ^= (*p) * PRIME64_5;
+        hash = RotateLeft(hash, 11) * PRIME64_1;
+        p++;
+        length--;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Converge(const uint64_t accumulators[4]) {
+    uint64_t hash = RotateLeft(accumulators[0], 1) + RotateLeft(accumulators[1], 7) +
+                    RotateLeft(accumulators[2], 12) + RotateLeft(accumulators[3], 18);
+    for (int i = 0; i < 4; i++) {
+        hash = MergeRound(hash, accumulators[i]);
+    }
+    return hash;
+}
+
+} // namespace
+
+uint64_t Hash64(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        uint64_t accumulators[4] = {
+            seed + PRIME64_1 + PRIME64_2,
+            seed + PRIME64_2,
+            seed,
+            seed - PRIME64_1
+        };
+
+        // Process 32-byte stripes
+        const uint8_t* limit = end - 32;
+        do {
+            accumulators[0] = Round(accumulators[0], Read64(p));
+            accumulators[1] = Round(accumulators[1], Read64(p + 8));
+            accumulators[2] = Round(accumulators[2], Read64(p + 16));
+            accumulators[3] = Round(accumulators[3], Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = Converge(accumulators);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+
+    hash += static_cast<uint64_t>(length);
+    return Finalize(hash, p, static_cast<size_t>(end - p));
+}
+
+Hasher::Hasher(uint64_t seed) {
+    Reset(seed);
+}
+
+void Hasher::Reset(uint64_t seed) {
+    m_seed = seed;
+    m_accumulators[0] = seed + PRIME64_1 + PRIME64_2;
+    m_accumulators[1] = seed + PRIME64_2;
+    m_accumulators[2] = seed;
+    m_accumulators[3] = seed - PRIME64_1;
+    m_totalLength = 0;
+    m_bufferSize = 0;
+}
+
+void Hasher::Update(const void* data, size_t length) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_totalLength += length;
+
+    // Top up a partially filled stripe first
+    if (m_bufferSize > 0) {
+        size_t needed = sizeof(m_buffer) - m_bufferSize;
+        if (length < needed) {
+            memcpy(m_buffer + m_bufferSize, p, length);
+            m_bufferSize += length;
+            return;
+        }
+
+        memcpy(m_buffer + m_bufferSize, p, needed);
+        for (int i = 0; i < 4; i++) {
+            m_accumulators[i] = Round(m_accumulators[i], Read64(m_buffer + i * 8));
+        }
+        p += needed;
+        length -= needed;
+        m_bufferSize = 0;
+    }
+
+    while (length >= 32) {
+        for (int i = 0; i < 4; i++) {
+            m_accumulators[i] = Round(m_accumulators[i], Read64(p + i * 8));
+        }
+        p += 32;
+        length -= 32;
+    }
+
+    if (length > 0) {
+        memcpy(m_buffer, p, length);
+        m_bufferSize = length;
+    }
+}
+
+uint64_t Hasher::Digest() const {
+    uint64_t hash = (m_totalLength >= 32) ? Converge(m_accumulators) : m_seed + PRIME64_5;
+    hash += m_totalLength;
+    return Finalize(hash, m_buffer, m_bufferSize);
+}
+
+} // namespace ContentHash
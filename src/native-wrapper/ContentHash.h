@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// XXH64 content hashing used to key cached analysis results
+namespace ContentHash {
+
+// One-shot hash of a contiguous buffer
+uint64_t Hash64(const void* data, size_t length, uint64_t seed = 0);
+
+// Incremental hasher for data that arrives in pieces (produces the same
+// value as Hash64 over the concatenated input)
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0);
+
+    void Reset(uint64_t seed = 0);
+    void Update(const void* data, size_t length);
+    uint64_t Digest() const;
+
+private:
+    uint64_t m_accumulators[4];
+    uint64_t m_seed;
+    uint64_t m_totalLength;
+    uint8_t m_buffer[32];
+    size_t m_bufferSize;
+};
+
+} // namespace ContentHash
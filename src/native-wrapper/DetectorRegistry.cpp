@@ -0,0 +1,120 @@
+#include "DetectorRegistry.h"
+#include <cctype>
+#include <chrono>
+
+namespace {
+
+const char* const FOCUS_NAMES[] = {"neutral", "combos", "edgeguarding", "recovery", "review"};
+const char* const FIELD_NAMES[] = {"position", "percent", "stocks", "character", "action", "hitstun", "offstage", "facing"};
+
+template <size_t N>
+std::string FlagsToString(uint32_t flags, const char* const (&names)[N]) {
+    std::string text;
+    for (size_t bit = 0; bit < N; bit++) {
+        if (flags & (1u << bit)) {
+            if (!text.empty()) {
+                text += ", ";
+            }
+            text += names[bit];
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+uint8_t ParseFocus(const std::string& text) {
+    uint8_t focus = 0;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+
+        std::string name;
+        for (size_t i = start; i < end; i++) {
+            if (!std::isspace(static_cast<unsigned char>(text[i]))) {
+                name += static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+            }
+        }
+        if (name == "all") {
+            return FOCUS_ALL;
+        }
+        for (size_t bit = 0; bit < sizeof(FOCUS_NAMES) / sizeof(FOCUS_NAMES[0]); bit++) {
+            if (name == FOCUS_NAMES[bit]) {
+                focus |= static_cast<uint8_t>(1u << bit);
+            }
+        }
+        start = end + 1;
+    }
+    return focus != 0 ? focus : static_cast<uint8_t>(FOCUS_ALL);
+}
+
+std::string FocusToString(uint8_t focus) {
+    return (focus & FOCUS_ALL) == FOCUS_ALL ? "all" : FlagsToString(focus, FOCUS_NAMES);
+}
+
+std::string FieldsToString(uint16_t fields) {
+    return FlagsToString(fields, FIELD_NAMES);
+}
+
+DetectorHandle DetectorRegistry::Register(const DetectorInfo& info, FrameFunction observe, GameFunction beginGame) {
+    Detector detector;
+    detector.info = info;
+    detector.observe = std::move(observe);
+    detector.beginGame = std::move(beginGame);
+    detector.enabled = info.focus == 0 || (info.focus & m_focus) != 0;
+    m_detectors.push_back(std::move(detector));
+    return static_cast<DetectorHandle>(m_detectors.size() - 1);
+}
+
+void DetectorRegistry::SetFocus(uint8_t focus) {
+    m_focus = focus;
+    for (Detector& detector : m_detectors) {
+        detector.enabled = detector.info.focus == 0 || (detector.info.focus & focus) != 0;
+    }
+}
+
+void DetectorRegistry::Observe(const GameState& state) {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start = Clock::now();
+    for (Detector& detector : m_detectors) {
+        if (!detector.enabled) {
+            continue;
+        }
+        detector.observe(state);
+
+        // Each detector's end is the next one's start, one clock read apiece
+        Clock::time_point end = Clock::now();
+        uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        detector.frames++;
+        detector.totalNs += elapsed;
+        detector.recentNs += (static_cast<double>(elapsed) - detector.recentNs) * RECENT_WEIGHT;
+        start = end;
+    }
+}
+
+void DetectorRegistry::BeginGame() {
+    for (Detector& detector : m_detectors) {
+        if (detector.beginGame) {
+            detector.beginGame();
+        }
+    }
+}
+
+std::vector<DetectorStatus> DetectorRegistry::GetStatus() const {
+    std::vector<DetectorStatus> status;
+    status.reserve(m_detectors.size());
+    for (const Detector& detector : m_detectors) {
+        DetectorStatus entry;
+        entry.info = detector.info;
+        entry.enabled = detector.enabled;
+        entry.frames = detector.frames;
+        entry.averageNs = detector.frames > 0 ? static_cast<double>(detector.totalNs) / detector.frames : 0.0;
+        entry.recentNs = detector.recentNs;
+        status.push_back(std::move(entry));
+    }
+    return status;
+}
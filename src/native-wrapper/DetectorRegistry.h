@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "GameState.h"
+
+// The per-frame analytics that run on the live stream, each registered with
+// what it reads and what it produces, and timed on every frame it runs. A
+// focus mode, a set of the coaching focus areas, turns off the detectors no
+// area in it needs; detectors with no focus area always run.
+//
+//   DetectorInfo info;
+//   info.name = "edgeguards";
+//   info.outputs = "edgeguards, edgeguard kills";
+//   info.fields = FIELD_PERCENT | FIELD_STOCKS | FIELD_OFFSTAGE;
+//   info.focus = FOCUS_EDGEGUARDING;
+//   registry.Register(info, [&](const GameState& state) { ... });
+//   registry.SetFocus(FOCUS_COMBOS | FOCUS_EDGEGUARDING);
+//   for each frame: registry.Observe(state);
+//
+// Not thread-safe; GameDataInterface calls it under its game state lock.
+
+enum FocusArea : uint8_t {
+    FOCUS_NEUTRAL = 1,
+    FOCUS_COMBOS = 2,
+    FOCUS_EDGEGUARDING = 4,
+    FOCUS_RECOVERY = 8,
+    FOCUS_REVIEW = 16,      // Post-game review: the frame history behind the game timeline
+    FOCUS_ALL = 31
+};
+
+// GameState fields a detector reads
+enum FrameField : uint16_t {
+    FIELD_POSITION = 1,
+    FIELD_PERCENT = 2,
+    FIELD_STOCKS = 4,
+    FIELD_CHARACTER = 8,
+    FIELD_ACTION = 16,
+    FIELD_HITSTUN = 32,
+    FIELD_OFFSTAGE = 64,
+    FIELD_FACING = 128
+};
+
+// Focus flags from a list like "combos, edgeguarding" ("all" or an empty
+// list = FOCUS_ALL); unknown names are skipped
+uint8_t ParseFocus(const std::string& text);
+
+// "neutral, combos" for flags; "all" for FOCUS_ALL
+std::string FocusToString(uint8_t focus);
+
+// Field flags as "percent, stocks"
+std::string FieldsToString(uint16_t fields);
+
+struct DetectorInfo {
+    std::string name;
+    std::string outputs;    // What it produces, for the Controls panel
+    uint16_t fields = 0;    // FrameField flags it reads
+    uint8_t focus = 0;      // FocusArea flags it serves; 0 = always runs
+};
+
+struct DetectorStatus {
+    DetectorInfo info;
+    bool enabled = false;
+    uint64_t frames = 0;            // Frames it has run on
+    double averageNs = 0.0;         // Per frame, over every frame it ran on
+    double recentNs = 0.0;          // Per frame, moving average over about the last second
+};
+
+using DetectorHandle = int;
+
+class DetectorRegistry {
+public:
+    using FrameFunction = std::function<void(const GameState&)>;
+    using GameFunction = std::function<void()>;
+
+    // beginGame runs on every game start, enabled or not, so detectors that
+    // number games stay in step
+    DetectorHandle Register(const DetectorInfo& info, FrameFunction observe, GameFunction beginGame = GameFunction());
+
+    void SetFocus(uint8_t focus);
+    uint8_t GetFocus() const { return m_focus; }
+    bool IsEnabled(DetectorHandle handle) const { return m_detectors[handle].enabled; }
+
+    // Runs the enabled detectors on a frame, timing each
+    void Observe(const GameState& state);
+    void BeginGame();
+
+    std::vector<DetectorStatus> GetStatus() const;
+
+private:
+    static constexpr double RECENT_WEIGHT = 1.0 / 60.0;
+
+    struct Detector {
+        DetectorInfo info;
+        FrameFunction observe;
+        GameFunction beginGame;
+        bool enabled = true;
+        uint64_t frames = 0;
+        uint64_t totalNs = 0;
+        double recentNs = 0.0;
+    };
+
+    std::vector<Detector> m_detectors;
+    uint8_t m_focus = FOCUS_ALL;
+};
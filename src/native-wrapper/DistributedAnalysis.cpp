@@ -0,0 +1,527 @@
+#include "DistributedAnalysis.h"
+#include "Logger.h"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+const SocketHandle NO_SOCKET = INVALID_SOCKET;
+const int SEND_FLAGS = 0;
+
+void CloseSocket(SocketHandle socket) {
+    closesocket(socket);
+}
+#else
+using SocketHandle = int;
+const SocketHandle NO_SOCKET = -1;
+const int SEND_FLAGS = MSG_NOSIGNAL;  // Report a dropped peer as an error instead of SIGPIPE
+
+void CloseSocket(SocketHandle socket) {
+    close(socket);
+}
+#endif
+
+// Winsock must be initialized once per process before any socket call
+class NetworkScope {
+public:
+    NetworkScope() {
+#ifdef _WIN32
+        WSADATA data;
+        m_ok = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#endif
+    }
+
+    ~NetworkScope() {
+#ifdef _WIN32
+        if (m_ok) {
+            WSACleanup();
+        }
+#endif
+    }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    bool m_ok = true;
+};
+
+std::string ToHex(const std::vector<uint8_t>& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (uint8_t byte : bytes) {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0xF]);
+    }
+    return hex;
+}
+
+bool FromHex(const std::string& hex, std::vector<uint8_t>& bytes) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    bytes.resize(hex.size() / 2);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        int high = nibble(hex[i * 2]);
+        int low = nibble(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+} // namespace
+
+// Newline-delimited message stream over one socket
+struct WorkerConnection {
+    SocketHandle socket = NO_SOCKET;
+    int id = -1;
+    bool accepted = false;      // Sent a HELLO the coordinator agreed to
+    std::string name;
+    std::string inbox;
+
+    ~WorkerConnection() {
+        Close();
+    }
+
+    void Close() {
+        if (socket != NO_SOCKET) {
+            CloseSocket(socket);
+            socket = NO_SOCKET;
+        }
+    }
+
+    bool SendLine(const std::string& line) {
+        std::string message = line + "\n";
+        size_t sent = 0;
+        while (sent < message.size()) {
+            int result = send(socket, message.data() + sent, static_cast<int>(message.size() - sent), SEND_FLAGS);
+            if (result <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    // One recv call; false once the peer has gone away
+    bool Receive() {
+        char buffer[4096];
+        int received = recv(socket, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return false;
+        }
+        inbox.append(buffer, static_cast<size_t>(received));
+        return true;
+    }
+
+    bool PopLine(std::string& line) {
+        size_t pos = inbox.find('\n');
+        if (pos == std::string::npos) {
+            return false;
+        }
+        line = inbox.substr(0, pos);
+        inbox.erase(0, pos + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    bool ReadLine(std::string& line) {
+        while (!PopLine(line)) {
+            if (!Receive()) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+AnalysisCoordinator::AnalysisCoordinator(const std::vector<std::filesystem::path>& replays,
+                                         const DistributedOptions& options)
+    : m_options(options), m_results(replays.size()), m_items(replays.size()) {
+    for (size_t i = 0; i < replays.size(); i++) {
+        m_results[i].path = replays[i];
+        m_items[i].queued = true;
+        m_pending.push_back(i);
+    }
+    m_options.shardSize = std::max<size_t>(1, m_options.shardSize);
+}
+
+AnalysisCoordinator::~AnalysisCoordinator() = default;
+
+bool AnalysisCoordinator::Run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    NetworkScope network;
+    if (!network.IsOk()) {
+        LOG_ERROR("Failed to initialize networking");
+        return false;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICHOST | AI_PASSIVE;
+    addrinfo* resolved = nullptr;
+    if (getaddrinfo(m_options.bindAddress.c_str(), nullptr, &hints, &resolved) != 0 || !resolved) {
+        LOG_ERROR("Invalid coordinator bind address: {}", m_options.bindAddress);
+        return false;
+    }
+    sockaddr_in address = *reinterpret_cast<sockaddr_in*>(resolved->ai_addr);
+    address.sin_port = htons(m_options.port);
+    freeaddrinfo(resolved);
+
+    // Anyone who can connect gets replay paths and can send results, so
+    // listening beyond this machine needs a token
+    bool loopback = (ntohl(address.sin_addr.s_addr) >> 24) == 127;
+    if (!loopback && m_options.token.empty()) {
+        LOG_ERROR("Listening on {} needs a token (--token)", m_options.bindAddress);
+        return false;
+    }
+
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == NO_SOCKET) {
+        LOG_ERROR("Failed to create coordinator socket");
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        LOG_ERROR("Failed to listen on {}:{}", m_options.bindAddress, m_options.port);
+        CloseSocket(listener);
+        return false;
+    }
+
+    LOG_INFO("Coordinator listening on {}:{} with {} replays", m_options.bindAddress, m_options.port,
+             m_items.size());
+
+    while (m_doneCount < m_items.size()) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(listener, &readSet);
+        SocketHandle maxSocket = listener;
+        for (const auto& worker : m_workers) {
+            FD_SET(worker->socket, &readSet);
+            maxSocket = std::max(maxSocket, worker->socket);
+        }
+
+        timeval timeout = {1, 0};
+        int ready = select(static_cast<int>(maxSocket + 1), &readSet, nullptr, nullptr, &timeout);
+        if (ready < 0) {
+            LOG_ERROR("Coordinator select failed");
+            break;
+        }
+
+        if (ready > 0 && FD_ISSET(listener, &readSet)) {
+            SocketHandle client = accept(listener, nullptr, nullptr);
+            if (client != NO_SOCKET) {
+                auto worker = std::make_unique<WorkerConnection>();
+                worker->socket = client;
+                worker->id = m_nextWorkerId++;
+                m_workers.push_back(std::move(worker));
+            }
+        }
+
+        for (size_t i = 0; i < m_workers.size();) {
+            WorkerConnection& worker = *m_workers[i];
+            bool alive = true;
+
+            if (ready > 0 && FD_ISSET(worker.socket, &readSet)) {
+                alive = worker.Receive();
+                std::string line;
+                while (alive && worker.PopLine(line)) {
+                    alive = HandleLine(worker, line);
+                }
+            }
+
+            if (!alive) {
+                // Worker crashed, disconnected or was rejected; its unfinished items go back in the queue
+                LOG_WARN("Worker {} lost", worker.id);
+                ReleaseWorkerItems(worker.id);
+                m_workers.erase(m_workers.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            i++;
+        }
+
+        RequeueExpiredItems();
+    }
+
+    // Let idle workers exit cleanly
+    for (auto& worker : m_workers) {
+        worker->SendLine("DONE");
+    }
+    m_workers.clear();
+    CloseSocket(listener);
+
+    m_stats.total = m_items.size();
+    m_stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return m_doneCount == m_items.size();
+}
+
+bool AnalysisCoordinator::HandleLine(WorkerConnection& worker, const std::string& line) {
+    if (!worker.accepted) {
+        return line.compare(0, 6, "HELLO ") == 0 && AcceptWorker(worker, line.substr(6));
+    }
+
+    if (line == "NEXT") {
+        AssignShard(worker);
+    } else if (line.compare(0, 7, "RESULT ") == 0) {
+        RecordResult(worker, line);
+    }
+    return true;
+}
+
+bool AnalysisCoordinator::AcceptWorker(WorkerConnection& worker, const std::string& hello) {
+    std::istringstream stream(hello);
+    uint32_t version = 0;
+    size_t summarySize = 0;
+    std::string token;
+    if (!(stream >> version >> summarySize >> token)) {
+        worker.SendLine("REJECT bad HELLO");
+        LOG_WARN("Worker {} rejected: bad HELLO", worker.id);
+        return false;
+    }
+    std::getline(stream >> std::ws, worker.name);
+
+    // Summaries travel as raw bytes, so both sides need the same layout
+    if (version != REPLAY_ANALYZER_VERSION || summarySize != sizeof(ReplaySummary)) {
+        worker.SendLine("REJECT analyzer version " + std::to_string(REPLAY_ANALYZER_VERSION) + " expected");
+        LOG_WARN("Worker {} ({}) rejected: analyzer version {} with {} byte summaries, expected {} with {}",
+                 worker.id, worker.name, version, summarySize, REPLAY_ANALYZER_VERSION, sizeof(ReplaySummary));
+        return false;
+    }
+
+    if (token != (m_options.token.empty() ? "-" : m_options.token)) {
+        worker.SendLine("REJECT wrong token");
+        LOG_WARN("Worker {} ({}) rejected: wrong token", worker.id, worker.name);
+        return false;
+    }
+
+    worker.accepted = true;
+    LOG_INFO("Worker {} connected: {}", worker.id, worker.name);
+    return true;
+}
+
+void AnalysisCoordinator::AssignShard(WorkerConnection& worker) {
+    if (m_doneCount == m_items.size()) {
+        worker.SendLine("DONE");
+        return;
+    }
+
+    std::vector<size_t> shard;
+    auto now = std::chrono::steady_clock::now();
+    while (!m_pending.empty() && shard.size() < m_options.shardSize) {
+        size_t index = m_pending.front();
+        m_pending.pop_front();
+        m_items[index].queued = false;
+
+        // Requeued items may have been finished by their original worker since
+        if (m_items[index].state == ItemState::DONE) {
+            continue;
+        }
+
+        m_items[index].state = ItemState::ASSIGNED;
+        m_items[index].workerId = worker.id;
+        m_items[index].assignedAt = now;
+        shard.push_back(index);
+    }
+
+    if (shard.empty()) {
+        worker.SendLine("WAIT");
+        return;
+    }
+
+    std::ostringstream message;
+    message << "SHARD " << shard.size();
+    for (size_t index : shard) {
+        message << "\n" << index << "\t" << m_results[index].path.u8string();
+    }
+    worker.SendLine(message.str());
+}
+
+void AnalysisCoordinator::RecordResult(WorkerConnection& worker, const std::string& line) {
+    std::istringstream stream(line.substr(7));
+    size_t index = 0;
+    int status = 0;
+    std::string hex;
+    if (!(stream >> index >> status >> hex) || index >= m_items.size()) {
+        return;
+    }
+
+    // Duplicate results from a reassigned item are ignored
+    if (m_items[index].state == ItemState::DONE) {
+        return;
+    }
+
+    BatchResult& result = m_results[index];
+    std::vector<uint8_t> blob;
+    result.succeeded = status != 0 && FromHex(hex, blob) && ReplaySummary::Deserialize(blob, result.summary);
+    result.fromCache = status == 2;
+
+    if (!result.succeeded) {
+        m_stats.failed++;
+    } else {
+        m_totals.Add(result.summary);
+        if (result.fromCache) {
+            m_stats.cacheHits++;
+        } else {
+            m_stats.analyzed++;
+        }
+    }
+
+    m_items[index].state = ItemState::DONE;
+    m_items[index].workerId = worker.id;
+    m_doneCount++;
+}
+
+void AnalysisCoordinator::ReleaseWorkerItems(int workerId) {
+    for (size_t i = 0; i < m_items.size(); i++) {
+        if (m_items[i].state == ItemState::ASSIGNED && m_items[i].workerId == workerId) {
+            m_items[i].state = ItemState::PENDING;
+            m_items[i].workerId = -1;
+            if (!m_items[i].queued) {
+                m_items[i].queued = true;
+                m_pending.push_front(i);
+                m_reassigned++;
+            }
+        }
+    }
+}
+
+void AnalysisCoordinator::RequeueExpiredItems() {
+    auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(m_options.itemTimeoutSeconds);
+    for (size_t i = 0; i < m_items.size(); i++) {
+        // Leave the item marked ASSIGNED so whichever worker finishes first wins;
+        // one already waiting in the queue stays there once
+        if (m_items[i].state == ItemState::ASSIGNED && !m_items[i].queued && m_items[i].assignedAt < deadline) {
+            m_items[i].queued = true;
+            m_pending.push_back(i);
+            m_reassigned++;
+        }
+    }
+}
+
+AnalysisWorker::AnalysisWorker(const std::string& host, uint16_t port, const std::string& token,
+                               BatchAnalyzer& analyzer)
+    : m_host(host), m_port(port), m_token(token), m_analyzer(analyzer) {
+}
+
+bool AnalysisWorker::Run() {
+    NetworkScope network;
+    if (!network.IsOk()) {
+        LOG_ERROR("Failed to initialize networking");
+        return false;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    std::string port = std::to_string(m_port);
+    if (getaddrinfo(m_host.c_str(), port.c_str(), &hints, &addresses) != 0 || !addresses) {
+        LOG_ERROR("Failed to resolve coordinator address");
+        return false;
+    }
+
+    WorkerConnection connection;
+    connection.socket = socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+    bool connected = connection.socket != NO_SOCKET &&
+                     connect(connection.socket, addresses->ai_addr, static_cast<int>(addresses->ai_addrlen)) == 0;
+    freeaddrinfo(addresses);
+
+    if (!connected) {
+        LOG_ERROR("Failed to connect to coordinator");
+        return false;
+    }
+
+    char hostName[256] = {0};
+    gethostname(hostName, sizeof(hostName) - 1);
+    connection.SendLine("HELLO " + std::to_string(REPLAY_ANALYZER_VERSION) + " " +
+                        std::to_string(sizeof(ReplaySummary)) + " " + (m_token.empty() ? "-" : m_token) + " " +
+                        hostName);
+
+    for (;;) {
+        std::string line;
+        if (!connection.SendLine("NEXT") || !connection.ReadLine(line)) {
+            LOG_WARN("Coordinator connection lost");
+            return false;
+        }
+
+        if (line == "DONE") {
+            break;
+        }
+
+        if (line.compare(0, 7, "REJECT ") == 0) {
+            LOG_ERROR("Coordinator rejected this worker: {}", line.substr(7));
+            return false;
+        }
+
+        if (line == "WAIT") {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        if (line.compare(0, 6, "SHARD ") != 0) {
+            continue;
+        }
+
+        size_t count = std::stoul(line.substr(6));
+        std::vector<size_t> indices;
+        std::vector<std::filesystem::path> paths;
+        for (size_t i = 0; i < count; i++) {
+            if (!connection.ReadLine(line)) {
+                return false;
+            }
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) {
+                continue;
+            }
+            indices.push_back(std::stoul(line.substr(0, tab)));
+            paths.push_back(std::filesystem::u8path(line.substr(tab + 1)));
+        }
+
+        std::vector<BatchResult> results = m_analyzer.Run(paths);
+        for (size_t i = 0; i < results.size(); i++) {
+            int status = !results[i].succeeded ? 0 : (results[i].fromCache ? 2 : 1);
+            std::string payload = results[i].succeeded ? ToHex(results[i].summary.Serialize()) : "-";
+            if (!connection.SendLine("RESULT " + std::to_string(indices[i]) + " " +
+                                     std::to_string(status) + " " + payload)) {
+                return false;
+            }
+        }
+        m_processed += results.size();
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include "BatchAnalyzer.h"
+
+// Coordinator/worker mode for batch analysis.
+//
+// Line-based text protocol over TCP:
+//   worker -> coordinator   HELLO <analyzer version> <summary size> <token | -> <name>
+//                           NEXT
+//                           RESULT <item> <status> <hex summary | ->   (status: 0 failed, 1 analyzed, 2 cached)
+//   coordinator -> worker   SHARD <count>  followed by <count> lines of "<item>\t<utf-8 path>"
+//                           WAIT           (everything is assigned; ask again shortly)
+//                           DONE
+//                           REJECT <reason>  (then the connection is closed)
+//
+// A worker built with a different REPLAY_ANALYZER_VERSION or ReplaySummary
+// layout, or without the coordinator's token, is rejected at HELLO, as is
+// one that sends anything before it.
+//
+// Workers must see the replays under the same paths as the coordinator
+// (same machine or a shared mount).
+
+struct DistributedOptions {
+    uint16_t port = 7878;
+    std::string bindAddress = "127.0.0.1";  // Anything but loopback needs a token
+    std::string token;                      // Shared secret workers must send; empty for none
+    size_t shardSize = 16;
+    unsigned itemTimeoutSeconds = 300;  // Reassign work held longer than this
+};
+
+struct WorkerConnection;
+
+class AnalysisCoordinator {
+public:
+    AnalysisCoordinator(const std::vector<std::filesystem::path>& replays, const DistributedOptions& options);
+    ~AnalysisCoordinator();
+
+    // Blocks until every replay has a result
+    bool Run();
+
+    const std::vector<BatchResult>& GetResults() const { return m_results; }
+    const BatchTotals& GetTotals() const { return m_totals; }
+    const BatchStats& GetStats() const { return m_stats; }
+    size_t GetReassignedCount() const { return m_reassigned; }
+
+private:
+    enum class ItemState { PENDING, ASSIGNED, DONE };
+
+    struct WorkItem {
+        ItemState state = ItemState::PENDING;
+        bool queued = false;        // In m_pending, so it isn't queued twice
+        int workerId = -1;
+        std::chrono::steady_clock::time_point assignedAt;
+    };
+
+    // Returns false if the worker should be dropped
+    bool HandleLine(WorkerConnection& worker, const std::string& line);
+    bool AcceptWorker(WorkerConnection& worker, const std::string& hello);
+    void AssignShard(WorkerConnection& worker);
+    void RecordResult(WorkerConnection& worker, const std::string& line);
+    void ReleaseWorkerItems(int workerId);
+    void RequeueExpiredItems();
+
+    DistributedOptions m_options;
+    std::vector<BatchResult> m_results;
+    std::vector<WorkItem> m_items;
+    std::deque<size_t> m_pending;
+    std::vector<std::unique_ptr<WorkerConnection>> m_workers;
+    int m_nextWorkerId = 0;
+    size_t m_doneCount = 0;
+    size_t m_reassigned = 0;
+    BatchTotals m_totals;
+    BatchStats m_stats;
+};
+
+class AnalysisWorker {
+public:
+    AnalysisWorker(const std::string& host, uint16_t port, const std::string& token, BatchAnalyzer& analyzer);
+
+    // Processes shards until the coordinator reports DONE or the connection drops
+    bool Run();
+
+    size_t GetProcessedCount() const { return m_processed; }
+
+private:
+    std::string m_host;
+    uint16_t m_port;
+    std::string m_token;
+    BatchAnalyzer& m_analyzer;
+    size_t m_processed = 0;
+};
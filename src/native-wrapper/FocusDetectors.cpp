@@ -0,0 +1,202 @@
+#include "FocusDetectors.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+int PlayerCount(const GameState& state) {
+    return std::min(state.activePlayerCount, FocusStats::MAX_PLAYERS);
+}
+
+// The frame right after the last one seen, with the same players
+bool Follows(const GameState& last, bool hasLast, const GameState& state) {
+    return hasLast && state.frameCount == last.frameCount + 1 && state.activePlayerCount == last.activePlayerCount;
+}
+
+} // namespace
+
+void NeutralDetector::BeginGame(FocusStats& stats) {
+    for (FocusPlayerStats& player : stats.players) {
+        player.neutralWins = 0;
+        player.neutralLosses = 0;
+        player.pressureFrames = 0;
+    }
+    stats.neutralFrames = 0;
+    m_hasLast = false;
+    std::fill(std::begin(m_attacker), std::end(m_attacker), -1);
+}
+
+void NeutralDetector::Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats) {
+    int count = PlayerCount(state);
+    if (!Follows(m_last, m_hasLast, state)) {
+        std::fill(std::begin(m_attacker), std::end(m_attacker), -1);
+    } else {
+        int frame = state.frameCount;
+        stats.neutralFrames++;
+        for (int victim = 0; victim < count; victim++) {
+            if (pairs.ThreatensAnyone(victim)) {
+                stats.players[victim].pressureFrames++;
+            }
+            if (state.players[victim].stocks < m_last.players[victim].stocks ||
+                (m_attacker[victim] >= 0 && frame - m_lastHitFrame[victim] > EXCHANGE_TIMEOUT_FRAMES)) {
+                m_attacker[victim] = -1;
+            }
+        }
+
+        for (int victim = 0; victim < count; victim++) {
+            int attacker = pairs.GetAttacker(victim);
+            if (attacker < 0) {
+                continue;
+            }
+            if (pairs.GetAttacker(attacker) == victim) {
+                // A trade goes to nobody
+                m_attacker[victim] = -1;
+                continue;
+            }
+
+            if (attacker != m_attacker[victim]) {
+                stats.players[attacker].neutralWins++;
+                stats.players[victim].neutralLosses++;
+                m_attacker[victim] = attacker;
+            }
+            m_lastHitFrame[victim] = frame;
+
+            // Landing a hit ends any exchange the attacker was losing
+            m_attacker[attacker] = -1;
+        }
+    }
+
+    m_last = state;
+    m_hasLast = true;
+}
+
+void PunishDetector::BeginGame(FocusStats& stats) {
+    for (FocusPlayerStats& player : stats.players) {
+        player.hitsLanded = 0;
+        player.punishes = 0;
+        player.combos = 0;
+        player.punishDamage = 0.0f;
+    }
+    m_hasLast = false;
+    std::fill(std::begin(m_punishes), std::end(m_punishes), Punish());
+}
+
+void PunishDetector::Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats) {
+    if (!Follows(m_last, m_hasLast, state)) {
+        for (Punish& punish : m_punishes) {
+            EndPunish(punish, stats);
+        }
+    } else {
+        int frame = state.frameCount;
+        for (int victim = 0; victim < PlayerCount(state); victim++) {
+            Punish& punish = m_punishes[victim];
+            const PlayerState& before = m_last.players[victim];
+            const PlayerState& after = state.players[victim];
+            bool timedOut = frame - punish.lastHitFrame > EXCHANGE_TIMEOUT_FRAMES;
+
+            int attacker = pairs.GetAttacker(victim);
+            if (after.stocks < before.stocks || (attacker < 0 && timedOut)) {
+                EndPunish(punish, stats);
+            }
+            if (attacker < 0) {
+                continue;
+            }
+
+            if (attacker != punish.attacker || timedOut) {
+                EndPunish(punish, stats);
+                punish.attacker = attacker;
+            }
+            punish.hits++;
+            punish.damage += after.damage - before.damage;
+            punish.lastHitFrame = frame;
+            stats.players[attacker].hitsLanded++;
+        }
+    }
+
+    m_last = state;
+    m_hasLast = true;
+}
+
+void PunishDetector::EndPunish(Punish& punish, FocusStats& stats) {
+    if (punish.attacker >= 0) {
+        FocusPlayerStats& attacker = stats.players[punish.attacker];
+        attacker.punishes++;
+        attacker.punishDamage += punish.damage;
+        if (punish.hits >= 2) {
+            attacker.combos++;
+        }
+    }
+    punish = Punish();
+}
+
+void EdgeguardDetector::BeginGame(FocusStats& stats) {
+    for (FocusPlayerStats& player : stats.players) {
+        player.edgeguards = 0;
+        player.edgeguardKills = 0;
+    }
+    m_hasLast = false;
+    std::fill(std::begin(m_edgeguarder), std::end(m_edgeguarder), -1);
+}
+
+void EdgeguardDetector::Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats) {
+    if (!Follows(m_last, m_hasLast, state)) {
+        std::fill(std::begin(m_edgeguarder), std::end(m_edgeguarder), -1);
+    } else {
+        for (int victim = 0; victim < PlayerCount(state); victim++) {
+            const PlayerState& before = m_last.players[victim];
+            const PlayerState& after = state.players[victim];
+            int& edgeguarder = m_edgeguarder[victim];
+
+            if (after.stocks < before.stocks) {
+                if (edgeguarder >= 0) {
+                    stats.players[edgeguarder].edgeguardKills++;
+                }
+                edgeguarder = -1;
+            } else if (!after.isOffstage) {
+                edgeguarder = -1;
+            } else if (edgeguarder < 0 && pairs.GetAttacker(victim) >= 0) {
+                edgeguarder = pairs.GetAttacker(victim);
+                stats.players[edgeguarder].edgeguards++;
+            }
+        }
+    }
+
+    m_last = state;
+    m_hasLast = true;
+}
+
+void RecoveryDetector::BeginGame(FocusStats& stats) {
+    for (FocusPlayerStats& player : stats.players) {
+        player.recoveries = 0;
+        player.failedRecoveries = 0;
+    }
+    m_hasLast = false;
+    std::fill(std::begin(m_offstage), std::end(m_offstage), false);
+}
+
+void RecoveryDetector::Observe(const GameState& state, FocusStats& stats) {
+    if (!Follows(m_last, m_hasLast, state)) {
+        std::fill(std::begin(m_offstage), std::end(m_offstage), false);
+    } else {
+        for (int i = 0; i < PlayerCount(state); i++) {
+            const PlayerState& before = m_last.players[i];
+            const PlayerState& after = state.players[i];
+
+            // Respawning puts a player back onstage; that's not a recovery
+            if (after.stocks < before.stocks) {
+                if (m_offstage[i]) {
+                    stats.players[i].failedRecoveries++;
+                }
+                m_offstage[i] = false;
+            } else if (after.isOffstage) {
+                m_offstage[i] = true;
+            } else if (m_offstage[i]) {
+                stats.players[i].recoveries++;
+                m_offstage[i] = false;
+            }
+        }
+    }
+
+    m_last = state;
+    m_hasLast = true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "GameState.h"
+#include "PlayerPairs.h"
+
+// Detectors for the focus areas: neutral, punishes, edgeguarding and
+// recovery, for any number of players. Each keeps its own copy of the
+// previous frame, so any of them can be switched off and on again; frames
+// that don't follow on from the last one it saw only update that copy.
+// Who landed a hit comes from PlayerPairs, which must see the frame first.
+
+struct FocusPlayerStats {
+    int neutralWins = 0;        // Landed the first hit of an exchange
+    int neutralLosses = 0;
+    int pressureFrames = 0;     // Had an opponent in threat range, facing them
+    int hitsLanded = 0;
+    int punishes = 0;           // Exchanges won, counted when they end
+    int combos = 0;             // ...of two or more hits
+    float punishDamage = 0.0f;
+    int edgeguards = 0;         // Offstage opponents hit
+    int edgeguardKills = 0;     // ...that lost the stock before getting back
+    int recoveries = 0;         // Made it back from offstage
+    int failedRecoveries = 0;
+};
+
+struct FocusStats {
+    static constexpr int MAX_PLAYERS = 4;
+    FocusPlayerStats players[MAX_PLAYERS];
+    int neutralFrames = 0;      // Frames the neutral detector saw, for pressureFrames
+};
+
+// An exchange is one attacker's run of hits on one victim; a trade, a lost
+// stock or EXCHANGE_TIMEOUT_FRAMES without a hit puts the pair back in neutral
+class NeutralDetector {
+public:
+    static constexpr int EXCHANGE_TIMEOUT_FRAMES = 45;     // Same as a combo ending
+
+    void BeginGame(FocusStats& stats);
+    void Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats);
+
+private:
+    GameState m_last = {};
+    bool m_hasLast = false;
+    int m_lastHitFrame[FocusStats::MAX_PLAYERS] = {};
+    int m_attacker[FocusStats::MAX_PLAYERS] = {-1, -1, -1, -1};    // Who is winning each victim's exchange
+};
+
+// Punishes are the same exchanges, scored by the attacker when they end
+class PunishDetector {
+public:
+    static constexpr int EXCHANGE_TIMEOUT_FRAMES = NeutralDetector::EXCHANGE_TIMEOUT_FRAMES;
+
+    void BeginGame(FocusStats& stats);
+    void Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats);
+
+private:
+    struct Punish {
+        int attacker = -1;
+        int hits = 0;
+        float damage = 0.0f;
+        int lastHitFrame = 0;
+    };
+
+    void EndPunish(Punish& punish, FocusStats& stats);
+
+    GameState m_last = {};
+    bool m_hasLast = false;
+    Punish m_punishes[FocusStats::MAX_PLAYERS];     // Per victim
+};
+
+class EdgeguardDetector {
+public:
+    void BeginGame(FocusStats& stats);
+    void Observe(const GameState& state, const PlayerPairs& pairs, FocusStats& stats);
+
+private:
+    GameState m_last = {};
+    bool m_hasLast = false;
+    int m_edgeguarder[FocusStats::MAX_PLAYERS] = {-1, -1, -1, -1};     // Hit them during the current trip offstage
+};
+
+class RecoveryDetector {
+public:
+    void BeginGame(FocusStats& stats);
+    void Observe(const GameState& state, FocusStats& stats);
+
+private:
+    GameState m_last = {};
+    bool m_hasLast = false;
+    bool m_offstage[FocusStats::MAX_PLAYERS] = {};      // On a trip offstage that hasn't ended
+};
@@ -0,0 +1,158 @@
+#include "FrameClock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Loop gains: how much of each arrival error is folded into phase and rate.
+// Small values average pipe latency noise out over a second or two of frames.
+const double PHASE_GAIN = 0.05;
+const double RATE_GAIN = 0.002;
+
+// Emulation speed is allowed to drift this far from nominal before it is clamped
+const double MAX_RATE_DEVIATION = 0.10;
+
+} // namespace
+
+FrameClock::FrameClock()
+    : m_origin(Clock::now()) {
+}
+
+void FrameClock::Reset() {
+    m_hasAnchor = false;
+    m_consecutiveSpikes = 0;
+    m_framePeriod = NOMINAL_FRAME_SECONDS;
+    m_stats.resets++;
+}
+
+double FrameClock::ToSeconds(Clock::time_point time) const {
+    return std::chrono::duration<double>(time - m_origin).count();
+}
+
+double FrameClock::FrameToSeconds(int frame) const {
+    if (!m_hasAnchor) {
+        return Now();
+    }
+    return m_anchorTime + (frame - m_anchorFrame) * m_framePeriod;
+}
+
+int FrameClock::SecondsToFrame(double seconds) const {
+    if (!m_hasAnchor) {
+        return 0;
+    }
+    return m_anchorFrame + static_cast<int>(std::floor((seconds - m_anchorTime) / m_framePeriod + 0.5));
+}
+
+FrameArrival FrameClock::OnFrame(int frame, Clock::time_point arrival) {
+    FrameArrival result;
+    double now = ToSeconds(arrival);
+
+    // New game, restarted overlay or a long stall: start a fresh mapping. A
+    // game that ended early is followed by frames close to its own, so going
+    // back to the first frame from further than a rollback reaches starts one.
+    bool restarted = frame == FIRST_FRAME && m_lastFrame - FIRST_FRAME > MAX_ROLLBACK_FRAMES;
+    if (m_hasAnchor && (restarted || std::abs(frame - m_lastFrame) > RESET_FRAME_DISTANCE)) {
+        Reset();
+    }
+
+    if (!m_hasAnchor) {
+        m_hasAnchor = true;
+        m_anchorFrame = frame;
+        m_anchorTime = now;
+        m_lastFrame = frame;
+        m_lastArrival = now;
+        m_stats.framesObserved++;
+        m_stats.estimatedFps = 1.0 / m_framePeriod;
+        result.timestamp = now;
+        return result;
+    }
+
+    // Rollback re-sends and duplicates keep their original timestamp
+    if (frame <= m_lastFrame) {
+        m_stats.repeatedFrames++;
+        result.isRepeat = true;
+        result.timestamp = FrameToSeconds(frame);
+        return result;
+    }
+
+    int frameDelta = frame - m_lastFrame;
+    if (frameDelta > 1) {
+        result.missingFrames = frameDelta - 1;
+        m_stats.gaps++;
+        m_stats.missingFrames += static_cast<uint64_t>(result.missingFrames);
+    }
+
+    // Inter-arrival deviation against the expected spacing
+    double expectedSpacing = frameDelta * m_framePeriod;
+    double deviation = (now - m_lastArrival) - expectedSpacing;
+    RecordJitter(deviation);
+
+    // Phase error of this arrival against the model
+    double predicted = FrameToSeconds(frame);
+    double error = now - predicted;
+
+    if (error > LAG_SPIKE_FRAMES * m_framePeriod) {
+        result.isLagSpike = true;
+        m_stats.lagSpikes++;
+        m_stats.lastSpikeMs = error * 1000.0;
+        m_consecutiveSpikes++;
+    } else {
+        m_consecutiveSpikes = 0;
+    }
+
+    // Still late after several frames: the game paused or the emulator stalled,
+    // so the phase genuinely moved. Jump to the arrival time and keep the rate.
+    if (m_consecutiveSpikes >= SPIKE_REANCHOR_FRAMES) {
+        m_consecutiveSpikes = 0;
+        m_stats.resets++;
+        predicted = now;
+        error = 0.0;
+        result.isLagSpike = false;
+    }
+
+    // Re-anchor on this frame, folding in part of the error as phase and part as rate.
+    // A lag spike is transport delay rather than game time, so it moves neither.
+    double corrected = predicted;
+    if (!result.isLagSpike) {
+        corrected += PHASE_GAIN * error;
+        double rateCorrection = RATE_GAIN * error / frameDelta;
+        m_framePeriod = std::clamp(m_framePeriod + rateCorrection,
+                                   NOMINAL_FRAME_SECONDS * (1.0 - MAX_RATE_DEVIATION),
+                                   NOMINAL_FRAME_SECONDS * (1.0 + MAX_RATE_DEVIATION));
+    }
+
+    m_anchorFrame = frame;
+    m_anchorTime = corrected;
+    m_lastFrame = frame;
+    m_lastArrival = now;
+
+    m_stats.framesObserved++;
+    m_stats.estimatedFps = 1.0 / m_framePeriod;
+
+    result.timestamp = corrected;
+    return result;
+}
+
+void FrameClock::RecordJitter(double deviationSeconds) {
+    double deviationMs = std::abs(deviationSeconds) * 1000.0;
+
+    m_stats.jitterMs += (deviationMs - m_stats.jitterMs) / 16.0;
+    m_stats.maxJitterMs = std::max(m_stats.maxJitterMs, deviationMs);
+
+    int bucket = std::min(JITTER_BUCKETS - 1, static_cast<int>(deviationMs * 2.0));
+    m_jitterHistogram[bucket]++;
+    m_jitterSamples++;
+
+    // Walk the histogram only every so often; it is 200 entries
+    if ((m_jitterSamples & 63) == 0) {
+        uint64_t target = m_jitterSamples - m_jitterSamples / 100;
+        uint64_t seen = 0;
+        for (int i = 0; i < JITTER_BUCKETS; i++) {
+            seen += m_jitterHistogram[i];
+            if (seen >= target) {
+                m_stats.p99JitterMs = (i + 1) * 0.5;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Maps game frame numbers to a monotonic high-resolution clock.
+//
+// Each frame arrival nudges a frame->time model (a small phase/rate loop), so
+// timestamps derived from frame numbers stay smooth despite pipe latency and
+// track the real emulation speed instead of a nominal 60 fps. Arrival jitter,
+// frame gaps and lag spikes are measured along the way.
+//
+// Not thread-safe; GameDataInterface guards it with its state mutex.
+
+struct FrameClockStats {
+    uint64_t framesObserved = 0;
+    uint64_t repeatedFrames = 0;      // Rollbacks and duplicates
+    uint64_t gaps = 0;                // Arrivals that skipped at least one frame
+    uint64_t missingFrames = 0;       // Total frames skipped
+    uint64_t lagSpikes = 0;
+    uint64_t resets = 0;              // New games and pause re-anchors
+    double jitterMs = 0.0;            // Smoothed inter-arrival deviation (RFC 3550 style)
+    double maxJitterMs = 0.0;
+    double p99JitterMs = 0.0;
+    double lastSpikeMs = 0.0;
+    double estimatedFps = 0.0;
+};
+
+// Result of feeding one arrival into the clock
+struct FrameArrival {
+    double timestamp = 0.0;           // Smoothed time of the frame, seconds on the clock
+    int missingFrames = 0;
+    bool isRepeat = false;
+    bool isLagSpike = false;
+};
+
+class FrameClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int FIRST_FRAME = -123;            // Melee's first frame number
+    static constexpr double NOMINAL_FRAME_SECONDS = 1.0 / 60.0;
+    static constexpr double LAG_SPIKE_FRAMES = 3.0;     // Late by this many frame periods
+    static constexpr int RESET_FRAME_DISTANCE = 600;    // Re-anchor after a jump this large (10 s)
+    static constexpr int SPIKE_REANCHOR_FRAMES = 10;    // Consecutive late frames that mean a real pause
+    static constexpr int MAX_ROLLBACK_FRAMES = 8;       // Deepest rollback Slippi re-sends
+
+    FrameClock();
+
+    // Forget the frame mapping (new game); the time base and stats are kept
+    void Reset();
+
+    FrameArrival OnFrame(int frame, Clock::time_point arrival);
+    FrameArrival OnFrame(int frame) { return OnFrame(frame, Clock::now()); }
+
+    // Seconds since the clock was created
+    double Now() const { return ToSeconds(Clock::now()); }
+    double ToSeconds(Clock::time_point time) const;
+
+    bool IsSynchronized() const { return m_hasAnchor; }
+    double FrameToSeconds(int frame) const;
+    int SecondsToFrame(double seconds) const;
+    int GetLastFrame() const { return m_lastFrame; }
+
+    const FrameClockStats& GetStats() const { return m_stats; }
+
+private:
+    void RecordJitter(double deviationSeconds);
+
+    Clock::time_point m_origin;
+
+    // Frame->time model: time(frame) = m_anchorTime + (frame - m_anchorFrame) * m_framePeriod
+    bool m_hasAnchor = false;
+    int m_anchorFrame = 0;
+    double m_anchorTime = 0.0;
+    double m_framePeriod = NOMINAL_FRAME_SECONDS;
+
+    int m_lastFrame = 0;
+    double m_lastArrival = 0.0;
+    int m_consecutiveSpikes = 0;
+
+    // Jitter histogram in 0.5 ms buckets for the percentile estimate
+    static const int JITTER_BUCKETS = 200;
+    uint64_t m_jitterHistogram[JITTER_BUCKETS] = {};
+    uint64_t m_jitterSamples = 0;
+
+    FrameClockStats m_stats;
+};
@@ -0,0 +1,321 @@
+#include "FrameHistory.h"
+#include "BlockCodec.h"
+#include "FrameStore.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+// Replay and frame are rebuilt on decode, not stored
+const size_t FIRST_STORED_COLUMN = 2;
+
+size_t TableBytes(const ColumnTable& table) {
+    size_t bytes = 0;
+    for (const Column& column : table.columns) {
+        bytes += column.data.size();
+    }
+    return bytes;
+}
+
+std::shared_ptr<const ColumnTable> DecodeGame(size_t game, size_t rows, const std::vector<uint8_t>& compressed) {
+    auto table = std::make_shared<ColumnTable>(FrameStore::EmptyTable());
+    table->Resize(rows);
+
+    int32_t* replay = table->columns[0].Values<int32_t>();
+    int32_t* frame = table->columns[1].Values<int32_t>();
+    for (size_t row = 0; row < rows; row++) {
+        replay[row] = static_cast<int32_t>(game);
+        frame[row] = FrameStore::FIRST_FRAME + static_cast<int32_t>(row);
+    }
+
+    size_t position = 0;
+    for (size_t i = FIRST_STORED_COLUMN; i < table->columns.size(); i++) {
+        Column& column = table->columns[i];
+        size_t consumed = 0;
+        if (!BlockCodec::Decode(compressed.data() + position, compressed.size() - position, rows,
+                                ColumnTypeSize(column.type), column.data.data(), consumed)) {
+            return nullptr;
+        }
+        position += consumed;
+    }
+    return table;
+}
+
+} // namespace
+
+FrameHistory::FrameHistory(const FrameHistoryOptions& options)
+    : m_options(options) {
+    ResetCurrentGame();
+}
+
+void FrameHistory::SetArchiveFile(const std::filesystem::path& archiveFile) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.archiveFile = archiveFile;
+}
+
+void FrameHistory::BeginGame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FinishGame();
+}
+
+void FrameHistory::EndGame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FinishGame();
+}
+
+void FrameHistory::Observe(const GameState& state) {
+    if (state.frameCount < FrameStore::FIRST_FRAME) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // No gameStart between two games; the frame counter starting over is enough
+    if (m_currentRows > 0 && state.frameCount < m_lastFrame - RESTART_FRAMES) {
+        FinishGame();
+    }
+
+    size_t row = static_cast<size_t>(state.frameCount - FrameStore::FIRST_FRAME);
+    if (row >= MAX_GAME_ROWS) {
+        return;
+    }
+    if (row >= m_current.rows) {
+        m_current.Resize(std::min(MAX_GAME_ROWS, std::max(row + 1, m_current.rows * 2)));
+    }
+
+    if (m_currentRows > 0 && row > m_currentRows) {
+        for (size_t i = FIRST_STORED_COLUMN; i < m_current.columns.size(); i++) {
+            Column& column = m_current.columns[i];
+            size_t size = ColumnTypeSize(column.type);
+            const uint8_t* last = column.data.data() + (m_currentRows - 1) * size;
+            for (size_t gapRow = m_currentRows; gapRow < row; gapRow++) {
+                std::copy(last, last + size, column.data.data() + gapRow * size);
+            }
+        }
+    }
+
+    Column* columns = m_current.columns.data();
+    for (int port = 0; port < FrameStore::PORTS; port++) {
+        const PlayerState& player = state.players[port];
+        columns[FrameStore::ColumnIndex(port, FrameStore::PERCENT)].Values<float>()[row] = player.damage;
+        columns[FrameStore::ColumnIndex(port, FrameStore::POSITION_X)].Values<float>()[row] = player.positionX;
+        columns[FrameStore::ColumnIndex(port, FrameStore::POSITION_Y)].Values<float>()[row] = player.positionY;
+        columns[FrameStore::ColumnIndex(port, FrameStore::ACTION_STATE)].Values<uint16_t>()[row] =
+            static_cast<uint16_t>(player.actionState);
+        columns[FrameStore::ColumnIndex(port, FrameStore::STOCKS)].Values<uint8_t>()[row] =
+            static_cast<uint8_t>(player.stocks);
+        columns[FrameStore::ColumnIndex(port, FrameStore::CHARACTER)].Values<uint8_t>()[row] =
+            static_cast<uint8_t>(player.character);
+    }
+
+    m_currentRows = std::max(m_currentRows, row + 1);
+    m_lastFrame = state.frameCount;
+}
+
+size_t FrameHistory::GetGameCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_games.size();
+}
+
+std::shared_ptr<const ColumnTable> FrameHistory::GetGame(size_t game) {
+    size_t rows = 0;
+    std::shared_ptr<const std::vector<uint8_t>> compressed;
+    uint64_t archiveOffset = 0;
+    uint64_t compressedSize = 0;
+    std::filesystem::path archiveFile;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (game >= m_games.size()) {
+            return nullptr;
+        }
+        for (CachedGame& cached : m_cache) {
+            if (cached.game == game) {
+                cached.lastUse = ++m_useCounter;
+                m_stats.cacheHits++;
+                return cached.table;
+            }
+        }
+        m_stats.cacheMisses++;
+
+        const StoredGame& stored = m_games[game];
+        if (!stored.compressed && !stored.archived) {
+            return nullptr;
+        }
+        rows = stored.rows;
+        compressed = stored.compressed;
+        archiveOffset = stored.archiveOffset;
+        compressedSize = stored.compressedSize;
+        archiveFile = m_options.archiveFile;
+    }
+
+    if (!compressed) {
+        auto bytes = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(compressedSize));
+        std::ifstream in(archiveFile, std::ios::binary);
+        if (!in.seekg(static_cast<std::streamoff>(archiveOffset)) ||
+            !in.read(reinterpret_cast<char*>(bytes->data()), static_cast<std::streamsize>(bytes->size()))) {
+            LOG_ERROR("Failed to read game {} from frame archive: {}", game, archiveFile.wstring());
+            return nullptr;
+        }
+        compressed = std::move(bytes);
+    }
+
+    std::shared_ptr<const ColumnTable> table = DecodeGame(game, rows, *compressed);
+    if (!table) {
+        LOG_ERROR("Frame history for game {} is corrupt", game);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_options.cachedGames == 0) {
+        return table;
+    }
+    if (m_cache.size() >= m_options.cachedGames) {
+        auto leastRecent = std::min_element(m_cache.begin(), m_cache.end(),
+            [](const CachedGame& a, const CachedGame& b) { return a.lastUse < b.lastUse; });
+        m_cache.erase(leastRecent);
+    }
+    CachedGame cached;
+    cached.game = game;
+    cached.table = table;
+    cached.lastUse = ++m_useCounter;
+    m_cache.push_back(std::move(cached));
+    return table;
+}
+
+ColumnTable FrameHistory::GetCurrentGame() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ColumnTable table = m_current;
+    table.Resize(m_currentRows);
+
+    int32_t* replay = table.columns[0].Values<int32_t>();
+    int32_t* frame = table.columns[1].Values<int32_t>();
+    for (size_t row = 0; row < m_currentRows; row++) {
+        replay[row] = static_cast<int32_t>(m_games.size());
+        frame[row] = FrameStore::FIRST_FRAME + static_cast<int32_t>(row);
+    }
+    return table;
+}
+
+FrameHistoryStats FrameHistory::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FrameHistoryStats stats = m_stats;
+    stats.games = m_games.size();
+    stats.currentRows = m_currentRows;
+    stats.currentBytes = TableBytes(m_current);
+    return stats;
+}
+
+GameTimeline FrameHistory::BuildTimeline(const ColumnTable& frames, size_t game) {
+    GameTimeline timeline;
+    timeline.game = game;
+    if (frames.rows == 0) {
+        return timeline;
+    }
+
+    // The last frame is always a point, so the final stock shows
+    size_t points = (frames.rows - 1) / GameTimeline::FRAMES_PER_POINT + 2;
+    for (int port = 0; port < GameTimeline::PORTS; port++) {
+        const float* percent = frames.columns[FrameStore::ColumnIndex(port, FrameStore::PERCENT)].Values<float>();
+        const uint8_t* stocks = frames.columns[FrameStore::ColumnIndex(port, FrameStore::STOCKS)].Values<uint8_t>();
+
+        for (size_t row = 0; row < frames.rows && !timeline.hasPort[port]; row++) {
+            timeline.hasPort[port] = stocks[row] > 0;
+        }
+        if (!timeline.hasPort[port]) {
+            continue;
+        }
+
+        timeline.percent[port].reserve(points);
+        timeline.stocks[port].reserve(points);
+        for (size_t row = 0; row < frames.rows; row += GameTimeline::FRAMES_PER_POINT) {
+            timeline.percent[port].push_back(percent[row]);
+            timeline.stocks[port].push_back(stocks[row]);
+        }
+        if ((frames.rows - 1) % GameTimeline::FRAMES_PER_POINT != 0) {
+            timeline.percent[port].push_back(percent[frames.rows - 1]);
+            timeline.stocks[port].push_back(stocks[frames.rows - 1]);
+        }
+    }
+    return timeline;
+}
+
+void FrameHistory::FinishGame() {
+    if (m_currentRows == 0) {
+        return;
+    }
+
+    auto compressed = std::make_shared<std::vector<uint8_t>>();
+    size_t rawBytes = 0;
+    for (size_t i = FIRST_STORED_COLUMN; i < m_current.columns.size(); i++) {
+        const Column& column = m_current.columns[i];
+        BlockCodec::Encode(column.data.data(), m_currentRows, ColumnTypeSize(column.type), *compressed);
+        rawBytes += m_currentRows * ColumnTypeSize(column.type);
+    }
+    compressed->shrink_to_fit();
+
+    StoredGame stored;
+    stored.rows = m_currentRows;
+    stored.compressedSize = compressed->size();
+    stored.compressed = std::move(compressed);
+
+    LOG_DEBUG("Frame history: game {} has {} frames, {} bytes compressed from {}", m_games.size(),
+              stored.rows, stored.compressedSize, rawBytes);
+
+    m_stats.compressedGames++;
+    m_stats.compressedBytes += stored.compressedSize;
+    m_games.push_back(std::move(stored));
+
+    ResetCurrentGame();
+    SpillOverBudget();
+}
+
+void FrameHistory::ResetCurrentGame() {
+    m_current = FrameStore::EmptyTable();
+    m_current.Resize(INITIAL_ROWS);
+    m_currentRows = 0;
+    m_lastFrame = 0;
+}
+
+void FrameHistory::SpillOverBudget() {
+    while (m_stats.compressedBytes > m_options.memoryBudget && m_oldestInMemory < m_games.size()) {
+        StoredGame& game = m_games[m_oldestInMemory++];
+        if (!game.compressed) {
+            continue;
+        }
+
+        m_stats.compressedGames--;
+        m_stats.compressedBytes -= game.compressedSize;
+        if (Archive(game)) {
+            m_stats.archivedGames++;
+            m_stats.archivedBytes += game.compressedSize;
+        } else {
+            m_stats.droppedGames++;
+        }
+        game.compressed.reset();
+    }
+}
+
+bool FrameHistory::Archive(StoredGame& game) {
+    if (m_options.archiveFile.empty() || m_archiveFailed) {
+        return false;
+    }
+
+    // The first game of the session replaces whatever an earlier one left
+    std::ios::openmode mode = std::ios::binary | (m_archiveSize == 0 ? std::ios::trunc : std::ios::app);
+    std::ofstream out(m_options.archiveFile, mode);
+    out.write(reinterpret_cast<const char*>(game.compressed->data()),
+              static_cast<std::streamsize>(game.compressed->size()));
+    if (!out) {
+        // A partial write would shift every later offset; stop archiving
+        LOG_ERROR("Failed to write frame archive, older games will be dropped: {}",
+                  m_options.archiveFile.wstring());
+        m_archiveFailed = true;
+        return false;
+    }
+
+    game.archiveOffset = m_archiveSize;
+    game.archived = true;
+    m_archiveSize += game.compressedSize;
+    return true;
+}
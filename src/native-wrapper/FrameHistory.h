@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ColumnTable.h"
+#include "GameState.h"
+
+// Every live frame of the session, in three tiers so memory stays flat over
+// a long session while any game's frames can still be pulled up:
+//
+//   the game in progress   raw columns (FrameStore's layout), appended per frame
+//   recent games           BlockCodec-compressed in memory, up to memoryBudget
+//   older games            moved to the archive file, read back on demand
+//
+// GetGame decodes a finished game into a ColumnTable and keeps the last
+// cachedGames of them (least recently used goes first), so a UI flipping
+// between a few games decodes each once. The archive only lives for the
+// session and is truncated by the first game written to it.
+//
+// The live feed has no airborne, last attack or last hit by fields; those
+// columns stay zero. Thread-safe; decoding and archive reads happen outside
+// the lock, so they don't hold up frame ingestion.
+
+struct FrameHistoryOptions {
+    size_t memoryBudget = 32 * 1024 * 1024;     // Compressed games kept in memory
+    size_t cachedGames = 4;                     // Decoded games kept for GetGame
+    std::filesystem::path archiveFile;          // Older games go here; empty = dropped
+};
+
+struct FrameHistoryStats {
+    size_t games = 0;               // Finished games
+    size_t currentRows = 0;
+    size_t currentBytes = 0;        // Raw columns of the game in progress
+    size_t compressedGames = 0;
+    size_t compressedBytes = 0;
+    size_t archivedGames = 0;
+    uint64_t archivedBytes = 0;
+    size_t droppedGames = 0;        // Over budget with no archive, or the write failed
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+};
+
+// A game's percent and stocks for each port, one point per second of frames,
+// for the timeline in the Player Stats panel
+struct GameTimeline {
+    static constexpr int PORTS = 4;
+    static constexpr size_t FRAMES_PER_POINT = 60;
+
+    size_t game = 0;                // As numbered by FrameHistory::GetGame
+    bool hasPort[PORTS] = {};       // Ports with stocks at some point in the game
+    std::vector<float> percent[PORTS];
+    std::vector<float> stocks[PORTS];
+};
+
+class FrameHistory {
+public:
+    static constexpr size_t INITIAL_ROWS = 8 * 1024;       // About two minutes of frames
+    static constexpr size_t MAX_GAME_ROWS = 60 * 60 * 60;  // An hour; frames past it aren't kept
+    static constexpr int RESTART_FRAMES = 600;             // Frame number this far back = a new game
+
+    explicit FrameHistory(const FrameHistoryOptions& options = FrameHistoryOptions());
+
+    void SetArchiveFile(const std::filesystem::path& archiveFile);
+
+    // Finishes the game in progress, if it has frames
+    void BeginGame();
+    void EndGame();
+
+    // Records a frame of the game in progress. Re-sent frames overwrite,
+    // frames skipped by a gap repeat the last known state.
+    void Observe(const GameState& state);
+
+    size_t GetGameCount() const;
+
+    // Frames of a finished game (0 = the session's first); nullptr if the
+    // game was dropped or can't be read back
+    std::shared_ptr<const ColumnTable> GetGame(size_t game);
+
+    // Copy of the game in progress so far
+    ColumnTable GetCurrentGame() const;
+
+    FrameHistoryStats GetStats() const;
+
+    // Samples a game's frames (from GetGame or GetCurrentGame) into a timeline
+    static GameTimeline BuildTimeline(const ColumnTable& frames, size_t game);
+
+private:
+    struct StoredGame {
+        size_t rows = 0;
+        std::shared_ptr<const std::vector<uint8_t>> compressed;    // Null once archived or dropped
+        uint64_t compressedSize = 0;
+        uint64_t archiveOffset = 0;
+        bool archived = false;
+    };
+
+    struct CachedGame {
+        size_t game = 0;
+        std::shared_ptr<const ColumnTable> table;
+        uint64_t lastUse = 0;
+    };
+
+    void FinishGame();
+    void ResetCurrentGame();
+    void SpillOverBudget();
+    bool Archive(StoredGame& game);
+
+    mutable std::mutex m_mutex;
+    FrameHistoryOptions m_options;
+
+    ColumnTable m_current;          // rows is the capacity; m_currentRows are filled
+    size_t m_currentRows = 0;
+    int m_lastFrame = 0;
+
+    std::vector<StoredGame> m_games;
+    size_t m_oldestInMemory = 0;
+    uint64_t m_archiveSize = 0;
+    bool m_archiveFailed = false;
+
+    std::vector<CachedGame> m_cache;
+    uint64_t m_useCounter = 0;
+    FrameHistoryStats m_stats;
+};
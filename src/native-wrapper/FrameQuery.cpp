@@ -0,0 +1,625 @@
+#include "FrameQuery.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+const size_t BLOCK_ROWS = ZoneMap::BLOCK_ROWS;
+const double OFFSTAGE_Y = -5.0;             // Below the floor of every legal stage
+
+// Ledge x of the legal stages (the stages are symmetric); other stages
+// only use the floor test
+double StageEdge(int stage) {
+    switch (stage) {
+        case 2: return 63.35;       // Fountain of Dreams
+        case 3: return 87.75;       // Pokemon Stadium
+        case 8: return 56.0;        // Yoshi's Story
+        case 28: return 77.27;      // Dream Land
+        case 31: return 68.4;       // Battlefield
+        case 32: return 85.5657;    // Final Destination
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+// Action state ranges behind the flags
+const int ACTION_AERIAL_FIRST = 0x41;       // AttackAirN
+const int ACTION_AERIAL_LAST = 0x45;        // AttackAirLw
+const int ACTION_DAMAGE_FIRST = 0x4B;       // DamageHi1
+const int ACTION_DAMAGE_LAST = 0x5B;        // DamageFlyRoll
+const int ACTION_GUARD_FIRST = 0xB2;        // GuardOn
+const int ACTION_GUARD_LAST = 0xB6;         // GuardSetOff
+
+// Zone map answer for a block, ordered so AND is min and OR is max
+enum Zone : uint8_t {
+    ZONE_NONE,
+    ZONE_SOME,
+    ZONE_ALL
+};
+
+template <typename T, typename Predicate>
+void FillMask(const T* values, size_t count, uint8_t* mask, Predicate predicate) {
+    for (size_t i = 0; i < count; i++) {
+        mask[i] = predicate(values[i]) ? 1 : 0;
+    }
+}
+
+} // namespace
+
+// Recursive descent over the expression, emitting postfix instructions:
+//
+//   or      := and ("or" and)*
+//   and     := unary ("and" unary)*
+//   unary   := "not" unary | "(" or ")" | operand
+//   operand := flag | column [comparison number]
+class FrameQuery::Parser {
+public:
+    Parser(const std::string& text, std::vector<Instruction>& program)
+        : m_text(text), m_program(program), m_columns(FrameStore::EmptyTable()) {
+        Next();
+    }
+
+    bool Parse(std::string& error) {
+        bool ok = ParseOr() && m_token.empty();
+        if (!ok) {
+            error = m_error.empty() ? "unexpected '" + m_token + "'" : m_error;
+        }
+        return ok;
+    }
+
+private:
+    bool Fail(const std::string& message) {
+        if (m_error.empty()) {
+            m_error = message;
+        }
+        return false;
+    }
+
+    bool IsKeyword(const char* keyword) const {
+        if (m_token.size() != strlen(keyword)) {
+            return false;
+        }
+        for (size_t i = 0; i < m_token.size(); i++) {
+            if (std::tolower(static_cast<unsigned char>(m_token[i])) != keyword[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Next() {
+        while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+            m_position++;
+        }
+        size_t start = m_position;
+        if (m_position < m_text.size()) {
+            char c = m_text[m_position];
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' ||
+                ((c == '-' || c == '+') && m_position + 1 < m_text.size() &&
+                 (std::isdigit(static_cast<unsigned char>(m_text[m_position + 1])) || m_text[m_position + 1] == '.'))) {
+                m_position++;
+                while (m_position < m_text.size() &&
+                       (std::isalnum(static_cast<unsigned char>(m_text[m_position])) ||
+                        m_text[m_position] == '_' || m_text[m_position] == '.')) {
+                    m_position++;
+                }
+            } else if ((c == '<' || c == '>' || c == '=' || c == '!') && m_position + 1 < m_text.size() &&
+                       m_text[m_position + 1] == '=') {
+                m_position += 2;
+            } else {
+                m_position++;
+            }
+        }
+        m_token = m_text.substr(start, m_position - start);
+    }
+
+    void Emit(Instruction::Kind kind) {
+        Instruction instruction;
+        instruction.kind = kind;
+        m_program.push_back(instruction);
+    }
+
+    void EmitCompare(int column, CompareOp compare, double value, int edgeSign = 0) {
+        Instruction instruction;
+        instruction.column = column;
+        instruction.compare = compare;
+        instruction.value = value;
+        instruction.edgeSign = edgeSign;
+        m_program.push_back(instruction);
+    }
+
+    bool ParseOr() {
+        if (!ParseAnd()) {
+            return false;
+        }
+        while (IsKeyword("or")) {
+            Next();
+            if (!ParseAnd()) {
+                return false;
+            }
+            Emit(Instruction::OR);
+        }
+        return true;
+    }
+
+    bool ParseAnd() {
+        if (!ParseUnary()) {
+            return false;
+        }
+        while (IsKeyword("and")) {
+            Next();
+            if (!ParseUnary()) {
+                return false;
+            }
+            Emit(Instruction::AND);
+        }
+        return true;
+    }
+
+    bool ParseUnary() {
+        if (IsKeyword("not")) {
+            Next();
+            if (!ParseUnary()) {
+                return false;
+            }
+            Emit(Instruction::NOT);
+            return true;
+        }
+        if (m_token == "(") {
+            Next();
+            if (!ParseOr()) {
+                return false;
+            }
+            if (m_token != ")") {
+                return Fail("expected ')'");
+            }
+            Next();
+            return true;
+        }
+        return ParseOperand();
+    }
+
+    int Column(int port, FrameStore::PortField field) const {
+        return m_columns.Find(FrameStore::ColumnName(port, field));
+    }
+
+    // pN_<flag> as comparisons on the port's columns
+    bool ParseFlag(const std::string& name) {
+        if (name.size() < 4 || name[0] != 'p' || name[1] < '1' || name[1] > '4' || name[2] != '_') {
+            return false;
+        }
+        int port = name[1] - '1';
+        std::string flag = name.substr(3);
+
+        if (flag == "offstage") {
+            int x = Column(port, FrameStore::POSITION_X);
+            EmitCompare(x, CompareOp::GREATER, 0.0, 1);
+            EmitCompare(x, CompareOp::LESS, 0.0, -1);
+            Emit(Instruction::OR);
+            EmitCompare(Column(port, FrameStore::POSITION_Y), CompareOp::LESS, OFFSTAGE_Y);
+            Emit(Instruction::OR);
+            return true;
+        }
+
+        int first = 0;
+        int last = 0;
+        if (flag == "aerial") {
+            first = ACTION_AERIAL_FIRST;
+            last = ACTION_AERIAL_LAST;
+        } else if (flag == "hitstun") {
+            first = ACTION_DAMAGE_FIRST;
+            last = ACTION_DAMAGE_LAST;
+        } else if (flag == "shielding") {
+            first = ACTION_GUARD_FIRST;
+            last = ACTION_GUARD_LAST;
+        } else if (flag == "grounded") {
+            EmitCompare(Column(port, FrameStore::AIRBORNE), CompareOp::EQUAL, 0.0);
+            return true;
+        } else {
+            return false;
+        }
+        int action = Column(port, FrameStore::ACTION_STATE);
+        EmitCompare(action, CompareOp::GREATER_EQUAL, first);
+        EmitCompare(action, CompareOp::LESS_EQUAL, last);
+        Emit(Instruction::AND);
+        return true;
+    }
+
+    bool ParseOperand() {
+        if (m_token.empty()) {
+            return Fail("unexpected end of query");
+        }
+
+        std::string name = m_token;
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        Next();
+        if (ParseFlag(name)) {
+            return true;
+        }
+
+        int column = m_columns.Find(name);
+        if (column < 0 || m_columns.columns[column].type == ColumnType::UTF8) {
+            return Fail("unknown field '" + name + "'");
+        }
+
+        CompareOp compare;
+        if (m_token == "<") {
+            compare = CompareOp::LESS;
+        } else if (m_token == "<=") {
+            compare = CompareOp::LESS_EQUAL;
+        } else if (m_token == ">") {
+            compare = CompareOp::GREATER;
+        } else if (m_token == ">=") {
+            compare = CompareOp::GREATER_EQUAL;
+        } else if (m_token == "==" || m_token == "=") {
+            compare = CompareOp::EQUAL;
+        } else if (m_token == "!=") {
+            compare = CompareOp::NOT_EQUAL;
+        } else {
+            // A bare column is true when non-zero
+            EmitCompare(column, CompareOp::NOT_EQUAL, 0.0);
+            return true;
+        }
+        Next();
+
+        char* end = nullptr;
+        double value = std::strtod(m_token.c_str(), &end);
+        if (m_token.empty() || end != m_token.c_str() + m_token.size() || !std::isfinite(value)) {
+            return Fail("expected a number after " + name);
+        }
+        Next();
+        EmitCompare(column, compare, value);
+        return true;
+    }
+
+    const std::string& m_text;
+    std::vector<Instruction>& m_program;
+    ColumnTable m_columns;
+    size_t m_position = 0;
+    std::string m_token;
+    std::string m_error;
+};
+
+namespace {
+
+using CompareOp = FrameQuery::CompareOp;
+
+// Whole-block answer of a comparison from the block's min/max
+Zone CompareZone(CompareOp compare, double minimum, double maximum, double threshold) {
+    switch (compare) {
+        case CompareOp::LESS:
+            return maximum < threshold ? ZONE_ALL : (minimum >= threshold ? ZONE_NONE : ZONE_SOME);
+        case CompareOp::LESS_EQUAL:
+            return maximum <= threshold ? ZONE_ALL : (minimum > threshold ? ZONE_NONE : ZONE_SOME);
+        case CompareOp::GREATER:
+            return minimum > threshold ? ZONE_ALL : (maximum <= threshold ? ZONE_NONE : ZONE_SOME);
+        case CompareOp::GREATER_EQUAL:
+            return minimum >= threshold ? ZONE_ALL : (maximum < threshold ? ZONE_NONE : ZONE_SOME);
+        case CompareOp::EQUAL:
+            if (threshold < minimum || threshold > maximum) {
+                return ZONE_NONE;
+            }
+            return minimum == threshold && maximum == threshold ? ZONE_ALL : ZONE_SOME;
+        case CompareOp::NOT_EQUAL:
+            if (threshold < minimum || threshold > maximum) {
+                return ZONE_ALL;
+            }
+            return minimum == threshold && maximum == threshold ? ZONE_NONE : ZONE_SOME;
+    }
+    return ZONE_SOME;
+}
+
+// mask[i] = values[i] <compare> threshold. Integer columns get the threshold
+// rounded into their own type so the loops compare like with like.
+template <typename T>
+void CompareKernel(const T* values, size_t count, CompareOp compare, double threshold, uint8_t* mask) {
+    if (std::is_integral<T>::value) {
+        const double low = static_cast<double>(std::numeric_limits<T>::min());
+        const double high = static_cast<double>(std::numeric_limits<T>::max());
+        const bool integral = std::floor(threshold) == threshold;
+        if (compare == CompareOp::LESS) {
+            compare = CompareOp::LESS_EQUAL;
+            threshold = std::ceil(threshold) - 1.0;
+        } else if (compare == CompareOp::GREATER) {
+            compare = CompareOp::GREATER_EQUAL;
+            threshold = std::floor(threshold) + 1.0;
+        } else if (compare == CompareOp::LESS_EQUAL) {
+            threshold = std::floor(threshold);
+        } else if (compare == CompareOp::GREATER_EQUAL) {
+            threshold = std::ceil(threshold);
+        }
+
+        // Thresholds outside the type's range give a constant answer
+        int constant = -1;
+        if (compare == CompareOp::LESS_EQUAL) {
+            constant = threshold >= high ? 1 : (threshold < low ? 0 : -1);
+        } else if (compare == CompareOp::GREATER_EQUAL) {
+            constant = threshold <= low ? 1 : (threshold > high ? 0 : -1);
+        } else if (!integral || threshold < low || threshold > high) {
+            constant = compare == CompareOp::EQUAL ? 0 : 1;
+        }
+        if (constant >= 0) {
+            memset(mask, constant, count);
+            return;
+        }
+    }
+
+    const T bound = static_cast<T>(threshold);
+    switch (compare) {
+        case CompareOp::LESS: FillMask(values, count, mask, [bound](T value) { return value < bound; }); break;
+        case CompareOp::LESS_EQUAL: FillMask(values, count, mask, [bound](T value) { return value <= bound; }); break;
+        case CompareOp::GREATER: FillMask(values, count, mask, [bound](T value) { return value > bound; }); break;
+        case CompareOp::GREATER_EQUAL: FillMask(values, count, mask, [bound](T value) { return value >= bound; }); break;
+        case CompareOp::EQUAL: FillMask(values, count, mask, [bound](T value) { return value == bound; }); break;
+        case CompareOp::NOT_EQUAL: FillMask(values, count, mask, [bound](T value) { return value != bound; }); break;
+    }
+}
+
+void CompareColumn(const Column& column, size_t begin, size_t count, CompareOp compare, double threshold,
+                   uint8_t* mask) {
+    switch (column.type) {
+        case ColumnType::UINT8: CompareKernel(column.Values<uint8_t>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::UINT16: CompareKernel(column.Values<uint16_t>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::INT32: CompareKernel(column.Values<int32_t>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::UINT32: CompareKernel(column.Values<uint32_t>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::INT64: CompareKernel(column.Values<int64_t>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::FLOAT32: CompareKernel(column.Values<float>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::FLOAT64: CompareKernel(column.Values<double>() + begin, count, compare, threshold, mask); break;
+        case ColumnType::UTF8: memset(mask, 0, count); break;
+    }
+}
+
+const char* const COMPARE_NAMES[] = {"<", "<=", ">", ">=", "==", "!="};
+
+} // namespace
+
+bool FrameQuery::Compile(const std::string& text, std::string& error) {
+    m_program.clear();
+    m_stackDepth = 0;
+
+    Parser parser(text, m_program);
+    if (!parser.Parse(error)) {
+        m_program.clear();
+        return false;
+    }
+
+    size_t depth = 0;
+    for (const Instruction& instruction : m_program) {
+        if (instruction.kind == Instruction::COMPARE) {
+            depth++;
+        } else if (instruction.kind != Instruction::NOT) {
+            depth--;
+        }
+        m_stackDepth = std::max(m_stackDepth, depth);
+    }
+    return true;
+}
+
+std::string FrameQuery::Describe() const {
+    ColumnTable columns = FrameStore::EmptyTable();
+    std::ostringstream text;
+    for (const Instruction& instruction : m_program) {
+        switch (instruction.kind) {
+            case Instruction::COMPARE:
+                text << columns.columns[instruction.column].name << " "
+                     << COMPARE_NAMES[static_cast<int>(instruction.compare)] << " ";
+                if (instruction.edgeSign != 0) {
+                    text << (instruction.edgeSign > 0 ? "+" : "-") << "ledge";
+                } else {
+                    text << instruction.value;
+                }
+                break;
+            case Instruction::AND: text << "and"; break;
+            case Instruction::OR: text << "or"; break;
+            case Instruction::NOT: text << "not"; break;
+        }
+        text << "\n";
+    }
+    return text.str();
+}
+
+double FrameQuery::Threshold(const Instruction& instruction, double stageEdge) const {
+    return instruction.edgeSign != 0 ? instruction.edgeSign * stageEdge : instruction.value;
+}
+
+void FrameQuery::Match(const FrameStore& store, int stage, size_t replay, const FrameQueryOptions& options,
+                       std::vector<FrameQueryHit>& hits, FrameQueryStats& stats) const {
+    const ColumnTable& table = store.GetTable();
+    const size_t rows = table.rows;
+    if (m_program.empty() || rows == 0) {
+        return;
+    }
+
+    const double stageEdge = StageEdge(stage);
+    const int32_t* frames = table.columns[table.Find("frame")].Values<int32_t>();
+    std::vector<uint8_t> masks(m_stackDepth * BLOCK_ROWS);
+    std::vector<Zone> zones(m_program.size());
+    std::vector<Zone> zoneStack(m_stackDepth);
+
+    // Matching frames become runs; runs within mergeGapFrames of the pending
+    // hit extend it, and the pending hit is kept once it is long enough
+    bool hasPending = false;
+    FrameQueryHit pending;
+    pending.replay = replay;
+    auto addRun = [&](int32_t start, int32_t end) {
+        if (hasPending && start - pending.endFrame - 1 <= options.mergeGapFrames) {
+            pending.endFrame = end;
+            return;
+        }
+        if (hasPending && pending.endFrame - pending.startFrame + 1 >= options.minFrames) {
+            hits.push_back(pending);
+        }
+        pending.startFrame = start;
+        pending.endFrame = end;
+        hasPending = true;
+    };
+
+    const size_t blocks = (rows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * BLOCK_ROWS;
+        const size_t count = std::min(BLOCK_ROWS, rows - begin);
+
+        // Zone map pass: the whole block's answer, per instruction
+        size_t top = 0;
+        for (size_t i = 0; i < m_program.size(); i++) {
+            const Instruction& instruction = m_program[i];
+            switch (instruction.kind) {
+                case Instruction::COMPARE: {
+                    const ZoneMap& zoneMap = store.GetZoneMap(instruction.column);
+                    zones[i] = CompareZone(instruction.compare, zoneMap.minimum[block], zoneMap.maximum[block],
+                                           Threshold(instruction, stageEdge));
+                    zoneStack[top++] = zones[i];
+                    break;
+                }
+                case Instruction::AND:
+                    top--;
+                    zoneStack[top - 1] = std::min(zoneStack[top - 1], zoneStack[top]);
+                    break;
+                case Instruction::OR:
+                    top--;
+                    zoneStack[top - 1] = std::max(zoneStack[top - 1], zoneStack[top]);
+                    break;
+                case Instruction::NOT:
+                    zoneStack[top - 1] = static_cast<Zone>(ZONE_ALL - zoneStack[top - 1]);
+                    break;
+            }
+        }
+
+        stats.blocks++;
+        if (zoneStack[0] == ZONE_NONE) {
+            stats.blocksSkipped++;
+            continue;
+        }
+        if (zoneStack[0] == ZONE_ALL) {
+            stats.blocksAccepted++;
+            addRun(frames[begin], frames[begin + count - 1]);
+            continue;
+        }
+
+        // Kernel pass over the rows; comparisons the zone maps settled are filled in directly
+        top = 0;
+        for (size_t i = 0; i < m_program.size(); i++) {
+            const Instruction& instruction = m_program[i];
+            if (instruction.kind == Instruction::COMPARE) {
+                uint8_t* mask = masks.data() + top * BLOCK_ROWS;
+                if (zones[i] == ZONE_SOME) {
+                    CompareColumn(table.columns[instruction.column], begin, count, instruction.compare,
+                                  Threshold(instruction, stageEdge), mask);
+                } else {
+                    memset(mask, zones[i] == ZONE_ALL ? 1 : 0, count);
+                }
+                top++;
+                continue;
+            }
+
+            if (instruction.kind == Instruction::NOT) {
+                uint8_t* mask = masks.data() + (top - 1) * BLOCK_ROWS;
+                for (size_t row = 0; row < count; row++) {
+                    mask[row] ^= 1;
+                }
+                continue;
+            }
+
+            top--;
+            uint8_t* left = masks.data() + (top - 1) * BLOCK_ROWS;
+            const uint8_t* right = masks.data() + top * BLOCK_ROWS;
+            if (instruction.kind == Instruction::AND) {
+                for (size_t row = 0; row < count; row++) {
+                    left[row] &= right[row];
+                }
+            } else {
+                for (size_t row = 0; row < count; row++) {
+                    left[row] |= right[row];
+                }
+            }
+        }
+
+        const uint8_t* result = masks.data();
+        for (size_t row = 0; row < count;) {
+            if (!result[row]) {
+                row++;
+                continue;
+            }
+            size_t end = row;
+            while (end + 1 < count && result[end + 1]) {
+                end++;
+            }
+            addRun(frames[begin + row], frames[begin + end]);
+            row = end + 1;
+        }
+    }
+
+    if (hasPending && pending.endFrame - pending.startFrame + 1 >= options.minFrames) {
+        hits.push_back(pending);
+    }
+}
+
+std::vector<FrameQueryHit> FrameQuery::Run(const std::vector<std::filesystem::path>& replays,
+                                           const FrameQueryOptions& options, FrameQueryStats& stats) const {
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<FrameQueryHit>> replayHits(replays.size());
+    std::atomic<size_t> nextIndex(0);
+    std::mutex statsMutex;
+    stats = FrameQueryStats();
+    stats.replays = replays.size();
+
+    auto worker = [&]() {
+        FrameStore store;
+        FrameQueryStats local;
+        for (;;) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= replays.size()) {
+                break;
+            }
+
+            SlpReader reader;
+            SlpGameStart gameStart;
+            if (!reader.LoadFile(replays[index]) || !reader.ReadGameStart(gameStart) ||
+                !store.Load(reader, static_cast<int32_t>(index))) {
+                local.failed++;
+                continue;
+            }
+            local.frames += store.GetRowCount();
+            Match(store, gameStart.stage, index, options, replayHits[index], local);
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.failed += local.failed;
+        stats.frames += local.frames;
+        stats.blocks += local.blocks;
+        stats.blocksSkipped += local.blocksSkipped;
+        stats.blocksAccepted += local.blocksAccepted;
+    };
+
+    unsigned threadCount = options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(1, replays.size())));
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<FrameQueryHit> hits;
+    for (const auto& list : replayHits) {
+        hits.insert(hits.end(), list.begin(), list.end());
+    }
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return hits;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "FrameStore.h"
+
+// Ad-hoc questions over replay frames, written as a filter expression:
+//
+//   p1_offstage and p2_percent > 100 and p2_aerial
+//   (p1_hitstun or p1_shielding) and not p2_grounded and frame >= 600
+//
+// Operands are FrameStore columns (frame, p1_percent, p2_x, ...) compared
+// with <, <=, >, >=, == or != against a number, a bare column (true when
+// non-zero), or one of the per-port flags below. Ports without a player
+// read as zero.
+//
+//   pN_offstage   past the stage's ledge or below its floor
+//   pN_aerial     in an aerial attack
+//   pN_hitstun    in a damage (hitstun) state
+//   pN_shielding  shielding
+//   pN_grounded   not airborne
+//
+// Compile turns the expression into postfix filter kernels. Each replay is
+// scanned in ZoneMap blocks: block min/max first decide whether the whole
+// block can match, can't, or has to be looked at; only the last kind runs
+// the kernels, which are tight loops over the column values that compilers
+// vectorize. Matching frames come back as (replay, frame range) hits.
+
+struct FrameQueryHit {
+    size_t replay = 0;          // Index into the replay list
+    int32_t startFrame = 0;
+    int32_t endFrame = 0;       // Inclusive
+};
+
+struct FrameQueryOptions {
+    unsigned threadCount = 0;   // 0 = hardware concurrency
+    int minFrames = 1;          // Shorter runs of matching frames are dropped
+    int mergeGapFrames = 0;     // Runs at most this many frames apart become one hit
+};
+
+struct FrameQueryStats {
+    size_t replays = 0;
+    size_t failed = 0;
+    uint64_t frames = 0;
+    uint64_t blocks = 0;
+    uint64_t blocksSkipped = 0;     // Ruled out by the zone maps
+    uint64_t blocksAccepted = 0;    // Every frame matches, by the zone maps alone
+    double elapsedSeconds = 0.0;
+};
+
+class FrameQuery {
+public:
+    enum class CompareOp : uint8_t {
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL,
+        NOT_EQUAL
+    };
+
+    // Returns false with a message naming the offending token
+    bool Compile(const std::string& text, std::string& error);
+    bool IsCompiled() const { return !m_program.empty(); }
+
+    // The compiled program, one instruction per line
+    std::string Describe() const;
+
+    // Appends the hits of a loaded replay; stage is the Slippi stage id
+    void Match(const FrameStore& store, int stage, size_t replay, const FrameQueryOptions& options,
+               std::vector<FrameQueryHit>& hits, FrameQueryStats& stats) const;
+
+    // Loads and matches each replay in parallel; hits are in replay order
+    std::vector<FrameQueryHit> Run(const std::vector<std::filesystem::path>& replays,
+                                   const FrameQueryOptions& options, FrameQueryStats& stats) const;
+
+private:
+    struct Instruction {
+        enum Kind : uint8_t {
+            COMPARE,
+            AND,
+            OR,
+            NOT
+        };
+
+        Kind kind = COMPARE;
+        CompareOp compare = CompareOp::NOT_EQUAL;
+        int column = -1;
+        double value = 0.0;
+        int edgeSign = 0;           // +1/-1: value is the stage's ledge x times this, not a constant
+    };
+
+    class Parser;
+
+    double Threshold(const Instruction& instruction, double stageEdge) const;
+
+    std::vector<Instruction> m_program;
+    size_t m_stackDepth = 0;
+};
@@ -0,0 +1,90 @@
+#include "FrameStore.h"
+#include <algorithm>
+
+namespace {
+
+const char* const PORT_FIELD_NAMES[] = {
+    "percent", "x", "y", "action", "stocks", "airborne", "last_attack", "last_hit_by", "character"
+};
+
+const ColumnType PORT_FIELD_TYPES[] = {
+    ColumnType::FLOAT32, ColumnType::FLOAT32, ColumnType::FLOAT32, ColumnType::UINT16,
+    ColumnType::UINT8, ColumnType::UINT8, ColumnType::UINT8, ColumnType::UINT8, ColumnType::UINT8
+};
+
+const size_t INITIAL_ROWS = 8 * 1024;      // About two minutes of frames
+
+} // namespace
+
+std::string FrameStore::ColumnName(int port, PortField field) {
+    return "p" + std::to_string(port + 1) + "_" + PORT_FIELD_NAMES[field];
+}
+
+ColumnTable FrameStore::EmptyTable() {
+    ColumnTable table;
+    table.Add("replay", ColumnType::INT32);
+    table.Add("frame", ColumnType::INT32);
+    for (int port = 0; port < PORTS; port++) {
+        for (int field = 0; field < PORT_FIELD_COUNT; field++) {
+            table.Add(ColumnName(port, static_cast<PortField>(field)), PORT_FIELD_TYPES[field]);
+        }
+    }
+    return table;
+}
+
+void FrameStore::Clear() {
+    m_table = EmptyTable();
+    m_zoneMaps.assign(m_table.columns.size(), ZoneMap());
+    for (bool& hasPort : m_hasPort) {
+        hasPort = false;
+    }
+}
+
+bool FrameStore::Load(const SlpReader& reader, int32_t replayId) {
+    Clear();
+
+    // Grown by doubling as frames arrive, trimmed to the last frame at the end
+    size_t rows = 0;
+    m_table.Resize(INITIAL_ROWS);
+
+    Column* columns = m_table.columns.data();
+    reader.ForEachEvent([&](uint8_t command, const uint8_t* payload, size_t size) {
+        SlpPostFrame postFrame;
+        if (command != SlpCommand::POST_FRAME_UPDATE || !SlpReader::DecodePostFrame(payload, size, postFrame) ||
+            postFrame.isFollower || postFrame.playerIndex >= PORTS || postFrame.frame < FIRST_FRAME) {
+            return true;
+        }
+
+        size_t row = static_cast<size_t>(postFrame.frame - FIRST_FRAME);
+        if (row >= m_table.rows) {
+            m_table.Resize(std::max(row + 1, m_table.rows * 2));
+            columns = m_table.columns.data();
+        }
+        rows = std::max(rows, row + 1);
+
+        int port = postFrame.playerIndex;
+        m_hasPort[port] = true;
+        columns[ColumnIndex(port, PERCENT)].Values<float>()[row] = postFrame.percent;
+        columns[ColumnIndex(port, POSITION_X)].Values<float>()[row] = postFrame.positionX;
+        columns[ColumnIndex(port, POSITION_Y)].Values<float>()[row] = postFrame.positionY;
+        columns[ColumnIndex(port, ACTION_STATE)].Values<uint16_t>()[row] = postFrame.actionState;
+        columns[ColumnIndex(port, STOCKS)].Values<uint8_t>()[row] = postFrame.stocksRemaining;
+        columns[ColumnIndex(port, AIRBORNE)].Values<uint8_t>()[row] = postFrame.isAirborne ? 1 : 0;
+        columns[ColumnIndex(port, LAST_ATTACK)].Values<uint8_t>()[row] = postFrame.lastAttackLanded;
+        columns[ColumnIndex(port, LAST_HIT_BY)].Values<uint8_t>()[row] = postFrame.lastHitBy;
+        columns[ColumnIndex(port, CHARACTER)].Values<uint8_t>()[row] = postFrame.internalCharacter;
+        return true;
+    });
+
+    m_table.Resize(rows);
+    int32_t* replay = m_table.columns[0].Values<int32_t>();
+    int32_t* frame = m_table.columns[1].Values<int32_t>();
+    for (size_t row = 0; row < rows; row++) {
+        replay[row] = replayId;
+        frame[row] = FIRST_FRAME + static_cast<int32_t>(row);
+    }
+    for (size_t i = 0; i < m_table.columns.size(); i++) {
+        m_zoneMaps[i].Build(m_table.columns[i], rows);
+    }
+    return rows > 0;
+}
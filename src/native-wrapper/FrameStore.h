@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ColumnTable.h"
+#include "SlippiReplay.h"
+
+// A replay's post-frame data as columns: one row per frame from Melee's first
+// frame (-123) on, one column per field and port. Rollbacks re-send frames;
+// later values overwrite earlier ones, so every row is the final state. Ports
+// without a player stay zero.
+//
+//   replay (int32), frame (int32),
+//   p<N>_percent, p<N>_x, p<N>_y (float32), p<N>_action (uint16),
+//   p<N>_stocks, p<N>_airborne, p<N>_last_attack, p<N>_last_hit_by,
+//   p<N>_character (uint8)                                  for N = 1..4
+
+class FrameStore {
+public:
+    static constexpr int PORTS = 4;
+    static constexpr int FIRST_FRAME = -123;
+
+    // Per-port columns, in table order after replay and frame
+    enum PortField {
+        PERCENT,
+        POSITION_X,
+        POSITION_Y,
+        ACTION_STATE,
+        STOCKS,
+        AIRBORNE,
+        LAST_ATTACK,
+        LAST_HIT_BY,
+        CHARACTER,
+        PORT_FIELD_COUNT
+    };
+
+    // replayId fills the replay column, to join with a summary table
+    bool Load(const SlpReader& reader, int32_t replayId);
+    void Clear();
+
+    const ColumnTable& GetTable() const { return m_table; }
+    size_t GetRowCount() const { return m_table.rows; }
+    bool HasPort(int port) const { return port >= 0 && port < PORTS && m_hasPort[port]; }
+
+    // Block min/max of a column, built by Load; empty for UTF8 columns
+    const ZoneMap& GetZoneMap(int column) const { return m_zoneMaps[column]; }
+
+    // Name of a per-port column, port 0-3 ("p1_percent")
+    static std::string ColumnName(int port, PortField field);
+
+    // The columns every FrameStore table has, with no rows
+    static ColumnTable EmptyTable();
+
+    // Index of a per-port column in those tables
+    static int ColumnIndex(int port, PortField field) { return 2 + port * PORT_FIELD_COUNT + field; }
+
+private:
+
+    ColumnTable m_table;
+    std::vector<ZoneMap> m_zoneMaps;
+    bool m_hasPort[PORTS] = {};
+};
@@ -1,11 +1,206 @@
 #include "GameDataInterface.h"
-#include <iostream>
+#include "ContentHash.h"
+#include "Logger.h"
 #include <sstream>
 #include <tlhelp32.h>
 #include <psapi.h>
 #include <mutex>
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+// Finds the value of a "key": pair in the overlay's flat JSON messages
+const char* FindFieldValue(std::string_view data, const char* key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = data.find(pattern);
+    if (pos == std::string_view::npos) {
+        return nullptr;
+    }
+    return data.data() + pos + pattern.size();
+}
+
+// The views passed in always point into a null-terminated message, so strtol
+// and strtod stop at the next delimiter at the latest
+bool FindIntField(std::string_view data, const char* key, long long& value) {
+    const char* start = FindFieldValue(data, key);
+    if (!start) {
+        return false;
+    }
+    
+    char* end = nullptr;
+    long long parsed = strtoll(start, &end, 10);
+    if (end == start) {
+        return false;
+    }
+    
+    value = parsed;
+    return true;
+}
+
+bool FindIntField(std::string_view data, const char* key, int& value) {
+    long long parsed = 0;
+    if (!FindIntField(data, key, parsed)) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool FindFloatField(std::string_view data, const char* key, float& value) {
+    const char* start = FindFieldValue(data, key);
+    if (!start) {
+        return false;
+    }
+    
+    char* end = nullptr;
+    double parsed = strtod(start, &end);
+    if (end == start) {
+        return false;
+    }
+    
+    value = static_cast<float>(parsed);
+    return true;
+}
+
+bool FindBoolField(std::string_view data, const char* key) {
+    const char* start = FindFieldValue(data, key);
+    return start && strncmp(start, "true", 4) == 0;
+}
+
+// Strings are taken up to the closing quote; escapes keep the escaped character
+bool FindStringField(std::string_view data, const char* key, std::string& value) {
+    const char* start = FindFieldValue(data, key);
+    const char* end = data.data() + data.size();
+    if (!start || start >= end || *start != '"') {
+        return false;
+    }
+    
+    value.clear();
+    for (const char* p = start + 1; p < end; p++) {
+        if (*p == '"') {
+            return true;
+        }
+        if (*p == '\\' && p + 1 < end) {
+            p++;
+        }
+        value += *p;
+    }
+    return false;
+}
+
+// Calls visit(port, object) for each entry of "players":[{...},{...}]; player
+// objects are flat. Returns the number of entries.
+template <typename Visit>
+int ForEachPlayer(std::string_view data, Visit&& visit) {
+    const char* start = FindFieldValue(data, "players");
+    if (!start || *start != '[') {
+        return 0;
+    }
+    
+    std::string_view rest = data.substr(start - data.data());
+    size_t end = rest.find(']');
+    rest = rest.substr(0, end);
+    
+    size_t pos = 0;
+    int index = 0;
+    while (index < 4 && (pos = rest.find('{', pos)) != std::string_view::npos) {
+        size_t close = rest.find('}', pos);
+        std::string_view object = rest.substr(pos, close == std::string_view::npos ? close : close - pos);
+        pos = close;
+        
+        int port = index;
+        FindIntField(object, "port", port);
+        if (port < 0 || port >= 4) {
+            port = index;
+        }
+        visit(port, object);
+        
+        index++;
+        if (pos == std::string_view::npos) {
+            break;
+        }
+    }
+    return index;
+}
+
+void ParsePlayers(std::string_view data, GameState& state) {
+    state.activePlayerCount = ForEachPlayer(data, [&state](int port, std::string_view object) {
+        PlayerState& player = state.players[port];
+        FindFloatField(object, "x", player.positionX);
+        FindFloatField(object, "y", player.positionY);
+        FindFloatField(object, "facing", player.facing);
+        FindFloatField(object, "percent", player.damage);
+        FindIntField(object, "stocks", player.stocks);
+        FindIntField(object, "character", player.character);
+        FindIntField(object, "action", player.actionState);
+        player.isInHitstun = FindBoolField(object, "hitstun");
+        player.isInShieldstun = FindBoolField(object, "shieldstun");
+        player.isOffstage = FindBoolField(object, "offstage");
+    });
+}
+
+// {"type":"event","event":"gameStart","stage":31,"matchId":"mode.ranked-...","gameNumber":2,
+//  "players":[{"port":0,"character":2,"code":"ABCD#123","name":"abcd","team":1},...]}
+// "team" is only sent in teams mode, "matchId" and "gameNumber" by overlays
+// that read Slippi's match info
+void ParseGameStart(std::string_view data, GameStartInfo& info) {
+    info = GameStartInfo();
+    FindIntField(data, "stage", info.stage);
+    FindStringField(data, "matchId", info.matchId);
+    FindIntField(data, "gameNumber", info.gameNumber);
+    ForEachPlayer(data, [&info](int port, std::string_view object) {
+        FindIntField(object, "character", info.characters[port]);
+        FindIntField(object, "team", info.teams[port]);
+        FindStringField(object, "code", info.connectCodes[port]);
+        FindStringField(object, "name", info.displayNames[port]);
+    });
+}
+
+// Identifies a game across an app restart: the same players on the same stage
+// in the same match
+uint64_t GameStartKey(const GameStartInfo& info) {
+    ContentHash::Hasher hasher;
+    hasher.Update(&info.stage, sizeof(info.stage));
+    hasher.Update(info.characters, sizeof(info.characters));
+    for (const std::string& code : info.connectCodes) {
+        hasher.Update(code.data(), code.size() + 1);
+    }
+    hasher.Update(info.matchId.data(), info.matchId.size() + 1);
+    hasher.Update(&info.gameNumber, sizeof(info.gameNumber));
+    return hasher.Digest();
+}
+
+// Whether a frame can belong to the same game as an earlier one: same
+// characters in the same slots, the clock and stocks not gone backwards
+bool ContinuesGame(const GameState& earlier, const GameState& state) {
+    if (state.activePlayerCount != earlier.activePlayerCount || state.stage != earlier.stage ||
+        state.frameCount < earlier.frameCount) {
+        return false;
+    }
+    int count = std::min(state.activePlayerCount, 4);
+    for (int i = 0; i < count; i++) {
+        if (state.players[i].character != earlier.players[i].character ||
+            state.players[i].stocks > earlier.players[i].stocks) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// {"type":"event","event":"gameEnd","method":7,"winner":-1,"lrasInitiator":1}
+// "winner" is left out when the overlay can't tell (no contest, teams)
+void ParseGameEnd(std::string_view data, GameEndInfo& info) {
+    info = GameEndInfo();
+    FindIntField(data, "method", info.method);
+    FindIntField(data, "winner", info.winner);
+    FindIntField(data, "lrasInitiator", info.lrasInitiator);
+}
+
+} // namespace
 
 GameDataInterface::GameDataInterface() 
     : m_isMonitoring(false), m_shouldStopMonitoring(false) {
@@ -13,7 +208,63 @@ GameDataInterface::GameDataInterface()
     // Initialize game state
     memset(&m_currentGameState, 0, sizeof(GameState));
     
-    std::wcout << L"GameDataInterface initialized" << std::endl;
+    RegisterDetectors();
+    
+    LOG_INFO("GameDataInterface initialized");
+}
+
+void GameDataInterface::RegisterDetectors() {
+    DetectorInfo info;
+    info.name = "Frame history";
+    info.outputs = "Frames of every game this session, for the game timeline";
+    info.fields = FIELD_POSITION | FIELD_PERCENT | FIELD_STOCKS | FIELD_CHARACTER | FIELD_ACTION;
+    info.focus = FOCUS_REVIEW;
+    m_detectors.Register(info, [this](const GameState& state) { m_frameHistory.Observe(state); },
+                         [this]() { m_frameHistory.BeginGame(); });
+    
+    info.name = "Highlights";
+    info.outputs = "Highlight reel (combos, kills, comebacks)";
+    info.fields = FIELD_PERCENT | FIELD_STOCKS;
+    info.focus = FOCUS_COMBOS;
+    m_detectors.Register(info, [this](const GameState& state) { m_highlights.Observe(state); },
+                         [this]() { m_highlights.BeginGame(); });
+    
+    // Runs before the detectors that need to know who hit whom; teams come
+    // from the game start, which is recorded before BeginGame
+    info.name = "Player pairs";
+    info.outputs = "Distances, facing, threat ranges and attackers for every pair";
+    info.fields = FIELD_POSITION | FIELD_PERCENT | FIELD_STOCKS | FIELD_FACING;
+    info.focus = FOCUS_NEUTRAL | FOCUS_COMBOS | FOCUS_EDGEGUARDING;
+    m_detectors.Register(info, [this](const GameState& state) { m_pairs.Observe(state); },
+                         [this]() { m_pairs.BeginGame(m_lastGameStart.teams); });
+    
+    info.name = "Neutral";
+    info.outputs = "Neutral wins and losses, pressure";
+    info.fields = FIELD_PERCENT | FIELD_STOCKS;
+    info.focus = FOCUS_NEUTRAL;
+    m_detectors.Register(info, [this](const GameState& state) { m_neutral.Observe(state, m_pairs, m_focusStats); },
+                         [this]() { m_neutral.BeginGame(m_focusStats); });
+    
+    info.name = "Punishes";
+    info.outputs = "Hits, punishes and combos by attacker";
+    info.fields = FIELD_PERCENT | FIELD_STOCKS;
+    info.focus = FOCUS_COMBOS;
+    m_detectors.Register(info, [this](const GameState& state) { m_punishes.Observe(state, m_pairs, m_focusStats); },
+                         [this]() { m_punishes.BeginGame(m_focusStats); });
+    
+    info.name = "Edgeguards";
+    info.outputs = "Edgeguards and edgeguard kills";
+    info.fields = FIELD_PERCENT | FIELD_STOCKS | FIELD_OFFSTAGE;
+    info.focus = FOCUS_EDGEGUARDING;
+    m_detectors.Register(info, [this](const GameState& state) { m_edgeguards.Observe(state, m_pairs, m_focusStats); },
+                         [this]() { m_edgeguards.BeginGame(m_focusStats); });
+    
+    info.name = "Recovery";
+    info.outputs = "Recoveries and failed recoveries";
+    info.fields = FIELD_STOCKS | FIELD_OFFSTAGE;
+    info.focus = FOCUS_RECOVERY;
+    m_detectors.Register(info, [this](const GameState& state) { m_recovery.Observe(state, m_focusStats); },
+                         [this]() { m_recovery.BeginGame(m_focusStats); });
 }
 
 GameDataInterface::~GameDataInterface() {
@@ -30,24 +281,24 @@ bool GameDataInterface::StartMonitoring() {
         return true;
     }
     
-    std::wcout << L"Starting game data monitoring..." << std::endl;
+    LOG_INFO("Starting game data monitoring...");
     
     // Find game process
     DWORD processId = FindGameProcessId();
     if (processId == 0) {
-        std::wcout << L"No game process found" << std::endl;
+        LOG_INFO("No game process found");
         return false;
     }
     
     // Inject DLL
     if (!InjectDLL(processId)) {
-        std::wcout << L"Failed to inject DLL" << std::endl;
+        LOG_ERROR("Failed to inject DLL");
         return false;
     }
     
     // Create named pipe connection
     if (!CreateNamedPipeConnection()) {
-        std::wcout << L"Failed to create pipe connection" << std::endl;
+        LOG_ERROR("Failed to create pipe connection");
         EjectDLL(processId);
         return false;
     }
@@ -57,7 +308,7 @@ bool GameDataInterface::StartMonitoring() {
     m_monitoringThread = std::thread(&GameDataInterface::MonitoringThreadProc, this);
     
     m_isMonitoring = true;
-    std::wcout << L"Game data monitoring started successfully" << std::endl;
+    LOG_INFO("Game data monitoring started successfully");
     
     return true;
 }
@@ -67,7 +318,7 @@ void GameDataInterface::StopMonitoring() {
         return;
     }
     
-    std::wcout << L"Stopping game data monitoring..." << std::endl;
+    LOG_INFO("Stopping game data monitoring...");
     
     m_shouldStopMonitoring = true;
     m_isMonitoring = false;
@@ -80,7 +331,16 @@ void GameDataInterface::StopMonitoring() {
         m_monitoringThread.join();
     }
     
-    std::wcout << L"Game data monitoring stopped" << std::endl;
+    // Persist the final state so the next start picks up from here
+    if (m_checkpointWriter) {
+        {
+            std::lock_guard<std::mutex> lock(m_gameStateMutex);
+            SubmitCheckpoint();
+        }
+        m_checkpointWriter->Flush();
+    }
+    
+    LOG_INFO("Game data monitoring stopped");
 }
 
 bool GameDataInterface::InjectDLL(DWORD processId) {
@@ -91,7 +351,7 @@ bool GameDataInterface::InjectDLL(DWORD processId) {
     
     std::wstring dllPath = GetDLLPath();
     if (dllPath.empty()) {
-        std::wcout << L"DLL not found" << std::endl;
+        LOG_INFO("DLL not found");
         return false;
     }
     
@@ -129,6 +389,94 @@ std::vector<GameEvent> GameDataInterface::GetRecentEvents(int maxEvents) const {
     );
 }
 
+FrameClockStats GameDataInterface::GetFrameClockStats() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    return m_frameClock.GetStats();
+}
+
+IngestStats GameDataInterface::GetIngestStats() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    IngestStats stats = m_ingestStats;
+    if (m_checkpointWriter) {
+        stats.checkpointsWritten = m_checkpointWriter->GetWrittenCount();
+    }
+    return stats;
+}
+
+uint64_t GameDataInterface::GetLastGameStart(GameStartInfo& info) const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    info = m_lastGameStart;
+    return m_gameStartCount;
+}
+
+uint64_t GameDataInterface::GetLastGameEnd(GameEndInfo& info) const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    info = m_lastGameEnd;
+    return m_gameEndCount;
+}
+
+LiveAnalytics GameDataInterface::GetLiveAnalytics() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    return m_liveAnalytics;
+}
+
+HighlightScorer GameDataInterface::GetHighlights() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    return m_highlights;
+}
+
+void GameDataInterface::SetFocus(uint8_t focus) {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    m_detectors.SetFocus(focus);
+    LOG_INFO("Coaching focus: {}", FocusToString(focus));
+}
+
+std::vector<DetectorStatus> GameDataInterface::GetDetectorStatus() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    return m_detectors.GetStatus();
+}
+
+FocusStats GameDataInterface::GetFocusStats() const {
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    return m_focusStats;
+}
+
+bool GameDataInterface::EnableCheckpoints(const std::filesystem::path& path) {
+    auto start = std::chrono::steady_clock::now();
+    
+    LiveCheckpoint checkpoint;
+    bool restored = LiveCheckpointFile::Read(path, checkpoint);
+    int64_t ageMs = 0;
+    if (restored) {
+        ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() - checkpoint.savedAtMs;
+        restored = ageMs >= 0 && ageMs <= MAX_CHECKPOINT_AGE_MS;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    if (restored) {
+        m_liveAnalytics = checkpoint.analytics;
+        m_currentGameState = checkpoint.state;
+        m_lastCheckpointFrame = checkpoint.state.frameCount;
+        m_gameKey = checkpoint.gameKey;
+        m_resumePending = true;
+        
+        // The first live frame decides whether this is still the same game
+        m_lastSeq = -1;
+        
+        // Detector, pair and focus state isn't checkpointed; start it over
+        // rather than leave it half-filled from a game that may have ended
+        m_detectors.BeginGame();
+        
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("Restored live checkpoint at seq {} frame {} ({} s old) in {} ms", checkpoint.seq,
+                 checkpoint.state.frameCount, ageMs / 1000, elapsedMs);
+    }
+    
+    m_checkpointWriter = std::make_unique<CheckpointWriter>(path);
+    return restored;
+}
+
 void GameDataInterface::SetGameStateCallback(GameStateCallback callback) {
     m_gameStateCallback = callback;
 }
@@ -159,21 +507,21 @@ DWORD GameDataInterface::FindGameProcessId() const {
 }
 
 void GameDataInterface::MonitoringThreadProc() {
-    std::wcout << L"Monitoring thread started" << std::endl;
+    LOG_INFO("Monitoring thread started");
     
     while (!m_shouldStopMonitoring) {
         // Check if game process is still running
         DWORD processId = FindGameProcessId();
         if (processId == 0) {
-            std::wcout << L"Game process lost" << std::endl;
+            LOG_WARN("Game process lost");
             break;
         }
         
         // Check if DLL is still injected
         if (!IsDLLInjected(processId)) {
-            std::wcout << L"DLL injection lost, attempting to re-inject..." << std::endl;
+            LOG_WARN("DLL injection lost, attempting to re-inject...");
             if (!InjectDLL(processId)) {
-                std::wcout << L"Failed to re-inject DLL" << std::endl;
+                LOG_ERROR("Failed to re-inject DLL");
                 break;
             }
         }
@@ -181,11 +529,11 @@ void GameDataInterface::MonitoringThreadProc() {
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
     
-    std::wcout << L"Monitoring thread ended" << std::endl;
+    LOG_INFO("Monitoring thread ended");
 }
 
 void GameDataInterface::PipeReaderThreadProc() {
-    std::wcout << L"Pipe reader thread started" << std::endl;
+    LOG_INFO("Pipe reader thread started");
     
     char buffer[4096];
     std::string messageBuffer;
@@ -193,6 +541,9 @@ void GameDataInterface::PipeReaderThreadProc() {
     while (!m_pipeConnection->shouldStop) {
         DWORD bytesRead;
         if (ReadFile(m_pipeConnection->pipe, buffer, sizeof(buffer) - 1, &bytesRead, nullptr)) {
+            // Stamp on arrival, before any parsing, so frame timing sees transport jitter only
+            FrameClock::Clock::time_point arrival = FrameClock::Clock::now();
+            
             if (bytesRead > 0) {
                 buffer[bytesRead] = '\0';
                 messageBuffer += buffer;
@@ -204,20 +555,20 @@ void GameDataInterface::PipeReaderThreadProc() {
                     messageBuffer.erase(0, pos + 1);
                     
                     if (!message.empty()) {
-                        ProcessIncomingData(message);
+                        ProcessIncomingData(message, arrival);
                     }
                 }
             }
         } else {
             DWORD error = GetLastError();
             if (error != ERROR_BROKEN_PIPE) {
-                std::wcout << L"Pipe read error: " << error << std::endl;
+                COACH_LOG(LogLevel::WARN, 1, "Pipe read error: {}", error);
             }
             break;
         }
     }
     
-    std::wcout << L"Pipe reader thread ended" << std::endl;
+    LOG_INFO("Pipe reader thread ended");
 }
 
 bool GameDataInterface::CreateNamedPipeConnection() {
@@ -225,7 +576,7 @@ bool GameDataInterface::CreateNamedPipeConnection() {
     
     // Wait for pipe to become available
     if (!WaitNamedPipe(pipeName, 5000)) {
-        std::wcout << L"Pipe not available" << std::endl;
+        LOG_INFO("Pipe not available");
         return false;
     }
     
@@ -234,7 +585,7 @@ bool GameDataInterface::CreateNamedPipeConnection() {
                             OPEN_EXISTING, 0, nullptr);
     
     if (pipe == INVALID_HANDLE_VALUE) {
-        std::wcout << L"Failed to connect to pipe: " << GetLastError() << std::endl;
+        LOG_ERROR("Failed to connect to pipe: {}", GetLastError());
         return false;
     }
     
@@ -245,7 +596,7 @@ bool GameDataInterface::CreateNamedPipeConnection() {
     // Start reader thread
     m_pipeConnection->readerThread = std::thread(&GameDataInterface::PipeReaderThreadProc, this);
     
-    std::wcout << L"Named pipe connection established" << std::endl;
+    LOG_INFO("Named pipe connection established");
     return true;
 }
 
@@ -272,7 +623,7 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
     // Open target process
     HANDLE processHandle = OpenProcess(PROCESS_ALL_ACCESS, FALSE, processId);
     if (!processHandle) {
-        std::wcout << L"Failed to open process: " << GetLastError() << std::endl;
+        LOG_ERROR("Failed to open process: {}", GetLastError());
         return false;
     }
     
@@ -282,14 +633,14 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
                                         MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
     
     if (!remoteMemory) {
-        std::wcout << L"Failed to allocate memory in target process" << std::endl;
+        LOG_ERROR("Failed to allocate memory in target process");
         CloseHandle(processHandle);
         return false;
     }
     
     // Write DLL path to target process
     if (!WriteProcessMemory(processHandle, remoteMemory, dllPath.c_str(), pathSize, nullptr)) {
-        std::wcout << L"Failed to write DLL path to target process" << std::endl;
+        LOG_ERROR("Failed to write DLL path to target process");
         VirtualFreeEx(processHandle, remoteMemory, 0, MEM_RELEASE);
         CloseHandle(processHandle);
         return false;
@@ -300,7 +651,7 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
     LPVOID loadLibraryAddr = GetProcAddress(kernel32, "LoadLibraryW");
     
     if (!loadLibraryAddr) {
-        std::wcout << L"Failed to get LoadLibraryW address" << std::endl;
+        LOG_ERROR("Failed to get LoadLibraryW address");
         VirtualFreeEx(processHandle, remoteMemory, 0, MEM_RELEASE);
         CloseHandle(processHandle);
         return false;
@@ -312,7 +663,7 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
                                            remoteMemory, 0, nullptr);
     
     if (!remoteThread) {
-        std::wcout << L"Failed to create remote thread" << std::endl;
+        LOG_ERROR("Failed to create remote thread");
         VirtualFreeEx(processHandle, remoteMemory, 0, MEM_RELEASE);
         CloseHandle(processHandle);
         return false;
@@ -331,7 +682,7 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
     VirtualFreeEx(processHandle, remoteMemory, 0, MEM_RELEASE);
     
     if (!dllModule) {
-        std::wcout << L"DLL injection failed" << std::endl;
+        LOG_ERROR("DLL injection failed");
         CloseHandle(processHandle);
         return false;
     }
@@ -343,7 +694,7 @@ bool GameDataInterface::InjectDLLIntoProcess(DWORD processId, const std::wstring
     injectedProcess.dllModule = dllModule;
     m_injectedProcesses.push_back(injectedProcess);
     
-    std::wcout << L"DLL injected successfully into process " << processId << std::endl;
+    LOG_INFO("DLL injected successfully into process {}", processId);
     return true;
 }
 
@@ -376,7 +727,7 @@ bool GameDataInterface::EjectDLLFromProcess(DWORD processId) {
     CloseHandle(it->processHandle);
     m_injectedProcesses.erase(it);
     
-    std::wcout << L"DLL ejected from process " << processId << std::endl;
+    LOG_INFO("DLL ejected from process {}", processId);
     return true;
 }
 
@@ -406,38 +757,242 @@ std::wstring GameDataInterface::GetDLLPath() const {
     return path;
 }
 
-void GameDataInterface::ProcessIncomingData(const std::string& data) {
+void GameDataInterface::ProcessIncomingData(const std::string& data, FrameClock::Clock::time_point arrival) {
     // Parse JSON-like data from DLL
     if (data.find("\"type\":\"gameState\"") != std::string::npos) {
-        ParseGameStateUpdate(data);
+        ParseGameStateUpdate(data, arrival);
     } else if (data.find("\"type\":\"event\"") != std::string::npos) {
-        ParseGameEvent(data);
+        ParseGameEvent(data, arrival);
     }
 }
 
-void GameDataInterface::ParseGameStateUpdate(const std::string& data) {
-    // Simple parsing - in a real implementation, use a JSON library
+// gameState messages from the overlay look like
+//   {"type":"gameState","seq":1041,"frame":980,"stage":31,"players":[
+//     {"port":0,"character":2,"x":-12.5,"y":0.0,"facing":1,"percent":34.0,"stocks":3,"action":14,"hitstun":false},...]}
+// "seq" goes up by one per message. After a "resync" command the overlay
+// answers with the same layout plus "full":true, numbered with the seq of the
+// frame it describes. Overlays that send no "seq" fall back to frame gaps.
+void GameDataInterface::ParseGameStateUpdate(const std::string& data, FrameClock::Clock::time_point arrival) {
+    GameState state = {};
+    bool hasFrame = FindIntField(data, "frame", state.frameCount);
+    FindIntField(data, "stage", state.stage);
+    ParsePlayers(data, state);
+    state.isInGame = state.activePlayerCount > 0;
+    
+    long long seq = -1;
+    bool hasSeq = FindIntField(data, "seq", seq);
+    bool isFull = FindBoolField(data, "full");
+    
     std::lock_guard<std::mutex> lock(m_gameStateMutex);
+    m_ingestStats.messages++;
+    
+    // Resync replies describe a frame that has already been timed
+    FrameArrival frameArrival;
+    if (hasFrame && !isFull) {
+        frameArrival = m_frameClock.OnFrame(state.frameCount, arrival);
+        if (frameArrival.isLagSpike) {
+            COACH_LOG(LogLevel::WARN, 1, "Lag spike: frame {} arrived {} ms late", state.frameCount,
+                      m_frameClock.GetStats().lastSpikeMs);
+        }
+        if (frameArrival.missingFrames > 0) {
+            LOG_DEBUG("Frame gap: {} frames missing before frame {}", frameArrival.missingFrames, state.frameCount);
+        }
+        state.frameTimestamp = frameArrival.timestamp;
+    } else if (hasFrame) {
+        state.frameTimestamp = m_frameClock.FrameToSeconds(state.frameCount);
+    } else {
+        state.frameTimestamp = m_frameClock.ToSeconds(arrival);
+    }
     
-    // For now, just update frame count as an example
-    size_t framePos = data.find("\"frame\":");
-    if (framePos != std::string::npos) {
-        framePos += 8; // Skip "frame":
-        size_t endPos = data.find_first_of(",}", framePos);
-        if (endPos != std::string::npos) {
-            std::string frameStr = data.substr(framePos, endPos - framePos);
-            m_currentGameState.frameCount = std::stoi(frameStr);
+    if (m_resumePending && state.activePlayerCount > 0) {
+        ResumeFromCheckpoint(state);
+    }
+    
+    if (isFull) {
+        if (!hasSeq) {
+            return;
+        }
+        CompleteResync(seq, state);
+    } else if (hasSeq) {
+        if (!ApplySequencedFrame(seq, state, arrival)) {
+            return;
+        }
+        m_currentGameState = state;
+    } else if (!frameArrival.isRepeat) {
+        if (state.activePlayerCount > 0) {
+            if (frameArrival.missingFrames > 0) {
+                m_ingestStats.gaps++;
+                m_ingestStats.missingMessages += static_cast<uint64_t>(frameArrival.missingFrames);
+                m_ingestStats.rebaselines++;
+                m_liveAnalytics.Rebaseline(state);
+            } else {
+                m_liveAnalytics.Apply(state);
+            }
         }
+        m_currentGameState = state;
+    } else {
+        return;
+    }
+    
+    // Detectors see frames as they arrive; a resync shows up as a skipped-ahead frame
+    if (m_currentGameState.activePlayerCount > 0) {
+        m_detectors.Observe(m_currentGameState);
+    }
+    
+    // Optimistic analytics during a resync aren't worth keeping
+    if (m_checkpointWriter && !m_resyncPending && m_liveAnalytics.HasBaseline() &&
+        std::abs(m_currentGameState.frameCount - m_lastCheckpointFrame) >= CHECKPOINT_INTERVAL_FRAMES) {
+        SubmitCheckpoint();
     }
     
     NotifyGameStateUpdate();
 }
 
-void GameDataInterface::ParseGameEvent(const std::string& data) {
+bool GameDataInterface::ApplySequencedFrame(long long seq, const GameState& state, FrameClock::Clock::time_point arrival) {
+    if (m_lastSeq >= 0 && seq <= m_lastSeq) {
+        if (m_lastSeq - seq <= SEQ_RESTART_DISTANCE) {
+            m_ingestStats.duplicates++;
+            return false;
+        }
+        
+        // The overlay restarted and its numbering with it
+        LOG_INFO("Sequence restarted at {} (was {})", seq, m_lastSeq);
+        m_lastSeq = -1;
+        m_resyncPending = false;
+        m_bufferedFrames.clear();
+        m_liveAnalytics.Reset();
+    }
+    
+    long long missing = m_lastSeq >= 0 ? seq - m_lastSeq - 1 : 0;
+    m_lastSeq = seq;
+    
+    if (m_resyncPending && arrival - m_resyncRequestedAt > std::chrono::milliseconds(RESYNC_TIMEOUT_MS)) {
+        // No reply; the rebaseline made at the gap stands
+        COACH_LOG(LogLevel::WARN, 1, "Resync timed out, {} buffered frames dropped", m_bufferedFrames.size());
+        m_ingestStats.resyncTimeouts++;
+        m_ingestStats.rebaselines++;
+        m_resyncPending = false;
+        m_bufferedFrames.clear();
+    }
+    
+    bool hasPlayers = state.activePlayerCount > 0;
+    
+    if (missing > 0) {
+        m_ingestStats.gaps++;
+        m_ingestStats.missingMessages += static_cast<uint64_t>(missing);
+        LOG_DEBUG("Sequence gap: {} messages missing before seq {}", missing, seq);
+        
+        if (!m_resyncPending && missing <= MAX_RESYNC_GAP && m_liveAnalytics.HasBaseline()) {
+            m_checkpoint = m_liveAnalytics;
+            if (SendCommandToDLL("resync")) {
+                m_resyncPending = true;
+                m_resyncRequestedAt = arrival;
+                m_ingestStats.resyncRequests++;
+            }
+        }
+        if (!m_resyncPending) {
+            m_ingestStats.rebaselines++;
+        }
+        
+        // Keep the live numbers moving until the snapshot arrives
+        if (hasPlayers) {
+            m_liveAnalytics.Rebaseline(state);
+        }
+    } else if (hasPlayers) {
+        m_liveAnalytics.Apply(state);
+    }
+    
+    if (m_resyncPending) {
+        if (m_bufferedFrames.size() >= MAX_BUFFERED_FRAMES) {
+            COACH_LOG(LogLevel::WARN, 1, "Resync buffer full, continuing from the current frame");
+            m_ingestStats.resyncTimeouts++;
+            m_ingestStats.rebaselines++;
+            m_resyncPending = false;
+            m_bufferedFrames.clear();
+        } else {
+            m_bufferedFrames.push_back({seq, state});
+        }
+    }
+    
+    return true;
+}
+
+void GameDataInterface::CompleteResync(long long seq, const GameState& snapshot) {
+    if (m_resyncPending) {
+        // Roll forward from the last contiguous frame: the snapshot closes the
+        // gap, then the frames received since are re-applied on top of it
+        m_liveAnalytics = m_checkpoint;
+        m_liveAnalytics.Rebaseline(snapshot);
+        
+        size_t rolledForward = 0;
+        for (const BufferedFrame& frame : m_bufferedFrames) {
+            if (frame.seq > seq && frame.state.activePlayerCount > 0) {
+                m_liveAnalytics.Apply(frame.state);
+                rolledForward++;
+            }
+        }
+        
+        m_ingestStats.resyncsCompleted++;
+        m_ingestStats.rolledForwardFrames += rolledForward;
+        m_resyncPending = false;
+        m_bufferedFrames.clear();
+        LOG_DEBUG("Resync at seq {} completed, {} frames rolled forward", seq, rolledForward);
+    } else {
+        // Unsolicited snapshot, e.g. the overlay's own keyframe
+        m_liveAnalytics.Rebaseline(snapshot);
+    }
+    
+    if (seq >= m_lastSeq) {
+        m_lastSeq = seq;
+        m_currentGameState = snapshot;
+    }
+}
+
+void GameDataInterface::ResumeFromCheckpoint(const GameState& state) {
+    m_resumePending = false;
+    
+    if (ContinuesGame(m_currentGameState, state)) {
+        // Whatever happened while the app was down shows up as one gap
+        m_liveAnalytics.Rebaseline(state);
+        m_ingestStats.rebaselines++;
+        LOG_INFO("Resumed checkpointed game at frame {} (checkpoint frame {})", state.frameCount,
+                 m_currentGameState.frameCount);
+    } else {
+        m_liveAnalytics.Reset();
+        m_gameKey = 0;
+        LOG_INFO("Checkpoint is from another game, live analytics start over at frame {}", state.frameCount);
+    }
+}
+
+void GameDataInterface::SubmitCheckpoint() {
+    if (!m_checkpointWriter || !m_liveAnalytics.HasBaseline()) {
+        return;
+    }
+    
+    LiveCheckpoint checkpoint;
+    checkpoint.seq = m_lastSeq;
+    checkpoint.savedAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    checkpoint.gameKey = m_gameKey;
+    checkpoint.state = m_currentGameState;
+    checkpoint.analytics = m_liveAnalytics;
+    m_checkpointWriter->Submit(checkpoint);
+    m_lastCheckpointFrame = m_currentGameState.frameCount;
+}
+
+void GameDataInterface::ParseGameEvent(const std::string& data, FrameClock::Clock::time_point arrival) {
     // Simple event parsing
     GameEvent event = {};
-    
-    if (data.find("\"combo\"") != std::string::npos) {
+    GameStartInfo gameStart;
+    GameEndInfo gameEnd;
+    
+    if (data.find("\"gameStart\"") != std::string::npos) {
+        event.type = GameEvent::GAME_START;
+        ParseGameStart(data, gameStart);
+    } else if (data.find("\"gameEnd\"") != std::string::npos) {
+        event.type = GameEvent::GAME_END;
+        ParseGameEnd(data, gameEnd);
+    } else if (data.find("\"combo\"") != std::string::npos) {
         event.type = GameEvent::COMBO_START;
     } else if (data.find("\"kill\"") != std::string::npos) {
         event.type = GameEvent::KILL;
@@ -445,11 +1000,40 @@ void GameDataInterface::ParseGameEvent(const std::string& data) {
         event.type = GameEvent::STOCK_LOST;
     }
     
-    event.timestamp = GetTickCount() / 1000.0f;
     event.data = data;
     
     {
         std::lock_guard<std::mutex> lock(m_gameStateMutex);
+        
+        // Events carrying a frame are placed on the frame clock; others use their arrival time
+        if (FindIntField(data, "frame", event.frame) && m_frameClock.IsSynchronized()) {
+            event.timestamp = m_frameClock.FrameToSeconds(event.frame);
+        } else {
+            event.frame = m_frameClock.GetLastFrame();
+            event.timestamp = m_frameClock.ToSeconds(arrival);
+        }
+        
+        if (event.type == GameEvent::GAME_START) {
+            uint64_t gameKey = GameStartKey(gameStart);
+            if (m_resumePending && gameKey != m_gameKey) {
+                // A different game started while the app was down
+                m_resumePending = false;
+                m_liveAnalytics.Reset();
+                LOG_INFO("Checkpoint is from another game, live analytics start over");
+            }
+            m_gameKey = gameKey;
+            m_lastGameStart = gameStart;
+            m_gameStartCount++;
+            m_detectors.BeginGame();
+            
+            // The new game's frames start over at -123; without this they'd
+            // be taken for repeats until they passed the last game's
+            m_frameClock.Reset();
+        } else if (event.type == GameEvent::GAME_END) {
+            m_lastGameEnd = gameEnd;
+            m_gameEndCount++;
+        }
+        
         m_recentEvents.push_back(event);
         
         // Keep only recent events
@@ -7,47 +7,29 @@
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <filesystem>
+#include "DetectorRegistry.h"
+#include "FocusDetectors.h"
+#include "FrameClock.h"
+#include "FrameHistory.h"
+#include "GameState.h"
+#include "HighlightScorer.h"
+#include "LiveAnalytics.h"
+#include "LiveCheckpoint.h"
+#include "PlayerPairs.h"
 
-// Game state structures
-struct PlayerState {
-    float positionX;
-    float positionY;
-    float damage;
-    int stocks;
-    int character;
-    int actionState;
-    bool isInHitstun;
-    bool isInShieldstun;
-    bool isOffstage;
-};
-
-struct GameState {
-    PlayerState players[4];
-    int activePlayerCount;
-    int frameCount;
-    int stage;
-    bool isInGame;
-    bool isPaused;
-    float gameTimer;
-};
-
-struct GameEvent {
-    enum Type {
-        GAME_START,
-        GAME_END,
-        STOCK_LOST,
-        COMBO_START,
-        COMBO_END,
-        KILL,
-        TECH,
-        EDGEGUARD,
-        NEUTRAL_WIN
-    };
-    
-    Type type;
-    int playerId;
-    float timestamp;
-    std::string data;
+// Live stream health, for measuring data quality under load
+struct IngestStats {
+    uint64_t messages = 0;
+    uint64_t gaps = 0;                  // Sequence jumps
+    uint64_t missingMessages = 0;       // Total messages skipped by those jumps
+    uint64_t duplicates = 0;            // Stale or repeated sequence numbers, ignored
+    uint64_t resyncRequests = 0;
+    uint64_t resyncsCompleted = 0;
+    uint64_t resyncTimeouts = 0;
+    uint64_t rebaselines = 0;           // Gaps healed from the next snapshot without a resync
+    uint64_t rolledForwardFrames = 0;   // Buffered frames re-applied after a resync
+    uint64_t checkpointsWritten = 0;
 };
 
 // Callback types
@@ -72,6 +54,35 @@ public:
     // Data access
     GameState GetCurrentGameState() const;
     std::vector<GameEvent> GetRecentEvents(int maxEvents = 10) const;
+    FrameClockStats GetFrameClockStats() const;
+    IngestStats GetIngestStats() const;
+    LiveAnalytics GetLiveAnalytics() const;
+    
+    // Highlights scored from every ingested frame this session (a copy)
+    HighlightScorer GetHighlights() const;
+    
+    // Every ingested frame this session, by game; does its own locking
+    FrameHistory& GetFrameHistory() { return m_frameHistory; }
+    
+    // Per-frame detectors: only those serving an area in focus (FocusArea
+    // flags) run. Status carries each one's cost; stats are the current game's.
+    void SetFocus(uint8_t focus);
+    std::vector<DetectorStatus> GetDetectorStatus() const;
+    FocusStats GetFocusStats() const;
+    
+    // Players of the latest gameStart event; returns how many have arrived so
+    // far (0 = none), so callers can tell a new game from one already handled
+    uint64_t GetLastGameStart(GameStartInfo& info) const;
+    
+    // The latest gameEnd event, counted the same way
+    uint64_t GetLastGameEnd(GameEndInfo& info) const;
+    
+    // Restores the live analytics from a recent checkpoint at this path, if
+    // any, then keeps checkpointing there. Returns true if state was restored.
+    bool EnableCheckpoints(const std::filesystem::path& path);
+    
+    // Where the frame history moves older games once the in-memory budget is used
+    void EnableFrameArchive(const std::filesystem::path& path) { m_frameHistory.SetArchiveFile(path); }
     
     // Callback registration
     void SetGameStateCallback(GameStateCallback callback);
@@ -97,6 +108,51 @@ private:
     mutable std::mutex m_gameStateMutex;
     GameState m_currentGameState;
     std::vector<GameEvent> m_recentEvents;
+    GameStartInfo m_lastGameStart;
+    uint64_t m_gameStartCount = 0;
+    GameEndInfo m_lastGameEnd;
+    uint64_t m_gameEndCount = 0;
+    FrameClock m_frameClock;
+    
+    // Gap detection and resync. The overlay numbers each gameState message with
+    // "seq"; a jump starts a resync, and the "full":true snapshot it answers
+    // with is rolled forward from the checkpoint taken before the gap.
+    struct BufferedFrame {
+        long long seq;
+        GameState state;
+    };
+    static constexpr int MAX_RESYNC_GAP = 120;         // Larger gaps just rebaseline
+    static constexpr int MAX_BUFFERED_FRAMES = 240;
+    static constexpr int RESYNC_TIMEOUT_MS = 500;
+    static constexpr int SEQ_RESTART_DISTANCE = 600;   // Sequence this far back = overlay restarted
+    
+    LiveAnalytics m_liveAnalytics;
+    LiveAnalytics m_checkpoint;
+    HighlightScorer m_highlights;
+    FrameHistory m_frameHistory;
+    DetectorRegistry m_detectors;
+    PlayerPairs m_pairs;
+    NeutralDetector m_neutral;
+    PunishDetector m_punishes;
+    EdgeguardDetector m_edgeguards;
+    RecoveryDetector m_recovery;
+    FocusStats m_focusStats;
+    IngestStats m_ingestStats;
+    long long m_lastSeq = -1;
+    bool m_resyncPending = false;
+    FrameClock::Clock::time_point m_resyncRequestedAt;
+    std::vector<BufferedFrame> m_bufferedFrames;
+    
+    // Warm restart: the overlay's numbering may have started over, so the
+    // first live frame sets a new seq baseline. The restored analytics are
+    // kept only if that frame continues the checkpointed game (and a gameStart
+    // seen meanwhile has the same fingerprint); otherwise they're dropped.
+    static constexpr int CHECKPOINT_INTERVAL_FRAMES = 60;
+    static constexpr int64_t MAX_CHECKPOINT_AGE_MS = 15 * 60 * 1000;
+    std::unique_ptr<CheckpointWriter> m_checkpointWriter;
+    int m_lastCheckpointFrame = 0;
+    uint64_t m_gameKey = 0;
+    bool m_resumePending = false;
     
     // Callbacks
     GameStateCallback m_gameStateCallback;
@@ -126,9 +182,14 @@ private:
     std::wstring GetDLLPath() const;
     
     // Data processing
-    void ProcessIncomingData(const std::string& data);
-    void ParseGameStateUpdate(const std::string& data);
-    void ParseGameEvent(const std::string& data);
+    void ProcessIncomingData(const std::string& data, FrameClock::Clock::time_point arrival);
+    void ParseGameStateUpdate(const std::string& data, FrameClock::Clock::time_point arrival);
+    void ParseGameEvent(const std::string& data, FrameClock::Clock::time_point arrival);
+    bool ApplySequencedFrame(long long seq, const GameState& state, FrameClock::Clock::time_point arrival);
+    void CompleteResync(long long seq, const GameState& snapshot);
+    void SubmitCheckpoint();
+    void ResumeFromCheckpoint(const GameState& state);
+    void RegisterDetectors();
     void NotifyGameStateUpdate();
     void NotifyGameEvent(const GameEvent& event);
     
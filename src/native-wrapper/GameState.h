@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+
+// Game state structures
+struct PlayerState {
+    float positionX;
+    float positionY;
+    float facing;       // +1 right, -1 left; 0 if the overlay doesn't send it
+    float damage;
+    int stocks;
+    int character;
+    int actionState;
+    bool isInHitstun;
+    bool isInShieldstun;
+    bool isOffstage;
+};
+
+struct GameState {
+    PlayerState players[4];
+    int activePlayerCount;
+    int frameCount;
+    int stage;
+    bool isInGame;
+    bool isPaused;
+    float gameTimer;
+    double frameTimestamp;  // Seconds on the frame clock for frameCount
+};
+
+// Who is playing, from the overlay's gameStart event
+struct GameStartInfo {
+    int stage = 0;
+    int characters[4] = {-1, -1, -1, -1};
+    int teams[4] = {-1, -1, -1, -1};    // Team ids in teams mode, -1 otherwise
+    std::string connectCodes[4];    // Empty outside Slippi online
+    std::string displayNames[4];
+    std::string matchId;            // Slippi match id; empty if the overlay doesn't send one
+    int gameNumber = 0;             // Game within the match, from 1; 0 if not sent
+};
+
+// The overlay's gameEnd event. method is Slippi's: 1 time out, 2 stocks out,
+// 7 no contest (LRAS or a disconnect); 0 if the overlay didn't send it.
+struct GameEndInfo {
+    int method = 0;
+    int winner = -1;            // Port the overlay reports as the winner; -1 if it didn't say
+    int lrasInitiator = -1;     // Port that quit with L+R+A+Start; -1 if none
+};
+
+struct GameEvent {
+    enum Type {
+        GAME_START,
+        GAME_END,
+        STOCK_LOST,
+        COMBO_START,
+        COMBO_END,
+        KILL,
+        TECH,
+        EDGEGUARD,
+        NEUTRAL_WIN
+    };
+    
+    Type type;
+    int playerId;
+    int frame;          // Game frame the event belongs to
+    double timestamp;   // Seconds on the frame clock
+    std::string data;
+    
+    // Typed payload, set by sources that know it (COMBO_END and KILL from
+    // frame tracking); overlay events only carry their raw data
+    int targetId = -1;      // Player comboed or killed
+    int startFrame = 0;     // First frame of a combo
+    int hits = 0;
+    float damage = 0.0f;    // Combo damage, or the victim's percent when killed
+};
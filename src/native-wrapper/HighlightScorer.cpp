@@ -0,0 +1,445 @@
+#include "HighlightScorer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+const int FIRST_FRAME = -123;               // Melee's first frame number
+const float MIN_COMBO_DAMAGE = 15.0f;       // Smaller strings aren't worth a clip
+const int KILL_LEAD_FRAMES = 60;
+const int COMEBACK_LEAD_FRAMES = 600;
+
+bool ScoreGreater(const Highlight& a, const Highlight& b) {
+    return a.score > b.score;
+}
+
+std::string EscapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+bool WritePlaybackQueue(const std::filesystem::path& file, const std::vector<PlaybackClip>& clips) {
+    std::ofstream out(file, std::ios::trunc);
+    if (!out) {
+        LOG_ERROR("Failed to write playback queue: {}", file.wstring());
+        return false;
+    }
+
+    out << "{\n  \"mode\": \"queue\",\n  \"replay\": \"\",\n  \"isRealTimeMode\": false,\n"
+        << "  \"outputOverlayFiles\": true,\n  \"queue\": [";
+    for (size_t i = 0; i < clips.size(); i++) {
+        out << (i > 0 ? ",\n" : "\n")
+            << "    {\"path\": \"" << EscapeJson(clips[i].replay.u8string()) << "\""
+            << ", \"startFrame\": " << std::max(FIRST_FRAME, clips[i].startFrame)
+            << ", \"endFrame\": " << clips[i].endFrame << "}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+void HighlightScorer::BeginGame() {
+    EndGame();
+
+    m_gameNumber++;
+    GameRecord record;
+    record.game = m_gameNumber;
+    m_games.push_back(record);
+    if (m_games.size() > GAME_HISTORY) {
+        m_games.pop_front();
+    }
+
+    m_inGame = true;
+    m_hasFrame = false;
+    for (PlayerTrack& track : m_players) {
+        track = PlayerTrack();
+    }
+    m_swingSamples.clear();
+}
+
+void HighlightScorer::EndGame() {
+    if (!m_inGame) {
+        return;
+    }
+
+    if (m_hasFrame && m_playerCount == 2) {
+        for (int i = 0; i < 2; i++) {
+            if (m_players[i].comboHits > 0) {
+                EndCombo(i, m_players[i].lastHitFrame);
+            }
+        }
+    }
+    CommitPending();
+    m_inGame = false;
+}
+
+void HighlightScorer::Observe(const GameState& state) {
+    int count = std::min(state.activePlayerCount, 4);
+    int frame = state.frameCount;
+
+    // Stocks only go down within a game; after a game ends, frames are
+    // ignored until they reset
+    bool restarted = false;
+    if (m_hasFrame) {
+        restarted = count != m_playerCount || frame < m_lastFrame - MERGE_GAP_FRAMES;
+        for (int i = 0; i < count && !restarted; i++) {
+            restarted = state.players[i].stocks > m_players[i].stocks;
+        }
+    }
+    if (restarted || (!m_inGame && !m_hasFrame)) {
+        BeginGame();
+    }
+    if (!m_inGame) {
+        return;
+    }
+
+    if (!m_hasFrame) {
+        for (int i = 0; i < count; i++) {
+            m_players[i].percent = state.players[i].damage;
+            m_players[i].stocks = state.players[i].stocks;
+        }
+        m_playerCount = count;
+        m_lastFrame = frame;
+        m_hasFrame = true;
+        
+        // Live frames are kept by port; empty ports have no stocks
+        if (!m_games.empty()) {
+            GameRecord& record = m_games.back();
+            record.stage = state.stage;
+            for (int port = 0; port < 4; port++) {
+                record.characters[port] = state.players[port].stocks > 0 ? state.players[port].character : -1;
+            }
+            int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.startedAtMs = nowMs - static_cast<int64_t>(frame - FIRST_FRAME) * 1000 / 60;
+            record.lastFrame = frame;
+        }
+        return;
+    }
+
+    if (frame <= m_lastFrame) {
+        return;
+    }
+    bool contiguous = frame == m_lastFrame + 1;
+    m_lastFrame = frame;
+    if (!m_games.empty()) {
+        m_games.back().lastFrame = frame;
+    }
+    if (count != 2) {
+        return;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        PlayerTrack& track = m_players[i];
+        const PlayerState& current = state.players[i];
+
+        if (current.stocks < track.stocks) {
+            float percentAtDeath = track.percent;
+            track.stocks = current.stocks;
+            if (track.comboHits > 0) {
+                EndCombo(i, frame);
+            }
+
+            GameEvent kill = {};
+            kill.type = GameEvent::KILL;
+            kill.playerId = 1 - i;
+            kill.targetId = i;
+            kill.frame = frame;
+            kill.damage = percentAtDeath;
+            OnEvent(kill);
+        } else if (current.damage > track.percent) {
+            bool comboOver = track.comboHits == 0 || frame - track.lastHitFrame > COMBO_TIMEOUT_FRAMES;
+            if (!contiguous) {
+                // Hits in the missing frames can't be told apart; start over
+                track.comboHits = 0;
+                track.comboDamage = 0.0f;
+                comboOver = true;
+            } else if (comboOver && track.comboHits > 0) {
+                EndCombo(i, track.lastHitFrame);
+            }
+
+            if (comboOver) {
+                track.comboStartFrame = frame;
+            }
+            track.comboHits++;
+            track.comboDamage += current.damage - track.percent;
+            track.lastHitFrame = frame;
+        } else if (track.comboHits > 0 && frame - track.lastHitFrame > COMBO_TIMEOUT_FRAMES) {
+            EndCombo(i, track.lastHitFrame);
+        }
+
+        track.percent = current.damage;
+    }
+
+    int stockLead = m_players[0].stocks - m_players[1].stocks;
+    m_players[0].worstDeficit = std::max(m_players[0].worstDeficit, -stockLead);
+    m_players[1].worstDeficit = std::max(m_players[1].worstDeficit, stockLead);
+
+    ObserveSwing(frame);
+
+    if (m_players[0].stocks == 0 || m_players[1].stocks == 0) {
+        EndGame();
+    }
+}
+
+void HighlightScorer::OnEvent(const GameEvent& event) {
+    if (!m_inGame || event.playerId < 0 || event.playerId >= 4 || event.targetId < 0 || event.targetId >= 4) {
+        return;
+    }
+
+    Highlight moment;
+    moment.game = m_gameNumber;
+    moment.player = event.playerId;
+    moment.endFrame = event.frame;
+
+    if (event.type == GameEvent::COMBO_END) {
+        if (event.damage < MIN_COMBO_DAMAGE) {
+            return;
+        }
+        moment.kinds = Highlight::COMBO;
+        moment.startFrame = event.startFrame;
+        moment.score = event.damage + 4.0f * event.hits;
+        AddMoment(moment);
+    } else if (event.type == GameEvent::KILL) {
+        // Early kills and game-winning ones rate higher
+        const PlayerTrack& killer = m_players[event.playerId];
+        const PlayerTrack& victim = m_players[event.targetId];
+        moment.kinds = Highlight::KILL;
+        moment.startFrame = event.frame - KILL_LEAD_FRAMES;
+        moment.score = 40.0f + std::max(0.0f, 120.0f - event.damage) * 0.4f + (victim.stocks == 0 ? 25.0f : 0.0f);
+        AddMoment(moment);
+
+        // Drawing level after being two or more stocks down
+        if (killer.worstDeficit >= 2 && killer.stocks >= victim.stocks) {
+            Highlight comeback = moment;
+            comeback.kinds = Highlight::COMEBACK;
+            comeback.startFrame = event.frame - COMEBACK_LEAD_FRAMES;
+            comeback.score = 50.0f + 25.0f * killer.worstDeficit;
+            m_players[event.playerId].worstDeficit = 0;
+            AddMoment(comeback);
+        }
+    }
+}
+
+std::vector<Highlight> HighlightScorer::GetGameHighlights(uint32_t game) const {
+    const GameRecord* record = FindGame(game);
+    if (!record) {
+        return {};
+    }
+
+    std::vector<Highlight> heap = record->top;
+    if (m_hasPending && m_pending.game == game) {
+        PushBounded(heap, m_pending, GAME_TOP_N);
+    }
+    return SortedBest(heap);
+}
+
+std::vector<Highlight> HighlightScorer::GetSessionHighlights() const {
+    std::vector<Highlight> heap = m_sessionTop;
+    if (m_hasPending) {
+        PushBounded(heap, m_pending, SESSION_TOP_N);
+    }
+    return SortedBest(heap);
+}
+
+void HighlightScorer::AssignReplays(const std::vector<ReplayInfo>& replays) {
+    std::vector<bool> used(replays.size(), false);
+    for (const GameRecord& record : m_games) {
+        for (size_t i = 0; i < replays.size(); i++) {
+            used[i] = used[i] || (!record.replay.empty() && record.replay == replays[i].path);
+        }
+    }
+
+    for (auto it = m_games.rbegin(); it != m_games.rend(); ++it) {
+        GameRecord& record = *it;
+        if (!record.replay.empty() || record.startedAtMs == 0) {
+            continue;
+        }
+
+        size_t best = replays.size();
+        int64_t bestSkew = 0;
+        int bestLengthGap = 0;
+        for (size_t i = 0; i < replays.size(); i++) {
+            const ReplayInfo& replay = replays[i];
+            if (used[i] || replay.stage != record.stage ||
+                !std::equal(std::begin(record.characters), std::end(record.characters), replay.characters)) {
+                continue;
+            }
+            int64_t skew = std::llabs(replay.startedAtMs - record.startedAtMs);
+            int lengthGap = std::abs(replay.lastFrame - record.lastFrame);
+            if (skew > MAX_START_SKEW_MS) {
+                continue;
+            }
+            if (best == replays.size() || skew < bestSkew || (skew == bestSkew && lengthGap < bestLengthGap)) {
+                best = i;
+                bestSkew = skew;
+                bestLengthGap = lengthGap;
+            }
+        }
+
+        if (best < replays.size()) {
+            record.replay = replays[best].path;
+            used[best] = true;
+        } else {
+            LOG_DEBUG("No replay matches highlight game {}", record.game);
+        }
+    }
+}
+
+void HighlightScorer::SetReplay(uint32_t game, const std::filesystem::path& replay) {
+    if (GameRecord* record = FindGame(game)) {
+        record->replay = replay;
+    }
+}
+
+int HighlightScorer::ExportPlaybackQueue(const std::filesystem::path& file,
+                                         const std::vector<Highlight>& highlights) const {
+    std::vector<Highlight> ordered = highlights;
+    std::sort(ordered.begin(), ordered.end(), [](const Highlight& a, const Highlight& b) {
+        return a.game != b.game ? a.game < b.game : a.startFrame < b.startFrame;
+    });
+
+    std::vector<PlaybackClip> clips;
+    for (const Highlight& highlight : ordered) {
+        const GameRecord* record = FindGame(highlight.game);
+        if (!record || record->replay.empty()) {
+            continue;
+        }
+        clips.push_back(PlaybackClip{record->replay, highlight.startFrame - LEAD_IN_FRAMES,
+                                     highlight.endFrame + FOLLOW_FRAMES});
+    }
+
+    if (!WritePlaybackQueue(file, clips)) {
+        return -1;
+    }
+    return static_cast<int>(clips.size());
+}
+
+void HighlightScorer::EndCombo(int victim, int frame) {
+    PlayerTrack& track = m_players[victim];
+    if (track.comboHits >= 2) {
+        GameEvent combo = {};
+        combo.type = GameEvent::COMBO_END;
+        combo.playerId = 1 - victim;
+        combo.targetId = victim;
+        combo.frame = frame;
+        combo.startFrame = track.comboStartFrame;
+        combo.hits = track.comboHits;
+        combo.damage = track.comboDamage;
+        OnEvent(combo);
+    }
+    track.comboHits = 0;
+    track.comboDamage = 0.0f;
+}
+
+void HighlightScorer::ObserveSwing(int frame) {
+    if (!m_swingSamples.empty() && frame - m_swingSamples.back().frame < SWING_SAMPLE_FRAMES) {
+        return;
+    }
+
+    float now = WinProbability();
+    const SwingSample* from = nullptr;
+    for (const SwingSample& sample : m_swingSamples) {
+        if (!from || std::fabs(now - sample.winProbability) > std::fabs(now - from->winProbability)) {
+            from = &sample;
+        }
+    }
+
+    if (from && std::fabs(now - from->winProbability) >= SWING_THRESHOLD) {
+        Highlight swing;
+        swing.game = m_gameNumber;
+        swing.player = now > from->winProbability ? 0 : 1;
+        swing.startFrame = from->frame;
+        swing.endFrame = frame;
+        swing.score = 100.0f * std::fabs(now - from->winProbability);
+        swing.kinds = Highlight::SWING;
+        m_swingSamples.clear();
+        AddMoment(swing);
+    }
+
+    m_swingSamples.push_back(SwingSample{frame, now});
+    if (m_swingSamples.size() > SWING_WINDOW) {
+        m_swingSamples.pop_front();
+    }
+}
+
+float HighlightScorer::WinProbability() const {
+    // Stock lead plus percent lead, where 150% counts as a stock
+    float lead = static_cast<float>(m_players[0].stocks - m_players[1].stocks) +
+                 (m_players[1].percent - m_players[0].percent) / 150.0f;
+    return 1.0f / (1.0f + std::exp(-1.4f * lead));
+}
+
+void HighlightScorer::AddMoment(const Highlight& moment) {
+    if (m_hasPending && moment.game == m_pending.game &&
+        moment.startFrame <= m_pending.endFrame + MERGE_GAP_FRAMES &&
+        moment.endFrame >= m_pending.startFrame - MERGE_GAP_FRAMES &&
+        std::max(moment.endFrame, m_pending.endFrame) - std::min(moment.startFrame, m_pending.startFrame) <=
+            MAX_CLIP_FRAMES) {
+        // One clip; the stronger moment decides whose it is
+        if (moment.score > m_pending.score) {
+            m_pending.player = moment.player;
+        }
+        m_pending.startFrame = std::min(m_pending.startFrame, moment.startFrame);
+        m_pending.endFrame = std::max(m_pending.endFrame, moment.endFrame);
+        m_pending.score = std::max(m_pending.score, moment.score) + 0.5f * std::min(m_pending.score, moment.score);
+        m_pending.kinds |= moment.kinds;
+        return;
+    }
+
+    CommitPending();
+    m_pending = moment;
+    m_hasPending = true;
+}
+
+void HighlightScorer::CommitPending() {
+    if (!m_hasPending) {
+        return;
+    }
+    if (GameRecord* record = FindGame(m_pending.game)) {
+        PushBounded(record->top, m_pending, GAME_TOP_N);
+    }
+    PushBounded(m_sessionTop, m_pending, SESSION_TOP_N);
+    m_hasPending = false;
+}
+
+HighlightScorer::GameRecord* HighlightScorer::FindGame(uint32_t game) {
+    return const_cast<GameRecord*>(static_cast<const HighlightScorer*>(this)->FindGame(game));
+}
+
+const HighlightScorer::GameRecord* HighlightScorer::FindGame(uint32_t game) const {
+    // Games are numbered consecutively, so the record is found by offset
+    if (m_games.empty() || game < m_games.front().game || game > m_games.back().game) {
+        return nullptr;
+    }
+    return &m_games[game - m_games.front().game];
+}
+
+void HighlightScorer::PushBounded(std::vector<Highlight>& heap, const Highlight& highlight, size_t capacity) {
+    if (heap.size() < capacity) {
+        heap.push_back(highlight);
+        std::push_heap(heap.begin(), heap.end(), ScoreGreater);
+    } else if (!heap.empty() && highlight.score > heap.front().score) {
+        std::pop_heap(heap.begin(), heap.end(), ScoreGreater);
+        heap.back() = highlight;
+        std::push_heap(heap.begin(), heap.end(), ScoreGreater);
+    }
+}
+
+std::vector<Highlight> HighlightScorer::SortedBest(const std::vector<Highlight>& heap) {
+    std::vector<Highlight> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), ScoreGreater);
+    return sorted;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "GameState.h"
+
+// Rates highlight-worthy moments while frames are ingested and keeps the best
+// ones in bounded min-heaps, GAME_TOP_N per game and SESSION_TOP_N for the
+// session, so a highlight reel is ready the moment a session ends.
+//
+// Frames are turned into typed COMBO_END and KILL events (OnEvent also takes
+// them from other sources); comebacks and win-probability swings are scored
+// from the running stocks and percents. Moments that overlap, such as a combo
+// and the kill that ends it, are merged into one highlight before they are
+// ranked. Attribution needs an opponent, so only singles are scored.
+//
+//   HighlightScorer scorer;
+//   for each frame: scorer.Observe(state);
+//   scorer.EndGame();
+//   scorer.ExportPlaybackQueue("reel.json", scorer.GetSessionHighlights());
+
+struct Highlight {
+    enum Kind : uint8_t {
+        COMBO = 1,
+        KILL = 2,
+        COMEBACK = 4,
+        SWING = 8           // Win probability moved sharply
+    };
+
+    uint32_t game = 0;      // HighlightScorer game number
+    int player = -1;        // Who made the moment happen
+    int startFrame = 0;
+    int endFrame = 0;
+    float score = 0.0f;
+    uint8_t kinds = 0;      // Kind flags of everything merged into it
+};
+
+// One Slippi Dolphin playback queue entry
+struct PlaybackClip {
+    std::filesystem::path replay;
+    int startFrame = 0;
+    int endFrame = 0;
+};
+
+// What a replay file says about its game, for matching it to a scored one
+struct ReplayInfo {
+    std::filesystem::path path;
+    int stage = -1;
+    int characters[4] = {-1, -1, -1, -1};   // By port, -1 for empty ports
+    int lastFrame = 0;
+    int64_t startedAtMs = 0;                // Wall clock, estimated from the file time
+};
+
+// Writes a playback queue ({"mode":"queue","queue":[...]}), clips in the
+// given order. Start frames are clamped to Melee's first frame.
+bool WritePlaybackQueue(const std::filesystem::path& file, const std::vector<PlaybackClip>& clips);
+
+class HighlightScorer {
+public:
+    static constexpr size_t GAME_TOP_N = 5;
+    static constexpr size_t SESSION_TOP_N = 20;
+    static constexpr size_t GAME_HISTORY = 128;
+    static constexpr int COMBO_TIMEOUT_FRAMES = 45;     // Same as LiveAnalytics
+    static constexpr int MERGE_GAP_FRAMES = 60;         // Moments closer than this become one...
+    static constexpr int MAX_CLIP_FRAMES = 900;         // ...unless the clip would get longer than this
+    static constexpr int LEAD_IN_FRAMES = 120;          // Exported before each highlight
+    static constexpr int FOLLOW_FRAMES = 60;            // Exported after
+    static constexpr int64_t MAX_START_SKEW_MS = 120 * 1000;    // Replay vs live start time
+
+    // Ends the current game, if any, and starts numbering a new one.
+    // Observe also starts games on its own when stocks reset.
+    void BeginGame();
+    void EndGame();
+    bool IsInGame() const { return m_inGame; }
+
+    // Next frame of the current game; frames that skip ahead close open
+    // combos without scoring them
+    void Observe(const GameState& state);
+
+    // Scores a typed COMBO_END or KILL event; other types are ignored
+    void OnEvent(const GameEvent& event);
+
+    // Best moments of a game (current or recent) and of the session, best first
+    std::vector<Highlight> GetGameHighlights(uint32_t game) const;
+    std::vector<Highlight> GetSessionHighlights() const;
+    uint32_t GetCurrentGame() const { return m_gameNumber; }
+
+    // Replay files are matched to games after the fact, by stage, the
+    // character in each port and start time (within MAX_START_SKEW_MS), the
+    // closest start and then the closest length winning. Each replay goes to
+    // one game; games without a match keep no replay.
+    void AssignReplays(const std::vector<ReplayInfo>& replays);
+    void SetReplay(uint32_t game, const std::filesystem::path& replay);
+
+    // Writes a Slippi Dolphin playback queue ({"mode":"queue","queue":[...]})
+    // with one entry per highlight, in game order. Highlights from games
+    // without a replay are skipped; returns how many were written, or -1.
+    int ExportPlaybackQueue(const std::filesystem::path& file, const std::vector<Highlight>& highlights) const;
+
+private:
+    struct PlayerTrack {
+        float percent = 0.0f;
+        int stocks = 0;
+        int comboHits = 0;
+        float comboDamage = 0.0f;
+        int comboStartFrame = 0;
+        int lastHitFrame = 0;
+        int worstDeficit = 0;       // Most stocks this player has been behind
+    };
+
+    struct GameRecord {
+        uint32_t game = 0;
+        std::filesystem::path replay;
+        std::vector<Highlight> top;     // Min-heap on score
+        
+        // Taken from the live frames, to match the replay by
+        int stage = -1;
+        int characters[4] = {-1, -1, -1, -1};
+        int64_t startedAtMs = 0;
+        int lastFrame = 0;
+    };
+
+    // Win probability samples for swing detection, one every SWING_SAMPLE_FRAMES
+    static constexpr int SWING_SAMPLE_FRAMES = 30;
+    static constexpr int SWING_WINDOW = 10;
+    static constexpr float SWING_THRESHOLD = 0.35f;
+
+    struct SwingSample {
+        int frame;
+        float winProbability;       // For the first of the two players
+    };
+
+    void EndCombo(int victim, int frame);
+    void ObserveSwing(int frame);
+    float WinProbability() const;
+    void AddMoment(const Highlight& moment);
+    void CommitPending();
+    GameRecord* FindGame(uint32_t game);
+    const GameRecord* FindGame(uint32_t game) const;
+
+    static void PushBounded(std::vector<Highlight>& heap, const Highlight& highlight, size_t capacity);
+    static std::vector<Highlight> SortedBest(const std::vector<Highlight>& heap);
+
+    bool m_inGame = false;
+    bool m_hasFrame = false;
+    uint32_t m_gameNumber = 0;
+    int m_lastFrame = 0;
+    int m_playerCount = 0;
+    PlayerTrack m_players[4];
+    std::deque<SwingSample> m_swingSamples;
+
+    bool m_hasPending = false;
+    Highlight m_pending;                // Latest moment, still open to merging
+
+    std::deque<GameRecord> m_games;
+    std::vector<Highlight> m_sessionTop;    // Min-heap on score
+};
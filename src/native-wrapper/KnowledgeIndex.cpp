@@ -0,0 +1,286 @@
+#include "KnowledgeIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char* const STOP_WORDS[] = {
+    "a", "an", "and", "are", "as", "at", "be", "by", "for", "from", "in", "is", "it",
+    "of", "on", "or", "so", "the", "to", "with", "you", "your"
+};
+
+bool IsStopWord(const std::string& token) {
+    for (const char* stopWord : STOP_WORDS) {
+        if (token == stopWord) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string Trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(start, end - start + 1);
+}
+
+std::string ToLower(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+std::vector<std::string> SplitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = ToLower(Trim(item));
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::string CharacterKey(const std::string& character) {
+    return "c:" + ToLower(Trim(character));
+}
+
+std::string TagKey(const std::string& tag) {
+    return "t:" + ToLower(Trim(tag));
+}
+
+} // namespace
+
+bool KnowledgeIndex::LoadCorpus(const std::filesystem::path& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path.string();
+        return false;
+    }
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return LoadCorpusText(contents.str(), error);
+}
+
+bool KnowledgeIndex::LoadCorpusText(const std::string& text, std::string& error) {
+    Clear();
+
+    std::stringstream stream(text);
+    std::string line;
+    int lineNumber = 0;
+    int entryLine = 1;
+    KnowledgeSnippet snippet;
+    bool inHeader = true;
+    bool hasContent = false;
+
+    auto finishEntry = [&]() {
+        if (hasContent) {
+            if (snippet.id.empty() || snippet.text.empty()) {
+                error = "entry at line " + std::to_string(entryLine) + " needs an id and text";
+                return false;
+            }
+            AddSnippet(snippet);
+        }
+        snippet = KnowledgeSnippet();
+        inHeader = true;
+        hasContent = false;
+        entryLine = lineNumber + 1;
+        return true;
+    };
+
+    while (std::getline(stream, line)) {
+        lineNumber++;
+        std::string trimmed = Trim(line);
+
+        if (trimmed == "---") {
+            if (!finishEntry()) {
+                return false;
+            }
+            continue;
+        }
+        if (trimmed.empty() || trimmed[0] == '#') {
+            continue;
+        }
+        hasContent = true;
+
+        if (inHeader) {
+            size_t colon = trimmed.find(':');
+            std::string key = colon != std::string::npos ? Trim(trimmed.substr(0, colon)) : "";
+            std::string value = colon != std::string::npos ? Trim(trimmed.substr(colon + 1)) : "";
+            if (key == "id") {
+                snippet.id = value;
+                continue;
+            } else if (key == "characters") {
+                snippet.characters = SplitList(value);
+                continue;
+            } else if (key == "tags") {
+                snippet.tags = SplitList(value);
+                continue;
+            }
+            inHeader = false;
+        }
+
+        if (!snippet.text.empty()) {
+            snippet.text += ' ';
+        }
+        snippet.text += trimmed;
+    }
+
+    return finishEntry();
+}
+
+void KnowledgeIndex::Clear() {
+    m_snippets.clear();
+    m_lengths.clear();
+    m_totalLength = 0;
+    m_termIds.clear();
+    m_postings.clear();
+    m_keyIds.clear();
+    m_keySnippets.clear();
+}
+
+void KnowledgeIndex::AddSnippet(const KnowledgeSnippet& snippet) {
+    uint32_t index = static_cast<uint32_t>(m_snippets.size());
+    m_snippets.push_back(snippet);
+
+    std::vector<std::string> tokens;
+    Tokenize(snippet.text, tokens);
+    m_lengths.push_back(static_cast<uint32_t>(tokens.size()));
+    m_totalLength += tokens.size();
+
+    std::unordered_map<std::string, uint32_t> frequencies;
+    for (const std::string& token : tokens) {
+        frequencies[token]++;
+    }
+    for (const auto& entry : frequencies) {
+        auto inserted = m_termIds.emplace(entry.first, static_cast<uint32_t>(m_postings.size()));
+        if (inserted.second) {
+            m_postings.emplace_back();
+        }
+        m_postings[inserted.first->second].push_back({index, entry.second});
+    }
+
+    std::vector<std::string> keys;
+    for (const std::string& character : snippet.characters) {
+        keys.push_back(CharacterKey(character));
+    }
+    for (const std::string& tag : snippet.tags) {
+        keys.push_back(TagKey(tag));
+    }
+    AddKeyPostings(index, keys);
+}
+
+std::vector<KnowledgeHit> KnowledgeIndex::Search(const KnowledgeQuery& query) const {
+    std::vector<KnowledgeHit> hits;
+    size_t count = m_snippets.size();
+    if (count == 0 || query.topK == 0) {
+        return hits;
+    }
+
+    std::vector<float> scores(count, 0.0f);
+    std::vector<uint8_t> characterMatches(count, 0);
+    float averageLength = static_cast<float>(m_totalLength) / count;
+
+    std::vector<std::string> tokens;
+    Tokenize(query.text, tokens);
+    for (const std::string& token : tokens) {
+        auto term = m_termIds.find(token);
+        if (term == m_termIds.end()) {
+            continue;
+        }
+
+        const std::vector<Posting>& postings = m_postings[term->second];
+        float documentFrequency = static_cast<float>(postings.size());
+        float idf = std::log(1.0f + (count - documentFrequency + 0.5f) / (documentFrequency + 0.5f));
+        for (const Posting& posting : postings) {
+            float tf = static_cast<float>(posting.termFrequency);
+            float norm = BM25_K1 * (1.0f - BM25_B + BM25_B * m_lengths[posting.snippet] / averageLength);
+            scores[posting.snippet] += idf * tf * (BM25_K1 + 1.0f) / (tf + norm);
+        }
+    }
+
+    std::vector<uint32_t> seenCharacters;
+    for (const std::string& character : query.characters) {
+        auto key = m_keyIds.find(CharacterKey(character));
+        if (key == m_keyIds.end() ||
+            std::find(seenCharacters.begin(), seenCharacters.end(), key->second) != seenCharacters.end()) {
+            continue;
+        }
+        seenCharacters.push_back(key->second);
+        for (uint32_t snippet : m_keySnippets[key->second]) {
+            characterMatches[snippet]++;
+            scores[snippet] += CHARACTER_BOOST;
+        }
+    }
+
+    for (const std::string& tag : query.tags) {
+        auto key = m_keyIds.find(TagKey(tag));
+        if (key == m_keyIds.end()) {
+            continue;
+        }
+        for (uint32_t snippet : m_keySnippets[key->second]) {
+            scores[snippet] += TAG_BOOST;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (scores[i] <= 0.0f) {
+            continue;
+        }
+        if (characterMatches[i] < m_snippets[i].characters.size()) {
+            continue;
+        }
+        hits.push_back({i, scores[i]});
+    }
+
+    size_t keep = std::min(query.topK, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(),
+                      [](const KnowledgeHit& a, const KnowledgeHit& b) {
+                          return a.score != b.score ? a.score > b.score : a.snippet < b.snippet;
+                      });
+    hits.resize(keep);
+    return hits;
+}
+
+void KnowledgeIndex::Tokenize(const std::string& text, std::vector<std::string>& tokens) {
+    tokens.clear();
+    std::string token;
+    for (size_t i = 0; i <= text.size(); i++) {
+        unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : 0;
+        if (c < 128 && std::isalnum(c)) {
+            token += static_cast<char>(std::tolower(c));
+            continue;
+        }
+        if (!token.empty() && !IsStopWord(token)) {
+            tokens.push_back(token);
+        }
+        token.clear();
+    }
+}
+
+uint32_t KnowledgeIndex::GetKeyId(const std::string& key) {
+    auto inserted = m_keyIds.emplace(key, static_cast<uint32_t>(m_keySnippets.size()));
+    if (inserted.second) {
+        m_keySnippets.emplace_back();
+    }
+    return inserted.first->second;
+}
+
+void KnowledgeIndex::AddKeyPostings(uint32_t snippet, const std::vector<std::string>& keys) {
+    for (const std::string& key : keys) {
+        std::vector<uint32_t>& snippets = m_keySnippets[GetKeyId(key)];
+        // The same key listed twice on one snippet counts once
+        if (snippets.empty() || snippets.back() != snippet) {
+            snippets.push_back(snippet);
+        }
+    }
+}
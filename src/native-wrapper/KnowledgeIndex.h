@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// BM25 retrieval over the coaching knowledge corpus (src/knowledge/coaching-notes.txt):
+// matchup notes, tips and frame-data facts, each tagged with characters and
+// situations. The JS side (utils/knowledgeIndex.js) reads the same file with
+// the same tokenizer and scoring.
+//
+// Snippets about specific characters are only returned when the query names
+// all of them (a Fox-Marth note needs both); general snippets always qualify.
+// Matching characters and tags add a fixed boost on top of the text score.
+
+struct KnowledgeSnippet {
+    std::string id;
+    std::string text;
+    std::vector<std::string> characters;  // Lowercase; empty for general notes
+    std::vector<std::string> tags;        // Lowercase
+};
+
+struct KnowledgeQuery {
+    std::string text;
+    std::vector<std::string> characters;
+    std::vector<std::string> tags;
+    size_t topK = 5;
+};
+
+struct KnowledgeHit {
+    uint32_t snippet;
+    float score;
+};
+
+class KnowledgeIndex {
+public:
+    static constexpr float BM25_K1 = 1.2f;
+    static constexpr float BM25_B = 0.75f;
+    static constexpr float CHARACTER_BOOST = 1.0f;
+    static constexpr float TAG_BOOST = 0.5f;
+
+    // Replaces the index contents. Returns false and fills error if the file
+    // can't be read or an entry has no id or text.
+    bool LoadCorpus(const std::filesystem::path& path, std::string& error);
+    bool LoadCorpusText(const std::string& text, std::string& error);
+
+    void Clear();
+    void AddSnippet(const KnowledgeSnippet& snippet);
+
+    // Best matches first; only snippets with a positive score
+    std::vector<KnowledgeHit> Search(const KnowledgeQuery& query) const;
+
+    const KnowledgeSnippet& GetSnippet(uint32_t index) const { return m_snippets[index]; }
+    size_t GetSnippetCount() const { return m_snippets.size(); }
+    size_t GetTermCount() const { return m_termIds.size(); }
+
+    // Lowercase ASCII letter/digit runs, minus a few stop words
+    static void Tokenize(const std::string& text, std::vector<std::string>& tokens);
+
+private:
+    struct Posting {
+        uint32_t snippet;
+        uint32_t termFrequency;
+    };
+
+    uint32_t GetKeyId(const std::string& key);
+    void AddKeyPostings(uint32_t snippet, const std::vector<std::string>& keys);
+
+    std::vector<KnowledgeSnippet> m_snippets;
+    std::vector<uint32_t> m_lengths;            // Tokens per snippet
+    uint64_t m_totalLength = 0;
+
+    std::unordered_map<std::string, uint32_t> m_termIds;
+    std::vector<std::vector<Posting>> m_postings;   // Indexed by term id
+
+    // Characters and tags share one key space; lists of snippets per key
+    std::unordered_map<std::string, uint32_t> m_keyIds;
+    std::vector<std::vector<uint32_t>> m_keySnippets;
+};
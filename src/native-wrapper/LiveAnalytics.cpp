@@ -0,0 +1,117 @@
+#include "LiveAnalytics.h"
+#include <algorithm>
+
+void LiveAnalytics::Reset() {
+    *this = LiveAnalytics();
+}
+
+void LiveAnalytics::Apply(const GameState& state) {
+    if (IsNewGame(state)) {
+        Rebaseline(state);
+        return;
+    }
+
+    int count = std::min(state.activePlayerCount, MAX_PLAYERS);
+    int frame = state.frameCount;
+    for (int i = 0; i < count; i++) {
+        LivePlayerStats& player = m_players[i];
+        const PlayerState& current = state.players[i];
+
+        if (current.stocks < player.stocks) {
+            player.stocksLost += player.stocks - current.stocks;
+            EndCombo(i);
+        } else if (current.damage > player.percent) {
+            float damage = current.damage - player.percent;
+            CreditDamage(i, damage);
+
+            if (player.comboHits == 0 || frame - player.lastHitFrame > COMBO_TIMEOUT_FRAMES) {
+                EndCombo(i);
+                player.comboStartFrame = frame;
+            }
+            player.comboHits++;
+            player.comboDamage += damage;
+            player.lastHitFrame = frame;
+        } else if (player.comboHits > 0 && frame - player.lastHitFrame > COMBO_TIMEOUT_FRAMES) {
+            EndCombo(i);
+        }
+
+        player.stocks = current.stocks;
+        player.percent = current.damage;
+    }
+
+    m_lastFrame = frame;
+}
+
+void LiveAnalytics::Rebaseline(const GameState& state) {
+    if (m_hasBaseline && IsNewGame(state)) {
+        Reset();
+    }
+
+    int count = std::min(state.activePlayerCount, MAX_PLAYERS);
+
+    for (int i = 0; i < count; i++) {
+        LivePlayerStats& player = m_players[i];
+        const PlayerState& current = state.players[i];
+
+        // Whatever happened in the unseen frames can't be attributed to a combo
+        EndCombo(i);
+
+        if (m_hasBaseline && i < m_playerCount) {
+            if (current.stocks < player.stocks) {
+                player.stocksLost += player.stocks - current.stocks;
+            } else if (current.stocks == player.stocks && current.damage > player.percent) {
+                CreditDamage(i, current.damage - player.percent);
+            }
+        }
+
+        player.stocks = current.stocks;
+        player.percent = current.damage;
+    }
+
+    m_playerCount = count;
+    m_lastFrame = state.frameCount;
+    m_hasBaseline = true;
+}
+
+bool LiveAnalytics::IsNewGame(const GameState& state) const {
+    int count = std::min(state.activePlayerCount, MAX_PLAYERS);
+    if (!m_hasBaseline || count != m_playerCount) {
+        return true;
+    }
+
+    // Stocks only ever go down within a game
+    for (int i = 0; i < count; i++) {
+        if (state.players[i].stocks > m_players[i].stocks) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LiveAnalytics::CreditDamage(int victim, float amount) {
+    m_players[victim].damageTaken += amount;
+
+    // Only a 1v1 says who dealt it
+    if (m_playerCount == 2) {
+        m_players[1 - victim].damageDealt += amount;
+    }
+}
+
+void LiveAnalytics::EndCombo(int index) {
+    LivePlayerStats& player = m_players[index];
+    if (player.comboHits >= 2) {
+        player.combosReceived++;
+        player.longestCombo = std::max(player.longestCombo, player.comboHits);
+        player.biggestComboDamage = std::max(player.biggestComboDamage, player.comboDamage);
+
+        ClosedCombo& closed = m_closedCombos[m_closedComboCount % CLOSED_COMBO_HISTORY];
+        closed.victim = index;
+        closed.hits = player.comboHits;
+        closed.damage = player.comboDamage;
+        closed.startFrame = player.comboStartFrame;
+        closed.endFrame = player.lastHitFrame;
+        m_closedComboCount++;
+    }
+    player.comboHits = 0;
+    player.comboDamage = 0.0f;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "GameState.h"
+
+// Running per-player analytics built from the live game state stream.
+//
+// Everything is plain data, so a checkpoint is a copy: GameDataInterface keeps
+// one at the last contiguous frame and rolls forward from it after a resync.
+
+struct LivePlayerStats {
+    int stocks = 0;
+    float percent = 0.0f;
+    int stocksLost = 0;
+    float damageTaken = 0.0f;
+    float damageDealt = 0.0f;
+
+    // Combo currently being received
+    int comboHits = 0;
+    float comboDamage = 0.0f;
+    int comboStartFrame = 0;
+    int lastHitFrame = 0;
+
+    int combosReceived = 0;         // Strings of two or more hits
+    int longestCombo = 0;
+    float biggestComboDamage = 0.0f;
+};
+
+// A combo of two or more hits that has ended
+struct ClosedCombo {
+    int victim = -1;
+    int hits = 0;
+    float damage = 0.0f;
+    int startFrame = 0;
+    int endFrame = 0;               // Frame of the last hit
+};
+
+class LiveAnalytics {
+public:
+    static constexpr int MAX_PLAYERS = 4;
+    static constexpr int COMBO_TIMEOUT_FRAMES = 45;  // No hit for this long ends a combo
+    static constexpr uint32_t CLOSED_COMBO_HISTORY = 16;
+
+    void Reset();
+
+    // Next contiguous frame: damage and stock deltas are credited
+    void Apply(const GameState& state);
+
+    // Frame after a gap: take the absolute values, credit only what the
+    // snapshot proves (stocks lost, damage within a stock) and close open combos
+    void Rebaseline(const GameState& state);
+
+    bool HasBaseline() const { return m_hasBaseline; }
+    int GetLastFrame() const { return m_lastFrame; }
+    int GetPlayerCount() const { return m_playerCount; }
+    const LivePlayerStats& GetPlayer(int index) const { return m_players[index]; }
+
+    // Combos numbered from 1 in the order they ended this game, so a poller
+    // that misses frames still sees every one: the last CLOSED_COMBO_HISTORY
+    // of them, up to GetClosedComboCount(), can be read back
+    uint32_t GetClosedComboCount() const { return m_closedComboCount; }
+    const ClosedCombo& GetClosedCombo(uint32_t number) const {
+        return m_closedCombos[(number - 1) % CLOSED_COMBO_HISTORY];
+    }
+
+private:
+    bool IsNewGame(const GameState& state) const;
+    void CreditDamage(int victim, float amount);
+    void EndCombo(int index);
+
+    LivePlayerStats m_players[MAX_PLAYERS];
+    ClosedCombo m_closedCombos[CLOSED_COMBO_HISTORY];
+    uint32_t m_closedComboCount = 0;
+    int m_playerCount = 0;
+    int m_lastFrame = 0;
+    bool m_hasBaseline = false;
+};
@@ -0,0 +1,143 @@
+#include "LiveCheckpoint.h"
+#include "ContentHash.h"
+#include "Logger.h"
+#include <fstream>
+#include <type_traits>
+
+namespace {
+
+const uint32_t CHECKPOINT_MAGIC = 0x434C4343;  // "CCLC"
+
+// The payload is the struct's bytes, so any layout change must bump this
+const uint32_t CHECKPOINT_FORMAT_VERSION = 3;
+
+static_assert(std::is_trivially_copyable<LiveCheckpoint>::value,
+              "LiveCheckpoint is written as raw bytes");
+
+struct CheckpointHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t payloadSize;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+} // namespace
+
+namespace LiveCheckpointFile {
+
+bool Write(const std::filesystem::path& path, const LiveCheckpoint& checkpoint) {
+    CheckpointHeader header = {};
+    header.magic = CHECKPOINT_MAGIC;
+    header.formatVersion = CHECKPOINT_FORMAT_VERSION;
+    header.payloadSize = sizeof(LiveCheckpoint);
+    header.checksum = ContentHash::Hash64(&checkpoint, sizeof(LiveCheckpoint));
+
+    std::filesystem::path tempFile = path;
+    tempFile += ".tmp";
+
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&checkpoint), sizeof(checkpoint));
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, path, error);
+    return !error;
+}
+
+bool Read(const std::filesystem::path& path, LiveCheckpoint& checkpoint) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    CheckpointHeader header = {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != CHECKPOINT_MAGIC || header.formatVersion != CHECKPOINT_FORMAT_VERSION ||
+        header.payloadSize != sizeof(LiveCheckpoint)) {
+        return false;
+    }
+
+    LiveCheckpoint loaded;
+    if (!in.read(reinterpret_cast<char*>(&loaded), sizeof(loaded)) ||
+        ContentHash::Hash64(&loaded, sizeof(loaded)) != header.checksum) {
+        return false;
+    }
+
+    checkpoint = loaded;
+    return true;
+}
+
+} // namespace LiveCheckpointFile
+
+CheckpointWriter::CheckpointWriter(const std::filesystem::path& path)
+    : m_path(path) {
+    m_writerThread = std::thread(&CheckpointWriter::WriterThreadProc, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+}
+
+void CheckpointWriter::Submit(const LiveCheckpoint& checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = checkpoint;
+        m_hasPending = true;
+    }
+    m_condition.notify_all();
+}
+
+void CheckpointWriter::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_hasPending && !m_writing; });
+}
+
+uint64_t CheckpointWriter::GetWrittenCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writtenCount;
+}
+
+void CheckpointWriter::WriterThreadProc() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_hasPending || m_stop; });
+
+        // Pending work is written even when stopping, so shutdown keeps the last state
+        if (!m_hasPending) {
+            break;
+        }
+
+        LiveCheckpoint checkpoint = m_pending;
+        m_hasPending = false;
+        m_writing = true;
+        lock.unlock();
+
+        bool written = LiveCheckpointFile::Write(m_path, checkpoint);
+        if (!written) {
+            COACH_LOG(LogLevel::WARN, 1, "Failed to write live checkpoint: {}", m_path.wstring());
+        }
+
+        lock.lock();
+        m_writing = false;
+        if (written) {
+            m_writtenCount++;
+        }
+        m_condition.notify_all();
+    }
+}
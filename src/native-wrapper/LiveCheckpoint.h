@@ -0,0 +1,61 @@
+#pragma once
+#include "GameState.h"
+#include "LiveAnalytics.h"
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+// Everything needed to pick the live analytics back up after a restart or a
+// monitoring toggle. Plain data, written to disk as one block. Detector,
+// player pair and focus state is not kept; it starts over from the first
+// frame after a restore.
+struct LiveCheckpoint {
+    long long seq = -1;         // Last stream sequence number folded into the analytics
+    int64_t savedAtMs = 0;      // Wall clock, so stale checkpoints can be ignored
+    uint64_t gameKey = 0;       // Fingerprint of the game's gameStart event, 0 if none arrived
+    GameState state = {};
+    LiveAnalytics analytics;
+};
+
+namespace LiveCheckpointFile {
+
+// Written to a temporary file and renamed over the old one, so a crash
+// mid-write leaves the previous checkpoint intact
+bool Write(const std::filesystem::path& path, const LiveCheckpoint& checkpoint);
+
+// Fails on a missing file, a different format version or a bad checksum
+bool Read(const std::filesystem::path& path, LiveCheckpoint& checkpoint);
+
+} // namespace LiveCheckpointFile
+
+// Writes checkpoints on a background thread. Submit only copies the
+// checkpoint; if the writer is still busy, newer submissions replace the
+// pending one.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const std::filesystem::path& path);
+    ~CheckpointWriter();
+
+    void Submit(const LiveCheckpoint& checkpoint);
+
+    // Blocks until the latest submission is on disk
+    void Flush();
+
+    uint64_t GetWrittenCount() const;
+    const std::filesystem::path& GetPath() const { return m_path; }
+
+private:
+    void WriterThreadProc();
+
+    std::filesystem::path m_path;
+    std::thread m_writerThread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    LiveCheckpoint m_pending;
+    bool m_hasPending = false;
+    bool m_writing = false;
+    bool m_stop = false;
+    uint64_t m_writtenCount = 0;
+};
@@ -0,0 +1,450 @@
+#include "Logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Single-producer (owning thread) / single-consumer (writer) byte ring
+struct LogThreadBuffer {
+    static const size_t CAPACITY = 64 * 1024;  // Power of two
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    uint64_t reservedHead = 0;  // Producer only: head after any wrap padding
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+    uint32_t threadId = 0;
+    std::vector<uint64_t> storage = std::vector<uint64_t>(CAPACITY / sizeof(uint64_t));
+
+    uint8_t* Data() { return reinterpret_cast<uint8_t*>(storage.data()); }
+};
+
+namespace {
+
+struct PendingLine {
+    uint64_t timestamp;
+    std::string text;
+};
+
+class LoggerState {
+public:
+    LoggerState() {
+        m_originSteady = Logger::Now();
+        m_originSystem = std::chrono::system_clock::now();
+    }
+
+    ~LoggerState() {
+        Shutdown();
+    }
+
+    std::shared_ptr<LogThreadBuffer> Register() {
+        auto buffer = std::make_shared<LogThreadBuffer>();
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        buffer->threadId = ++m_nextThreadId;
+        m_buffers.push_back(buffer);
+        return buffer;
+    }
+
+    void Start(const LogOptions& options) {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (m_running) {
+            return;
+        }
+
+        m_options = options;
+        if (!m_options.filePath.empty()) {
+            m_file = fopen(m_options.filePath.c_str(), "a");
+        }
+        m_running = true;
+        m_writer = std::thread(&LoggerState::WriterLoop, this);
+    }
+
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_controlMutex);
+            if (!m_running) {
+                return;
+            }
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_writer.joinable()) {
+            m_writer.join();
+        }
+
+        Drain();
+        if (m_file) {
+            fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    void Drain();
+
+private:
+    void WriterLoop() {
+        std::unique_lock<std::mutex> lock(m_controlMutex);
+        while (m_running) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_options.flushIntervalMs));
+            lock.unlock();
+            Drain();
+            lock.lock();
+        }
+    }
+
+    void DrainBuffer(LogThreadBuffer& buffer, std::vector<PendingLine>& lines);
+    std::string FormatRecord(const LogRecordHeader& header, const uint8_t* args, const uint8_t* end,
+                             uint32_t threadId) const;
+    std::string FormatTimestamp(uint64_t timestamp) const;
+
+    std::mutex m_registryMutex;
+    std::vector<std::shared_ptr<LogThreadBuffer>> m_buffers;
+    uint32_t m_nextThreadId = 0;
+
+    std::mutex m_controlMutex;
+    std::condition_variable m_wake;
+    bool m_running = false;
+    std::thread m_writer;
+    LogOptions m_options;
+
+    std::mutex m_drainMutex;  // Keeps the ring buffers single-consumer
+    FILE* m_file = nullptr;
+
+    uint64_t m_originSteady;
+    std::chrono::system_clock::time_point m_originSystem;
+};
+
+LoggerState& State() {
+    static LoggerState state;
+    return state;
+}
+
+const char* LevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO ";
+        case LogLevel::WARN:  return "WARN ";
+        case LogLevel::ERR:   return "ERROR";
+    }
+    return "?????";
+}
+
+void AppendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+// wchar_t is UTF-16 on Windows and UTF-32 elsewhere
+void AppendWide(std::string& out, const wchar_t* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint32_t codePoint = static_cast<uint32_t>(text[i]);
+        if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint < 0xDC00 && i + 1 < length) {
+            uint32_t low = static_cast<uint32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low < 0xE000) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        AppendUtf8(out, codePoint);
+    }
+}
+
+// Appends one encoded argument; returns false on a malformed record
+bool AppendArg(std::string& out, const uint8_t*& cursor, const uint8_t* end) {
+    if (cursor >= end) {
+        return false;
+    }
+
+    uint8_t type = *cursor++;
+    char text[32];
+
+    auto read = [&](void* value, size_t size) {
+        if (static_cast<size_t>(end - cursor) < size) {
+            return false;
+        }
+        memcpy(value, cursor, size);
+        cursor += size;
+        return true;
+    };
+
+    switch (type) {
+        case LogFormat::ARG_INT: {
+            int64_t value;
+            if (!read(&value, sizeof(value))) return false;
+            snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+            out += text;
+            return true;
+        }
+        case LogFormat::ARG_UINT: {
+            uint64_t value;
+            if (!read(&value, sizeof(value))) return false;
+            snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+            out += text;
+            return true;
+        }
+        case LogFormat::ARG_DOUBLE: {
+            double value;
+            if (!read(&value, sizeof(value))) return false;
+            snprintf(text, sizeof(text), "%g", value);
+            out += text;
+            return true;
+        }
+        case LogFormat::ARG_POINTER: {
+            uint64_t value;
+            if (!read(&value, sizeof(value))) return false;
+            snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(value));
+            out += text;
+            return true;
+        }
+        case LogFormat::ARG_BOOL: {
+            uint8_t value;
+            if (!read(&value, sizeof(value))) return false;
+            out += value ? "true" : "false";
+            return true;
+        }
+        case LogFormat::ARG_CHAR: {
+            char value;
+            if (!read(&value, sizeof(value))) return false;
+            out.push_back(value);
+            return true;
+        }
+        case LogFormat::ARG_STRING:
+        case LogFormat::ARG_WSTRING: {
+            uint32_t length;
+            if (!read(&length, sizeof(length))) return false;
+            size_t bytes = static_cast<size_t>(length) * (type == LogFormat::ARG_STRING ? 1 : sizeof(wchar_t));
+            if (static_cast<size_t>(end - cursor) < bytes) return false;
+            if (type == LogFormat::ARG_STRING) {
+                out.append(reinterpret_cast<const char*>(cursor), length);
+            } else {
+                std::vector<wchar_t> wide(length);
+                memcpy(wide.data(), cursor, bytes);
+                AppendWide(out, wide.data(), length);
+            }
+            cursor += bytes;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::string LoggerState::FormatTimestamp(uint64_t timestamp) const {
+    auto wallTime = m_originSystem + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(static_cast<int64_t>(timestamp - m_originSteady)));
+    std::time_t seconds = std::chrono::system_clock::to_time_t(wallTime);
+    int milliseconds = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        wallTime.time_since_epoch()).count() % 1000);
+
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+
+    char text[64];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+             local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+             local.tm_hour, local.tm_min, local.tm_sec, milliseconds);
+    return text;
+}
+
+std::string LoggerState::FormatRecord(const LogRecordHeader& header, const uint8_t* args, const uint8_t* end,
+                                      uint32_t threadId) const {
+    const LogSite& site = *header.site;
+
+    std::string line = FormatTimestamp(header.timestamp);
+    line += " ";
+    line += LevelName(site.level);
+    line += " [T" + std::to_string(threadId) + "] ";
+
+    for (const char* format = site.format; *format != '\0'; format++) {
+        if (format[0] == '{' && format[1] == '}') {
+            if (!AppendArg(line, args, end)) {
+                line += "<?>";
+            }
+            format++;
+        } else {
+            line.push_back(*format);
+        }
+    }
+
+    if (header.suppressedBefore > 0) {
+        line += " [" + std::to_string(header.suppressedBefore) + " similar suppressed]";
+    }
+
+    const char* file = site.file;
+    for (const char* p = site.file; *p != '\0'; p++) {
+        if (*p == '/' || *p == '\\') {
+            file = p + 1;
+        }
+    }
+    line += " (";
+    line += file;
+    line += ":" + std::to_string(site.line) + ")\n";
+    return line;
+}
+
+void LoggerState::DrainBuffer(LogThreadBuffer& buffer, std::vector<PendingLine>& lines) {
+    uint64_t head = buffer.head.load(std::memory_order_acquire);
+    uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+    uint8_t* data = buffer.Data();
+
+    while (tail < head) {
+        size_t offset = static_cast<size_t>(tail & (LogThreadBuffer::CAPACITY - 1));
+        size_t contiguous = LogThreadBuffer::CAPACITY - offset;
+
+        // Too little room at the end for a header: the producer wrapped
+        if (contiguous < sizeof(LogRecordHeader)) {
+            tail += contiguous;
+            continue;
+        }
+
+        LogRecordHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        if (header.site) {
+            const uint8_t* args = data + offset + sizeof(header);
+            lines.push_back({header.timestamp,
+                             FormatRecord(header, args, data + offset + header.size, buffer.threadId)});
+        }
+        tail += header.size;
+    }
+
+    buffer.tail.store(tail, std::memory_order_release);
+
+    uint64_t dropped = buffer.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        uint64_t now = Logger::Now();
+        lines.push_back({now, FormatTimestamp(now) + " WARN  [T" + std::to_string(buffer.threadId) + "] " +
+                              std::to_string(dropped) + " log records dropped (buffer full)\n"});
+    }
+}
+
+void LoggerState::Drain() {
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+    std::vector<std::shared_ptr<LogThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        buffers = m_buffers;
+    }
+
+    std::vector<PendingLine> lines;
+    for (const auto& buffer : buffers) {
+        DrainBuffer(*buffer, lines);
+    }
+
+    // Threads that have exited and been fully drained no longer need a slot
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+            [](const std::shared_ptr<LogThreadBuffer>& buffer) {
+                return buffer->retired.load(std::memory_order_acquire) &&
+                       buffer->tail.load(std::memory_order_relaxed) ==
+                           buffer->head.load(std::memory_order_acquire);
+            }), m_buffers.end());
+    }
+
+    if (lines.empty()) {
+        return;
+    }
+
+    std::stable_sort(lines.begin(), lines.end(), [](const PendingLine& a, const PendingLine& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    for (const auto& line : lines) {
+        if (m_file) {
+            fwrite(line.text.data(), 1, line.text.size(), m_file);
+        }
+        if (m_options.echoToConsole) {
+            fwrite(line.text.data(), 1, line.text.size(), stderr);
+        }
+    }
+    if (m_file) {
+        fflush(m_file);
+    }
+    if (m_options.echoToConsole) {
+        fflush(stderr);
+    }
+}
+
+void Logger::Start(const LogOptions& options) {
+    State().Start(options);
+}
+
+void Logger::Shutdown() {
+    State().Shutdown();
+}
+
+void Logger::Flush() {
+    State().Drain();
+}
+
+LogThreadBuffer& Logger::LocalBuffer() {
+    struct LocalHandle {
+        std::shared_ptr<LogThreadBuffer> buffer;
+        ~LocalHandle() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local LocalHandle handle;
+    if (!handle.buffer) {
+        handle.buffer = State().Register();
+    }
+    return *handle.buffer;
+}
+
+uint8_t* Logger::Reserve(LogThreadBuffer& buffer, size_t size) {
+    const size_t capacity = LogThreadBuffer::CAPACITY;
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    uint64_t tail = buffer.tail.load(std::memory_order_acquire);
+
+    size_t offset = static_cast<size_t>(head & (capacity - 1));
+    size_t contiguous = capacity - offset;
+    size_t padding = size > contiguous ? contiguous : 0;
+
+    if (size > capacity / 2 || padding + size > capacity - static_cast<size_t>(head - tail)) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (padding > 0) {
+        // Records never straddle the end; mark the tail of the ring as skipped
+        if (padding >= sizeof(LogRecordHeader)) {
+            LogRecordHeader skip = {static_cast<uint32_t>(padding), 0, nullptr, 0};
+            memcpy(buffer.Data() + offset, &skip, sizeof(skip));
+        }
+        offset = 0;
+    }
+
+    buffer.reservedHead = head + padding;
+    return buffer.Data() + offset;
+}
+
+void Logger::Commit(LogThreadBuffer& buffer, size_t size) {
+    buffer.head.store(buffer.reservedHead + size, std::memory_order_release);
+}
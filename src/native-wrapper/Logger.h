@@ -0,0 +1,270 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Asynchronous structured logger.
+//
+// A log call copies a pointer to its static LogSite plus the binary-encoded
+// arguments into a per-thread ring buffer; a background thread does all
+// formatting and I/O. The calling thread never locks, allocates or flushes.
+//
+//   LOG_INFO("Worker {} connected: {}", worker.id, worker.name);
+//   COACH_LOG(LogLevel::WARN, 1, "Pipe read error: {}", error);   // at most once per second
+//
+// Levels below COACH_LOG_MIN_LEVEL compile out, and the number of "{}"
+// placeholders is checked against the argument count at compile time.
+
+#ifndef COACH_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define COACH_LOG_MIN_LEVEL 2   // INFO
+#else
+#define COACH_LOG_MIN_LEVEL 1   // DEBUG
+#endif
+#endif
+
+// ERR rather than ERROR: wingdi.h defines ERROR as a macro
+enum class LogLevel : uint8_t {
+    TRACE,
+    DEBUG,
+    INFO,
+    WARN,
+    ERR
+};
+
+// One per call site, constant-initialized so no guard runs on the hot path
+struct LogSite {
+    LogLevel level;
+    uint32_t maxPerSecond;   // 0 = unlimited
+    const char* file;
+    int line;
+    const char* format;
+
+    std::atomic<uint32_t> windowSecond{0};
+    std::atomic<uint32_t> windowCount{0};
+    std::atomic<uint32_t> suppressed{0};
+
+    constexpr LogSite(LogLevel level, uint32_t maxPerSecond, const char* file, int line, const char* format)
+        : level(level), maxPerSecond(maxPerSecond), file(file), line(line), format(format) {}
+
+    // Rate limiting; races between threads only blur the window edges
+    bool Admit(uint64_t timestamp, uint32_t& suppressedBefore) {
+        suppressedBefore = 0;
+        if (maxPerSecond == 0) {
+            return true;
+        }
+
+        uint32_t second = static_cast<uint32_t>(timestamp / 1000000000ull);
+        if (windowSecond.load(std::memory_order_relaxed) != second) {
+            windowSecond.store(second, std::memory_order_relaxed);
+            windowCount.store(0, std::memory_order_relaxed);
+            suppressedBefore = suppressed.exchange(0, std::memory_order_relaxed);
+        }
+
+        if (windowCount.fetch_add(1, std::memory_order_relaxed) >= maxPerSecond) {
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+};
+
+namespace LogFormat {
+
+constexpr size_t CountPlaceholders(const char* format) {
+    size_t count = 0;
+    for (size_t i = 0; format[i] != '\0'; i++) {
+        if (format[i] == '{' && format[i + 1] == '}') {
+            count++;
+            i++;
+        }
+    }
+    return count;
+}
+
+template <size_t N>
+struct ArgCount {
+    static const size_t value = N;
+};
+
+// Only used inside decltype, so arguments are never evaluated twice
+template <typename... Args>
+ArgCount<sizeof...(Args)> CountArgs(const Args&...);
+
+enum ArgType : uint8_t {
+    ARG_INT,
+    ARG_UINT,
+    ARG_DOUBLE,
+    ARG_BOOL,
+    ARG_CHAR,
+    ARG_POINTER,
+    ARG_STRING,
+    ARG_WSTRING
+};
+
+template <typename T>
+struct AlwaysFalse : std::false_type {};
+
+template <typename T>
+constexpr bool IsNarrowString() {
+    return std::is_same<T, const char*>::value || std::is_same<T, char*>::value ||
+           std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value;
+}
+
+template <typename T>
+constexpr bool IsWideString() {
+    return std::is_same<T, const wchar_t*>::value || std::is_same<T, wchar_t*>::value ||
+           std::is_same<T, std::wstring>::value || std::is_same<T, std::wstring_view>::value;
+}
+
+// Encoded layout: one ArgType byte, then the value. Strings are a uint32
+// length followed by the raw characters.
+template <typename T>
+size_t EncodedSize(const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (IsNarrowString<U>()) {
+        return 1 + sizeof(uint32_t) + std::string_view(value).size();
+    } else if constexpr (IsWideString<U>()) {
+        return 1 + sizeof(uint32_t) + std::wstring_view(value).size() * sizeof(wchar_t);
+    } else if constexpr (std::is_same<U, bool>::value || std::is_same<U, char>::value) {
+        return 2;
+    } else if constexpr (std::is_arithmetic<U>::value || std::is_enum<U>::value || std::is_pointer<U>::value) {
+        return 1 + sizeof(uint64_t);
+    } else {
+        static_assert(AlwaysFalse<U>::value, "Unsupported log argument type");
+        return 0;
+    }
+}
+
+template <typename T>
+void Encode(uint8_t*& out, const T& value) {
+    using U = std::decay_t<T>;
+    auto put = [&out](const void* data, size_t size) {
+        memcpy(out, data, size);
+        out += size;
+    };
+
+    if constexpr (IsNarrowString<U>() || IsWideString<U>()) {
+        auto view = [&]() {
+            if constexpr (IsNarrowString<U>()) return std::string_view(value);
+            else return std::wstring_view(value);
+        }();
+        *out++ = IsNarrowString<U>() ? ARG_STRING : ARG_WSTRING;
+        uint32_t length = static_cast<uint32_t>(view.size());
+        put(&length, sizeof(length));
+        put(view.data(), view.size() * sizeof(view[0]));
+    } else if constexpr (std::is_same<U, bool>::value) {
+        *out++ = ARG_BOOL;
+        *out++ = value ? 1 : 0;
+    } else if constexpr (std::is_same<U, char>::value) {
+        *out++ = ARG_CHAR;
+        *out++ = static_cast<uint8_t>(value);
+    } else if constexpr (std::is_floating_point<U>::value) {
+        *out++ = ARG_DOUBLE;
+        double number = static_cast<double>(value);
+        put(&number, sizeof(number));
+    } else if constexpr (std::is_pointer<U>::value) {
+        *out++ = ARG_POINTER;
+        uint64_t address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+        put(&address, sizeof(address));
+    } else if constexpr (std::is_enum<U>::value || std::is_signed<U>::value) {
+        *out++ = ARG_INT;
+        int64_t number = static_cast<int64_t>(value);
+        put(&number, sizeof(number));
+    } else {
+        *out++ = ARG_UINT;
+        uint64_t number = static_cast<uint64_t>(value);
+        put(&number, sizeof(number));
+    }
+}
+
+} // namespace LogFormat
+
+// Fixed header in front of each record's encoded arguments
+struct LogRecordHeader {
+    uint32_t size;              // Header plus arguments, rounded up to 8 bytes
+    uint32_t suppressedBefore;  // Calls dropped by rate limiting since the last record
+    const LogSite* site;        // nullptr marks wrap-around padding
+    uint64_t timestamp;         // Nanoseconds on the steady clock
+};
+
+struct LogThreadBuffer;
+
+struct LogOptions {
+    std::string filePath;           // Empty = no log file
+    bool echoToConsole = true;      // Also write to stderr
+    unsigned flushIntervalMs = 20;  // How often the writer drains thread buffers
+};
+
+class Logger {
+public:
+    static void Start(const LogOptions& options);
+    static void Shutdown();
+
+    // Blocks until everything logged so far has been written
+    static void Flush();
+
+    static uint64_t Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    template <typename... Args>
+    static void Write(LogSite& site, const char*, const Args&... args) {
+        uint64_t timestamp = Now();
+        uint32_t suppressedBefore = 0;
+        if (!site.Admit(timestamp, suppressedBefore)) {
+            return;
+        }
+
+        size_t size = sizeof(LogRecordHeader) + (LogFormat::EncodedSize(args) + ... + size_t(0));
+        size = (size + 7) & ~size_t(7);
+
+        LogThreadBuffer& buffer = LocalBuffer();
+        uint8_t* out = Reserve(buffer, size);
+        if (!out) {
+            return;  // Buffer full; counted as dropped
+        }
+
+        LogRecordHeader header = {static_cast<uint32_t>(size), suppressedBefore, &site, timestamp};
+        memcpy(out, &header, sizeof(header));
+        uint8_t* cursor = out + sizeof(header);
+        (LogFormat::Encode(cursor, args), ...);
+        (void)cursor;
+        Commit(buffer, size);
+    }
+
+private:
+    static LogThreadBuffer& LocalBuffer();
+    static uint8_t* Reserve(LogThreadBuffer& buffer, size_t size);
+    static void Commit(LogThreadBuffer& buffer, size_t size);
+};
+
+#define COACH_LOG_EXPAND(x) x
+#define COACH_LOG_FIRST_(first, ...) first
+#define COACH_LOG_FIRST(...) COACH_LOG_EXPAND(COACH_LOG_FIRST_(__VA_ARGS__, 0))
+
+#define COACH_LOG(level, maxPerSecond, ...)                                                           \
+    do {                                                                                              \
+        if constexpr (static_cast<int>(level) >= COACH_LOG_MIN_LEVEL) {                               \
+            static_assert(LogFormat::CountPlaceholders(COACH_LOG_FIRST(__VA_ARGS__)) + 1 ==           \
+                          decltype(LogFormat::CountArgs(__VA_ARGS__))::value,                         \
+                          "Log format placeholders do not match the argument count");                 \
+            static LogSite coachLogSite(level, maxPerSecond, __FILE__, __LINE__,                      \
+                                        COACH_LOG_FIRST(__VA_ARGS__));                                \
+            Logger::Write(coachLogSite, __VA_ARGS__);                                                 \
+        }                                                                                             \
+    } while (0)
+
+// Default budget per call site; repeats beyond it are counted and reported
+#define COACH_LOG_DEFAULT_RATE 50
+
+#define LOG_TRACE(...) COACH_LOG(LogLevel::TRACE, COACH_LOG_DEFAULT_RATE, __VA_ARGS__)
+#define LOG_DEBUG(...) COACH_LOG(LogLevel::DEBUG, COACH_LOG_DEFAULT_RATE, __VA_ARGS__)
+#define LOG_INFO(...) COACH_LOG(LogLevel::INFO, COACH_LOG_DEFAULT_RATE, __VA_ARGS__)
+#define LOG_WARN(...) COACH_LOG(LogLevel::WARN, COACH_LOG_DEFAULT_RATE, __VA_ARGS__)
+#define LOG_ERROR(...) COACH_LOG(LogLevel::ERR, COACH_LOG_DEFAULT_RATE, __VA_ARGS__)
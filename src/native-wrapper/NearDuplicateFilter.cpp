@@ -0,0 +1,167 @@
+#include "NearDuplicateFilter.h"
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+// The top byte of a fingerprint holds the player ports the line names
+const int PORTS_SHIFT = 56;
+const uint64_t SIMHASH_MASK = (1ull << PORTS_SHIFT) - 1;
+
+// FNV-1a is plenty for words of a few bytes; the finalizer spreads it so
+// every fingerprint bit depends on the whole word
+uint64_t FinishToken(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Per-bit counts of the token hashes, bit-sliced: plane p holds bit p of all
+// 64 counts, so adding a token is a ripple of ANDs and XORs rather than 64
+// separate increments. Tokens past MAX_TOKENS are ignored.
+struct BitCounter {
+    static constexpr int PLANES = 8;
+    static constexpr uint32_t MAX_TOKENS = (1u << PLANES) - 1;
+
+    uint64_t planes[PLANES] = {};
+    uint32_t tokens = 0;
+
+    void Add(uint64_t hash) {
+        if (tokens == MAX_TOKENS) {
+            return;
+        }
+        tokens++;
+        uint64_t carry = FinishToken(hash);
+        for (int p = 0; p < PLANES && carry != 0; p++) {
+            uint64_t next = planes[p] & carry;
+            planes[p] ^= carry;
+            carry = next;
+        }
+    }
+
+    // Bits set in more than half of the tokens
+    uint64_t Majority() const {
+        uint32_t threshold = tokens / 2 + 1;
+        uint64_t greater = 0;
+        uint64_t equal = ~0ull;
+        for (int p = PLANES - 1; p >= 0; p--) {
+            uint64_t bit = ((threshold >> p) & 1) ? ~0ull : 0;
+            greater |= equal & planes[p] & ~bit;
+            equal &= ~(planes[p] ^ bit);
+        }
+        return greater | equal;
+    }
+};
+
+} // namespace
+
+NearDuplicateFilter::NearDuplicateFilter(const NearDuplicateOptions& options)
+    : m_options(options) {
+}
+
+uint64_t NearDuplicateFilter::Fingerprint(const std::string& text) {
+    BitCounter counter;
+    uint64_t hash = FNV_OFFSET;
+    size_t tokenLength = 0;
+    unsigned char last = 0;
+    bool inNumber = false;
+    int tokenPort = 0;          // 1-4 while the token so far is "p1" to "p4"
+    uint32_t portMask = 0;
+    uint32_t firstPort = 0;
+
+    auto endToken = [&]() {
+        counter.Add(hash);
+        if (tokenPort > 0) {
+            portMask |= 1u << (tokenPort - 1);
+            firstPort = firstPort != 0 ? firstPort : static_cast<uint32_t>(tokenPort);
+        }
+        hash = FNV_OFFSET;
+        tokenLength = 0;
+        inNumber = false;
+        tokenPort = 0;
+    };
+
+    for (unsigned char c : text) {
+        bool isDigit = c >= '0' && c <= '9';
+        bool isLetter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<unsigned char>(c - 'A' + 'a');
+        }
+        if (isDigit && tokenLength == 1 && last == 'p' && c >= '1' && c <= '4') {
+            // "P1" to "P4" name a player and keep their digit
+            hash = (hash ^ c) * FNV_PRIME;
+            tokenLength++;
+            tokenPort = c - '0';
+        } else if (isDigit) {
+            // Any other digit run hashes as "#" whatever its value
+            if (!inNumber) {
+                hash = (hash ^ '#') * FNV_PRIME;
+                inNumber = true;
+            }
+            tokenLength++;
+            tokenPort = 0;
+        } else if (isLetter) {
+            hash = (hash ^ c) * FNV_PRIME;
+            tokenLength++;
+            inNumber = false;
+            tokenPort = 0;
+        } else if (tokenLength > 0) {
+            endToken();
+        }
+        last = c;
+    }
+    if (tokenLength > 0) {
+        endToken();
+    }
+    if (counter.tokens == 0) {
+        return 0;
+    }
+    return (counter.Majority() & SIMHASH_MASK) | (static_cast<uint64_t>(firstPort << 4 | portMask) << PORTS_SHIFT);
+}
+
+int NearDuplicateFilter::Distance(uint64_t first, uint64_t second) {
+    // SWAR popcount; std::bitset::count is a library call without -mpopcnt
+    uint64_t bits = first ^ second;
+    bits -= (bits >> 1) & 0x5555555555555555ull;
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((bits * 0x0101010101010101ull) >> 56);
+}
+
+bool NearDuplicateFilter::Match(uint64_t fingerprint, uint32_t nowMs, uint64_t& tag) {
+    for (Entry& entry : m_ring) {
+        // Unsigned difference stays right across GetTickCount wraparound
+        if (!entry.used || nowMs - entry.time > m_options.windowMs) {
+            continue;
+        }
+        if ((entry.fingerprint >> PORTS_SHIFT) == (fingerprint >> PORTS_SHIFT) &&
+            Distance(entry.fingerprint, fingerprint) <= m_options.maxDistance) {
+            entry.time = nowMs;
+            tag = entry.tag;
+            m_suppressed++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void NearDuplicateFilter::Remember(uint64_t fingerprint, uint32_t nowMs, uint64_t tag) {
+    Entry& entry = m_ring[m_next];
+    entry.fingerprint = fingerprint;
+    entry.tag = tag;
+    entry.time = nowMs;
+    entry.used = true;
+    m_next = (m_next + 1) % RING_SIZE;
+}
+
+void NearDuplicateFilter::Clear() {
+    for (Entry& entry : m_ring) {
+        entry = Entry();
+    }
+    m_next = 0;
+    m_suppressed = 0;
+}
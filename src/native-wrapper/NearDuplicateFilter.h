@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Catches near-identical lines ("What a combo!", "What a combo!!", "Fox landed
+// a 3-hit string for 38%" right after "...4-hit string for 45%") so bursts of
+// events don't fill the commentary panel with repeats.
+//
+// Each line is reduced to a 56-bit SimHash of its lowercased words, with runs
+// of digits folded into one token so percents and hit counts don't make lines
+// distinct. Similar lines get fingerprints a few bits apart; unrelated ones
+// differ in about half. Player ports ("P1" to "P4") keep their digit, and the
+// top byte records which ports the line names and which comes first, so
+// "P1 lost a stock" never repeats "P2 lost a stock". The last RING_SIZE
+// fingerprints are kept in a ring, and a line naming the same ports within
+// maxDistance bits of one seen in the last windowMs is a repeat. No
+// allocation; a check is a hash per word and RING_SIZE popcounts.
+// utils/nearDuplicateFilter.js computes the same fingerprints on the Node side.
+//
+//   uint64_t fingerprint = NearDuplicateFilter::Fingerprint(line);
+//   if (filter.Match(fingerprint, GetTickCount(), tag)) { merge into line tag }
+//   else { show it; filter.Remember(fingerprint, GetTickCount(), id); }
+
+struct NearDuplicateOptions {
+    int maxDistance = 10;           // Hamming distance still counted as a repeat
+    uint32_t windowMs = 15000;      // How long a line keeps suppressing repeats
+};
+
+class NearDuplicateFilter {
+public:
+    static constexpr size_t RING_SIZE = 16;
+
+    explicit NearDuplicateFilter(const NearDuplicateOptions& options = NearDuplicateOptions());
+
+    static uint64_t Fingerprint(const std::string& text);
+    static int Distance(uint64_t first, uint64_t second);
+
+    // True if fingerprint repeats a recent line; tag is set to that line's tag
+    // and its time refreshed, so a steady burst keeps matching
+    bool Match(uint64_t fingerprint, uint32_t nowMs, uint64_t& tag);
+
+    // Adds a line to the ring, replacing the oldest
+    void Remember(uint64_t fingerprint, uint32_t nowMs, uint64_t tag = 0);
+
+    void Clear();
+    uint64_t GetSuppressedCount() const { return m_suppressed; }
+
+private:
+    struct Entry {
+        uint64_t fingerprint = 0;
+        uint64_t tag = 0;
+        uint32_t time = 0;
+        bool used = false;
+    };
+
+    NearDuplicateOptions m_options;
+    Entry m_ring[RING_SIZE];
+    size_t m_next = 0;
+    uint64_t m_suppressed = 0;
+};
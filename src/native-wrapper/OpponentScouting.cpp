@@ -0,0 +1,456 @@
+#include "OpponentScouting.h"
+#include "ContentHash.h"
+#include "Logger.h"
+#include "SlippiNames.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<ScoutingAggregate>::value,
+              "ScoutingAggregate rows are stored as raw blobs");
+
+namespace {
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+const uint32_t MAX_KEY_LENGTH = 256;
+const uint32_t MAX_ROWS_PER_PLAYER = 64;
+
+const char* const TECH_OPTION_NAMES[ReplaySummary::TECH_OPTION_COUNT] = {
+    "in place", "roll forward", "roll back", "wall/ceiling", "missed"
+};
+
+int Percent(uint64_t part, uint64_t whole) {
+    return whole > 0 ? static_cast<int>((part * 100 + whole / 2) / whole) : 0;
+}
+
+// Indices of the largest non-zero counts, largest first
+template <typename T, size_t N>
+std::vector<int> TopEntries(const T (&counts)[N], size_t limit) {
+    std::vector<int> indices;
+    for (size_t i = 0; i < N; i++) {
+        if (counts[i] > 0) {
+            indices.push_back(static_cast<int>(i));
+        }
+    }
+    std::stable_sort(indices.begin(), indices.end(), [&counts](int a, int b) {
+        return counts[a] > counts[b];
+    });
+    if (indices.size() > limit) {
+        indices.resize(limit);
+    }
+    return indices;
+}
+
+} // namespace
+
+void ScoutingAggregate::Add(const ReplaySummary& summary, int port) {
+    games++;
+    frames += static_cast<uint64_t>(std::max(0, summary.lastFrame - summary.firstFrame + 1));
+    stocksLost += static_cast<uint32_t>(summary.stocksLost[port]);
+    damageTaken += summary.damageTaken[port];
+
+    for (int other = 0; other < 4; other++) {
+        if (other != port && summary.characters[other] >= 0) {
+            stocksTaken += static_cast<uint32_t>(summary.stocksLost[other]);
+        }
+    }
+
+    bool hasStage = summary.stage >= 0 && summary.stage < STAGE_COUNT;
+    if (hasStage) {
+        stageGames[summary.stage]++;
+    }
+    if (summary.winner >= 0) {
+        decided++;
+        bool won = summary.winner == port;
+        wins += won ? 1 : 0;
+        if (hasStage) {
+            stageDecided[summary.stage]++;
+            stageWins[summary.stage] += won ? 1 : 0;
+        }
+    }
+    if (summary.lrasInitiator == port) {
+        lrasQuits++;
+    }
+
+    for (int move = 0; move < ReplaySummary::MOVE_ID_COUNT; move++) {
+        killMoves[move] += summary.killMoves[port][move];
+    }
+    for (int option = 0; option < ReplaySummary::TECH_OPTION_COUNT; option++) {
+        techs[option] += summary.techs[port][option];
+    }
+}
+
+void ScoutingAggregate::Merge(const ScoutingAggregate& other) {
+    games += other.games;
+    decided += other.decided;
+    wins += other.wins;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        stageGames[i] += other.stageGames[i];
+        stageDecided[i] += other.stageDecided[i];
+        stageWins[i] += other.stageWins[i];
+    }
+    stocksTaken += other.stocksTaken;
+    stocksLost += other.stocksLost;
+    lrasQuits += other.lrasQuits;
+    frames += other.frames;
+    damageTaken += other.damageTaken;
+    for (int move = 0; move < ReplaySummary::MOVE_ID_COUNT; move++) {
+        killMoves[move] += other.killMoves[move];
+    }
+    for (int option = 0; option < ReplaySummary::TECH_OPTION_COUNT; option++) {
+        techs[option] += other.techs[option];
+    }
+}
+
+OpponentScouting::OpponentScouting(const std::filesystem::path& storeFile)
+    : m_storeFile(storeFile) {
+}
+
+bool OpponentScouting::Load() {
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(m_storeFile, error);
+
+    std::ifstream in(m_storeFile, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t formatVersion = 0;
+    uint32_t rowSize = 0;
+    if (!ReadPod(in, magic) || !ReadPod(in, formatVersion) || !ReadPod(in, rowSize) ||
+        magic != STORE_MAGIC || formatVersion != STORE_FORMAT_VERSION || rowSize != sizeof(ScoutingAggregate)) {
+        LOG_WARN("Ignoring incompatible scouting store: {}", m_storeFile.wstring());
+        return false;
+    }
+
+    uint64_t gameCount = 0;
+    if (!ReadPod(in, gameCount)) {
+        return false;
+    }
+    std::unordered_set<uint64_t> seenGames;
+    seenGames.reserve(static_cast<size_t>(gameCount));
+    for (uint64_t i = 0; i < gameCount; i++) {
+        uint64_t gameId = 0;
+        if (!ReadPod(in, gameId)) {
+            return false;
+        }
+        seenGames.insert(gameId);
+    }
+
+    uint64_t playerCount = 0;
+    if (!ReadPod(in, playerCount)) {
+        return false;
+    }
+    std::unordered_map<std::string, std::vector<CharacterRow>> players;
+    players.reserve(static_cast<size_t>(playerCount));
+    for (uint64_t i = 0; i < playerCount; i++) {
+        uint32_t keyLength = 0;
+        if (!ReadPod(in, keyLength) || keyLength > MAX_KEY_LENGTH) {
+            return false;
+        }
+        std::string key(keyLength, '\0');
+        uint32_t rowCount = 0;
+        if (!in.read(&key[0], keyLength) || !ReadPod(in, rowCount) || rowCount > MAX_ROWS_PER_PLAYER) {
+            return false;
+        }
+
+        std::vector<CharacterRow>& rows = players[key];
+        rows.resize(rowCount);
+        for (CharacterRow& row : rows) {
+            if (!ReadPod(in, row.character) || !ReadPod(in, row.aggregate)) {
+                return false;
+            }
+        }
+    }
+
+    m_seenGames = std::move(seenGames);
+    m_players = std::move(players);
+    m_dirty = false;
+    m_loadedWriteTime = writeTime;
+
+    LOG_INFO("Loaded scouting store: {} players, {} games", m_players.size(), m_seenGames.size());
+    return true;
+}
+
+bool OpponentScouting::ReloadIfChanged() {
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(m_storeFile, error);
+    if (error || writeTime == m_loadedWriteTime) {
+        return false;
+    }
+    return Load();
+}
+
+bool OpponentScouting::Save() {
+    // Write to a temporary file and swap it in so a crash never leaves a torn store
+    std::filesystem::path tempFile = m_storeFile;
+    tempFile += ".tmp";
+
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Failed to write scouting store: {}", tempFile.wstring());
+            return false;
+        }
+
+        WritePod(out, STORE_MAGIC);
+        WritePod(out, STORE_FORMAT_VERSION);
+        WritePod(out, static_cast<uint32_t>(sizeof(ScoutingAggregate)));
+
+        WritePod(out, static_cast<uint64_t>(m_seenGames.size()));
+        for (uint64_t gameId : m_seenGames) {
+            WritePod(out, gameId);
+        }
+
+        WritePod(out, static_cast<uint64_t>(m_players.size()));
+        for (const auto& entry : m_players) {
+            WritePod(out, static_cast<uint32_t>(entry.first.size()));
+            out.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+            WritePod(out, static_cast<uint32_t>(entry.second.size()));
+            for (const CharacterRow& row : entry.second) {
+                WritePod(out, row.character);
+                WritePod(out, row.aggregate);
+            }
+        }
+
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, m_storeFile, error);
+    if (error) {
+        LOG_ERROR("Failed to replace scouting store: {}", error.value());
+        return false;
+    }
+
+    m_dirty = false;
+    m_loadedWriteTime = std::filesystem::last_write_time(m_storeFile, error);
+    return true;
+}
+
+bool OpponentScouting::AddGame(const ReplaySummary& summary) {
+    if (summary.playerCount != 2) {
+        return false;
+    }
+
+    std::string identities[4];
+    bool hasIdentity = false;
+    for (int port = 0; port < 4; port++) {
+        if (summary.characters[port] < 0) {
+            continue;
+        }
+        identities[port] = summary.connectCodes[port][0] ? IdentityForCode(summary.connectCodes[port])
+                                                          : IdentityForName(summary.displayNames[port]);
+        hasIdentity = hasIdentity || !identities[port].empty();
+    }
+    if (!hasIdentity || !m_seenGames.insert(GameId(summary)).second) {
+        return false;
+    }
+
+    for (int port = 0; port < 4; port++) {
+        if (!identities[port].empty()) {
+            GetRow(identities[port], summary.characters[port]).Add(summary, port);
+        }
+    }
+    m_dirty = true;
+    return true;
+}
+
+bool OpponentScouting::BuildReport(const std::string& connectCode, const std::string& displayName,
+                                   int character, ScoutingReport& report) const {
+    report = ScoutingReport();
+
+    auto found = m_players.end();
+    if (!connectCode.empty()) {
+        found = m_players.find(IdentityForCode(connectCode));
+    }
+    if (found == m_players.end() && !displayName.empty()) {
+        found = m_players.find(IdentityForName(displayName));
+    }
+    if (found == m_players.end()) {
+        return false;
+    }
+
+    report.identity = found->first;
+    report.character = character;
+    for (const CharacterRow& row : found->second) {
+        report.overall.Merge(row.aggregate);
+        if (row.character == character) {
+            report.asCharacter.Merge(row.aggregate);
+        }
+        report.characters.emplace_back(row.character, row.aggregate.games);
+    }
+    std::stable_sort(report.characters.begin(), report.characters.end(),
+                     [](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) {
+                         return a.second > b.second;
+                     });
+    if (report.overall.games == 0) {
+        return false;
+    }
+
+    FormatReport(report);
+    return true;
+}
+
+std::string OpponentScouting::IdentityForCode(const std::string& connectCode) {
+    std::string identity;
+    for (char c : connectCode) {
+        if (c != ' ') {
+            identity += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    return identity;
+}
+
+std::string OpponentScouting::IdentityForName(const std::string& displayName) {
+    if (displayName.empty()) {
+        return "";
+    }
+    std::string identity = "name:";
+    for (char c : displayName) {
+        identity += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return identity;
+}
+
+uint64_t OpponentScouting::GameId(const ReplaySummary& summary) {
+    // Field by field; padding in the summary is not reliably zeroed
+    ContentHash::Hasher hasher;
+    hasher.Update(&summary.randomSeed, sizeof(summary.randomSeed));
+    hasher.Update(&summary.stage, sizeof(summary.stage));
+    hasher.Update(&summary.firstFrame, sizeof(summary.firstFrame));
+    hasher.Update(&summary.lastFrame, sizeof(summary.lastFrame));
+    hasher.Update(summary.characters, sizeof(summary.characters));
+    hasher.Update(summary.damageTaken, sizeof(summary.damageTaken));
+    for (int port = 0; port < 4; port++) {
+        hasher.Update(summary.connectCodes[port], strnlen(summary.connectCodes[port], ReplaySummary::CODE_LENGTH));
+        hasher.Update(summary.displayNames[port], strnlen(summary.displayNames[port], ReplaySummary::NAME_LENGTH));
+    }
+    return hasher.Digest();
+}
+
+ScoutingAggregate& OpponentScouting::GetRow(const std::string& identity, int character) {
+    std::vector<CharacterRow>& rows = m_players[identity];
+    for (CharacterRow& row : rows) {
+        if (row.character == character) {
+            return row.aggregate;
+        }
+    }
+    rows.push_back(CharacterRow{character, ScoutingAggregate()});
+    return rows.back().aggregate;
+}
+
+void OpponentScouting::FormatReport(ScoutingReport& report) {
+    const ScoutingAggregate& overall = report.overall;
+    std::ostringstream line;
+
+    line << report.identity << ": " << overall.games << " games, " << overall.wins << "-"
+         << (overall.decided - overall.wins);
+    if (overall.decided > 0) {
+        line << " (" << Percent(overall.wins, overall.decided) << "% wins)";
+    }
+    report.lines.push_back(line.str());
+
+    if (!report.characters.empty()) {
+        line.str("");
+        line << "Plays: ";
+        for (size_t i = 0; i < report.characters.size() && i < 3; i++) {
+            line << (i > 0 ? ", " : "") << SlippiNames::Character(report.characters[i].first) << " "
+                 << Percent(report.characters[i].second, overall.games) << "%";
+        }
+        report.lines.push_back(line.str());
+    }
+
+    if (report.character >= 0 && report.asCharacter.games > 0 && report.asCharacter.games != overall.games) {
+        const ScoutingAggregate& current = report.asCharacter;
+        line.str("");
+        line << "As " << SlippiNames::Character(report.character) << ": " << current.games << " games, "
+             << current.wins << "-" << (current.decided - current.wins);
+        report.lines.push_back(line.str());
+    }
+
+    int bestStage = -1;
+    int worstStage = -1;
+    for (int stage = 0; stage < ScoutingAggregate::STAGE_COUNT; stage++) {
+        if (overall.stageDecided[stage] < MIN_STAGE_GAMES) {
+            continue;
+        }
+        uint64_t rate = static_cast<uint64_t>(overall.stageWins[stage]) * 1000 / overall.stageDecided[stage];
+        if (bestStage < 0 ||
+            rate > static_cast<uint64_t>(overall.stageWins[bestStage]) * 1000 / overall.stageDecided[bestStage]) {
+            bestStage = stage;
+        }
+        if (worstStage < 0 ||
+            rate < static_cast<uint64_t>(overall.stageWins[worstStage]) * 1000 / overall.stageDecided[worstStage]) {
+            worstStage = stage;
+        }
+    }
+    if (bestStage >= 0 && bestStage != worstStage) {
+        line.str("");
+        line << "Best stage: " << SlippiNames::Stage(bestStage) << " ("
+             << Percent(overall.stageWins[bestStage], overall.stageDecided[bestStage]) << "% of "
+             << overall.stageDecided[bestStage] << "); worst: " << SlippiNames::Stage(worstStage) << " ("
+             << Percent(overall.stageWins[worstStage], overall.stageDecided[worstStage]) << "% of "
+             << overall.stageDecided[worstStage] << ")";
+        report.lines.push_back(line.str());
+    }
+
+    uint64_t kills = 0;
+    for (uint32_t count : overall.killMoves) {
+        kills += count;
+    }
+    std::vector<int> killMoves = TopEntries(overall.killMoves, 3);
+    if (!killMoves.empty()) {
+        line.str("");
+        line << "Kills with: ";
+        for (size_t i = 0; i < killMoves.size(); i++) {
+            line << (i > 0 ? ", " : "") << SlippiNames::Move(killMoves[i]) << " "
+                 << Percent(overall.killMoves[killMoves[i]], kills) << "%";
+        }
+        report.lines.push_back(line.str());
+    }
+
+    uint64_t techSituations = 0;
+    for (uint32_t count : overall.techs) {
+        techSituations += count;
+    }
+    if (techSituations > 0) {
+        line.str("");
+        line << "Tech: ";
+        std::vector<int> options = TopEntries(overall.techs, ReplaySummary::TECH_OPTION_COUNT);
+        for (size_t i = 0; i < options.size(); i++) {
+            line << (i > 0 ? ", " : "") << TECH_OPTION_NAMES[options[i]] << " "
+                 << Percent(overall.techs[options[i]], techSituations) << "%";
+        }
+        line << " (" << techSituations << " knockdowns)";
+        report.lines.push_back(line.str());
+    }
+
+    if (overall.games > 0) {
+        line.str("");
+        line << "Per game: " << std::fixed;
+        line.precision(1);
+        line << static_cast<double>(overall.stocksTaken) / overall.games << " stocks taken, "
+             << static_cast<double>(overall.stocksLost) / overall.games << " lost, "
+             << overall.damageTaken / overall.games << "% taken";
+        if (overall.lrasQuits > 0) {
+            line << "; quits " << Percent(overall.lrasQuits, overall.games) << "% of games";
+        }
+        report.lines.push_back(line.str());
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "BatchAnalyzer.h"
+
+// Scouting aggregates over past singles games, one row per player identity
+// and character. Identities are connect codes, or "name:<display name>" for
+// games without one. Rows are updated in place as games are added, so a
+// report is one hash lookup plus a merge of that player's character rows,
+// independent of how many games they have played.
+//
+//   OpponentScouting scouting("scouting.dat");
+//   scouting.Load();
+//   for (const BatchResult& result : results) scouting.AddGame(result.summary);
+//   scouting.Save();
+//   scouting.BuildReport("ABCD#123", "", currentCharacter, report);
+
+struct ScoutingAggregate {
+    static const int STAGE_COUNT = 64;
+
+    uint32_t games = 0;
+    uint32_t decided = 0;                   // Games with a winner
+    uint32_t wins = 0;
+    uint32_t stageGames[STAGE_COUNT] = {};
+    uint32_t stageDecided[STAGE_COUNT] = {};
+    uint32_t stageWins[STAGE_COUNT] = {};
+    uint32_t stocksTaken = 0;
+    uint32_t stocksLost = 0;
+    uint32_t lrasQuits = 0;
+    uint64_t frames = 0;
+    double damageTaken = 0.0;
+    uint32_t killMoves[ReplaySummary::MOVE_ID_COUNT] = {};
+    uint32_t techs[ReplaySummary::TECH_OPTION_COUNT] = {};
+
+    void Add(const ReplaySummary& summary, int port);
+    void Merge(const ScoutingAggregate& other);
+};
+
+struct ScoutingReport {
+    std::string identity;
+    ScoutingAggregate overall;
+    int character = -1;                     // Character asked about, -1 if none
+    ScoutingAggregate asCharacter;          // Their games on that character
+    std::vector<std::pair<int, uint32_t>> characters;   // (character, games), most played first
+    std::vector<std::string> lines;         // Ready to show, most useful first
+};
+
+class OpponentScouting {
+public:
+    explicit OpponentScouting(const std::filesystem::path& storeFile);
+
+    bool Load();
+    bool Save();
+
+    // Loads again if the file was rewritten (by CoachClippiBatch) since the
+    // last Load; returns true if it was
+    bool ReloadIfChanged();
+    bool IsDirty() const { return m_dirty; }
+    const std::filesystem::path& GetStoreFile() const { return m_storeFile; }
+
+    // Folds a singles game into both players' rows. Returns false for games
+    // already added (keyed by seed, frames, players and damage) or unusable ones.
+    bool AddGame(const ReplaySummary& summary);
+
+    // Looks the player up by connect code, falling back to display name.
+    // Returns false if neither has any games.
+    bool BuildReport(const std::string& connectCode, const std::string& displayName, int character,
+                     ScoutingReport& report) const;
+
+    size_t GetPlayerCount() const { return m_players.size(); }
+    size_t GetGameCount() const { return m_seenGames.size(); }
+
+    static std::string IdentityForCode(const std::string& connectCode);
+    static std::string IdentityForName(const std::string& displayName);
+
+private:
+    struct CharacterRow {
+        int character;
+        ScoutingAggregate aggregate;
+    };
+
+    static uint64_t GameId(const ReplaySummary& summary);
+    static void FormatReport(ScoutingReport& report);
+
+    ScoutingAggregate& GetRow(const std::string& identity, int character);
+
+    std::filesystem::path m_storeFile;
+    std::unordered_map<std::string, std::vector<CharacterRow>> m_players;
+    std::unordered_set<uint64_t> m_seenGames;
+    bool m_dirty = false;
+    std::filesystem::file_time_type m_loadedWriteTime;
+
+    static constexpr uint32_t STORE_MAGIC = 0x57534343;  // "CCSW"
+    static constexpr uint32_t STORE_FORMAT_VERSION = 1;
+    static constexpr int MIN_STAGE_GAMES = 3;             // For best/worst stage
+};
@@ -0,0 +1,130 @@
+#include "PlayerPairs.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+const int8_t PAIR_INDEX[PlayerPairs::MAX_PLAYERS][PlayerPairs::MAX_PLAYERS] = {
+    {-1, 0, 1, 2},
+    {0, -1, 3, 4},
+    {1, 3, -1, 5},
+    {2, 4, 5, -1}
+};
+
+// Free-for-all players each get a team of their own
+const int SOLO_TEAM_BASE = 1000;
+
+} // namespace
+
+// Padding lanes pair player 0 with itself, which is never an opponent
+const uint8_t PlayerPairs::FIRST[LANES] = {0, 0, 0, 1, 1, 2, 0, 0};
+const uint8_t PlayerPairs::SECOND[LANES] = {1, 2, 3, 2, 3, 3, 0, 0};
+
+int PlayerPairs::PairIndex(int a, int b) {
+    return PAIR_INDEX[a][b];
+}
+
+void PlayerPairs::BeginGame(const int teams[MAX_PLAYERS]) {
+    *this = PlayerPairs();
+    std::copy(teams, teams + MAX_PLAYERS, m_teams);
+}
+
+void PlayerPairs::Observe(const GameState& state) {
+    int count = std::min(state.activePlayerCount, MAX_PLAYERS);
+
+    float x[MAX_PLAYERS];
+    float y[MAX_PLAYERS];
+    float facing[MAX_PLAYERS];
+    int team[MAX_PLAYERS];
+    uint8_t active[MAX_PLAYERS];
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        const PlayerState& player = state.players[i];
+        active[i] = i < count && player.stocks > 0;
+        x[i] = player.positionX;
+        y[i] = player.positionY;
+        facing[i] = player.facing;
+        team[i] = m_teams[i] == NO_TEAM ? SOLO_TEAM_BASE + i : m_teams[i];
+    }
+
+    // Spread the players over the lanes, then do every pair at once
+    alignas(32) float dx[LANES];
+    alignas(32) float dy[LANES];
+    alignas(32) float firstFacing[LANES];
+    alignas(32) float secondFacing[LANES];
+    alignas(32) uint8_t opponents[LANES];
+    for (int lane = 0; lane < LANES; lane++) {
+        int a = FIRST[lane];
+        int b = SECOND[lane];
+        dx[lane] = x[b] - x[a];
+        dy[lane] = y[b] - y[a];
+        firstFacing[lane] = facing[a];
+        secondFacing[lane] = facing[b];
+        opponents[lane] = active[a] & active[b] & static_cast<uint8_t>(team[a] != team[b]);
+    }
+
+    const float THREAT_RANGE_SQ = THREAT_RANGE * THREAT_RANGE;
+    for (int lane = 0; lane < LANES; lane++) {
+        float distanceSq = dx[lane] * dx[lane] + dy[lane] * dy[lane];
+        uint8_t inRange = opponents[lane] & static_cast<uint8_t>(distanceSq <= THREAT_RANGE_SQ);
+
+        // Facing is +1 right and -1 left; 0 (not sent) counts as facing both ways
+        m_distanceSq[lane] = distanceSq;
+        m_opponents[lane] = opponents[lane];
+        m_firstThreatens[lane] = inRange & static_cast<uint8_t>(dx[lane] * firstFacing[lane] >= 0.0f);
+        m_secondThreatens[lane] = inRange & static_cast<uint8_t>(dx[lane] * secondFacing[lane] <= 0.0f);
+    }
+
+    std::fill(std::begin(m_threatening), std::end(m_threatening), 0);
+    for (int lane = 0; lane < PAIR_COUNT; lane++) {
+        m_threatening[FIRST[lane]] |= m_firstThreatens[lane];
+        m_threatening[SECOND[lane]] |= m_secondThreatens[lane];
+    }
+
+    // Hits, credited to the nearest opponent, those facing the victim first
+    bool follows = m_hasLast && state.frameCount == m_lastFrame + 1 && count == m_lastPlayerCount;
+    for (int victim = 0; victim < MAX_PLAYERS; victim++) {
+        m_attacker[victim] = -1;
+        const PlayerState& player = state.players[victim];
+        if (!follows || victim >= count || player.stocks != m_lastStocks[victim] ||
+            player.damage <= m_lastPercent[victim]) {
+            continue;
+        }
+
+        float bestScore = 0.0f;
+        for (int other = 0; other < count; other++) {
+            if (other == victim || !IsOpponent(victim, other)) {
+                continue;
+            }
+            float score = m_distanceSq[PAIR_INDEX[victim][other]] + (Threatens(other, victim) ? 0.0f : 1.0e12f);
+            if (m_attacker[victim] < 0 || score < bestScore) {
+                m_attacker[victim] = other;
+                bestScore = score;
+            }
+        }
+    }
+
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        m_lastPercent[i] = state.players[i].damage;
+        m_lastStocks[i] = state.players[i].stocks;
+    }
+    m_lastFrame = state.frameCount;
+    m_lastPlayerCount = count;
+    m_hasLast = true;
+}
+
+bool PlayerPairs::IsOpponent(int a, int b) const {
+    return a != b && m_opponents[PAIR_INDEX[a][b]] != 0;
+}
+
+float PlayerPairs::GetDistance(int a, int b) const {
+    return a == b ? 0.0f : std::sqrt(m_distanceSq[PAIR_INDEX[a][b]]);
+}
+
+bool PlayerPairs::Threatens(int attacker, int target) const {
+    if (attacker == target) {
+        return false;
+    }
+    int lane = PAIR_INDEX[attacker][target];
+    return (attacker < target ? m_firstThreatens[lane] : m_secondThreatens[lane]) != 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include "GameState.h"
+
+// What's between every two players on a frame: distance, whether each faces
+// the other, and whether each has the other in its threat range. All six
+// pairs of a four-player game are computed together in one pass over
+// struct-of-arrays lanes, padded to eight so the loop vectorizes; a singles
+// frame fills the same lanes, so doubles costs the same per frame.
+//
+// The live stream doesn't say who landed a hit, so the pass also names an
+// attacker for every player hit on the frame: the nearest opponent, with
+// those facing the victim first. Teammates are never credited.
+//
+//   pairs.BeginGame(gameStart.teams);
+//   for each frame: pairs.Observe(state);
+//                   int attacker = pairs.GetAttacker(victim);
+//
+// Not thread-safe; GameDataInterface calls it under its game state lock.
+
+class PlayerPairs {
+public:
+    static constexpr int MAX_PLAYERS = 4;
+    static constexpr int PAIR_COUNT = 6;
+    static constexpr int LANES = 8;
+    static constexpr float THREAT_RANGE = 40.0f;    // Game units; a long disjoint plus a dash
+    static constexpr int NO_TEAM = -1;
+
+    // Lane of the pair a, b (a != b)
+    static int PairIndex(int a, int b);
+
+    // teams[i] = NO_TEAM for everyone is a free-for-all
+    void BeginGame(const int teams[MAX_PLAYERS]);
+    void Observe(const GameState& state);
+
+    bool IsOpponent(int a, int b) const;
+    float GetDistance(int a, int b) const;
+    bool Threatens(int attacker, int target) const;     // In range and facing the target
+    bool ThreatensAnyone(int player) const { return m_threatening[player] != 0; }
+
+    // Who hit victim on this frame; -1 when it wasn't hit, or the frame
+    // doesn't follow on from the last one
+    int GetAttacker(int victim) const { return m_attacker[victim]; }
+    int GetTeam(int player) const { return m_teams[player]; }
+
+private:
+    static const uint8_t FIRST[LANES];
+    static const uint8_t SECOND[LANES];
+
+    int m_teams[MAX_PLAYERS] = {NO_TEAM, NO_TEAM, NO_TEAM, NO_TEAM};
+
+    // One lane per pair; the last two lanes are padding and never active
+    alignas(32) float m_distanceSq[LANES] = {};
+    alignas(32) uint8_t m_opponents[LANES] = {};
+    alignas(32) uint8_t m_firstThreatens[LANES] = {};   // FIRST[lane] threatens SECOND[lane]
+    alignas(32) uint8_t m_secondThreatens[LANES] = {};
+    uint8_t m_threatening[MAX_PLAYERS] = {};
+
+    int m_attacker[MAX_PLAYERS] = {-1, -1, -1, -1};
+
+    // Previous frame, for hits
+    int m_lastFrame = 0;
+    int m_lastPlayerCount = 0;
+    bool m_hasLast = false;
+    float m_lastPercent[MAX_PLAYERS] = {};
+    int m_lastStocks[MAX_PLAYERS] = {};
+};
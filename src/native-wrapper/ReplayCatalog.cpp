@@ -0,0 +1,335 @@
+#include "ReplayCatalog.h"
+#include "ContentHash.h"
+#include "FrameStore.h"
+#include "Logger.h"
+#include "ZipArchive.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+// Guards against reading garbage lengths from a damaged catalog
+const uint32_t MAX_STRING_LENGTH = 64 * 1024;
+const uint32_t MAX_COPIES = 1024 * 1024;
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void WriteString(std::ofstream& out, const std::string& text) {
+    WritePod(out, static_cast<uint32_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool ReadString(std::ifstream& in, std::string& text) {
+    uint32_t length = 0;
+    if (!ReadPod(in, length) || length > MAX_STRING_LENGTH) {
+        return false;
+    }
+    text.assign(length, '\0');
+    return length == 0 || static_cast<bool>(in.read(&text[0], length));
+}
+
+// Columns that make up a frame's state for the game key; the rest (last
+// attack, last hit by, character) follow from these
+const FrameStore::PortField KEY_FIELDS[] = {
+    FrameStore::PERCENT, FrameStore::POSITION_X, FrameStore::POSITION_Y,
+    FrameStore::ACTION_STATE, FrameStore::STOCKS
+};
+
+bool Identify(const SlpReader& reader, ReplayIdentity& identity, CatalogGame& game) {
+    SlpGameStart gameStart;
+    if (!reader.ReadGameStart(gameStart)) {
+        return false;
+    }
+    identity.contentHash = ContentHash::Hash64(reader.GetRawData(), reader.GetRawLength());
+
+    FrameStore store;
+    if (!store.Load(reader, 0)) {
+        return false;
+    }
+
+    ContentHash::Hasher hasher;
+    hasher.Update(&gameStart.stage, sizeof(gameStart.stage));
+    hasher.Update(&gameStart.randomSeed, sizeof(gameStart.randomSeed));
+    hasher.Update(gameStart.characters, sizeof(gameStart.characters));
+    for (const std::string& code : gameStart.connectCodes) {
+        hasher.Update(code.data(), code.size() + 1);
+    }
+
+    const ColumnTable& table = store.GetTable();
+    for (int port = 0; port < FrameStore::PORTS; port++) {
+        if (!store.HasPort(port)) {
+            continue;
+        }
+        for (FrameStore::PortField field : KEY_FIELDS) {
+            const Column& column = table.columns[table.Find(FrameStore::ColumnName(port, field))];
+            hasher.Update(column.data.data(), column.data.size());
+        }
+    }
+    identity.gameKey = hasher.Digest();
+
+    game.gameKey = identity.gameKey;
+    game.contentHash = identity.contentHash;
+    game.stage = gameStart.stage;
+    for (int port = 0; port < 4; port++) {
+        game.characters[port] = gameStart.characters[port];
+    }
+    game.lastFrame = FrameStore::FIRST_FRAME + static_cast<int>(store.GetRowCount()) - 1;
+    return true;
+}
+
+// Size and timestamp of a replay file or zip entry path
+bool StatReplay(const std::filesystem::path& path, uint64_t& size, int64_t& modifiedTime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return ZipArchive::StatEntry(path, size, modifiedTime);
+    }
+    modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    return !error;
+}
+
+} // namespace
+
+bool IdentifyReplay(const SlpReader& reader, ReplayIdentity& identity) {
+    CatalogGame game;
+    return Identify(reader, identity, game);
+}
+
+ReplayCatalog::ReplayCatalog(const std::filesystem::path& catalogFile)
+    : m_catalogFile(catalogFile) {
+}
+
+bool ReplayCatalog::Load() {
+    std::ifstream in(m_catalogFile, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t formatVersion = 0;
+    if (!ReadPod(in, magic) || !ReadPod(in, formatVersion) ||
+        magic != CATALOG_MAGIC || formatVersion != CATALOG_FORMAT_VERSION) {
+        LOG_WARN("Ignoring incompatible replay catalog: {}", m_catalogFile.wstring());
+        return false;
+    }
+
+    uint64_t gameCount = 0;
+    if (!ReadPod(in, gameCount)) {
+        return false;
+    }
+    std::vector<CatalogGame> games;
+    for (uint64_t i = 0; i < gameCount; i++) {
+        CatalogGame game;
+        uint32_t copyCount = 0;
+        if (!ReadPod(in, game.gameKey) || !ReadPod(in, game.contentHash) || !ReadPod(in, game.stage) ||
+            !ReadPod(in, game.characters) || !ReadPod(in, game.lastFrame) || !ReadString(in, game.path) ||
+            !ReadPod(in, copyCount) || copyCount > MAX_COPIES) {
+            return false;
+        }
+        game.copies.resize(copyCount);
+        for (std::string& copy : game.copies) {
+            if (!ReadString(in, copy)) {
+                return false;
+            }
+        }
+        games.push_back(std::move(game));
+    }
+
+    uint64_t pathCount = 0;
+    if (!ReadPod(in, pathCount)) {
+        return false;
+    }
+    std::unordered_map<std::string, PathRecord> paths;
+    for (uint64_t i = 0; i < pathCount; i++) {
+        std::string key;
+        PathRecord record;
+        if (!ReadString(in, key) || !ReadPod(in, record)) {
+            return false;
+        }
+        paths.emplace(std::move(key), record);
+    }
+
+    m_games = std::move(games);
+    m_paths = std::move(paths);
+    m_gameIndex.clear();
+    m_contentIndex.clear();
+    for (size_t i = 0; i < m_games.size(); i++) {
+        m_gameIndex[m_games[i].gameKey] = i;
+    }
+    for (const auto& entry : m_paths) {
+        m_contentIndex[entry.second.identity.contentHash] = entry.second.identity.gameKey;
+    }
+    m_dirty = false;
+
+    LOG_INFO("Loaded replay catalog with {} games from {} files", m_games.size(), m_paths.size());
+    return true;
+}
+
+bool ReplayCatalog::Save() {
+    std::filesystem::path tempFile = m_catalogFile;
+    tempFile += ".tmp";
+
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Failed to write replay catalog: {}", tempFile.wstring());
+            return false;
+        }
+
+        WritePod(out, CATALOG_MAGIC);
+        WritePod(out, CATALOG_FORMAT_VERSION);
+
+        WritePod(out, static_cast<uint64_t>(m_games.size()));
+        for (const CatalogGame& game : m_games) {
+            WritePod(out, game.gameKey);
+            WritePod(out, game.contentHash);
+            WritePod(out, game.stage);
+            WritePod(out, game.characters);
+            WritePod(out, game.lastFrame);
+            WriteString(out, game.path);
+            WritePod(out, static_cast<uint32_t>(game.copies.size()));
+            for (const std::string& copy : game.copies) {
+                WriteString(out, copy);
+            }
+        }
+
+        WritePod(out, static_cast<uint64_t>(m_paths.size()));
+        for (const auto& entry : m_paths) {
+            WriteString(out, entry.first);
+            WritePod(out, entry.second);
+        }
+
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, m_catalogFile, error);
+    if (error) {
+        LOG_ERROR("Failed to replace replay catalog: {}", error.value());
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+std::vector<std::filesystem::path> ReplayCatalog::Import(const std::vector<std::filesystem::path>& replays,
+                                                         unsigned threadCount, ImportStats& stats) {
+    auto startTime = std::chrono::steady_clock::now();
+    stats = ImportStats();
+    stats.total = replays.size();
+
+    // Identified in parallel; the catalog itself is only read here
+    struct Work {
+        std::string pathKey;
+        PathRecord record;
+        CatalogGame game;
+        bool unchanged = false;
+        bool succeeded = false;
+    };
+    std::vector<Work> work(replays.size());
+    std::atomic<size_t> nextIndex(0);
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= replays.size()) {
+                break;
+            }
+
+            Work& item = work[index];
+            item.pathKey = replays[index].generic_u8string();
+            if (!StatReplay(replays[index], item.record.size, item.record.modifiedTime)) {
+                continue;
+            }
+
+            auto known = m_paths.find(item.pathKey);
+            if (known != m_paths.end() && known->second.size == item.record.size &&
+                known->second.modifiedTime == item.record.modifiedTime) {
+                item.unchanged = true;
+                item.succeeded = true;
+                continue;
+            }
+
+            SlpReader reader;
+            item.succeeded = reader.LoadFile(replays[index]) && Identify(reader, item.record.identity, item.game);
+        }
+    };
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(1, replays.size())));
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Registered in list order so the canonical copy doesn't depend on thread timing
+    std::vector<std::filesystem::path> added;
+    for (size_t index = 0; index < work.size(); index++) {
+        Work& item = work[index];
+        if (!item.succeeded) {
+            stats.failed++;
+            continue;
+        }
+        if (item.unchanged) {
+            stats.unchanged++;
+            continue;
+        }
+
+        const ReplayIdentity& identity = item.record.identity;
+        auto byContent = m_contentIndex.find(identity.contentHash);
+        uint64_t gameKey = byContent != m_contentIndex.end() ? byContent->second : identity.gameKey;
+        auto existing = m_gameIndex.find(gameKey);
+
+        if (existing == m_gameIndex.end()) {
+            item.game.path = item.pathKey;
+            m_gameIndex[gameKey] = m_games.size();
+            m_games.push_back(std::move(item.game));
+            added.push_back(replays[index]);
+            stats.added++;
+        } else {
+            CatalogGame& game = m_games[existing->second];
+            if (byContent != m_contentIndex.end()) {
+                stats.duplicates++;
+            } else {
+                stats.perspectives++;
+            }
+            if (game.path != item.pathKey &&
+                std::find(game.copies.begin(), game.copies.end(), item.pathKey) == game.copies.end()) {
+                game.copies.push_back(item.pathKey);
+            }
+        }
+
+        m_contentIndex[identity.contentHash] = gameKey;
+        m_paths[item.pathKey] = item.record;
+        m_dirty = true;
+    }
+
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return added;
+}
+
+const CatalogGame* ReplayCatalog::FindGame(uint64_t gameKey) const {
+    auto found = m_gameIndex.find(gameKey);
+    return found != m_gameIndex.end() ? &m_games[found->second] : nullptr;
+}
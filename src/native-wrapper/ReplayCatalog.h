@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SlippiReplay.h"
+
+// What makes two replay files the same game
+struct ReplayIdentity {
+    // XXH64 of the raw event stream (game start block and frames), so byte
+    // copies and re-uploads match even if their metadata was rewritten
+    uint64_t contentHash = 0;
+
+    // XXH64 of the game start fields both players share and the final state
+    // of every frame. Each player's client records its own rollbacks, so the
+    // two perspectives of an online game differ in bytes but not in this key.
+    uint64_t gameKey = 0;
+};
+
+bool IdentifyReplay(const SlpReader& reader, ReplayIdentity& identity);
+
+struct CatalogGame {
+    uint64_t gameKey = 0;
+    uint64_t contentHash = 0;           // Of the canonical copy
+    std::string path;                   // Canonical copy: the first one imported
+    std::vector<std::string> copies;    // Every other file of the same game
+    int stage = 0;
+    int characters[4] = {-1, -1, -1, -1};
+    int lastFrame = 0;
+};
+
+struct ImportStats {
+    size_t total = 0;
+    size_t unchanged = 0;       // Already imported, same size and timestamp
+    size_t added = 0;           // New games
+    size_t duplicates = 0;      // Byte copies of a known game
+    size_t perspectives = 0;    // Another player's recording of a known game
+    size_t failed = 0;
+    double elapsedSeconds = 0.0;
+};
+
+// Persistent catalog of unique games. Import hashes replays in parallel and
+// registers each game once, remembering the other files it was found in, so
+// analysis and storage only ever deal with one copy.
+class ReplayCatalog {
+public:
+    explicit ReplayCatalog(const std::filesystem::path& catalogFile);
+
+    bool Load();
+    bool Save();
+
+    // Identifies the replays (threadCount 0 = hardware concurrency) and
+    // registers them in list order; returns the replays that added a game
+    std::vector<std::filesystem::path> Import(const std::vector<std::filesystem::path>& replays,
+                                              unsigned threadCount, ImportStats& stats);
+
+    const CatalogGame* FindGame(uint64_t gameKey) const;
+    const std::vector<CatalogGame>& GetGames() const { return m_games; }
+    size_t GetGameCount() const { return m_games.size(); }
+    bool IsDirty() const { return m_dirty; }
+
+private:
+    // Path -> identity, valid while size and modification time match
+    struct PathRecord {
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        ReplayIdentity identity;
+    };
+
+    std::filesystem::path m_catalogFile;
+    std::vector<CatalogGame> m_games;
+    std::unordered_map<uint64_t, size_t> m_gameIndex;          // gameKey -> m_games index
+    std::unordered_map<uint64_t, uint64_t> m_contentIndex;     // contentHash -> gameKey
+    std::unordered_map<std::string, PathRecord> m_paths;
+    bool m_dirty = false;
+
+    static constexpr uint32_t CATALOG_MAGIC = 0x52434343;  // "CCCR"
+    static constexpr uint32_t CATALOG_FORMAT_VERSION = 1;
+};
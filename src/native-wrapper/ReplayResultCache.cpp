@@ -0,0 +1,223 @@
+#include "ReplayResultCache.h"
+#include "Logger.h"
+#include <fstream>
+
+namespace {
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Guards against reading garbage lengths from a damaged cache file
+const uint32_t MAX_BLOB_SIZE = 16 * 1024 * 1024;
+
+} // namespace
+
+ReplayResultCache::ReplayResultCache(const std::filesystem::path& cacheFile)
+    : m_cacheFile(cacheFile) {
+}
+
+ReplayResultCache::~ReplayResultCache() {
+    if (m_dirty) {
+        Save();
+    }
+}
+
+bool ReplayResultCache::Load() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::ifstream in(m_cacheFile, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t formatVersion = 0;
+    if (!ReadPod(in, magic) || !ReadPod(in, formatVersion) ||
+        magic != CACHE_MAGIC || formatVersion != CACHE_FORMAT_VERSION) {
+        LOG_WARN("Ignoring incompatible result cache: {}", m_cacheFile.wstring());
+        return false;
+    }
+
+    uint64_t fingerprintCount = 0;
+    if (!ReadPod(in, fingerprintCount)) {
+        return false;
+    }
+
+    std::unordered_map<std::string, FileFingerprint> fingerprints;
+    for (uint64_t i = 0; i < fingerprintCount; i++) {
+        uint32_t keyLength = 0;
+        if (!ReadPod(in, keyLength) || keyLength > MAX_BLOB_SIZE) {
+            return false;
+        }
+
+        std::string key(keyLength, '\0');
+        FileFingerprint fingerprint;
+        if (!in.read(&key[0], keyLength) || !ReadPod(in, fingerprint)) {
+            return false;
+        }
+        fingerprints.emplace(std::move(key), fingerprint);
+    }
+
+    uint64_t resultCount = 0;
+    if (!ReadPod(in, resultCount)) {
+        return false;
+    }
+
+    std::unordered_map<ReplayCacheKey, std::vector<uint8_t>, ReplayCacheKeyHash> results;
+    results.reserve(static_cast<size_t>(resultCount));
+    for (uint64_t i = 0; i < resultCount; i++) {
+        ReplayCacheKey key;
+        uint32_t blobSize = 0;
+        if (!ReadPod(in, key.contentHash) || !ReadPod(in, key.analyzerVersion) ||
+            !ReadPod(in, key.optionsHash) || !ReadPod(in, blobSize) || blobSize > MAX_BLOB_SIZE) {
+            return false;
+        }
+
+        std::vector<uint8_t> blob(blobSize);
+        if (blobSize > 0 && !in.read(reinterpret_cast<char*>(blob.data()), blobSize)) {
+            return false;
+        }
+        results.emplace(key, std::move(blob));
+    }
+
+    m_fingerprints = std::move(fingerprints);
+    m_results = std::move(results);
+    m_dirty = false;
+
+    LOG_INFO("Loaded result cache with {} entries", m_results.size());
+    return true;
+}
+
+bool ReplayResultCache::Save() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Write to a temporary file and swap it in so a crash never leaves a torn cache
+    std::filesystem::path tempFile = m_cacheFile;
+    tempFile += ".tmp";
+
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Failed to write result cache: {}", tempFile.wstring());
+            return false;
+        }
+
+        WritePod(out, CACHE_MAGIC);
+        WritePod(out, CACHE_FORMAT_VERSION);
+
+        // Replays deleted since they were fingerprinted are dropped
+        size_t removed = 0;
+        for (auto it = m_fingerprints.begin(); it != m_fingerprints.end();) {
+            std::error_code error;
+            if (!std::filesystem::exists(std::filesystem::u8path(it->first), error) && !error) {
+                it = m_fingerprints.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        if (removed > 0) {
+            LOG_INFO("Dropped {} result cache fingerprints for missing replays", removed);
+        }
+
+        WritePod(out, static_cast<uint64_t>(m_fingerprints.size()));
+        for (const auto& entry : m_fingerprints) {
+            WritePod(out, static_cast<uint32_t>(entry.first.size()));
+            out.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+            WritePod(out, entry.second);
+        }
+
+        WritePod(out, static_cast<uint64_t>(m_results.size()));
+        for (const auto& entry : m_results) {
+            WritePod(out, entry.first.contentHash);
+            WritePod(out, entry.first.analyzerVersion);
+            WritePod(out, entry.first.optionsHash);
+            WritePod(out, static_cast<uint32_t>(entry.second.size()));
+            out.write(reinterpret_cast<const char*>(entry.second.data()),
+                      static_cast<std::streamsize>(entry.second.size()));
+        }
+
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, m_cacheFile, error);
+    if (error) {
+        LOG_ERROR("Failed to replace result cache: {}", error.value());
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool ReplayResultCache::LookupFingerprint(const std::string& pathKey, uint64_t size,
+                                          int64_t modifiedTime, uint64_t& contentHash) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_fingerprints.find(pathKey);
+    if (it == m_fingerprints.end() || it->second.size != size ||
+        it->second.modifiedTime != modifiedTime) {
+        return false;
+    }
+
+    contentHash = it->second.contentHash;
+    return true;
+}
+
+void ReplayResultCache::StoreFingerprint(const std::string& pathKey, const FileFingerprint& fingerprint) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fingerprints[pathKey] = fingerprint;
+    m_dirty = true;
+}
+
+bool ReplayResultCache::Lookup(const ReplayCacheKey& key, std::vector<uint8_t>& result) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_results.find(key);
+    if (it == m_results.end()) {
+        return false;
+    }
+
+    result = it->second;
+    return true;
+}
+
+void ReplayResultCache::Store(const ReplayCacheKey& key, const std::vector<uint8_t>& result) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results[key] = result;
+    m_dirty = true;
+}
+
+size_t ReplayResultCache::PruneVersions(uint32_t currentVersion) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t removed = 0;
+    for (auto it = m_results.begin(); it != m_results.end();) {
+        if (it->first.analyzerVersion != currentVersion) {
+            it = m_results.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+
+    if (removed > 0) {
+        m_dirty = true;
+    }
+    return removed;
+}
+
+size_t ReplayResultCache::GetResultCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_results.size();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <filesystem>
+
+// Identifies one analysis result: what was analyzed, by which analyzer
+// version and with which options
+struct ReplayCacheKey {
+    uint64_t contentHash = 0;
+    uint32_t analyzerVersion = 0;
+    uint64_t optionsHash = 0;
+
+    bool operator==(const ReplayCacheKey& other) const {
+        return contentHash == other.contentHash &&
+               analyzerVersion == other.analyzerVersion &&
+               optionsHash == other.optionsHash;
+    }
+};
+
+struct ReplayCacheKeyHash {
+    size_t operator()(const ReplayCacheKey& key) const {
+        uint64_t h = key.contentHash ^ (key.optionsHash * 0x9E3779B97F4A7C15ULL) ^ key.analyzerVersion;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+// Cheap file identity used to skip re-hashing unchanged replays
+struct FileFingerprint {
+    uint64_t size = 0;
+    int64_t modifiedTime = 0;
+    uint64_t contentHash = 0;
+};
+
+// Persistent analysis result cache. Results are opaque byte blobs owned by
+// the analyzer; the cache only keys and stores them.
+class ReplayResultCache {
+public:
+    explicit ReplayResultCache(const std::filesystem::path& cacheFile);
+    ~ReplayResultCache();
+
+    bool Load();
+    // Also drops fingerprints of replays that no longer exist
+    bool Save();
+
+    // Path -> content hash, valid while size and modification time match
+    bool LookupFingerprint(const std::string& pathKey, uint64_t size, int64_t modifiedTime,
+                           uint64_t& contentHash) const;
+    void StoreFingerprint(const std::string& pathKey, const FileFingerprint& fingerprint);
+
+    bool Lookup(const ReplayCacheKey& key, std::vector<uint8_t>& result) const;
+    void Store(const ReplayCacheKey& key, const std::vector<uint8_t>& result);
+
+    // Drops results produced by any other analyzer version
+    size_t PruneVersions(uint32_t currentVersion);
+
+    size_t GetResultCount() const;
+    bool IsDirty() const { return m_dirty; }
+    const std::filesystem::path& GetCacheFile() const { return m_cacheFile; }
+
+private:
+    std::filesystem::path m_cacheFile;
+    mutable std::mutex m_mutex;
+    std::unordered_map<ReplayCacheKey, std::vector<uint8_t>, ReplayCacheKeyHash> m_results;
+    std::unordered_map<std::string, FileFingerprint> m_fingerprints;
+    bool m_dirty = false;
+
+    static constexpr uint32_t CACHE_MAGIC = 0x43524343;  // "CCRC"
+    static constexpr uint32_t CACHE_FORMAT_VERSION = 1;
+};
@@ -0,0 +1,91 @@
+#include "ScoutingIngest.h"
+#include "BatchAnalyzer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+ScoutingIngest::ScoutingIngest(OpponentScouting& scouting, const std::filesystem::path& replayDirectory,
+                               std::filesystem::file_time_type since)
+    : m_scouting(scouting), m_replayDirectory(replayDirectory), m_since(since) {
+    m_ingestThread = std::thread(&ScoutingIngest::IngestThreadProc, this);
+}
+
+ScoutingIngest::~ScoutingIngest() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_ingestThread.joinable()) {
+        m_ingestThread.join();
+    }
+}
+
+void ScoutingIngest::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakePending = true;
+    }
+    m_condition.notify_all();
+}
+
+void ScoutingIngest::IngestThreadProc() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_wakePending || m_stop; });
+        if (!m_wakePending) {
+            break;
+        }
+
+        m_wakePending = false;
+        lock.unlock();
+        IngestNewReplays();
+        lock.lock();
+    }
+}
+
+void ScoutingIngest::IngestNewReplays() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> replays;
+    for (const std::filesystem::path& path : BatchAnalyzer::CollectReplays(m_replayDirectory, true)) {
+        std::error_code error;
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+        if (!error && writeTime > m_since) {
+            replays.emplace_back(writeTime, path);
+        }
+    }
+    std::sort(replays.begin(), replays.end());
+
+    // Analysis runs without the store lock; only the additions take it
+    BatchAnalyzer analyzer(BatchOptions(), nullptr);
+    std::vector<ReplaySummary> finished;
+    for (const auto& replay : replays) {
+        ReplaySummary summary;
+        bool fromCache = false;
+        if (!analyzer.AnalyzeFile(replay.second, summary, fromCache) || summary.gameEndMethod <= 0) {
+            continue;
+        }
+        finished.push_back(summary);
+        m_since = replay.first;
+    }
+
+    int added = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_storeMutex);
+        m_scouting.ReloadIfChanged();
+        for (const ReplaySummary& summary : finished) {
+            if (m_scouting.AddGame(summary)) {
+                added++;
+            }
+        }
+        if (added > 0 && !m_scouting.Save()) {
+            LOG_WARN("Failed to save scouting store {}", m_scouting.GetStoreFile().wstring());
+        }
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Scouting: {} of {} new replays added in {} ms", added, replays.size(), elapsedMs);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include "OpponentScouting.h"
+
+// Adds the games finished in the replay folder to the scouting store on a
+// background thread, so a game start only pays for the report lookup. Each
+// pass analyzes the replays written since the last one; a replay that is
+// still being written is left for the next pass.
+//
+//   ScoutingIngest ingest(scouting, replayDirectory, now);
+//   ingest.Wake();                         // A game just finished
+//   {
+//       std::lock_guard<std::mutex> lock(ingest.GetStoreMutex());
+//       scouting.BuildReport(code, name, character, report);
+//   }
+class ScoutingIngest {
+public:
+    ScoutingIngest(OpponentScouting& scouting, const std::filesystem::path& replayDirectory,
+                   std::filesystem::file_time_type since);
+
+    // A pass that was asked for still runs, so the last game of a session
+    // gets into the store
+    ~ScoutingIngest();
+
+    void Wake();
+
+    // Held by the ingest thread while it changes or saves the store; hold it
+    // to read the store
+    std::mutex& GetStoreMutex() { return m_storeMutex; }
+
+private:
+    void IngestThreadProc();
+    void IngestNewReplays();
+
+    OpponentScouting& m_scouting;
+    std::filesystem::path m_replayDirectory;
+    std::filesystem::file_time_type m_since;    // Replays up to here are in the store
+    std::mutex m_storeMutex;
+
+    std::thread m_ingestThread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_wakePending = false;
+    bool m_stop = false;
+};
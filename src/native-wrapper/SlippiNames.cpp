@@ -0,0 +1,109 @@
+#include "SlippiNames.h"
+#include <cstddef>
+
+namespace {
+
+const char* const CHARACTER_NAMES[] = {
+    "Captain Falcon", "Donkey Kong", "Fox", "Mr. Game & Watch", "Kirby", "Bowser", "Link",
+    "Luigi", "Mario", "Marth", "Mewtwo", "Ness", "Peach", "Pikachu", "Ice Climbers",
+    "Jigglypuff", "Samus", "Yoshi", "Zelda", "Sheik", "Falco", "Young Link", "Dr. Mario",
+    "Roy", "Pichu", "Ganondorf"
+};
+
+struct IdName {
+    int id;
+    const char* name;
+};
+
+const IdName STAGE_NAMES[] = {
+    {2, "Fountain of Dreams"},
+    {3, "Pokemon Stadium"},
+    {4, "Princess Peach's Castle"},
+    {5, "Kongo Jungle"},
+    {6, "Brinstar"},
+    {7, "Corneria"},
+    {8, "Yoshi's Story"},
+    {9, "Onett"},
+    {10, "Mute City"},
+    {11, "Rainbow Cruise"},
+    {12, "Jungle Japes"},
+    {13, "Great Bay"},
+    {14, "Hyrule Temple"},
+    {15, "Brinstar Depths"},
+    {16, "Yoshi's Island"},
+    {17, "Green Greens"},
+    {18, "Fourside"},
+    {19, "Mushroom Kingdom I"},
+    {20, "Mushroom Kingdom II"},
+    {22, "Venom"},
+    {23, "Poke Floats"},
+    {24, "Big Blue"},
+    {25, "Icicle Mountain"},
+    {27, "Flat Zone"},
+    {28, "Dream Land N64"},
+    {29, "Yoshi's Island N64"},
+    {30, "Kongo Jungle N64"},
+    {31, "Battlefield"},
+    {32, "Final Destination"}
+};
+
+const IdName MOVE_NAMES[] = {
+    {1, "Miscellaneous"},
+    {2, "Jab"},
+    {3, "Jab"},
+    {4, "Jab"},
+    {5, "Rapid Jabs"},
+    {6, "Dash Attack"},
+    {7, "Forward Tilt"},
+    {8, "Up Tilt"},
+    {9, "Down Tilt"},
+    {10, "Forward Smash"},
+    {11, "Up Smash"},
+    {12, "Down Smash"},
+    {13, "Neutral Air"},
+    {14, "Forward Air"},
+    {15, "Back Air"},
+    {16, "Up Air"},
+    {17, "Down Air"},
+    {18, "Neutral B"},
+    {19, "Side B"},
+    {20, "Up B"},
+    {21, "Down B"},
+    {50, "Getup Attack"},
+    {51, "Getup Attack (Slow)"},
+    {52, "Grab Pummel"},
+    {53, "Forward Throw"},
+    {54, "Back Throw"},
+    {55, "Up Throw"},
+    {56, "Down Throw"},
+    {61, "Edge Attack (Slow)"},
+    {62, "Edge Attack"}
+};
+
+template <size_t N>
+const char* FindName(const IdName (&names)[N], int id) {
+    for (const IdName& entry : names) {
+        if (entry.id == id) {
+            return entry.name;
+        }
+    }
+    return "Unknown";
+}
+
+} // namespace
+
+const char* SlippiNames::Character(int externalCharacterId) {
+    const int count = static_cast<int>(sizeof(CHARACTER_NAMES) / sizeof(CHARACTER_NAMES[0]));
+    if (externalCharacterId < 0 || externalCharacterId >= count) {
+        return "Unknown";
+    }
+    return CHARACTER_NAMES[externalCharacterId];
+}
+
+const char* SlippiNames::Stage(int stageId) {
+    return FindName(STAGE_NAMES, stageId);
+}
+
+const char* SlippiNames::Move(int moveId) {
+    return FindName(MOVE_NAMES, moveId);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Display names for the ids found in Slippi replays and live messages. These
+// match the tables in utils/slippiUtils.js. Unknown ids return "Unknown".
+namespace SlippiNames {
+    const char* Character(int externalCharacterId);
+    const char* Stage(int stageId);
+    const char* Move(int moveId);           // lastAttackLanded values
+}
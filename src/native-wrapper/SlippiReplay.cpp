@@ -0,0 +1,231 @@
+#include "SlippiReplay.h"
+#include "ZipArchive.h"
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+inline uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t ReadU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline float ReadF32(const uint8_t* p) {
+    uint32_t bits = ReadU32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Reads a null-padded Shift-JIS field. Fullwidth letters, digits, '#' and
+// spaces (the connect code '#' is always fullwidth) become ASCII; any other
+// double-byte character becomes '?'.
+std::string ReadShiftJis(const uint8_t* p, size_t length) {
+    std::string text;
+    for (size_t i = 0; i < length && p[i] != 0; i++) {
+        uint8_t lead = p[i];
+        if (lead < 0x80) {
+            text += static_cast<char>(lead);
+            continue;
+        }
+        bool isDoubleByte = (lead >= 0x81 && lead <= 0x9F) || (lead >= 0xE0 && lead <= 0xEF);
+        if (!isDoubleByte || i + 1 >= length) {
+            text += '?';
+            continue;
+        }
+
+        uint8_t trail = p[++i];
+        if (lead == 0x81 && trail == 0x94) {
+            text += '#';
+        } else if (lead == 0x81 && trail == 0x40) {
+            text += ' ';
+        } else if (lead == 0x82 && trail >= 0x4F && trail <= 0x58) {
+            text += static_cast<char>('0' + (trail - 0x4F));
+        } else if (lead == 0x82 && trail >= 0x60 && trail <= 0x79) {
+            text += static_cast<char>('A' + (trail - 0x60));
+        } else if (lead == 0x82 && trail >= 0x81 && trail <= 0x9A) {
+            text += static_cast<char>('a' + (trail - 0x81));
+        } else {
+            text += '?';
+        }
+    }
+    return text;
+}
+
+// UBJSON header that precedes the raw event stream: {U\x03raw[$U#l<int32 length>
+const uint8_t RAW_HEADER[] = { '{', 'U', 3, 'r', 'a', 'w', '[', '$', 'U', '#', 'l' };
+const size_t RAW_HEADER_SIZE = sizeof(RAW_HEADER);
+
+} // namespace
+
+SlpReader::SlpReader() {
+    memset(m_payloadSizes, 0, sizeof(m_payloadSizes));
+}
+
+bool SlpReader::LoadFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        // Not a file on disk; maybe an entry inside a zipped set
+        std::vector<uint8_t> bytes;
+        if (!ZipArchive::ReadEntry(path, bytes)) {
+            Clear();
+            return false;
+        }
+        return LoadFromMemory(std::move(bytes));
+    }
+
+    std::streamsize size = file.tellg();
+    if (size <= 0) {
+        Clear();
+        return false;
+    }
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+        Clear();
+        return false;
+    }
+
+    return LoadFromMemory(std::move(bytes));
+}
+
+bool SlpReader::LoadFromMemory(std::vector<uint8_t> bytes) {
+    Clear();
+    m_bytes = std::move(bytes);
+
+    if (!LocateRawStream() || !ReadEventPayloads()) {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+void SlpReader::Clear() {
+    m_bytes.clear();
+    m_rawOffset = 0;
+    m_rawLength = 0;
+    m_firstEventOffset = 0;
+    memset(m_payloadSizes, 0, sizeof(m_payloadSizes));
+}
+
+bool SlpReader::LocateRawStream() {
+    if (m_bytes.size() < RAW_HEADER_SIZE + 4 ||
+        memcmp(m_bytes.data(), RAW_HEADER, RAW_HEADER_SIZE) != 0) {
+        return false;
+    }
+
+    m_rawOffset = RAW_HEADER_SIZE + 4;
+    size_t declaredLength = ReadU32(m_bytes.data() + RAW_HEADER_SIZE);
+    size_t available = m_bytes.size() - m_rawOffset;
+
+    // A zero length means the replay is still being written; use what exists
+    m_rawLength = (declaredLength == 0 || declaredLength > available) ? available : declaredLength;
+    return m_rawLength > 0;
+}
+
+bool SlpReader::ReadEventPayloads() {
+    const uint8_t* raw = m_bytes.data() + m_rawOffset;
+    if (m_rawLength < 2 || raw[0] != SlpCommand::EVENT_PAYLOADS) {
+        return false;
+    }
+
+    uint8_t infoSize = raw[1];
+    if (static_cast<size_t>(infoSize) + 1 > m_rawLength) {
+        return false;
+    }
+
+    m_payloadSizes[SlpCommand::EVENT_PAYLOADS] = infoSize;
+
+    // Each entry is a command byte followed by a big-endian u16 payload size
+    for (size_t i = 2; i + 3 <= static_cast<size_t>(infoSize) + 1; i += 3) {
+        m_payloadSizes[raw[i]] = ReadU16(raw + i + 1);
+    }
+
+    m_firstEventOffset = static_cast<size_t>(infoSize) + 1;
+    return true;
+}
+
+bool SlpReader::ReadGameStart(SlpGameStart& gameStart) const {
+    bool found = false;
+    ForEachEvent([&](uint8_t command, const uint8_t* payload, size_t size) {
+        if (command == SlpCommand::GAME_START) {
+            found = DecodeGameStart(payload, size, gameStart);
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+bool SlpReader::DecodeGameStart(const uint8_t* payload, size_t size, SlpGameStart& gameStart) {
+    // Player blocks end at 0x65 + 4 * 0x24
+    if (size < 0xF5) {
+        return false;
+    }
+
+    gameStart.versionMajor = payload[0x1];
+    gameStart.versionMinor = payload[0x2];
+    gameStart.versionBuild = payload[0x3];
+    gameStart.isTeams = payload[0xD] != 0;
+    gameStart.stage = ReadU16(payload + 0x13);
+
+    for (int i = 0; i < 4; i++) {
+        size_t offset = 0x24 * i;
+        gameStart.playerTypes[i] = payload[0x66 + offset];
+        gameStart.characters[i] = gameStart.playerTypes[i] == 3 ? -1 : payload[0x65 + offset];
+        gameStart.startStocks[i] = payload[0x67 + offset];
+        gameStart.teams[i] = payload[0x6E + offset];
+    }
+
+    if (size >= 0x141) {
+        gameStart.randomSeed = ReadU32(payload + 0x13D);
+    }
+
+    if (size >= 0x249) {
+        for (int i = 0; i < 4; i++) {
+            gameStart.displayNames[i] = ReadShiftJis(payload + 0x1A5 + 0x1F * i, 0x1F);
+            gameStart.connectCodes[i] = ReadShiftJis(payload + 0x221 + 0xA * i, 0xA);
+        }
+    }
+
+    return true;
+}
+
+bool SlpReader::DecodePostFrame(const uint8_t* payload, size_t size, SlpPostFrame& postFrame) {
+    if (size < 0x22) {
+        return false;
+    }
+
+    postFrame.frame = static_cast<int32_t>(ReadU32(payload + 0x1));
+    postFrame.playerIndex = payload[0x5];
+    postFrame.isFollower = payload[0x6] != 0;
+    postFrame.internalCharacter = payload[0x7];
+    postFrame.actionState = ReadU16(payload + 0x8);
+    postFrame.positionX = ReadF32(payload + 0xA);
+    postFrame.positionY = ReadF32(payload + 0xE);
+    postFrame.facing = ReadF32(payload + 0x12);
+    postFrame.percent = ReadF32(payload + 0x16);
+    postFrame.shieldSize = ReadF32(payload + 0x1A);
+    postFrame.lastAttackLanded = payload[0x1E];
+    postFrame.comboCount = payload[0x1F];
+    postFrame.lastHitBy = payload[0x20];
+    postFrame.stocksRemaining = payload[0x21];
+    postFrame.isAirborne = size > 0x2F && payload[0x2F] != 0;
+    return true;
+}
+
+bool SlpReader::DecodeGameEnd(const uint8_t* payload, size_t size, SlpGameEnd& gameEnd) {
+    if (size < 2) {
+        return false;
+    }
+
+    gameEnd.method = payload[0x1];
+    gameEnd.lrasInitiator = size > 2 ? static_cast<int8_t>(payload[0x2]) : -1;
+    return true;
+}
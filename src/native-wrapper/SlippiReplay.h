@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// Slippi (.slp) event stream command bytes
+namespace SlpCommand {
+    const uint8_t MESSAGE_SPLITTER = 0x10;
+    const uint8_t EVENT_PAYLOADS = 0x35;
+    const uint8_t GAME_START = 0x36;
+    const uint8_t PRE_FRAME_UPDATE = 0x37;
+    const uint8_t POST_FRAME_UPDATE = 0x38;
+    const uint8_t GAME_END = 0x39;
+    const uint8_t FRAME_START = 0x3A;
+    const uint8_t ITEM_UPDATE = 0x3B;
+    const uint8_t FRAME_BOOKEND = 0x3C;
+}
+
+// Decoded Game Start payload (only the fields the analyzers use)
+struct SlpGameStart {
+    uint8_t versionMajor = 0;
+    uint8_t versionMinor = 0;
+    uint8_t versionBuild = 0;
+    int stage = 0;
+    bool isTeams = false;
+    int characters[4] = {-1, -1, -1, -1};   // External character id, -1 for empty slots
+    int playerTypes[4] = {3, 3, 3, 3};      // 0 = human, 1 = CPU, 2 = demo, 3 = empty
+    int startStocks[4] = {0, 0, 0, 0};
+    int teams[4] = {0, 0, 0, 0};
+    uint32_t randomSeed = 0;
+    // Slippi 3.9+ online games; Shift-JIS with fullwidth ASCII folded to ASCII
+    std::string displayNames[4];
+    std::string connectCodes[4];            // "ABCD#123"
+};
+
+// Decoded Post-Frame Update payload
+struct SlpPostFrame {
+    int32_t frame = 0;
+    uint8_t playerIndex = 0;
+    bool isFollower = false;
+    uint8_t internalCharacter = 0;
+    uint16_t actionState = 0;
+    float positionX = 0.0f;
+    float positionY = 0.0f;
+    float facing = 0.0f;
+    float percent = 0.0f;
+    float shieldSize = 0.0f;
+    uint8_t lastAttackLanded = 0;
+    uint8_t comboCount = 0;
+    uint8_t lastHitBy = 0;
+    uint8_t stocksRemaining = 0;
+    bool isAirborne = false;
+};
+
+struct SlpGameEnd {
+    int method = -1;            // 1 = time, 2 = game, 7 = no contest
+    int lrasInitiator = -1;
+};
+
+// Reads the raw event stream out of a .slp file held in memory
+class SlpReader {
+public:
+    SlpReader();
+
+    // Also takes "<archive>.zip/<entry>" paths (see ZipArchive)
+    bool LoadFile(const std::filesystem::path& path);
+    bool LoadFromMemory(std::vector<uint8_t> bytes);
+    void Clear();
+
+    bool IsValid() const { return m_rawLength > 0; }
+    const std::vector<uint8_t>& GetBytes() const { return m_bytes; }
+
+    // Raw event stream bounds within GetBytes()
+    const uint8_t* GetRawData() const { return m_bytes.data() + m_rawOffset; }
+    size_t GetRawLength() const { return m_rawLength; }
+
+    // Payload size (excluding the command byte) for a command, 0 if unknown
+    uint16_t GetPayloadSize(uint8_t command) const { return m_payloadSizes[command]; }
+
+    // Walks every event after the Event Payloads block. The callback receives
+    // the command byte and a pointer to the event (including the command byte)
+    // and returns false to stop early.
+    template <typename Callback>
+    bool ForEachEvent(Callback&& callback) const;
+
+    bool ReadGameStart(SlpGameStart& gameStart) const;
+
+    // Payload decoders; payload points at the command byte
+    static bool DecodeGameStart(const uint8_t* payload, size_t size, SlpGameStart& gameStart);
+    static bool DecodePostFrame(const uint8_t* payload, size_t size, SlpPostFrame& postFrame);
+    static bool DecodeGameEnd(const uint8_t* payload, size_t size, SlpGameEnd& gameEnd);
+
+private:
+    bool LocateRawStream();
+    bool ReadEventPayloads();
+
+    std::vector<uint8_t> m_bytes;
+    size_t m_rawOffset = 0;
+    size_t m_rawLength = 0;
+    size_t m_firstEventOffset = 0;
+    uint16_t m_payloadSizes[256];
+};
+
+template <typename Callback>
+bool SlpReader::ForEachEvent(Callback&& callback) const {
+    if (!IsValid()) {
+        return false;
+    }
+
+    const uint8_t* raw = GetRawData();
+    size_t pos = m_firstEventOffset;
+
+    while (pos < m_rawLength) {
+        uint8_t command = raw[pos];
+        uint16_t payloadSize = m_payloadSizes[command];
+        if (payloadSize == 0 || pos + 1 + payloadSize > m_rawLength) {
+            // Unknown command or truncated event (replay still being written)
+            break;
+        }
+
+        if (!callback(command, raw + pos, static_cast<size_t>(payloadSize) + 1)) {
+            break;
+        }
+
+        pos += static_cast<size_t>(payloadSize) + 1;
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+#include "StartupProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <fstream>
+
+StartupProfiler& StartupProfiler::Instance() {
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+int StartupProfiler::ThreadIndex() {
+    static std::atomic<int> nextIndex{1};
+    thread_local int index = nextIndex.fetch_add(1);
+    return index;
+}
+
+void StartupProfiler::Start() {
+    StartupProfiler& profiler = Instance();
+    std::lock_guard<std::mutex> lock(profiler.m_mutex);
+    if (!profiler.m_started) {
+        profiler.m_started = true;
+        profiler.m_origin = Clock::now();
+        ThreadIndex();  // The starting thread is T1
+    }
+}
+
+double StartupProfiler::ToMs(Clock::time_point time) const {
+    return std::chrono::duration<double, std::milli>(time - m_origin).count();
+}
+
+void StartupProfiler::Record(const char* name, Clock::time_point start, Clock::time_point end) {
+    StartupProfiler& profiler = Instance();
+    int thread = ThreadIndex();
+    std::lock_guard<std::mutex> lock(profiler.m_mutex);
+    if (!profiler.m_started || profiler.m_reported) {
+        return;
+    }
+    profiler.m_phases.push_back({name, profiler.ToMs(start),
+                                 std::chrono::duration<double, std::milli>(end - start).count(), thread});
+}
+
+void StartupProfiler::Mark(const char* milestone) {
+    StartupProfiler& profiler = Instance();
+    std::lock_guard<std::mutex> lock(profiler.m_mutex);
+    if (!profiler.m_started || profiler.m_reported) {
+        return;
+    }
+    for (const Milestone& existing : profiler.m_milestones) {
+        if (existing.name == milestone) {
+            return;
+        }
+    }
+    profiler.m_milestones.push_back({milestone, profiler.ToMs(Clock::now())});
+    profiler.ReportIfComplete();
+}
+
+double StartupProfiler::GetMilestoneMs(const char* milestone) {
+    StartupProfiler& profiler = Instance();
+    std::lock_guard<std::mutex> lock(profiler.m_mutex);
+    for (const Milestone& existing : profiler.m_milestones) {
+        if (existing.name == milestone) {
+            return existing.ms;
+        }
+    }
+    return -1.0;
+}
+
+void StartupProfiler::SetHistoryFile(const std::filesystem::path& historyFile) {
+    StartupProfiler& profiler = Instance();
+    std::lock_guard<std::mutex> lock(profiler.m_mutex);
+    profiler.m_historyFile = historyFile;
+}
+
+void StartupProfiler::ReportIfComplete() {
+    double firstFrameMs = -1.0;
+    double readyMs = -1.0;
+    for (const Milestone& milestone : m_milestones) {
+        if (milestone.name == FIRST_FRAME) firstFrameMs = milestone.ms;
+        if (milestone.name == READY) readyMs = milestone.ms;
+    }
+    if (firstFrameMs < 0.0 || readyMs < 0.0) {
+        return;
+    }
+    m_reported = true;
+
+    std::sort(m_phases.begin(), m_phases.end(),
+              [](const Phase& a, const Phase& b) { return a.startMs < b.startMs; });
+
+    LOG_INFO("Startup: first frame at {} ms, ready at {} ms", firstFrameMs, readyMs);
+    for (const Phase& phase : m_phases) {
+        LOG_INFO("Startup:   +{} ms [T{}] {} took {} ms", phase.startMs, phase.thread, phase.name, phase.durationMs);
+    }
+
+    if (m_historyFile.empty()) {
+        return;
+    }
+
+    std::ofstream history(m_historyFile, std::ios::app);
+    if (!history) {
+        return;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char timestamp[32] = {};
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    history << timestamp << ',' << firstFrameMs << ',' << readyMs;
+    for (const Phase& phase : m_phases) {
+        history << ',' << phase.name << '=' << phase.durationMs;
+    }
+    history << '\n';
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Startup timeline: named phases (from any thread) and milestones, measured
+// from process start. The report goes to the log, and one summary line per
+// launch is appended to a CSV so regressions show up over time.
+//
+//   {
+//       STARTUP_PHASE("Direct3D");
+//       CreateDeviceD3D(hwnd);
+//   }
+//   StartupProfiler::Mark(StartupProfiler::FIRST_FRAME);
+
+class StartupProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr const char* FIRST_FRAME = "first-frame";
+    static constexpr const char* READY = "ready";
+
+    // Records one phase on destruction
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(name), m_start(Clock::now()) {}
+        ~Scope() { StartupProfiler::Record(m_name, m_start, Clock::now()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+    };
+
+    // Call first thing in main; later calls are ignored
+    static void Start();
+
+    static void Record(const char* name, Clock::time_point start, Clock::time_point end);
+    static void Mark(const char* milestone);
+
+    // Milliseconds since Start, or -1 if the milestone hasn't been reached
+    static double GetMilestoneMs(const char* milestone);
+
+    // Logs the timeline once both FIRST_FRAME and READY are marked, and
+    // appends "time,firstFrameMs,readyMs,phase=ms..." to historyFile
+    static void SetHistoryFile(const std::filesystem::path& historyFile);
+
+private:
+    struct Phase {
+        std::string name;
+        double startMs;
+        double durationMs;
+        int thread;
+    };
+
+    struct Milestone {
+        std::string name;
+        double ms;
+    };
+
+    static StartupProfiler& Instance();
+    static int ThreadIndex();
+
+    void ReportIfComplete();
+    double ToMs(Clock::time_point time) const;
+
+    std::mutex m_mutex;
+    bool m_started = false;
+    bool m_reported = false;
+    Clock::time_point m_origin;
+    std::vector<Phase> m_phases;
+    std::vector<Milestone> m_milestones;
+    std::filesystem::path m_historyFile;
+};
+
+#define STARTUP_PHASE_CONCAT_(a, b) a##b
+#define STARTUP_PHASE_CONCAT(a, b) STARTUP_PHASE_CONCAT_(a, b)
+#define STARTUP_PHASE(name) StartupProfiler::Scope STARTUP_PHASE_CONCAT(startupPhase, __LINE__)(name)
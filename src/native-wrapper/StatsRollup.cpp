@@ -0,0 +1,355 @@
+#include "StatsRollup.h"
+#include "ContentHash.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<RollupStats>::value, "RollupStats is saved as a raw blob");
+
+namespace {
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+const int64_t MS_PER_MINUTE = 60 * 1000;
+const float COMBO_BUCKET_WIDTH = 10.0f;
+
+void Stamp(RollupStats& stats, int64_t nowMs) {
+    if (stats.startMs == 0) {
+        stats.startMs = nowMs;
+    }
+    stats.endMs = std::max(stats.endMs, nowMs);
+}
+
+template <typename T>
+void PushCapped(std::deque<T>& history, const T& item, size_t capacity) {
+    history.push_back(item);
+    if (history.size() > capacity) {
+        history.pop_front();
+    }
+}
+
+} // namespace
+
+void RollupStats::Merge(const RollupStats& other) {
+    if (other.IsEmpty()) {
+        return;
+    }
+    startMs = IsEmpty() ? other.startMs : std::min(startMs, other.startMs);
+    endMs = std::max(endMs, other.endMs);
+    games += other.games;
+    wins += other.wins;
+    losses += other.losses;
+    stocksTaken += other.stocksTaken;
+    stocksLost += other.stocksLost;
+    combos += other.combos;
+    comboHits += other.comboHits;
+    frames += other.frames;
+    damageDealt += other.damageDealt;
+    damageTaken += other.damageTaken;
+    biggestCombo = std::max(biggestCombo, other.biggestCombo);
+    for (int i = 0; i < COMBO_BUCKETS; i++) {
+        comboDamage[i] += other.comboDamage[i];
+    }
+    for (int i = 0; i < OPPONENT_REGISTERS; i++) {
+        opponents[i] = std::max(opponents[i], other.opponents[i]);
+    }
+}
+
+float RollupStats::ComboDamageQuantile(float q) const {
+    uint64_t total = 0;
+    for (uint32_t count : comboDamage) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0f;
+    }
+
+    double target = std::clamp(q, 0.0f, 1.0f) * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (int i = 0; i < COMBO_BUCKETS; i++) {
+        seen += comboDamage[i];
+        if (seen >= target && comboDamage[i] > 0) {
+            return i == COMBO_BUCKETS - 1 ? i * COMBO_BUCKET_WIDTH : (i + 0.5f) * COMBO_BUCKET_WIDTH;
+        }
+    }
+    return (COMBO_BUCKETS - 1) * COMBO_BUCKET_WIDTH;
+}
+
+double RollupStats::EstimateDistinctOpponents() const {
+    const double m = OPPONENT_REGISTERS;
+    double sum = 0.0;
+    int zeros = 0;
+    for (uint8_t rank : opponents) {
+        sum += std::ldexp(1.0, -rank);
+        zeros += rank == 0 ? 1 : 0;
+    }
+
+    double estimate = 0.709 * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);    // Linear counting for small sets
+    }
+    return estimate;
+}
+
+void StatsRollup::StartGame(const std::string& opponent, int64_t nowMs, const std::string& matchId,
+                            int gameNumber) {
+    if (m_inGame) {
+        EndGame(GameResult::NONE, nowMs);
+    }
+
+    int64_t gap = m_lastGameEndMs > 0 ? nowMs - m_lastGameEndMs : 0;
+    if (!m_session.IsEmpty() && gap > SESSION_GAP_MS) {
+        CloseSet();
+        CloseSession();
+    } else if (!m_set.stats.IsEmpty()) {
+        // A match id settles it; a game number that doesn't move forward is a rematch
+        bool newSet;
+        if (!matchId.empty() || !m_set.matchId.empty()) {
+            newSet = matchId != m_set.matchId || (gameNumber > 0 && gameNumber <= m_set.gameNumber);
+        } else {
+            newSet = opponent != m_set.opponent || gap > SET_GAP_MS || m_set.IsDecided(WinsNeeded());
+        }
+        if (newSet) {
+            CloseSet();
+        }
+    }
+
+    m_set.opponent = opponent;
+    m_set.matchId = matchId;
+    m_set.gameNumber = std::max(m_set.gameNumber, gameNumber);
+    m_game = RollupStats();
+    m_inGame = true;
+
+    // Leading bits pick the register, the rank comes from the rest
+    uint64_t hash = ContentHash::Hash64(opponent.data(), opponent.size());
+    int reg = static_cast<int>(hash >> 58);
+    uint64_t rest = hash << 6;
+    uint8_t rank = 1;
+    while (rank < 58 && (rest & (1ULL << 63)) == 0) {
+        rest <<= 1;
+        rank++;
+    }
+
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->games++;
+        levels[i]->opponents[reg] = std::max(levels[i]->opponents[reg], rank);
+    }
+}
+
+void StatsRollup::EndGame(GameResult result, int64_t nowMs) {
+    if (!m_inGame) {
+        return;
+    }
+
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->wins += result == GameResult::WIN ? 1 : 0;
+        levels[i]->losses += result == GameResult::LOSS ? 1 : 0;
+    }
+    m_set.wins += result == GameResult::WIN ? 1 : 0;
+    m_set.losses += result == GameResult::LOSS ? 1 : 0;
+
+    PushCapped(m_games, m_game, GAME_HISTORY);
+    m_game = RollupStats();
+    m_inGame = false;
+    m_lastGameEndMs = nowMs;
+
+    if (m_set.IsDecided(WinsNeeded())) {
+        CloseSet();
+    }
+}
+
+void StatsRollup::AddFrames(int frames, int64_t nowMs) {
+    if (frames <= 0) {
+        return;
+    }
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->frames += static_cast<uint64_t>(frames);
+    }
+}
+
+void StatsRollup::AddDamage(float dealt, float taken, int64_t nowMs) {
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->damageDealt += dealt;
+        levels[i]->damageTaken += taken;
+    }
+}
+
+void StatsRollup::AddStocks(int taken, int lost, int64_t nowMs) {
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->stocksTaken += static_cast<uint32_t>(std::max(0, taken));
+        levels[i]->stocksLost += static_cast<uint32_t>(std::max(0, lost));
+    }
+}
+
+void StatsRollup::AddCombo(float damage, int hits, int64_t nowMs) {
+    int bucket = std::clamp(static_cast<int>(damage / COMBO_BUCKET_WIDTH), 0, RollupStats::COMBO_BUCKETS - 1);
+
+    RollupStats* levels[LEVEL_COUNT];
+    int count = OpenLevels(nowMs, levels);
+    for (int i = 0; i < count; i++) {
+        levels[i]->combos++;
+        levels[i]->comboHits += static_cast<uint32_t>(std::max(0, hits));
+        levels[i]->biggestCombo = std::max(levels[i]->biggestCombo, damage);
+        levels[i]->comboDamage[bucket]++;
+    }
+}
+
+const RollupStats& StatsRollup::Current(RollupLevel level) const {
+    switch (level) {
+        case RollupLevel::MINUTE: return m_minute;
+        case RollupLevel::GAME: return m_game;
+        case RollupLevel::SET: return m_set.stats;
+        case RollupLevel::SESSION: return m_session;
+        case RollupLevel::LIFETIME: return m_lifetime;
+    }
+    return m_lifetime;
+}
+
+bool StatsRollup::Load(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t formatVersion = 0;
+    uint32_t statsSize = 0;
+    if (!ReadPod(in, magic) || !ReadPod(in, formatVersion) || !ReadPod(in, statsSize) ||
+        magic != FILE_MAGIC || formatVersion != FILE_FORMAT_VERSION || statsSize != sizeof(RollupStats)) {
+        LOG_WARN("Ignoring incompatible stats rollup file: {}", path.wstring());
+        return false;
+    }
+
+    RollupStats lifetime;
+    RollupStats session;
+    int64_t lastGameEndMs = 0;
+    uint32_t sessionCount = 0;
+    if (!ReadPod(in, lifetime) || !ReadPod(in, session) || !ReadPod(in, lastGameEndMs) ||
+        !ReadPod(in, sessionCount) || sessionCount > SESSION_HISTORY) {
+        return false;
+    }
+
+    std::deque<RollupStats> sessions(sessionCount);
+    for (RollupStats& closed : sessions) {
+        if (!ReadPod(in, closed)) {
+            return false;
+        }
+    }
+
+    m_lifetime = lifetime;
+    m_session = session;
+    m_lastGameEndMs = lastGameEndMs;
+    m_sessions = std::move(sessions);
+    return true;
+}
+
+bool StatsRollup::Save(const std::filesystem::path& path) const {
+    std::filesystem::path tempFile = path;
+    tempFile += ".tmp";
+
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Failed to write stats rollup file: {}", tempFile.wstring());
+            return false;
+        }
+
+        WritePod(out, FILE_MAGIC);
+        WritePod(out, FILE_FORMAT_VERSION);
+        WritePod(out, static_cast<uint32_t>(sizeof(RollupStats)));
+        WritePod(out, m_lifetime);
+        WritePod(out, m_session);
+        WritePod(out, m_lastGameEndMs);
+        WritePod(out, static_cast<uint32_t>(m_sessions.size()));
+        for (const RollupStats& closed : m_sessions) {
+            WritePod(out, closed);
+        }
+
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, path, error);
+    if (error) {
+        LOG_ERROR("Failed to replace stats rollup file: {}", error.value());
+        return false;
+    }
+    return true;
+}
+
+int StatsRollup::OpenLevels(int64_t nowMs, RollupStats* levels[LEVEL_COUNT]) {
+    int64_t minuteIndex = nowMs / MS_PER_MINUTE;
+    if (minuteIndex != m_minuteIndex) {
+        if (!m_minute.IsEmpty()) {
+            PushCapped(m_minutes, m_minute, MINUTE_HISTORY);
+        }
+        m_minute = RollupStats();
+        m_minuteIndex = minuteIndex;
+    }
+
+    int count = 0;
+    levels[count++] = &m_minute;
+    if (m_inGame) {
+        levels[count++] = &m_game;
+    }
+    levels[count++] = &m_set.stats;
+    levels[count++] = &m_session;
+    levels[count++] = &m_lifetime;
+
+    for (int i = 0; i < count; i++) {
+        Stamp(*levels[i], nowMs);
+    }
+    return count;
+}
+
+// A match id doesn't say how long the match is, so those sets stay open
+// until the next match starts unless a side reaches three wins
+int StatsRollup::WinsNeeded() const {
+    return m_set.matchId.empty() ? m_defaultBestOf / 2 + 1 : 3;
+}
+
+void StatsRollup::CloseSet() {
+    if (!m_set.stats.IsEmpty()) {
+        // Two wins out of at most three games is a Bo3, unless sets are known to be Bo5
+        int leader = std::max(m_set.wins, m_set.losses);
+        bool knownBo5 = m_set.matchId.empty() && m_defaultBestOf == 5;
+        if (leader >= 3) {
+            m_set.bestOf = 5;
+        } else if (leader == 2 && m_set.wins + m_set.losses <= 3 && !knownBo5) {
+            m_set.bestOf = 3;
+        } else {
+            m_set.bestOf = 0;
+        }
+        PushCapped(m_sets, m_set, SET_HISTORY);
+    }
+    m_set = RollupSet();
+}
+
+void StatsRollup::CloseSession() {
+    if (!m_session.IsEmpty()) {
+        PushCapped(m_sessions, m_session, SESSION_HISTORY);
+    }
+    m_session = RollupStats();
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Incremental stats at five granularities: the current minute, game, set,
+// session and lifetime. Every event is added to the open aggregate of each
+// level as it arrives, so reading any level is free and nothing is ever
+// recomputed from frames. Aggregates only hold counts, sums, maxima and
+// fixed-size sketches, so any two of them merge exactly.
+//
+// Games with a Slippi match id are in the same set exactly when they share
+// the id. Without one, a game starts a new set when the opponent changes,
+// more than SET_GAP_MS passed since the last game, or the open set is
+// already decided: two wins, or three when sets are known to be Bo5
+// (SetDefaultBestOf). More than SESSION_GAP_MS between games starts a new
+// session.
+
+enum class RollupLevel : uint8_t {
+    MINUTE,
+    GAME,
+    SET,
+    SESSION,
+    LIFETIME
+};
+
+enum class GameResult : uint8_t {
+    WIN,
+    LOSS,
+    NONE            // Quit or no contest
+};
+
+struct RollupStats {
+    static constexpr int COMBO_BUCKETS = 16;        // 10% wide; the last one is 150% and up
+    static constexpr int OPPONENT_REGISTERS = 64;   // HyperLogLog registers
+
+    int64_t startMs = 0;
+    int64_t endMs = 0;
+    uint32_t games = 0;
+    uint32_t wins = 0;
+    uint32_t losses = 0;
+    uint32_t stocksTaken = 0;
+    uint32_t stocksLost = 0;
+    uint32_t combos = 0;
+    uint32_t comboHits = 0;
+    uint64_t frames = 0;
+    double damageDealt = 0.0;
+    double damageTaken = 0.0;
+    float biggestCombo = 0.0f;
+    uint32_t comboDamage[COMBO_BUCKETS] = {};       // Histogram of combo damage dealt
+    uint8_t opponents[OPPONENT_REGISTERS] = {};     // Sketch of distinct opponents
+
+    bool IsEmpty() const { return startMs == 0; }
+    void Merge(const RollupStats& other);
+
+    // Approximate combo damage at quantile q (0-1), to bucket resolution
+    float ComboDamageQuantile(float q) const;
+    double EstimateDistinctOpponents() const;
+};
+
+struct RollupSet {
+    RollupStats stats;
+    std::string opponent;
+    std::string matchId;    // Empty if the games didn't come with one
+    int gameNumber = 0;     // Of the last game, when the match id came with one
+    int wins = 0;
+    int losses = 0;
+    int bestOf = 0;         // 3 or 5 once decided, 0 while open or if abandoned
+
+    bool IsDecided(int winsNeeded) const { return wins >= winsNeeded || losses >= winsNeeded; }
+};
+
+class StatsRollup {
+public:
+    static constexpr int64_t SET_GAP_MS = 5 * 60 * 1000;
+    static constexpr int64_t SESSION_GAP_MS = 30 * 60 * 1000;
+    static constexpr size_t MINUTE_HISTORY = 60;
+    static constexpr size_t GAME_HISTORY = 64;
+    static constexpr size_t SET_HISTORY = 32;
+    static constexpr size_t SESSION_HISTORY = 32;
+
+    // opponent identifies who is being played (connect code, or a character
+    // name when nothing better is known); it drives set detection along with
+    // the match id and game number when the game start has them
+    void StartGame(const std::string& opponent, int64_t nowMs, const std::string& matchId = "",
+                   int gameNumber = 0);
+    void EndGame(GameResult result, int64_t nowMs);
+    bool IsInGame() const { return m_inGame; }
+
+    // Length assumed for sets without a match id, 3 (default) or 5
+    void SetDefaultBestOf(int bestOf) { m_defaultBestOf = bestOf == 5 ? 5 : 3; }
+
+    void AddFrames(int frames, int64_t nowMs);
+    void AddDamage(float dealt, float taken, int64_t nowMs);
+    void AddStocks(int taken, int lost, int64_t nowMs);
+    void AddCombo(float damage, int hits, int64_t nowMs);
+
+    // Open aggregate at a level (the minute and game are empty between events/games)
+    const RollupStats& Current(RollupLevel level) const;
+    const RollupSet& CurrentSet() const { return m_set; }
+
+    // Closed aggregates, oldest first
+    const std::deque<RollupStats>& GetMinutes() const { return m_minutes; }
+    const std::deque<RollupStats>& GetGames() const { return m_games; }
+    const std::deque<RollupSet>& GetSets() const { return m_sets; }
+    const std::deque<RollupStats>& GetSessions() const { return m_sessions; }
+
+    // Lifetime totals and the session history survive restarts; a session
+    // resumed within SESSION_GAP_MS continues where it left off
+    bool Load(const std::filesystem::path& path);
+    bool Save(const std::filesystem::path& path) const;
+
+private:
+    static constexpr int LEVEL_COUNT = 5;
+
+    // Rolls the minute over if needed and collects the open aggregates an
+    // event at nowMs belongs to (the game only while one is running)
+    int OpenLevels(int64_t nowMs, RollupStats* levels[LEVEL_COUNT]);
+    int WinsNeeded() const;
+    void CloseSet();
+    void CloseSession();
+
+    RollupStats m_minute;
+    int64_t m_minuteIndex = -1;
+    RollupStats m_game;
+    RollupSet m_set;
+    RollupStats m_session;
+    RollupStats m_lifetime;
+    bool m_inGame = false;
+    int64_t m_lastGameEndMs = 0;
+    int m_defaultBestOf = 3;
+
+    std::deque<RollupStats> m_minutes;
+    std::deque<RollupStats> m_games;
+    std::deque<RollupSet> m_sets;
+    std::deque<RollupStats> m_sessions;
+
+    static constexpr uint32_t FILE_MAGIC = 0x52534343;  // "CCSR"
+    static constexpr uint32_t FILE_FORMAT_VERSION = 1;
+};
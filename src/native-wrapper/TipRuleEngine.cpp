@@ -0,0 +1,282 @@
+#include "TipRuleEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace {
+
+std::string Trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(start, end - start + 1);
+}
+
+bool ParseCondition(const std::string& text, TipCondition& condition, std::string& error) {
+    size_t opStart = text.find_first_of("<>=!");
+    if (opStart == std::string::npos) {
+        error = "missing comparison in '" + text + "'";
+        return false;
+    }
+
+    bool withEquals = opStart + 1 < text.size() && text[opStart + 1] == '=';
+    switch (text[opStart]) {
+        case '<': condition.compare = withEquals ? TipCompare::LESS_EQUAL : TipCompare::LESS; break;
+        case '>': condition.compare = withEquals ? TipCompare::GREATER_EQUAL : TipCompare::GREATER; break;
+        case '=': condition.compare = TipCompare::EQUAL; break;
+        case '!': condition.compare = TipCompare::NOT_EQUAL; break;
+    }
+    if ((text[opStart] == '=' || text[opStart] == '!') && !withEquals) {
+        error = "expected '==' or '!=' in '" + text + "'";
+        return false;
+    }
+
+    condition.stat = Trim(text.substr(0, opStart));
+    if (condition.stat.empty()) {
+        error = "missing stat name in '" + text + "'";
+        return false;
+    }
+
+    std::string number = Trim(text.substr(opStart + (withEquals ? 2 : 1)));
+    char* end = nullptr;
+    condition.threshold = std::strtod(number.c_str(), &end);
+    if (number.empty() || *end != '\0') {
+        error = "bad number in '" + text + "'";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool TipRuleEngine::ParseConditions(const std::string& text, std::vector<TipCondition>& conditions,
+                                    std::string& error) {
+    std::vector<TipCondition> parsed;
+    size_t start = 0;
+    while (true) {
+        size_t separator = text.find("&&", start);
+        TipCondition condition;
+        if (!ParseCondition(text.substr(start, separator - start), condition, error)) {
+            return false;
+        }
+        parsed.push_back(condition);
+
+        if (separator == std::string::npos) {
+            break;
+        }
+        start = separator + 2;
+    }
+
+    conditions = std::move(parsed);
+    return true;
+}
+
+void TipRuleEngine::AddRule(const TipRule& rule) {
+    if (rule.conditions.empty()) {
+        return;
+    }
+    m_rules.push_back(rule);
+    m_compiled = false;
+}
+
+TipStatId TipRuleEngine::GetStatId(const std::string& name) {
+    auto existing = m_statIds.find(name);
+    if (existing != m_statIds.end()) {
+        return existing->second;
+    }
+
+    TipStatId id = static_cast<TipStatId>(m_statValues.size());
+    m_statIds.emplace(name, id);
+    m_statValues.push_back(std::numeric_limits<double>::quiet_NaN());
+    m_statDirty.push_back(0);
+    m_statConditions.emplace_back();
+    return id;
+}
+
+void TipRuleEngine::SetStat(TipStatId stat, double value) {
+    if (stat >= m_statValues.size()) {
+        return;
+    }
+
+    double& current = m_statValues[stat];
+    if (value == current || (std::isnan(value) && std::isnan(current))) {
+        return;
+    }
+    current = value;
+
+    if (!m_statDirty[stat]) {
+        m_statDirty[stat] = 1;
+        m_dirtyStats.push_back(stat);
+    }
+}
+
+void TipRuleEngine::DefineOutcomeWindow(const std::string& name, int windowSize) {
+    OutcomeWindow window;
+    window.rateStat = GetStatId(name + ".rate");
+    window.countStat = GetStatId(name + ".count");
+    window.outcomes.assign(static_cast<size_t>(std::max(windowSize, 1)), 0);
+    m_outcomeWindows[name] = std::move(window);
+}
+
+void TipRuleEngine::RecordOutcome(const std::string& name, bool success) {
+    auto found = m_outcomeWindows.find(name);
+    if (found == m_outcomeWindows.end()) {
+        return;
+    }
+
+    OutcomeWindow& window = found->second;
+    if (window.count == static_cast<int>(window.outcomes.size())) {
+        window.successes -= window.outcomes[window.next];
+    } else {
+        window.count++;
+    }
+    window.outcomes[window.next] = success ? 1 : 0;
+    window.successes += success ? 1 : 0;
+    window.next = (window.next + 1) % window.outcomes.size();
+
+    SetStat(window.rateStat, static_cast<double>(window.successes) / window.count);
+    SetStat(window.countStat, window.count);
+}
+
+void TipRuleEngine::ResetStats() {
+    for (TipStatId stat = 0; stat < m_statValues.size(); stat++) {
+        SetStat(stat, std::numeric_limits<double>::quiet_NaN());
+    }
+    for (auto& entry : m_outcomeWindows) {
+        OutcomeWindow& window = entry.second;
+        std::fill(window.outcomes.begin(), window.outcomes.end(), 0);
+        window.next = 0;
+        window.count = 0;
+        window.successes = 0;
+    }
+}
+
+std::vector<const TipRule*> TipRuleEngine::Evaluate() {
+    std::vector<const TipRule*> fired;
+
+    if (!m_compiled) {
+        // Everything was evaluated while compiling
+        Compile();
+        m_lastEvaluatedConditions = m_conditions.size();
+        for (uint32_t i = 0; i < m_ruleNodes.size(); i++) {
+            RuleNode& rule = m_ruleNodes[i];
+            if (rule.unsatisfied == 0 && !rule.fired) {
+                rule.fired = true;
+                fired.push_back(&m_rules[i]);
+            }
+        }
+        return fired;
+    }
+
+    std::vector<uint32_t> touchedRules;
+    size_t evaluated = 0;
+    for (TipStatId stat : m_dirtyStats) {
+        m_statDirty[stat] = 0;
+        for (uint32_t index : m_statConditions[stat]) {
+            ConditionNode& condition = m_conditions[index];
+            evaluated++;
+
+            bool value = Test(condition.compare, m_statValues[stat], condition.threshold);
+            if (value == condition.value) {
+                continue;
+            }
+            condition.value = value;
+            for (uint32_t rule : condition.rules) {
+                m_ruleNodes[rule].unsatisfied += value ? -1 : 1;
+                touchedRules.push_back(rule);
+            }
+        }
+    }
+    m_dirtyStats.clear();
+    m_lastEvaluatedConditions = evaluated;
+
+    for (uint32_t index : touchedRules) {
+        RuleNode& rule = m_ruleNodes[index];
+        if (rule.unsatisfied > 0) {
+            rule.fired = false;
+        } else if (!rule.fired) {
+            rule.fired = true;
+            fired.push_back(&m_rules[index]);
+        }
+    }
+    return fired;
+}
+
+bool TipRuleEngine::Test(TipCompare compare, double value, double threshold) {
+    if (std::isnan(value)) {
+        return false;
+    }
+    switch (compare) {
+        case TipCompare::LESS: return value < threshold;
+        case TipCompare::LESS_EQUAL: return value <= threshold;
+        case TipCompare::GREATER: return value > threshold;
+        case TipCompare::GREATER_EQUAL: return value >= threshold;
+        case TipCompare::EQUAL: return value == threshold;
+        case TipCompare::NOT_EQUAL: return value != threshold;
+    }
+    return false;
+}
+
+void TipRuleEngine::Compile() {
+    // Rules are only ever appended, so existing rules keep their fired state
+    std::vector<bool> wasFired(m_rules.size(), false);
+    for (size_t i = 0; i < m_ruleNodes.size(); i++) {
+        wasFired[i] = m_ruleNodes[i].fired;
+    }
+
+    m_conditions.clear();
+    m_ruleNodes.assign(m_rules.size(), RuleNode());
+    for (std::vector<uint32_t>& conditions : m_statConditions) {
+        conditions.clear();
+    }
+
+    std::map<std::tuple<TipStatId, TipCompare, double>, uint32_t> uniqueConditions;
+    for (uint32_t ruleIndex = 0; ruleIndex < m_rules.size(); ruleIndex++) {
+        RuleNode& rule = m_ruleNodes[ruleIndex];
+        rule.fired = wasFired[ruleIndex];
+
+        for (const TipCondition& condition : m_rules[ruleIndex].conditions) {
+            TipStatId stat = GetStatId(condition.stat);
+            auto key = std::make_tuple(stat, condition.compare, condition.threshold);
+
+            auto existing = uniqueConditions.find(key);
+            uint32_t conditionIndex;
+            if (existing != uniqueConditions.end()) {
+                conditionIndex = existing->second;
+            } else {
+                conditionIndex = static_cast<uint32_t>(m_conditions.size());
+                uniqueConditions.emplace(key, conditionIndex);
+
+                ConditionNode node;
+                node.stat = stat;
+                node.compare = condition.compare;
+                node.threshold = condition.threshold;
+                node.value = Test(node.compare, m_statValues[stat], node.threshold);
+                m_conditions.push_back(node);
+                m_statConditions[stat].push_back(conditionIndex);
+            }
+
+            ConditionNode& node = m_conditions[conditionIndex];
+            node.rules.push_back(ruleIndex);
+            rule.conditions.push_back(conditionIndex);
+            if (!node.value) {
+                rule.unsatisfied++;
+            }
+        }
+
+        if (rule.unsatisfied > 0) {
+            rule.fired = false;
+        }
+    }
+
+    for (TipStatId stat : m_dirtyStats) {
+        m_statDirty[stat] = 0;
+    }
+    m_dirtyStats.clear();
+    m_compiled = true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Coaching tips triggered by declarative conditions over named live stats.
+//
+// Rules are compiled into a graph: stat -> condition -> rule. Identical
+// conditions shared by several rules are evaluated once, and Evaluate only
+// visits conditions whose stat changed since the last call and the rules
+// that use them. A rule fires when all its conditions become true, and can
+// fire again only after one of them has been false in between.
+//
+//   TipRule rule;
+//   TipRuleEngine::ParseConditions("tech.rate < 0.6 && tech.count >= 20", rule.conditions, error);
+//   engine.AddRule(rule);
+//   engine.DefineOutcomeWindow("tech", 20);
+//   engine.RecordOutcome("tech", missed == false);
+//   for (const TipRule* fired : engine.Evaluate()) { ... }
+
+enum class TipCompare : uint8_t {
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    EQUAL,
+    NOT_EQUAL
+};
+
+struct TipCondition {
+    std::string stat;
+    TipCompare compare = TipCompare::GREATER;
+    double threshold = 0.0;
+};
+
+struct TipRule {
+    std::string id;
+    std::vector<TipCondition> conditions;  // All must hold
+    std::string title;
+    std::string description;
+    std::string category;
+    int importance = 1;                    // 1-5, as in TipItem
+};
+
+using TipStatId = uint32_t;
+
+class TipRuleEngine {
+public:
+    // Parses "stat op number [&& stat op number ...]" with op one of
+    // < <= > >= == !=. Returns false and fills error on bad input.
+    static bool ParseConditions(const std::string& text, std::vector<TipCondition>& conditions,
+                                std::string& error);
+
+    // Rules can be added at any time; the graph is rebuilt on the next Evaluate
+    void AddRule(const TipRule& rule);
+
+    // Resolve a stat name once and keep the id for per-frame updates
+    TipStatId GetStatId(const std::string& name);
+
+    // Stats start unset, and conditions on unset stats are false. Setting a
+    // stat to its current value is free.
+    void SetStat(TipStatId stat, double value);
+    void SetStat(const std::string& name, double value) { SetStat(GetStatId(name), value); }
+
+    // Success rate over the last windowSize outcomes, published as the stats
+    // "<name>.rate" (0-1) and "<name>.count"
+    void DefineOutcomeWindow(const std::string& name, int windowSize);
+    void RecordOutcome(const std::string& name, bool success);
+
+    // Rules that became true since the last call; the pointers stay valid
+    // until the next AddRule
+    std::vector<const TipRule*> Evaluate();
+
+    // Drops all stat values and outcome history (new game); rules are kept
+    void ResetStats();
+
+    size_t GetRuleCount() const { return m_rules.size(); }
+    size_t GetConditionCount() const { return m_conditions.size(); }
+    size_t GetLastEvaluatedConditions() const { return m_lastEvaluatedConditions; }
+
+private:
+    struct ConditionNode {
+        TipStatId stat;
+        TipCompare compare;
+        double threshold;
+        bool value = false;
+        std::vector<uint32_t> rules;
+    };
+
+    struct RuleNode {
+        std::vector<uint32_t> conditions;
+        int unsatisfied = 0;   // Conditions currently false
+        bool fired = false;
+    };
+
+    struct OutcomeWindow {
+        TipStatId rateStat;
+        TipStatId countStat;
+        std::vector<uint8_t> outcomes;  // Ring buffer
+        size_t next = 0;
+        int count = 0;
+        int successes = 0;
+    };
+
+    static bool Test(TipCompare compare, double value, double threshold);
+
+    void Compile();
+
+    std::vector<TipRule> m_rules;
+    bool m_compiled = false;
+
+    // Compiled graph
+    std::vector<ConditionNode> m_conditions;
+    std::vector<RuleNode> m_ruleNodes;
+    std::vector<std::vector<uint32_t>> m_statConditions;  // Indexed by stat
+
+    // Stat values and the ones changed since the last Evaluate
+    std::unordered_map<std::string, TipStatId> m_statIds;
+    std::vector<double> m_statValues;
+    std::vector<uint8_t> m_statDirty;
+    std::vector<TipStatId> m_dirtyStats;
+
+    std::unordered_map<std::string, OutcomeWindow> m_outcomeWindows;
+    size_t m_lastEvaluatedConditions = 0;
+};
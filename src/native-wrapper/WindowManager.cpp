@@ -1,10 +1,10 @@
 #include "WindowManager.h"
-#include <iostream>
+#include "Logger.h"
 #include <algorithm>
 #include <tlhelp32.h>
 
 WindowManager::WindowManager() {
-    std::wcout << L"WindowManager initialized" << std::endl;
+    LOG_INFO("WindowManager initialized");
 }
 
 WindowManager::~WindowManager() {
@@ -22,7 +22,7 @@ HWND WindowManager::FindGameWindow() {
     for (const auto& window : windows) {
         if (IsSlippiWindow(window) || IsDolphinWindow(window)) {
             if (IsValidGameWindow(window.hwnd)) {
-                std::wcout << L"Found game window: " << window.title << std::endl;
+                LOG_INFO("Found game window: {}", window.title);
                 return window.hwnd;
             }
         }
@@ -32,18 +32,16 @@ HWND WindowManager::FindGameWindow() {
 }
 
 bool WindowManager::EmbedGameWindow(HWND parentWindow, HWND gameWindow) {
-    std::wcout << L"=== Starting Window Embedding Process ===" << std::endl;
-    std::wcout << L"Parent window: " << (void*)parentWindow << std::endl;
-    std::wcout << L"Game window: " << (void*)gameWindow << std::endl;
+    LOG_INFO("Embedding game window {} into parent {}", (void*)gameWindow, (void*)parentWindow);
     
     // Validate input windows
     if (!IsWindow(gameWindow)) {
-        std::wcout << L"ERROR: Game window handle is invalid!" << std::endl;
+        LOG_ERROR("Game window handle is invalid!");
         return false;
     }
     
     if (!IsWindow(parentWindow)) {
-        std::wcout << L"ERROR: Parent window handle is invalid!" << std::endl;
+        LOG_ERROR("Parent window handle is invalid!");
         return false;
     }
     
@@ -53,13 +51,12 @@ bool WindowManager::EmbedGameWindow(HWND parentWindow, HWND gameWindow) {
     GetWindowText(gameWindow, gameTitle, 256);
     GetWindowText(parentWindow, parentTitle, 256);
     
-    std::wcout << L"Game window title: '" << gameTitle << L"'" << std::endl;
-    std::wcout << L"Parent window title: '" << parentTitle << L"'" << std::endl;
+    LOG_DEBUG("Game window title: '{}', parent window title: '{}'", gameTitle, parentTitle);
     
     // Check if already embedded
     for (const auto& info : m_embeddedWindows) {
         if (info.gameWindow == gameWindow) {
-            std::wcout << L"Window is already embedded, returning success" << std::endl;
+            LOG_INFO("Window is already embedded, returning success");
             return true; // Already embedded
         }
     }
@@ -69,44 +66,41 @@ bool WindowManager::EmbedGameWindow(HWND parentWindow, HWND gameWindow) {
     GetWindowRect(gameWindow, &gameRect);
     GetWindowRect(parentWindow, &parentRect);
     
-    std::wcout << L"Game window rect: (" << gameRect.left << L"," << gameRect.top 
-              << L") to (" << gameRect.right << L"," << gameRect.bottom << L")" << std::endl;
-    std::wcout << L"Parent window rect: (" << parentRect.left << L"," << parentRect.top 
-              << L") to (" << parentRect.right << L"," << parentRect.bottom << L")" << std::endl;
+    LOG_DEBUG("Game window rect: ({},{}) to ({},{})", gameRect.left, gameRect.top, gameRect.right, gameRect.bottom);
+    LOG_DEBUG("Parent window rect: ({},{}) to ({},{})", parentRect.left, parentRect.top, parentRect.right, parentRect.bottom);
     
     EmbeddedWindowInfo embedInfo = {};
     embedInfo.gameWindow = gameWindow;
     
     // Save current window state
-    std::wcout << L"Saving original window state..." << std::endl;
+    LOG_DEBUG("Saving original window state...");
     SaveWindowState(gameWindow, embedInfo);
     
     // Clear any previous error
     SetLastError(0);
     
     // Set new parent
-    std::wcout << L"Setting parent window..." << std::endl;
+    LOG_DEBUG("Setting parent window...");
     HWND oldParent = SetParent(gameWindow, parentWindow);
     DWORD lastError = GetLastError();
     
     if (!oldParent && lastError != 0) {
-        std::wcout << L"ERROR: Failed to set parent window! Error code: " << lastError << std::endl;
+        LOG_ERROR("Failed to set parent window! Error code: {}", lastError);
         
         // Try to get more information about the error
         LPWSTR errorMsg = nullptr;
         FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
                      nullptr, lastError, 0, (LPWSTR)&errorMsg, 0, nullptr);
         if (errorMsg) {
-            std::wcout << L"Error message: " << errorMsg << std::endl;
+            LOG_ERROR("Error message: {}", errorMsg);
             LocalFree(errorMsg);
         }
         return false;
     }
     
-    std::wcout << L"Parent set successfully. Old parent was: " << (void*)oldParent << std::endl;
+    LOG_DEBUG("Parent set successfully. Old parent was: {}", (void*)oldParent);
     
     // Apply embedded window style
-    std::wcout << L"Applying embedded window styles..." << std::endl;
     ApplyEmbeddedStyle(gameWindow);
     
     // Get the parent's client area and position the game window
@@ -115,17 +109,17 @@ bool WindowManager::EmbedGameWindow(HWND parentWindow, HWND gameWindow) {
         int clientWidth = parentClientRect.right - parentClientRect.left;
         int clientHeight = parentClientRect.bottom - parentClientRect.top;
         
-        std::wcout << L"Parent client area: " << clientWidth << L"x" << clientHeight << std::endl;
+        LOG_DEBUG("Parent client area: {}x{}", clientWidth, clientHeight);
         
         // Position and size the game window to fill the parent's client area
         if (SetWindowPos(gameWindow, HWND_BOTTOM, 0, 0, clientWidth, clientHeight,
                         SWP_NOACTIVATE | SWP_SHOWWINDOW)) {
-            std::wcout << L"Game window positioned and sized successfully" << std::endl;
+            LOG_DEBUG("Game window positioned and sized successfully");
         } else {
-            std::wcout << L"WARNING: Failed to position game window, error: " << GetLastError() << std::endl;
+            LOG_WARN("Failed to position game window, error: {}", GetLastError());
         }
     } else {
-        std::wcout << L"WARNING: Could not get parent client rect, error: " << GetLastError() << std::endl;
+        LOG_WARN("Could not get parent client rect, error: {}", GetLastError());
     }
     
     // Store the embedding info
@@ -137,9 +131,7 @@ bool WindowManager::EmbedGameWindow(HWND parentWindow, HWND gameWindow) {
     UpdateWindow(parentWindow);
     UpdateWindow(gameWindow);
     
-    std::wcout << L"Game window embedded successfully!" << std::endl;
-    std::wcout << L"Total embedded windows: " << m_embeddedWindows.size() << std::endl;
-    std::wcout << L"=========================================" << std::endl;
+    LOG_INFO("Game window embedded successfully ({} embedded windows)", m_embeddedWindows.size());
     
     return true;
 }
@@ -153,7 +145,7 @@ bool WindowManager::RestoreGameWindow(HWND gameWindow) {
     if (it != m_embeddedWindows.end()) {
         RestoreWindowState(*it);
         m_embeddedWindows.erase(it);
-        std::wcout << L"Game window restored" << std::endl;
+        LOG_INFO("Game window restored");
         return true;
     }
     
@@ -295,22 +287,12 @@ bool WindowManager::IsDolphinWindow(const WindowInfo& windowInfo) {
     // Enhanced debug output with more information
     if (isValidDolphin || title.find(L"melee") != std::wstring::npos || 
         title.find(L"slippi") != std::wstring::npos || title.find(L"dolphin") != std::wstring::npos) {
-        std::wcout << L"=== Window Detection Debug ===" << std::endl;
-        std::wcout << L"Title: '" << windowInfo.title.c_str() << L"'" << std::endl;
-        std::wcout << L"Class: '" << windowInfo.className.c_str() << L"'" << std::endl;
-        std::wcout << L"HWND: " << windowInfo.hwnd << std::endl;
-        std::wcout << L"Size: " << width << L"x" << height << std::endl;
-        std::wcout << L"Position: (" << windowRect.left << L"," << windowRect.top << L")" << std::endl;
-        std::wcout << L"Process ID: " << windowInfo.processId << std::endl;
-        std::wcout << L"isSlippiDolphin: " << (isSlippiDolphin ? L"YES" : L"NO") << std::endl;
-        std::wcout << L"isDolphinExecutable: " << (isDolphinExecutable ? L"YES" : L"NO") << std::endl;
-        std::wcout << L"isGameSize: " << (isGameSize ? L"YES" : L"NO") << std::endl;
-        std::wcout << L"isActuallyVisible: " << (isActuallyVisible ? L"YES" : L"NO") << std::endl;
-        std::wcout << L"hasClientArea: " << (hasClientArea ? L"YES" : L"NO") << std::endl;
-        
         bool finalResult = isValidDolphin && isGameSize && isActuallyVisible && hasClientArea;
-        std::wcout << L"FINAL RESULT: " << (finalResult ? L"MATCH!" : L"NO MATCH") << std::endl;
-        std::wcout << L"==============================" << std::endl;
+        LOG_DEBUG("Window detection: title='{}' class='{}' hwnd={} size={}x{} pos=({},{}) pid={} "
+                  "slippiDolphin={} dolphinExe={} gameSize={} visible={} clientArea={} match={}",
+                  windowInfo.title, windowInfo.className, windowInfo.hwnd, width, height,
+                  windowRect.left, windowRect.top, windowInfo.processId, isSlippiDolphin,
+                  isDolphinExecutable, isGameSize, isActuallyVisible, hasClientArea, finalResult);
     }
     
     return isValidDolphin && isGameSize && isActuallyVisible && hasClientArea;
@@ -421,7 +403,7 @@ void WindowManager::RestoreWindowState(const EmbeddedWindowInfo& info) {
 }
 
 void WindowManager::ApplyEmbeddedStyle(HWND window) {
-    std::wcout << L"Applying embedded window styles..." << std::endl;
+    LOG_DEBUG("Applying embedded window styles...");
     
     // Remove window decorations for embedding
     LONG style = GetWindowLong(window, GWL_STYLE);
@@ -435,13 +417,13 @@ void WindowManager::ApplyEmbeddedStyle(HWND window) {
                  WS_EX_OVERLAPPEDWINDOW | WS_EX_PALETTEWINDOW);
     SetWindowLong(window, GWL_EXSTYLE, exStyle);
     
-    std::wcout << L"Applied styles - WS_CHILD | WS_CLIPSIBLINGS" << std::endl;
+    LOG_DEBUG("Applied styles - WS_CHILD | WS_CLIPSIBLINGS");
     
     // Apply changes with proper flags for embedded windows
     SetWindowPos(window, HWND_BOTTOM, 0, 0, 0, 0,
                 SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED | SWP_NOACTIVATE | SWP_NOOWNERZORDER);
     
-    std::wcout << L"Window positioned at HWND_BOTTOM with proper flags" << std::endl;
+    LOG_DEBUG("Window positioned at HWND_BOTTOM with proper flags");
 }
 
 std::wstring WindowManager::GetWindowTitle(HWND hwnd) {
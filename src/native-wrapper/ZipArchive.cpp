@@ -0,0 +1,704 @@
+#include "ZipArchive.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace {
+
+const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034B50;
+const uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014B50;
+const uint32_t END_SIGNATURE = 0x06054B50;
+const uint32_t ZIP64_END_SIGNATURE = 0x06064B50;
+const uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064B50;
+const size_t LOCAL_HEADER_SIZE = 30;
+const size_t CENTRAL_HEADER_SIZE = 46;
+const size_t END_SIZE = 22;
+const size_t ZIP64_LOCATOR_SIZE = 20;
+const size_t ZIP64_END_SIZE = 56;
+const size_t MAX_COMMENT = 0xFFFF;
+const uint16_t ZIP64_EXTRA_ID = 0x0001;
+const uint16_t FLAG_ENCRYPTED = 0x0001;
+const uint16_t METHOD_STORED = 0;
+const uint16_t METHOD_DEFLATE = 8;
+
+// Zip fields are little-endian
+inline uint16_t ReadLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t ReadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t ReadLE64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadLE32(p)) | (static_cast<uint64_t>(ReadLE32(p + 4)) << 32);
+}
+
+bool ReadAt(std::istream& file, uint64_t offset, void* data, size_t size) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    return static_cast<bool>(file.read(static_cast<char*>(data), static_cast<std::streamsize>(size)));
+}
+
+struct Crc32Table {
+    uint32_t values[256];
+
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+    static const Crc32Table TABLE;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = TABLE.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Canonical Huffman code (RFC 1951 3.2.2). Codes up to FAST_BITS long are
+// decoded with one table lookup, longer ones bit by bit.
+struct Huffman {
+    static const int MAX_BITS = 15;
+    static const int FAST_BITS = 10;
+
+    uint16_t counts[MAX_BITS + 1];
+    uint16_t symbols[288];
+    uint16_t fast[1 << FAST_BITS];      // length << 9 | symbol, 0 when the code is longer
+
+    // False for over-subscribed codes; incomplete codes are allowed (a
+    // distance code may have a single symbol)
+    bool Build(const uint8_t* lengths, int count) {
+        memset(counts, 0, sizeof(counts));
+        memset(fast, 0, sizeof(fast));
+        for (int symbol = 0; symbol < count; symbol++) {
+            counts[lengths[symbol]]++;
+        }
+        counts[0] = 0;
+
+        int left = 1;
+        for (int length = 1; length <= MAX_BITS; length++) {
+            left = (left << 1) - counts[length];
+            if (left < 0) {
+                return false;
+            }
+        }
+
+        uint16_t offsets[MAX_BITS + 2];
+        offsets[1] = 0;
+        for (int length = 1; length <= MAX_BITS; length++) {
+            offsets[length + 1] = static_cast<uint16_t>(offsets[length] + counts[length]);
+        }
+
+        uint32_t nextCode[MAX_BITS + 1];
+        uint32_t code = 0;
+        for (int length = 1; length <= MAX_BITS; length++) {
+            code = (code + counts[length - 1]) << 1;
+            nextCode[length] = code;
+        }
+
+        for (int symbol = 0; symbol < count; symbol++) {
+            int length = lengths[symbol];
+            if (length == 0) {
+                continue;
+            }
+            symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+
+            // Codes are sent most significant bit first; the bit reader is LSB first
+            uint32_t assigned = nextCode[length]++;
+            if (length <= FAST_BITS) {
+                uint32_t reversed = 0;
+                for (int bit = 0; bit < length; bit++) {
+                    reversed |= ((assigned >> bit) & 1) << (length - 1 - bit);
+                }
+                for (uint32_t fill = reversed; fill < (1u << FAST_BITS); fill += 1u << length) {
+                    fast[fill] = static_cast<uint16_t>((length << 9) | symbol);
+                }
+            }
+        }
+        return true;
+    }
+};
+
+const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// Raw deflate (RFC 1951) from a stream into a byte vector. Input is pulled
+// in INPUT_CHUNK pieces; the output doubles as the back-reference window.
+class Inflater {
+public:
+    // output is sized to outputSize up front and trimmed to what was produced
+    Inflater(std::istream& input, uint64_t inputSize, std::vector<uint8_t>& output, size_t outputSize)
+        : m_input(input), m_inputLeft(inputSize), m_output(output), m_chunk(ZipArchive::INPUT_CHUNK) {
+        m_output.resize(outputSize);
+    }
+
+    bool Run() {
+        bool last = false;
+        bool ok = true;
+        while (ok && !last) {
+            uint32_t header;
+            if (!Bits(3, header)) {
+                ok = false;
+                break;
+            }
+            last = (header & 1) != 0;
+
+            switch (header >> 1) {
+                case 0: ok = Stored(); break;
+                case 1: ok = Fixed(); break;
+                case 2: ok = Dynamic(); break;
+                default: ok = false; break;
+            }
+        }
+        m_output.resize(m_outputSize);
+        return ok;
+    }
+
+private:
+    // Tops the bit buffer up to at least 57 bits while input remains
+    void Refill() {
+        // Eight bytes at a time away from the chunk's end (little-endian host)
+        if (m_chunkSize - m_chunkPosition >= 8) {
+            uint64_t word;
+            memcpy(&word, m_chunk.data() + m_chunkPosition, sizeof(word));
+            m_bitBuffer |= word << m_bitCount;
+            size_t bytes = static_cast<size_t>(63 - m_bitCount) >> 3;
+            m_chunkPosition += bytes;
+            m_bitCount += static_cast<int>(bytes) * 8;
+            return;
+        }
+
+        while (m_bitCount <= 56) {
+            if (m_chunkPosition == m_chunkSize) {
+                size_t size = static_cast<size_t>(std::min<uint64_t>(m_chunk.size(), m_inputLeft));
+                if (size == 0 || !m_input.read(reinterpret_cast<char*>(m_chunk.data()), static_cast<std::streamsize>(size))) {
+                    return;
+                }
+                m_inputLeft -= size;
+                m_chunkSize = size;
+                m_chunkPosition = 0;
+            }
+            m_bitBuffer |= static_cast<uint64_t>(m_chunk[m_chunkPosition++]) << m_bitCount;
+            m_bitCount += 8;
+        }
+    }
+
+    bool Bits(int count, uint32_t& value) {
+        if (m_bitCount < count) {
+            Refill();
+            if (m_bitCount < count) {
+                return false;
+            }
+        }
+        value = static_cast<uint32_t>(m_bitBuffer & ((1ull << count) - 1));
+        m_bitBuffer >>= count;
+        m_bitCount -= count;
+        return true;
+    }
+
+    bool Decode(const Huffman& huffman, int& symbol) {
+        if (m_bitCount < Huffman::MAX_BITS) {
+            Refill();
+        }
+
+        uint16_t entry = huffman.fast[m_bitBuffer & ((1u << Huffman::FAST_BITS) - 1)];
+        int length = entry >> 9;
+        if (entry != 0 && length <= m_bitCount) {
+            m_bitBuffer >>= length;
+            m_bitCount -= length;
+            symbol = entry & 0x1FF;
+            return true;
+        }
+
+        // Canonical decode, one bit at a time
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (length = 1; length <= Huffman::MAX_BITS; length++) {
+            uint32_t bit;
+            if (!Bits(1, bit)) {
+                return false;
+            }
+            code |= static_cast<int>(bit);
+            int count = huffman.counts[length];
+            if (code - count < first) {
+                symbol = huffman.symbols[index + (code - first)];
+                return true;
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        return false;
+    }
+
+    bool Stored() {
+        // Skip to a byte boundary; the rest of the bit buffer is whole bytes
+        m_bitBuffer >>= m_bitCount % 8;
+        m_bitCount -= m_bitCount % 8;
+
+        uint32_t length;
+        uint32_t complement;
+        if (!Bits(16, length) || !Bits(16, complement) || length != (~complement & 0xFFFF)) {
+            return false;
+        }
+        if (m_outputSize + length > m_output.size()) {
+            return false;
+        }
+
+        while (length > 0 && m_bitCount >= 8) {
+            m_output[m_outputSize++] = static_cast<uint8_t>(m_bitBuffer);
+            m_bitBuffer >>= 8;
+            m_bitCount -= 8;
+            length--;
+        }
+        while (length > 0) {
+            if (m_chunkPosition == m_chunkSize) {
+                Refill();
+                if (m_bitCount == 0) {
+                    return false;
+                }
+                // Refill went through the bit buffer; drain it again
+                while (length > 0 && m_bitCount >= 8) {
+                    m_output[m_outputSize++] = static_cast<uint8_t>(m_bitBuffer);
+                    m_bitBuffer >>= 8;
+                    m_bitCount -= 8;
+                    length--;
+                }
+                continue;
+            }
+            // Bypassing the bit buffer: drop the look-ahead bits Refill leaves in it
+            m_bitBuffer = 0;
+            size_t size = std::min<size_t>(length, m_chunkSize - m_chunkPosition);
+            memcpy(m_output.data() + m_outputSize, m_chunk.data() + m_chunkPosition, size);
+            m_outputSize += size;
+            m_chunkPosition += size;
+            length -= static_cast<uint32_t>(size);
+        }
+        return true;
+    }
+
+    bool Fixed() {
+        uint8_t lengths[288 + 30];
+        memset(lengths, 8, 144);
+        memset(lengths + 144, 9, 112);
+        memset(lengths + 256, 7, 24);
+        memset(lengths + 280, 8, 8);
+        memset(lengths + 288, 5, 30);
+        return m_literals.Build(lengths, 288) && m_distances.Build(lengths + 288, 30) && Codes();
+    }
+
+    bool Dynamic() {
+        uint32_t literalCount;
+        uint32_t distanceCount;
+        uint32_t codeLengthCount;
+        if (!Bits(5, literalCount) || !Bits(5, distanceCount) || !Bits(4, codeLengthCount)) {
+            return false;
+        }
+        literalCount += 257;
+        distanceCount += 1;
+        codeLengthCount += 4;
+        if (literalCount > 286 || distanceCount > 30) {
+            return false;
+        }
+
+        uint8_t lengths[288 + 30] = {};
+        for (uint32_t i = 0; i < codeLengthCount; i++) {
+            uint32_t length;
+            if (!Bits(3, length)) {
+                return false;
+            }
+            lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(length);
+        }
+        Huffman codeLengths;
+        if (!codeLengths.Build(lengths, 19)) {
+            return false;
+        }
+
+        // Literal/length and distance code lengths share one run-length stream
+        memset(lengths, 0, sizeof(lengths));
+        uint32_t index = 0;
+        while (index < literalCount + distanceCount) {
+            int symbol;
+            if (!Decode(codeLengths, symbol)) {
+                return false;
+            }
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t repeated = 0;
+            uint32_t repeat;
+            if (symbol == 16) {
+                if (index == 0 || !Bits(2, repeat)) {
+                    return false;
+                }
+                repeated = lengths[index - 1];
+                repeat += 3;
+            } else if (symbol == 17) {
+                if (!Bits(3, repeat)) {
+                    return false;
+                }
+                repeat += 3;
+            } else {
+                if (!Bits(7, repeat)) {
+                    return false;
+                }
+                repeat += 11;
+            }
+            if (index + repeat > literalCount + distanceCount) {
+                return false;
+            }
+            while (repeat-- > 0) {
+                lengths[index++] = repeated;
+            }
+        }
+
+        if (lengths[256] == 0) {
+            return false;       // No end-of-block code
+        }
+        uint8_t distanceLengths[30];
+        memcpy(distanceLengths, lengths + literalCount, distanceCount);
+        return m_literals.Build(lengths, static_cast<int>(literalCount)) &&
+               m_distances.Build(distanceLengths, static_cast<int>(distanceCount)) && Codes();
+    }
+
+    bool Codes() {
+        uint8_t* output = m_output.data();
+        const size_t outputLimit = m_output.size();
+        for (;;) {
+            int symbol;
+            if (!Decode(m_literals, symbol)) {
+                return false;
+            }
+            if (symbol < 256) {
+                if (m_outputSize >= outputLimit) {
+                    return false;
+                }
+                output[m_outputSize++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            if (symbol == 256) {
+                return true;
+            }
+
+            symbol -= 257;
+            uint32_t extra;
+            if (symbol >= 29 || !Bits(LENGTH_EXTRA[symbol], extra)) {
+                return false;
+            }
+            size_t length = LENGTH_BASE[symbol] + extra;
+
+            int distanceSymbol;
+            if (!Decode(m_distances, distanceSymbol) || distanceSymbol >= 30 ||
+                !Bits(DISTANCE_EXTRA[distanceSymbol], extra)) {
+                return false;
+            }
+            size_t distance = DISTANCE_BASE[distanceSymbol] + extra;
+            if (distance > m_outputSize || m_outputSize + length > outputLimit) {
+                return false;
+            }
+
+            // Byte by byte: the source may overlap what is being written
+            const uint8_t* from = output + m_outputSize - distance;
+            uint8_t* to = output + m_outputSize;
+            for (size_t i = 0; i < length; i++) {
+                to[i] = from[i];
+            }
+            m_outputSize += length;
+        }
+    }
+
+    std::istream& m_input;
+    uint64_t m_inputLeft;
+    std::vector<uint8_t>& m_output;
+    size_t m_outputSize = 0;
+
+    std::vector<uint8_t> m_chunk;
+    size_t m_chunkSize = 0;
+    size_t m_chunkPosition = 0;
+    uint64_t m_bitBuffer = 0;
+    int m_bitCount = 0;
+
+    Huffman m_literals;
+    Huffman m_distances;
+};
+
+int64_t ModifiedTime(const std::filesystem::path& path, std::error_code& error) {
+    return static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+}
+
+} // namespace
+
+bool ZipArchive::Open(const std::filesystem::path& path) {
+    m_path = path;
+    m_entries.clear();
+    m_entryIndex.clear();
+
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    m_modifiedTime = error ? 0 : ModifiedTime(path, error);
+    std::ifstream file(path, std::ios::binary);
+    if (error || !file) {
+        LOG_WARN("Failed to open archive: {}", path.wstring());
+        return false;
+    }
+
+    if (!ReadCentralDirectory(file, fileSize)) {
+        LOG_WARN("Not a readable zip archive: {}", path.wstring());
+        m_entries.clear();
+        return false;
+    }
+
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        m_entryIndex.emplace(m_entries[i].name, i);
+    }
+    return true;
+}
+
+bool ZipArchive::ReadCentralDirectory(std::istream& file, uint64_t fileSize) {
+    // The end record is last, followed only by a comment of up to 64 KiB
+    size_t tailSize = static_cast<size_t>(std::min<uint64_t>(fileSize, END_SIZE + MAX_COMMENT));
+    std::vector<uint8_t> tail(tailSize);
+    uint64_t tailOffset = fileSize - tailSize;
+    if (tailSize < END_SIZE || !ReadAt(file, tailOffset, tail.data(), tailSize)) {
+        return false;
+    }
+
+    size_t end = tailSize - END_SIZE + 1;
+    while (end-- > 0) {
+        if (ReadLE32(&tail[end]) == END_SIGNATURE) {
+            break;
+        }
+    }
+    if (end == static_cast<size_t>(-1)) {
+        return false;
+    }
+
+    const uint8_t* record = &tail[end];
+    uint64_t entryCount = ReadLE16(record + 10);
+    uint64_t directorySize = ReadLE32(record + 12);
+    uint64_t directoryOffset = ReadLE32(record + 16);
+
+    // Zip64: the real values are in a record found through the locator before the end record
+    if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF) {
+        uint8_t locator[ZIP64_LOCATOR_SIZE];
+        uint8_t zip64End[ZIP64_END_SIZE];
+        uint64_t endOffset = tailOffset + end;
+        if (endOffset < ZIP64_LOCATOR_SIZE ||
+            !ReadAt(file, endOffset - ZIP64_LOCATOR_SIZE, locator, sizeof(locator)) ||
+            ReadLE32(locator) != ZIP64_LOCATOR_SIGNATURE ||
+            !ReadAt(file, ReadLE64(locator + 8), zip64End, sizeof(zip64End)) ||
+            ReadLE32(zip64End) != ZIP64_END_SIGNATURE) {
+            return false;
+        }
+        entryCount = ReadLE64(zip64End + 32);
+        directorySize = ReadLE64(zip64End + 40);
+        directoryOffset = ReadLE64(zip64End + 48);
+    }
+
+    if (directoryOffset + directorySize > fileSize) {
+        return false;
+    }
+    std::vector<uint8_t> directory(static_cast<size_t>(directorySize));
+    if (!ReadAt(file, directoryOffset, directory.data(), directory.size())) {
+        return false;
+    }
+
+    size_t position = 0;
+    m_entries.reserve(static_cast<size_t>(std::min<uint64_t>(entryCount, directory.size() / CENTRAL_HEADER_SIZE)));
+    for (uint64_t i = 0; i < entryCount; i++) {
+        if (position + CENTRAL_HEADER_SIZE > directory.size() ||
+            ReadLE32(&directory[position]) != CENTRAL_HEADER_SIGNATURE) {
+            return false;
+        }
+        const uint8_t* header = &directory[position];
+        uint16_t flags = ReadLE16(header + 8);
+        size_t nameLength = ReadLE16(header + 28);
+        size_t extraLength = ReadLE16(header + 30);
+        size_t commentLength = ReadLE16(header + 32);
+        size_t next = position + CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+        if (next > directory.size()) {
+            return false;
+        }
+
+        ZipEntry entry;
+        entry.method = ReadLE16(header + 10);
+        entry.crc32 = ReadLE32(header + 16);
+        entry.compressedSize = ReadLE32(header + 20);
+        entry.uncompressedSize = ReadLE32(header + 24);
+        entry.localHeaderOffset = ReadLE32(header + 42);
+        entry.name.assign(reinterpret_cast<const char*>(header + CENTRAL_HEADER_SIZE), nameLength);
+
+        // Zip64 extra field: 64-bit values for whichever fields are saturated, in this order
+        const uint8_t* extra = header + CENTRAL_HEADER_SIZE + nameLength;
+        for (size_t offset = 0; offset + 4 <= extraLength;) {
+            uint16_t id = ReadLE16(extra + offset);
+            size_t size = ReadLE16(extra + offset + 2);
+            if (id == ZIP64_EXTRA_ID) {
+                const uint8_t* value = extra + offset + 4;
+                const uint8_t* valueEnd = value + std::min(size, extraLength - offset - 4);
+                uint64_t* fields[] = {&entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset};
+                for (uint64_t* field : fields) {
+                    if (*field == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                        *field = ReadLE64(value);
+                        value += 8;
+                    }
+                }
+            }
+            offset += 4 + size;
+        }
+
+        bool isDirectory = !entry.name.empty() && entry.name.back() == '/';
+        if (!isDirectory && !(flags & FLAG_ENCRYPTED)) {
+            std::replace(entry.name.begin(), entry.name.end(), '\\', '/');
+            m_entries.push_back(std::move(entry));
+        }
+        position = next;
+    }
+    return true;
+}
+
+const ZipEntry* ZipArchive::FindEntry(const std::string& name) const {
+    auto found = m_entryIndex.find(name);
+    return found != m_entryIndex.end() ? &m_entries[found->second] : nullptr;
+}
+
+bool ZipArchive::Extract(const ZipEntry& entry, std::vector<uint8_t>& bytes) const {
+    bytes.clear();
+    if (entry.uncompressedSize > MAX_ENTRY_SIZE ||
+        (entry.method != METHOD_STORED && entry.method != METHOD_DEFLATE)) {
+        LOG_WARN("Unsupported zip entry {} (method {})", entry.name, entry.method);
+        return false;
+    }
+
+    std::ifstream file(m_path, std::ios::binary);
+    uint8_t header[LOCAL_HEADER_SIZE];
+    if (!file || !ReadAt(file, entry.localHeaderOffset, header, sizeof(header)) ||
+        ReadLE32(header) != LOCAL_HEADER_SIGNATURE) {
+        return false;
+    }
+    uint64_t dataOffset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + ReadLE16(header + 26) + ReadLE16(header + 28);
+    file.seekg(static_cast<std::streamoff>(dataOffset), std::ios::beg);
+
+    bool ok;
+    if (entry.method == METHOD_STORED) {
+        bytes.resize(static_cast<size_t>(entry.uncompressedSize));
+        ok = entry.compressedSize == entry.uncompressedSize &&
+             file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    } else {
+        Inflater inflater(file, entry.compressedSize, bytes, static_cast<size_t>(entry.uncompressedSize));
+        ok = inflater.Run() && bytes.size() == entry.uncompressedSize;
+    }
+
+    if (!ok || Crc32(bytes.data(), bytes.size()) != entry.crc32) {
+        LOG_WARN("Corrupt zip entry {} in {}", entry.name, m_path.wstring());
+        bytes.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ZipArchive::SplitEntryPath(const std::filesystem::path& path, std::filesystem::path& archive,
+                                std::string& entryName) {
+    std::filesystem::path prefix;
+    auto it = path.begin();
+    for (; it != path.end(); ++it) {
+        prefix /= *it;
+        std::error_code error;
+        if (IsArchive(prefix) && std::filesystem::is_regular_file(prefix, error)) {
+            break;
+        }
+    }
+    if (it == path.end()) {
+        return false;
+    }
+
+    archive = prefix;
+    entryName.clear();
+    for (++it; it != path.end(); ++it) {
+        entryName += (entryName.empty() ? "" : "/") + it->u8string();
+    }
+    return !entryName.empty();
+}
+
+std::shared_ptr<const ZipArchive> ZipArchive::OpenShared(const std::filesystem::path& archive) {
+    static std::mutex cacheMutex;
+    static std::map<std::filesystem::path, std::shared_ptr<const ZipArchive>> cache;
+
+    std::error_code error;
+    int64_t modifiedTime = ModifiedTime(archive, error);
+    if (error) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = cache.find(archive);
+    if (found != cache.end() && found->second->GetModifiedTime() == modifiedTime) {
+        return found->second;
+    }
+
+    auto opened = std::make_shared<ZipArchive>();
+    if (!opened->Open(archive)) {
+        cache.erase(archive);
+        return nullptr;
+    }
+    cache[archive] = opened;
+    return opened;
+}
+
+bool ZipArchive::ReadEntry(const std::filesystem::path& path, std::vector<uint8_t>& bytes) {
+    std::filesystem::path archivePath;
+    std::string entryName;
+    if (!SplitEntryPath(path, archivePath, entryName)) {
+        return false;
+    }
+
+    std::shared_ptr<const ZipArchive> archive = OpenShared(archivePath);
+    const ZipEntry* entry = archive ? archive->FindEntry(entryName) : nullptr;
+    return entry && archive->Extract(*entry, bytes);
+}
+
+bool ZipArchive::StatEntry(const std::filesystem::path& path, uint64_t& size, int64_t& modifiedTime) {
+    std::filesystem::path archivePath;
+    std::string entryName;
+    if (!SplitEntryPath(path, archivePath, entryName)) {
+        return false;
+    }
+
+    std::shared_ptr<const ZipArchive> archive = OpenShared(archivePath);
+    const ZipEntry* entry = archive ? archive->FindEntry(entryName) : nullptr;
+    if (!entry) {
+        return false;
+    }
+    size = entry->uncompressedSize;
+    modifiedTime = archive->GetModifiedTime();
+    return true;
+}
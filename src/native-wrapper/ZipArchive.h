@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reads replays straight out of .zip archives (stored or deflate entries,
+// zip64 included) so zipped sets can be analyzed in place. An entry is
+// addressed as a path through the archive, "D:/Sets/top8.zip/Game_1.slp",
+// which SlpReader::LoadFile and BatchAnalyzer accept like any replay path.
+//
+// Only the central directory is kept in memory. Extract reads the entry's
+// compressed bytes in INPUT_CHUNK pieces and inflates them into the output,
+// so the memory an entry needs is its uncompressed size plus one chunk. It
+// opens its own stream, so entries of one archive can be extracted from
+// several threads at once.
+
+struct ZipEntry {
+    std::string name;                   // Path inside the archive, '/' separated
+    uint16_t method = 0;                // 0 = stored, 8 = deflate
+    uint32_t crc32 = 0;
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
+};
+
+class ZipArchive {
+public:
+    static constexpr size_t INPUT_CHUNK = 64 * 1024;
+    static constexpr uint64_t MAX_ENTRY_SIZE = 512ull * 1024 * 1024;  // Larger entries are not replays
+
+    bool Open(const std::filesystem::path& path);
+
+    const std::filesystem::path& GetPath() const { return m_path; }
+    const std::vector<ZipEntry>& GetEntries() const { return m_entries; }
+    int64_t GetModifiedTime() const { return m_modifiedTime; }
+
+    // Entry by its name inside the archive, or nullptr
+    const ZipEntry* FindEntry(const std::string& name) const;
+
+    // Inflates an entry and checks its CRC
+    bool Extract(const ZipEntry& entry, std::vector<uint8_t>& bytes) const;
+
+    static bool IsArchive(const std::filesystem::path& path) { return path.extension() == ".zip"; }
+
+    // Splits "<archive>.zip/<entry>" into the archive file and the entry name
+    static bool SplitEntryPath(const std::filesystem::path& path, std::filesystem::path& archive,
+                               std::string& entryName);
+
+    // Archives opened through here are parsed once and shared until the
+    // file changes on disk; nullptr if the archive can't be read
+    static std::shared_ptr<const ZipArchive> OpenShared(const std::filesystem::path& archive);
+
+    // Bytes, or size and timestamp (the archive's), of an entry path
+    static bool ReadEntry(const std::filesystem::path& path, std::vector<uint8_t>& bytes);
+    static bool StatEntry(const std::filesystem::path& path, uint64_t& size, int64_t& modifiedTime);
+
+private:
+    bool ReadCentralDirectory(std::istream& file, uint64_t fileSize);
+
+    std::filesystem::path m_path;
+    int64_t m_modifiedTime = 0;
+    std::vector<ZipEntry> m_entries;
+    std::unordered_map<std::string, size_t> m_entryIndex;
+};
@@ -29,8 +29,38 @@ g++ -std=c++17 -O2 -Wall -Wextra ^
     WindowManager.cpp ^
     GameDataInterface.cpp ^
     CoachingInterface.cpp ^
+    AnimationSystem.cpp ^
+    Logger.cpp ^
+    ConfigSnapshot.cpp ^
+    StartupProfiler.cpp ^
+    FrameClock.cpp ^
+    LiveAnalytics.cpp ^
+    LiveCheckpoint.cpp ^
+    StatsRollup.cpp ^
+    HighlightScorer.cpp ^
+    FrameStore.cpp ^
+    BlockCodec.cpp ^
+    FrameHistory.cpp ^
+    DetectorRegistry.cpp ^
+    FocusDetectors.cpp ^
+    PlayerPairs.cpp ^
+    ArrowWriter.cpp ^
+    FrameQuery.cpp ^
+    TipRuleEngine.cpp ^
+    NearDuplicateFilter.cpp ^
+    KnowledgeIndex.cpp ^
+    ContentHash.cpp ^
+    ZipArchive.cpp ^
+    SlippiReplay.cpp ^
+    ReplayResultCache.cpp ^
+    ReplayCatalog.cpp ^
+    BatchAnalyzer.cpp ^
+    SlippiNames.cpp ^
+    OpponentScouting.cpp ^
+    ScoutingIngest.cpp ^
+    DistributedAnalysis.cpp ^
     -o bin/CoachClippiWrapper.exe ^
-    -luser32 -lgdi32 -lkernel32 -lcomctl32 -lole32 -loleaut32 -luuid -ladvapi32 -lshell32 -lpsapi ^
+    -luser32 -lgdi32 -lkernel32 -lcomctl32 -lole32 -loleaut32 -luuid -ladvapi32 -lshell32 -lpsapi -lws2_32 ^
     -mwindows
 
 if errorlevel 1 (
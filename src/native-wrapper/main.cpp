@@ -1,13 +1,22 @@
 #include <windows.h>
 #include <objbase.h>
-#include <iostream>
 #include <string>
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <future>
+#include <algorithm>
 #include "WindowManager.h"
 #include "GameDataInterface.h"
 #include "CoachingInterface.h"
+#include "Logger.h"
+#include "ConfigSnapshot.h"
+#include "StartupProfiler.h"
+#include "OpponentScouting.h"
+#include "ScoutingIngest.h"
+#include "BatchAnalyzer.h"
+#include "SlippiNames.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "imgui_impl_win32.h"
@@ -21,6 +30,7 @@ const int DEFAULT_WIDTH = 1400;
 const int DEFAULT_HEIGHT = 900;
 const int GAME_AREA_WIDTH = 960;
 const int GAME_AREA_HEIGHT = 720;
+const DWORD BACKGROUND_POLL_MS = 100;   // Wake-up interval while no frames are built
 
 // Global application state
 struct AppState {
@@ -29,6 +39,13 @@ struct AppState {
     WindowManager* windowManager;
     GameDataInterface* gameInterface;
     CoachingInterface* coachingUI;
+    ConfigStore* config;
+    OpponentScouting* scouting;
+    uint64_t handledGameStarts;
+    uint64_t handledGameEnds;
+    size_t timelineGames;           // Finished games in the frame history when last checked
+    std::filesystem::file_time_type sessionStart;   // Older replays are not this session's
+    ScoutingIngest* scoutingIngest;
     bool isGameEmbedded;
     bool isRunning;
 };
@@ -41,9 +58,19 @@ static ID3D11DeviceContext*     g_pd3dDeviceContext = nullptr;
 static IDXGISwapChain*          g_pSwapChain = nullptr;
 static ID3D11RenderTargetView*  g_mainRenderTargetView = nullptr;
 
+// Components that need neither the window nor the D3D device; they are built
+// on a worker thread while the main thread brings up the window
+struct BackgroundComponents {
+    ConfigStore* config = nullptr;
+    WindowManager* windowManager = nullptr;
+    GameDataInterface* gameInterface = nullptr;
+    OpponentScouting* scouting = nullptr;
+};
+
 // Forward declarations
 LRESULT CALLBACK MainWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
-void InitializeApplication();
+BackgroundComponents InitializeBackgroundComponents();
+void InitializeApplication(const BackgroundComponents& components);
 void GameDetectionThread();
 void UpdateLayout();
 void CleanupApplication();
@@ -52,13 +79,38 @@ void CleanupDeviceD3D();
 void CreateRenderTarget();
 void CleanupRenderTarget();
 void RenderUI();
+void HandleGameStart();
+void HandleGameEnd();
+void UpdateGameTimeline();
+std::filesystem::path GetReplayDirectory();
+void ExportHighlightReel();
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    StartupProfiler::Start();
+    
     // Initialize COM for window management
     CoInitialize(nullptr);
     
+    // Log to CoachClippi.log next to the executable
+    char modulePath[MAX_PATH] = {0};
+    GetModuleFileNameA(nullptr, modulePath, MAX_PATH);
+    std::string exeDirectory = modulePath;
+    exeDirectory = exeDirectory.substr(0, exeDirectory.find_last_of("\\/") + 1);
+    
+    LogOptions logOptions;
+    logOptions.filePath = exeDirectory + "CoachClippi.log";
+    Logger::Start(logOptions);
+    
+    // One line per launch, to track startup time across versions
+    StartupProfiler::SetHistoryFile(exeDirectory + "CoachClippi-startup.csv");
+    
+    std::future<BackgroundComponents> backgroundInit =
+        std::async(std::launch::async, InitializeBackgroundComponents);
+    
+    auto windowStart = StartupProfiler::Clock::now();
+    
     // Register window class
     WNDCLASSEX wc = {};
     wc.cbSize = sizeof(WNDCLASSEX);
@@ -128,19 +180,19 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         return 1;
     }
     
+    StartupProfiler::Record("Window", windowStart, StartupProfiler::Clock::now());
+    
     // Initialize Direct3D
-    if (!CreateDeviceD3D(g_appState.mainWindow))
     {
-        CleanupDeviceD3D();
-        return 1;
+        STARTUP_PHASE("Direct3D");
+        if (!CreateDeviceD3D(g_appState.mainWindow))
+        {
+            CleanupDeviceD3D();
+            return 1;
+        }
     }
     
-    // Initialize application components
-    InitializeApplication();
-    
-    // Show window
-    ShowWindow(g_appState.mainWindow, nCmdShow);
-    UpdateWindow(g_appState.mainWindow);
+    auto imguiStart = StartupProfiler::Clock::now();
     
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
@@ -186,17 +238,42 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         style.Colors[ImGuiCol_WindowBg].w = 1.0f;
     }
 
+    {
+        STARTUP_PHASE("Fonts");
+        
+        // ImGui 1.92 bakes glyphs on first use, so this only registers the font
+        ImFontConfig fontConfig;
+        fontConfig.SizePixels = 13.0f * CoachingInterface::GetSystemDpiScale();
+        io.Fonts->AddFontDefault(&fontConfig);
+    }
+
     // Setup Platform/Renderer backends
     ImGui_ImplWin32_Init(g_appState.mainWindow);
     ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
     
-    // Start game detection thread
-    std::thread gameDetection(GameDetectionThread);
-    gameDetection.detach();
+    StartupProfiler::Record("ImGui", imguiStart, StartupProfiler::Clock::now());
+    
+    // Initialize application components
+    {
+        BackgroundComponents components;
+        {
+            STARTUP_PHASE("Wait for background init");
+            components = backgroundInit.get();
+        }
+        InitializeApplication(components);
+    }
+    
+    // Show window
+    ShowWindow(g_appState.mainWindow, nCmdShow);
+    UpdateWindow(g_appState.mainWindow);
     
     // Main message loop
     MSG msg = {};
     g_appState.isRunning = true;
+    bool firstFramePresented = false;
+    bool swapChainOccluded = false;
+    bool inBackground = false;
+    auto backgroundStart = std::chrono::steady_clock::now();
     
     while (g_appState.isRunning)
     {
@@ -205,7 +282,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-        if (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
+        while (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
         {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
@@ -215,6 +292,56 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         if (!g_appState.isRunning)
             break;
 
+        // Runs in the background too, so reports and rollups are up to date
+        // when the window comes back
+        HandleGameStart();
+        UpdateGameTimeline();
+        if (g_appState.coachingUI && g_appState.gameInterface) {
+            g_appState.coachingUI->UpdateIngestStats(g_appState.gameInterface->GetIngestStats());
+            g_appState.coachingUI->UpdateLiveAnalytics(g_appState.gameInterface->GetLiveAnalytics());
+            HandleGameEnd();
+            g_appState.coachingUI->UpdateDetectors(g_appState.gameInterface->GetDetectorStatus(),
+                                                   g_appState.gameInterface->GetFocusStats());
+            
+            uint8_t focus;
+            if (g_appState.coachingUI->TakeFocusChange(focus)) {
+                g_appState.gameInterface->SetFocus(focus);
+            }
+        }
+
+        // Background mode: while minimized, hidden or covered, no ImGui frames are
+        // built or presented. Ingestion, analytics and commentary run on their own
+        // threads and keep going. Occlusion only counts when there are no floating
+        // viewports that could still be visible.
+        if (firstFramePresented &&
+            (IsIconic(g_appState.mainWindow) || !IsWindowVisible(g_appState.mainWindow) ||
+             (swapChainOccluded && ImGui::GetPlatformIO().Viewports.Size <= 1 &&
+              g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)))
+        {
+            if (!inBackground) {
+                inBackground = true;
+                backgroundStart = std::chrono::steady_clock::now();
+                if (g_appState.coachingUI) {
+                    g_appState.coachingUI->SetMinimized(true);
+                }
+                LOG_DEBUG("UI in background, frame building paused");
+            }
+            MsgWaitForMultipleObjects(0, nullptr, FALSE, BACKGROUND_POLL_MS, QS_ALLINPUT);
+            continue;
+        }
+        swapChainOccluded = false;
+        
+        // The next frame is the catch-up frame
+        if (inBackground) {
+            inBackground = false;
+            if (g_appState.coachingUI) {
+                g_appState.coachingUI->SetMinimized(false);
+            }
+            auto pausedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - backgroundStart).count();
+            LOG_DEBUG("UI back in foreground after {} ms", pausedMs);
+        }
+
         // Start the Dear ImGui frame
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
@@ -236,12 +363,22 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             ImGui::RenderPlatformWindowsDefault();
         }
 
-        g_pSwapChain->Present(1, 0); // Present with vsync
+        HRESULT presentResult = g_pSwapChain->Present(1, 0); // Present with vsync
+        swapChainOccluded = (presentResult == DXGI_STATUS_OCCLUDED);
+        
+        // Game detection needs the ImGui container window, which exists after the first frame
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            StartupProfiler::Mark(StartupProfiler::FIRST_FRAME);
+            std::thread gameDetection(GameDetectionThread);
+            gameDetection.detach();
+        }
     }
     
     // Cleanup
     CleanupApplication();
     CoUninitialize();
+    Logger::Shutdown();
     
     return (int)msg.wParam;
 }
@@ -347,6 +484,15 @@ void RenderUI()
             ImGui::EndMenu();
         }
         
+        if (ImGui::BeginMenu("Session"))
+        {
+            if (ImGui::MenuItem("Export Highlight Reel")) {
+                ExportHighlightReel();
+            }
+            
+            ImGui::EndMenu();
+        }
+        
         if (ImGui::BeginMenu("Windows"))
         {
             if (ImGui::MenuItem("Player Stats", "F1")) {
@@ -494,27 +640,283 @@ LRESULT CALLBACK MainWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPar
     return 0;
 }
 
-void InitializeApplication() {
-    // Initialize window manager
-    g_appState.windowManager = new WindowManager();
+BackgroundComponents InitializeBackgroundComponents() {
+    BackgroundComponents components;
+    
+    {
+        // Same config.json and .env the Node services read, from the working directory
+        STARTUP_PHASE("Config");
+        components.config = new ConfigStore("config.json", ".env");
+        components.config->StartWatching();
+    }
+    
+    {
+        STARTUP_PHASE("WindowManager");
+        components.windowManager = new WindowManager();
+    }
     
-    // Initialize game data interface
-    g_appState.gameInterface = new GameDataInterface();
+    {
+        STARTUP_PHASE("GameDataInterface");
+        components.gameInterface = new GameDataInterface();
+        
+        // Live analytics checkpoint next to the executable, for warm restarts mid-set
+        wchar_t modulePath[MAX_PATH] = {0};
+        GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+        std::filesystem::path checkpointPath = std::filesystem::path(modulePath).parent_path() / L"CoachClippi.checkpoint";
+        components.gameInterface->EnableCheckpoints(checkpointPath);
+        
+        // Frames of games that no longer fit in memory, kept for this session only
+        components.gameInterface->EnableFrameArchive(
+            std::filesystem::path(modulePath).parent_path() / L"CoachClippi.frames");
+    }
+    
+    {
+        // Per-opponent aggregates written by CoachClippiBatch --scouting
+        STARTUP_PHASE("Scouting");
+        wchar_t modulePath[MAX_PATH] = {0};
+        GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+        components.scouting = new OpponentScouting(
+            std::filesystem::path(modulePath).parent_path() / L"CoachClippi-scouting.dat");
+        components.scouting->Load();
+    }
+    
+    return components;
+}
+
+void InitializeApplication(const BackgroundComponents& components) {
+    g_appState.config = components.config;
+    g_appState.windowManager = components.windowManager;
+    g_appState.gameInterface = components.gameInterface;
+    g_appState.scouting = components.scouting;
+    g_appState.sessionStart = std::filesystem::file_time_type::clock::now();
+    if (g_appState.scouting) {
+        g_appState.scoutingIngest = new ScoutingIngest(*g_appState.scouting, GetReplayDirectory(),
+                                                       g_appState.sessionStart);
+    }
     
     // Initialize coaching interface
-    g_appState.coachingUI = new CoachingInterface(g_appState.mainWindow);
+    {
+        STARTUP_PHASE("CoachingInterface");
+        g_appState.coachingUI = new CoachingInterface(g_appState.mainWindow);
+        
+        // Session and lifetime stats, saved after every game
+        wchar_t modulePath[MAX_PATH] = {0};
+        GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+        g_appState.coachingUI->LoadRollups(std::filesystem::path(modulePath).parent_path() / L"CoachClippi-rollup.dat");
+    }
+    
+    // Coaching focus, e.g. "combos, edgeguarding"; only the detectors it needs run
+    static const ConfigKey FOCUS_KEY("coaching.focus");
+    uint8_t focus = ParseFocus(g_appState.config ? g_appState.config->Current().GetString(FOCUS_KEY, "all") : "all");
+    g_appState.coachingUI->SetFocus(focus);
+    if (g_appState.gameInterface) {
+        g_appState.gameInterface->SetFocus(focus);
+    }
+    
+    // Length of sets that come without a Slippi match id (3 or 5)
+    static const ConfigKey BEST_OF_KEY("coaching.bestOf");
+    g_appState.coachingUI->SetDefaultBestOf(g_appState.config ? g_appState.config->Current().GetInt(BEST_OF_KEY, 3) : 3);
     
     // Set initial state
     g_appState.isGameEmbedded = false;
     
-    std::wcout << L"Coach Clippi initialized successfully" << std::endl;
+    LOG_INFO("Coach Clippi initialized successfully");
 }
 
-void GameDetectionThread() {
-    std::wcout << L"Starting game detection thread..." << std::endl;
+// Handles a game that just started: starts the tip stats over, opens a rollup
+// game against the first opponent and shows a scouting report for each
+// opponent. The player is the port with their own connect code
+// (slippi.connectCode); without one it is the first player, and every player
+// with a known code or name is scouted.
+void HandleGameStart() {
+    if (!g_appState.gameInterface || !g_appState.coachingUI) {
+        return;
+    }
+    
+    GameStartInfo gameStart;
+    uint64_t gameStarts = g_appState.gameInterface->GetLastGameStart(gameStart);
+    if (gameStarts == g_appState.handledGameStarts) {
+        return;
+    }
+    g_appState.handledGameStarts = gameStarts;
+    g_appState.coachingUI->ResetTipStats();
     
-    // Give the main UI thread time to initialize ImGui
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    static const ConfigKey CONNECT_CODE_KEY("slippi.connectCode");
+    std::string ownIdentity;
+    if (g_appState.config) {
+        ownIdentity = OpponentScouting::IdentityForCode(g_appState.config->Current().GetString(CONNECT_CODE_KEY));
+    }
+    
+    int localPort = -1;
+    for (int port = 0; port < 4 && localPort < 0; port++) {
+        if (gameStart.characters[port] >= 0 && !ownIdentity.empty() &&
+            OpponentScouting::IdentityForCode(gameStart.connectCodes[port]) == ownIdentity) {
+            localPort = port;
+        }
+    }
+    bool ownCodeFound = localPort >= 0;
+    for (int port = 0; port < 4 && localPort < 0; port++) {
+        if (gameStart.characters[port] >= 0) {
+            localPort = port;
+        }
+    }
+    
+    for (int port = 0; port < 4; port++) {
+        if (port != localPort && gameStart.characters[port] >= 0) {
+            std::string opponent = OpponentScouting::IdentityForCode(gameStart.connectCodes[port]);
+            if (opponent.empty() && !gameStart.displayNames[port].empty()) {
+                opponent = OpponentScouting::IdentityForName(gameStart.displayNames[port]);
+            }
+            if (opponent.empty()) {
+                opponent = SlippiNames::Character(gameStart.characters[port]);
+            }
+            g_appState.coachingUI->StartRollupGame(localPort, port, opponent, gameStart.matchId,
+                                                   gameStart.gameNumber);
+            break;
+        }
+    }
+    
+    if (!g_appState.scouting || !g_appState.scoutingIngest) {
+        return;
+    }
+    
+    // The game before this one just finished; it's added in the background
+    g_appState.scoutingIngest->Wake();
+    
+    auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(g_appState.scoutingIngest->GetStoreMutex());
+    int reports = 0;
+    for (int port = 0; port < 4; port++) {
+        if (gameStart.characters[port] < 0 || (ownCodeFound && port == localPort)) {
+            continue;
+        }
+        
+        ScoutingReport report;
+        if (g_appState.scouting->BuildReport(gameStart.connectCodes[port], gameStart.displayNames[port],
+                                             gameStart.characters[port], report)) {
+            g_appState.coachingUI->ShowScoutingReport(report);
+            reports++;
+        }
+    }
+    
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Game start: {} scouting reports in {} ms", reports, elapsedMs);
+}
+
+// Closes the rollup game from the gameEnd event, which also covers time outs,
+// quit outs and disconnects, where no one runs out of stocks
+void HandleGameEnd() {
+    GameEndInfo gameEnd;
+    uint64_t gameEnds = g_appState.gameInterface->GetLastGameEnd(gameEnd);
+    if (gameEnds == g_appState.handledGameEnds) {
+        return;
+    }
+    g_appState.handledGameEnds = gameEnds;
+    g_appState.coachingUI->EndRollupGame(gameEnd);
+    
+    // The finished game's replay is complete now
+    if (g_appState.scoutingIngest) {
+        g_appState.scoutingIngest->Wake();
+    }
+}
+
+// Shows each game in the timeline as it finishes, or the one picked there.
+// Decoding is a millisecond or two, and the frame history caches the result.
+void UpdateGameTimeline() {
+    if (!g_appState.gameInterface || !g_appState.coachingUI) {
+        return;
+    }
+    
+    FrameHistory& history = g_appState.gameInterface->GetFrameHistory();
+    size_t games = history.GetGameCount();
+    size_t game = games - 1;
+    bool picked = g_appState.coachingUI->TakeTimelineRequest(game);
+    if ((!picked && games <= g_appState.timelineGames) || game >= games) {
+        return;
+    }
+    g_appState.timelineGames = games;
+    
+    std::shared_ptr<const ColumnTable> frames = history.GetGame(game);
+    if (!frames) {
+        LOG_WARN("Game {} is no longer in the frame history", game + 1);
+        return;
+    }
+    g_appState.coachingUI->ShowGameTimeline(FrameHistory::BuildTimeline(*frames, game), games);
+}
+
+// slippi.replayPath, Documents\Slippi by default
+std::filesystem::path GetReplayDirectory() {
+    static const ConfigKey REPLAY_PATH_KEY("slippi.replayPath");
+    std::filesystem::path replayDirectory;
+    if (g_appState.config) {
+        replayDirectory = std::filesystem::u8path(g_appState.config->Current().GetString(REPLAY_PATH_KEY));
+    }
+    if (replayDirectory.empty()) {
+        const wchar_t* profile = _wgetenv(L"USERPROFILE");
+        replayDirectory = std::filesystem::path(profile ? profile : L"") / L"Documents" / L"Slippi";
+    }
+    return replayDirectory;
+}
+
+// The replays written this session, with what the highlight scorer matches
+// them by. Slippi writes a replay as its game ends, so the game started the
+// file's length of frames before its last write.
+std::vector<ReplayInfo> FindSessionReplays() {
+    auto fileNow = std::filesystem::file_time_type::clock::now();
+    int64_t systemNowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    BatchAnalyzer analyzer(BatchOptions(), nullptr);
+    std::vector<ReplayInfo> replays;
+    for (const std::filesystem::path& path : BatchAnalyzer::CollectReplays(GetReplayDirectory(), true)) {
+        std::error_code error;
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+        ReplaySummary summary;
+        bool fromCache = false;
+        if (error || writeTime < g_appState.sessionStart || !analyzer.AnalyzeFile(path, summary, fromCache)) {
+            continue;
+        }
+        
+        ReplayInfo replay;
+        replay.path = path;
+        replay.stage = summary.stage;
+        std::copy(std::begin(summary.characters), std::end(summary.characters), replay.characters);
+        replay.lastFrame = summary.lastFrame;
+        int64_t writtenAtMs = systemNowMs -
+            std::chrono::duration_cast<std::chrono::milliseconds>(fileNow - writeTime).count();
+        replay.startedAtMs = writtenAtMs - static_cast<int64_t>(summary.lastFrame - summary.firstFrame + 1) * 1000 / 60;
+        replays.push_back(replay);
+    }
+    return replays;
+}
+
+// Writes the session's best moments as a Dolphin playback queue,
+// CoachClippi-highlights.json next to the executable. Games are matched to
+// this session's replays by stage, characters and start time (see
+// HighlightScorer::AssignReplays); a game with no matching replay is left out.
+void ExportHighlightReel() {
+    if (!g_appState.gameInterface) {
+        return;
+    }
+    
+    HighlightScorer highlights = g_appState.gameInterface->GetHighlights();
+    std::vector<Highlight> best = highlights.GetSessionHighlights();
+    if (best.empty()) {
+        return;
+    }
+    
+    highlights.AssignReplays(FindSessionReplays());
+    
+    wchar_t modulePath[MAX_PATH] = {0};
+    GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+    std::filesystem::path queueFile = std::filesystem::path(modulePath).parent_path() / L"CoachClippi-highlights.json";
+    int written = highlights.ExportPlaybackQueue(queueFile, best);
+    LOG_INFO("Highlight reel: {} of {} highlights exported to {}", written, best.size(), queueFile.wstring());
+}
+
+void GameDetectionThread() {
+    LOG_INFO("Starting game detection thread...");
+    StartupProfiler::Mark(StartupProfiler::READY);
     
     while (g_appState.isRunning) {
         if (!g_appState.isGameEmbedded) {
@@ -522,21 +924,21 @@ void GameDetectionThread() {
             HWND gameWindow = g_appState.windowManager->FindGameWindow();
             
             if (gameWindow) {
-                std::wcout << L"Found game window, attempting to embed..." << std::endl;
+                LOG_INFO("Found game window, attempting to embed...");
                 
                 // Get the ImGui game window container from CoachingInterface
                 HWND containerWindow = g_appState.coachingUI->GetGameWindowContainer();
                 
                 // If container window is not yet created, wait for next iteration
                 if (containerWindow == nullptr) {
-                    std::wcout << L"Waiting for ImGui game container window to be created..." << std::endl;
+                    LOG_DEBUG("Waiting for ImGui game container window to be created...");
                     std::this_thread::sleep_for(std::chrono::milliseconds(500));
                     continue;
                 }
                 
                 // Validate that the container window is actually ready
                 if (!IsWindow(containerWindow)) {
-                    std::wcout << L"Container window handle is invalid, waiting..." << std::endl;
+                    LOG_DEBUG("Container window handle is invalid, waiting...");
                     std::this_thread::sleep_for(std::chrono::milliseconds(500));
                     continue;
                 }
@@ -545,13 +947,12 @@ void GameDetectionThread() {
                 RECT containerRect;
                 if (!GetClientRect(containerWindow, &containerRect) || 
                     containerRect.right <= 0 || containerRect.bottom <= 0) {
-                    std::wcout << L"Container window not ready (no client area), waiting..." << std::endl;
+                    LOG_DEBUG("Container window not ready (no client area), waiting...");
                     std::this_thread::sleep_for(std::chrono::milliseconds(500));
                     continue;
                 }
                 
-                std::wcout << L"Container window ready: " << (void*)containerWindow 
-                          << L" (size: " << containerRect.right << L"x" << containerRect.bottom << L")" << std::endl;
+                LOG_INFO("Container window ready: {} (size: {}x{})", (void*)containerWindow, containerRect.right, containerRect.bottom);
                 
                 // Embed the game window into the ImGui container window
                 if (g_appState.windowManager->EmbedGameWindow(containerWindow, gameWindow)) {
@@ -565,9 +966,8 @@ void GameDetectionThread() {
                         int contentWidth = contentArea.right - contentArea.left;
                         int contentHeight = contentArea.bottom - contentArea.top;
                         
-                        std::wcout << L"Positioning game window to ImGui content area:" << std::endl;
-                        std::wcout << L"  Position: (" << contentArea.left << L"," << contentArea.top << L")" << std::endl;
-                        std::wcout << L"  Size: " << contentWidth << L"x" << contentHeight << std::endl;
+                        LOG_INFO("Positioning game window to ImGui content area at ({},{}) size {}x{}",
+                                 contentArea.left, contentArea.top, contentWidth, contentHeight);
                         
                         // Position and size the game window to exactly match the ImGui panel's content area
                         SetWindowPos(g_appState.gameWindow, HWND_BOTTOM,
@@ -578,7 +978,7 @@ void GameDetectionThread() {
                         // Use synchronized refresh
                         g_appState.windowManager->SynchronizeWindowRefresh(containerWindow, g_appState.gameWindow);
                     } else {
-                        std::wcout << L"Warning: Invalid content area, using fallback sizing" << std::endl;
+                        LOG_WARN("Invalid content area, using fallback sizing");
                         
                         // Fallback to container client area
                         RECT containerClientRect;
@@ -598,7 +998,7 @@ void GameDetectionThread() {
                     // Update layout
                     UpdateLayout();
                     
-                    std::wcout << L"Game window embedded successfully into ImGui container!" << std::endl;
+                    LOG_INFO("Game window embedded successfully into ImGui container!");
                     
                     // Add a commentary message about successful embedding
                     g_appState.coachingUI->AddCommentaryWithType(
@@ -607,13 +1007,13 @@ void GameDetectionThread() {
                         true
                     );
                 } else {
-                    std::wcout << L"Failed to embed game window, will retry..." << std::endl;
+                    LOG_WARN("Failed to embed game window, will retry...");
                 }
             }
         } else {
             // Check if game window is still valid
             if (!IsWindow(g_appState.gameWindow)) {
-                std::wcout << L"Game window lost, resetting..." << std::endl;
+                LOG_WARN("Game window lost, resetting...");
                 g_appState.isGameEmbedded = false;
                 g_appState.gameWindow = nullptr;
                 g_appState.gameInterface->StopMonitoring();
@@ -629,7 +1029,7 @@ void GameDetectionThread() {
             // Check if container window is still valid
             HWND containerWindow = g_appState.coachingUI->GetGameWindowContainer();
             if (g_appState.isGameEmbedded && (!containerWindow || !IsWindow(containerWindow))) {
-                std::wcout << L"ImGui container window lost, resetting..." << std::endl;
+                LOG_WARN("ImGui container window lost, resetting...");
                 
                 // Restore the game window before resetting
                 if (g_appState.gameWindow && IsWindow(g_appState.gameWindow)) {
@@ -682,7 +1082,7 @@ void GameDetectionThread() {
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
     
-    std::wcout << L"Game detection thread ended" << std::endl;
+    LOG_INFO("Game detection thread ended");
 }
 
 void UpdateLayout() {
@@ -728,8 +1128,7 @@ void UpdateLayout() {
     RECT gameArea = {gameX, gameY, gameX + optimalGameWidth, gameY + optimalGameHeight};
     
     // Log layout information
-    std::wcout << L"Game area: " << optimalGameWidth << L"x" << optimalGameHeight 
-              << L" at (" << gameX << L"," << gameY << L")" << std::endl;
+    LOG_INFO("Game area: {}x{} at ({},{})", optimalGameWidth, optimalGameHeight, gameX, gameY);
     
     // Update coaching interface with the calculated layout
     if (g_appState.coachingUI) {
@@ -754,15 +1153,14 @@ void UpdateLayout() {
                             0, 0, containerWidth, containerHeight,
                             SWP_NOACTIVATE);
                 
-                std::wcout << L"Resized game window to match container: " 
-                          << containerWidth << L"x" << containerHeight << std::endl;
+                LOG_DEBUG("Resized game window to match container: {}x{}", containerWidth, containerHeight);
             }
         }
     }
 }
 
 void CleanupApplication() {
-    std::wcout << L"Cleaning up application..." << std::endl;
+    LOG_INFO("Cleaning up application...");
     
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
@@ -770,9 +1168,10 @@ void CleanupApplication() {
 
     CleanupDeviceD3D();
     
-    // Stop monitoring
+    // Stop monitoring; the session's highlight reel is written once no more frames arrive
     if (g_appState.gameInterface) {
         g_appState.gameInterface->StopMonitoring();
+        ExportHighlightReel();
         delete g_appState.gameInterface;
     }
     
@@ -786,11 +1185,25 @@ void CleanupApplication() {
         delete g_appState.coachingUI;
     }
     
+    if (g_appState.config) {
+        delete g_appState.config;
+    }
+    
+    // One last pass adds the session's final game to the scouting store
+    if (g_appState.scoutingIngest) {
+        g_appState.scoutingIngest->Wake();
+        delete g_appState.scoutingIngest;
+    }
+    
+    if (g_appState.scouting) {
+        delete g_appState.scouting;
+    }
+    
     if (g_appState.windowManager) {
         delete g_appState.windowManager;
     }
     
-    std::wcout << L"Cleanup complete" << std::endl;
+    LOG_INFO("Cleanup complete");
 }
 
 // Helper functions
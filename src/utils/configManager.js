@@ -8,56 +8,152 @@ const __dirname = path.dirname(__filename);
 const configPath = path.join(process.cwd(), '.env');
 const jsonConfigPath = path.join(process.cwd(), 'config.json');
 
-export function getConfig(key, defaultValue = null) {
-    // First check environment variables
-    if (process.env[key]) {
-        return process.env[key];
+// Parsed config files, rebuilt only when config.json or .env changes.
+// Snapshots are frozen and swapped whole, so a reader never sees a half-applied
+// reload and a lookup is a single Map.get.
+let snapshot = null;
+let watcher = null;
+let reloadTimer = null;
+const changeListeners = new Set();
+
+function deepFreeze(value) {
+    if (value && typeof value === 'object' && !Object.isFrozen(value)) {
+        Object.freeze(value);
+        for (const child of Object.values(value)) {
+            deepFreeze(child);
+        }
     }
-    
-    // Then check config.json file
+    return value;
+}
+
+// Flattens nested objects into dotted keys ('slippi.address'); intermediate
+// objects stay addressable too, as they were with the old per-call walk
+function flattenInto(values, prefix, object) {
+    for (const [key, value] of Object.entries(object)) {
+        const fullKey = prefix ? `${prefix}.${key}` : key;
+        values.set(fullKey, value);
+        if (value && typeof value === 'object' && !Array.isArray(value)) {
+            flattenInto(values, fullKey, value);
+        }
+    }
+}
+
+function readJsonConfig() {
     try {
         if (fs.existsSync(jsonConfigPath)) {
-            const config = JSON.parse(fs.readFileSync(jsonConfigPath, 'utf8'));
-            
-            // Handle nested keys like 'slippi.address' or 'ai.apiKey'
-            if (key.includes('.')) {
-                const parts = key.split('.');
-                let value = config;
-                for (const part of parts) {
-                    if (value && typeof value === 'object') {
-                        value = value[part];
-                    } else {
-                        value = undefined;
-                        break;
-                    }
-                }
-                if (value !== undefined) {
-                    return value;
-                }
-            } else {
-                // Handle direct keys
-                if (config[key] !== undefined) {
-                    return config[key];
-                }
-            }
+            return JSON.parse(fs.readFileSync(jsonConfigPath, 'utf8'));
         }
     } catch (error) {
         console.warn('Error reading config.json:', error.message);
     }
-    
-    // Then check .env file (legacy support)
+    return null;
+}
+
+function readEnvFile() {
+    const values = new Map();
     try {
         const envContent = fs.readFileSync(configPath, 'utf8');
-        const lines = envContent.split('\n');
-        for (const line of lines) {
+        for (const line of envContent.split('\n')) {
             const [k, v] = line.split('=');
-            if (k.trim() === key) {
-                return v.trim();
+            if (v !== undefined && !values.has(k.trim())) {
+                values.set(k.trim(), v.trim());
             }
         }
     } catch (error) {
         // .env file doesn't exist or can't be read
     }
+    return values;
+}
+
+function buildSnapshot(version) {
+    const json = deepFreeze(readJsonConfig());
+    const jsonValues = new Map();
+    if (json && typeof json === 'object') {
+        flattenInto(jsonValues, '', json);
+    }
+    return Object.freeze({
+        version,
+        loadedAt: Date.now(),
+        json,
+        jsonValues,
+        envValues: readEnvFile()
+    });
+}
+
+function watchConfigFiles() {
+    if (watcher) {
+        return;
+    }
+    try {
+        // Watch the directory: editors often replace files instead of writing in place
+        watcher = fs.watch(process.cwd(), (eventType, filename) => {
+            if (filename !== 'config.json' && filename !== '.env') {
+                return;
+            }
+            // Saves arrive as several events; reload once they settle
+            clearTimeout(reloadTimer);
+            reloadTimer = setTimeout(reloadConfig, 100);
+            reloadTimer.unref();
+        });
+        watcher.unref();
+        watcher.on('error', () => {
+            watcher = null;
+        });
+    } catch (error) {
+        console.warn('Config file watching unavailable:', error.message);
+    }
+}
+
+// Re-reads both files and swaps in a new snapshot. Called by the file watcher,
+// and directly after this process writes config.json itself.
+export function reloadConfig() {
+    const previous = snapshot;
+    snapshot = buildSnapshot(previous ? previous.version + 1 : 1);
+    if (previous) {
+        for (const listener of changeListeners) {
+            try {
+                listener(snapshot, previous);
+            } catch (error) {
+                console.warn('Config change listener failed:', error.message);
+            }
+        }
+    }
+    return snapshot;
+}
+
+export function getConfigSnapshot() {
+    if (!snapshot) {
+        reloadConfig();
+        watchConfigFiles();
+    }
+    return snapshot;
+}
+
+// Returns a function that removes the listener
+export function onConfigChange(listener) {
+    changeListeners.add(listener);
+    return () => changeListeners.delete(listener);
+}
+
+export function getConfig(key, defaultValue = null) {
+    // First check environment variables
+    if (process.env[key]) {
+        return process.env[key];
+    }
+    
+    const current = snapshot || getConfigSnapshot();
+    
+    // Then config.json, including nested keys like 'slippi.address' or 'ai.apiKey'
+    const value = current.jsonValues.get(key);
+    if (value !== undefined) {
+        return value;
+    }
+    
+    // Then the .env file (legacy support)
+    const envValue = current.envValues.get(key);
+    if (envValue !== undefined) {
+        return envValue;
+    }
     
     return defaultValue;
 }
@@ -174,12 +270,5 @@ export function validateConfig() {
 }
 
 export function loadFullConfig() {
-    try {
-        if (fs.existsSync(jsonConfigPath)) {
-            return JSON.parse(fs.readFileSync(jsonConfigPath, 'utf8'));
-        }
-    } catch (error) {
-        console.error('Error loading full config:', error.message);
-    }
-    return null;
+    return getConfigSnapshot().json;
 }
@@ -0,0 +1,206 @@
+import fs from 'fs';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = path.dirname(__filename);
+
+const corpusPath = path.join(__dirname, '..', 'knowledge', 'coaching-notes.txt');
+
+// BM25 retrieval over the coaching knowledge corpus. The native KnowledgeIndex
+// reads the same file with the same tokenizer, scoring and boosts, so both
+// sides return the same snippets for the same query.
+const BM25_K1 = 1.2;
+const BM25_B = 0.75;
+const CHARACTER_BOOST = 1.0;
+const TAG_BOOST = 0.5;
+
+const STOP_WORDS = new Set([
+    'a', 'an', 'and', 'are', 'as', 'at', 'be', 'by', 'for', 'from', 'in', 'is', 'it',
+    'of', 'on', 'or', 'so', 'the', 'to', 'with', 'you', 'your'
+]);
+
+let index = null;
+
+export function tokenize(text) {
+    const tokens = [];
+    for (const match of String(text || '').toLowerCase().matchAll(/[a-z0-9]+/g)) {
+        if (!STOP_WORDS.has(match[0])) {
+            tokens.push(match[0]);
+        }
+    }
+    return tokens;
+}
+
+function splitList(value) {
+    return value.split(',').map(item => item.trim().toLowerCase()).filter(Boolean);
+}
+
+function parseCorpus(text) {
+    const snippets = [];
+    let snippet = { id: '', text: '', characters: [], tags: [] };
+    let inHeader = true;
+    let hasContent = false;
+
+    const finishEntry = () => {
+        if (hasContent) {
+            if (!snippet.id || !snippet.text) {
+                throw new Error(`Knowledge corpus entry after "${snippets.at(-1)?.id || 'start'}" needs an id and text`);
+            }
+            snippets.push(snippet);
+        }
+        snippet = { id: '', text: '', characters: [], tags: [] };
+        inHeader = true;
+        hasContent = false;
+    };
+
+    for (const line of text.split('\n')) {
+        const trimmed = line.trim();
+        if (trimmed === '---') {
+            finishEntry();
+            continue;
+        }
+        if (!trimmed || trimmed.startsWith('#')) {
+            continue;
+        }
+        hasContent = true;
+
+        if (inHeader) {
+            const colon = trimmed.indexOf(':');
+            const key = colon >= 0 ? trimmed.slice(0, colon).trim() : '';
+            const value = colon >= 0 ? trimmed.slice(colon + 1).trim() : '';
+            if (key === 'id') {
+                snippet.id = value;
+                continue;
+            } else if (key === 'characters') {
+                snippet.characters = splitList(value);
+                continue;
+            } else if (key === 'tags') {
+                snippet.tags = splitList(value);
+                continue;
+            }
+            inHeader = false;
+        }
+
+        snippet.text = snippet.text ? `${snippet.text} ${trimmed}` : trimmed;
+    }
+    finishEntry();
+    return snippets;
+}
+
+function buildIndex(snippets) {
+    const postings = new Map();     // term -> [{ snippet, tf }]
+    const keySnippets = new Map();  // 'c:fox' / 't:recovery' -> [snippet]
+    const lengths = [];
+    let totalLength = 0;
+
+    snippets.forEach((snippet, i) => {
+        const tokens = tokenize(snippet.text);
+        lengths.push(tokens.length);
+        totalLength += tokens.length;
+
+        const frequencies = new Map();
+        for (const token of tokens) {
+            frequencies.set(token, (frequencies.get(token) || 0) + 1);
+        }
+        for (const [term, tf] of frequencies) {
+            if (!postings.has(term)) {
+                postings.set(term, []);
+            }
+            postings.get(term).push({ snippet: i, tf });
+        }
+
+        const keys = new Set([
+            ...snippet.characters.map(character => `c:${character}`),
+            ...snippet.tags.map(tag => `t:${tag}`)
+        ]);
+        for (const key of keys) {
+            if (!keySnippets.has(key)) {
+                keySnippets.set(key, []);
+            }
+            keySnippets.get(key).push(i);
+        }
+    });
+
+    return {
+        snippets,
+        postings,
+        keySnippets,
+        lengths,
+        averageLength: snippets.length ? totalLength / snippets.length : 0
+    };
+}
+
+/**
+ * Loads (or reloads) the corpus. Called lazily by searchKnowledge.
+ */
+export function loadKnowledgeIndex(filePath = corpusPath) {
+    index = buildIndex(parseCorpus(fs.readFileSync(filePath, 'utf8')));
+    return index.snippets.length;
+}
+
+/**
+ * Top snippets for a query. Snippets about specific characters only qualify
+ * when every one of their characters is in `characters`.
+ *
+ * @param {string} text - Free text to match
+ * @param {Object} options - { characters: string[], tags: string[], topK: number }
+ * @returns {Array<{id: string, text: string, score: number}>}
+ */
+export function searchKnowledge(text, { characters = [], tags = [], topK = 5 } = {}) {
+    if (!index) {
+        try {
+            loadKnowledgeIndex();
+        } catch (error) {
+            console.warn('Knowledge corpus unavailable:', error.message);
+            index = buildIndex([]);
+        }
+    }
+
+    const count = index.snippets.length;
+    if (count === 0 || topK <= 0) {
+        return [];
+    }
+
+    const scores = new Float64Array(count);
+    const characterMatches = new Uint8Array(count);
+
+    for (const token of tokenize(text)) {
+        const termPostings = index.postings.get(token);
+        if (!termPostings) {
+            continue;
+        }
+        const df = termPostings.length;
+        const idf = Math.log(1 + (count - df + 0.5) / (df + 0.5));
+        for (const { snippet, tf } of termPostings) {
+            const norm = BM25_K1 * (1 - BM25_B + BM25_B * index.lengths[snippet] / index.averageLength);
+            scores[snippet] += idf * tf * (BM25_K1 + 1) / (tf + norm);
+        }
+    }
+
+    for (const character of new Set(characters.map(c => String(c).trim().toLowerCase()))) {
+        for (const snippet of index.keySnippets.get(`c:${character}`) || []) {
+            characterMatches[snippet]++;
+            scores[snippet] += CHARACTER_BOOST;
+        }
+    }
+    for (const tag of tags) {
+        for (const snippet of index.keySnippets.get(`t:${String(tag).trim().toLowerCase()}`) || []) {
+            scores[snippet] += TAG_BOOST;
+        }
+    }
+
+    const hits = [];
+    for (let i = 0; i < count; i++) {
+        if (scores[i] > 0 && characterMatches[i] >= index.snippets[i].characters.length) {
+            hits.push({ i, score: scores[i] });
+        }
+    }
+    hits.sort((a, b) => (b.score - a.score) || (a.i - b.i));
+
+    return hits.slice(0, topK).map(({ i, score }) => ({
+        id: index.snippets[i].id,
+        text: index.snippets[i].text,
+        score
+    }));
+}
@@ -0,0 +1,165 @@
+// Near-duplicate check for commentary requests. The native NearDuplicateFilter
+// merges repeated lines in the overlay's panel; this is the same SimHash over
+// the same tokens, so the Node side can skip asking the model for a line it
+// asked for a moment ago.
+//
+// Each text becomes a 56-bit SimHash of its lowercased words. Digit runs fold
+// into one token, so percents and hit counts don't make texts distinct, except
+// in player ports ("P1" to "P4"). The top byte records which ports the text
+// names and which comes first. A text naming the same ports within
+// maxDistance bits of one seen in the last windowMs is a repeat.
+const MASK = (1n << 64n) - 1n;
+const PORTS_SHIFT = 56n;
+const SIMHASH_MASK = (1n << PORTS_SHIFT) - 1n;
+const FNV_OFFSET = 14695981039346656037n;
+const FNV_PRIME = 1099511628211n;
+const MAX_TOKENS = 255;
+
+export const RING_SIZE = 16;
+
+// Spreads a word's FNV-1a hash so every fingerprint bit depends on all of it
+function finishToken(hash) {
+    hash ^= hash >> 33n;
+    hash = (hash * 0xff51afd7ed558ccdn) & MASK;
+    hash ^= hash >> 33n;
+    hash = (hash * 0xc4ceb9fe1a85ec53n) & MASK;
+    hash ^= hash >> 33n;
+    return hash;
+}
+
+function popcount32(value) {
+    value -= (value >>> 1) & 0x55555555;
+    value = (value & 0x33333333) + ((value >>> 2) & 0x33333333);
+    value = (value + (value >>> 4)) & 0x0f0f0f0f;
+    return Math.imul(value, 0x01010101) >>> 24;
+}
+
+export function fingerprint(text) {
+    const counts = new Array(64).fill(0);
+    let tokens = 0;
+    let hash = FNV_OFFSET;
+    let tokenLength = 0;
+    let last = 0;
+    let inNumber = false;
+    let tokenPort = 0;
+    let portMask = 0;
+    let firstPort = 0;
+
+    const addToken = () => {
+        if (tokens < MAX_TOKENS) {
+            tokens++;
+            const finished = finishToken(hash);
+            const low = Number(finished & 0xffffffffn);
+            const high = Number(finished >> 32n);
+            for (let bit = 0; bit < 32; bit++) {
+                counts[bit] += (low >>> bit) & 1;
+                counts[bit + 32] += (high >>> bit) & 1;
+            }
+        }
+        if (tokenPort > 0) {
+            portMask |= 1 << (tokenPort - 1);
+            firstPort = firstPort || tokenPort;
+        }
+        hash = FNV_OFFSET;
+        tokenLength = 0;
+        inNumber = false;
+        tokenPort = 0;
+    };
+    const addByte = (byte) => {
+        hash = ((hash ^ BigInt(byte)) * FNV_PRIME) & MASK;
+    };
+
+    // Bytes, like the native side: anything outside ASCII counts as a letter
+    for (let c of Buffer.from(String(text || ''), 'utf8')) {
+        const isDigit = c >= 0x30 && c <= 0x39;
+        const isLetter = (c >= 0x61 && c <= 0x7a) || (c >= 0x41 && c <= 0x5a) || c >= 0x80;
+        if (c >= 0x41 && c <= 0x5a) {
+            c += 0x20;
+        }
+        if (isDigit && tokenLength === 1 && last === 0x70 && c >= 0x31 && c <= 0x34) {
+            addByte(c);
+            tokenLength++;
+            tokenPort = c - 0x30;
+        } else if (isDigit) {
+            if (!inNumber) {
+                addByte(0x23);
+                inNumber = true;
+            }
+            tokenLength++;
+            tokenPort = 0;
+        } else if (isLetter) {
+            addByte(c);
+            tokenLength++;
+            inNumber = false;
+            tokenPort = 0;
+        } else if (tokenLength > 0) {
+            addToken();
+        }
+        last = c;
+    }
+    if (tokenLength > 0) {
+        addToken();
+    }
+    if (tokens === 0) {
+        return 0n;
+    }
+
+    // Bits set in more than half of the tokens
+    const threshold = Math.floor(tokens / 2) + 1;
+    let result = 0n;
+    for (let bit = 63; bit >= 0; bit--) {
+        result = (result << 1n) | (counts[bit] >= threshold ? 1n : 0n);
+    }
+    return (result & SIMHASH_MASK) | (BigInt(firstPort << 4 | portMask) << PORTS_SHIFT);
+}
+
+export function distance(first, second) {
+    const bits = first ^ second;
+    return popcount32(Number(bits & 0xffffffffn)) + popcount32(Number(bits >> 32n));
+}
+
+export class NearDuplicateFilter {
+    constructor({ maxDistance = 10, windowMs = 15000 } = {}) {
+        this.maxDistance = maxDistance;
+        this.windowMs = windowMs;
+        this.ring = [];
+        this.next = 0;
+        this.suppressed = 0;
+    }
+
+    // True if the fingerprint repeats a recent text; that text's time is
+    // refreshed, so a steady burst keeps matching
+    match(value, nowMs = Date.now()) {
+        for (const entry of this.ring) {
+            if (nowMs - entry.time <= this.windowMs && entry.fingerprint >> PORTS_SHIFT === value >> PORTS_SHIFT &&
+                distance(entry.fingerprint, value) <= this.maxDistance) {
+                entry.time = nowMs;
+                this.suppressed++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Adds a text to the ring, replacing the oldest
+    remember(value, nowMs = Date.now()) {
+        this.ring[this.next] = { fingerprint: value, time: nowMs };
+        this.next = (this.next + 1) % RING_SIZE;
+    }
+
+    // False for a near-duplicate of a recent text; otherwise remembers it
+    admit(text, nowMs = Date.now()) {
+        const value = fingerprint(text);
+        if (this.match(value, nowMs)) {
+            return false;
+        }
+        this.remember(value, nowMs);
+        return true;
+    }
+
+    clear() {
+        this.ring = [];
+        this.next = 0;
+        this.suppressed = 0;
+    }
+}